@@ -0,0 +1,662 @@
+#include "AsyncReader.h"
+#include "IOStream.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef MTDISASM_HAVE_IO_URING
+#include <cerrno>
+#include <cstring>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace mtdisasm
+{
+	namespace
+	{
+		// Reads on a set of threads of its own, so that reads never wait behind decoding jobs
+		class ThreadedAsyncReader final : public AsyncReader
+		{
+		public:
+			ThreadedAsyncReader(size_t numThreads, size_t maxInFlight);
+			~ThreadedAsyncReader();
+
+			bool Submit(const IOStream& stream, uint32_t pos, void* dest, size_t size, uintptr_t tag) override;
+			bool WaitForCompletion(uintptr_t& outTag, bool& outSucceeded) override;
+			void CancelAll() override;
+
+			size_t NumInFlight() const override;
+			size_t MaxInFlight() const override;
+			const char* GetName() const override;
+
+		private:
+			struct Request
+			{
+				const IOStream* m_stream;
+				uint32_t m_pos;
+				void* m_dest;
+				size_t m_size;
+				uintptr_t m_tag;
+			};
+
+			struct Completion
+			{
+				uintptr_t m_tag;
+				bool m_succeeded;
+			};
+
+			void ReaderThreadFunc();
+
+			std::vector<std::thread> m_threads;
+			std::deque<Request> m_requests;
+			std::deque<Completion> m_completions;
+
+			std::mutex m_mutex;
+			std::condition_variable m_requestCondition;
+			std::condition_variable m_completionCondition;
+
+			size_t m_numInFlight;
+			size_t m_maxInFlight;
+			bool m_isShuttingDown;
+		};
+
+		ThreadedAsyncReader::ThreadedAsyncReader(size_t numThreads, size_t maxInFlight)
+			: m_numInFlight(0)
+			, m_maxInFlight(maxInFlight)
+			, m_isShuttingDown(false)
+		{
+			m_threads.reserve(numThreads);
+			for (size_t i = 0; i < numThreads; i++)
+				m_threads.push_back(std::thread(&ThreadedAsyncReader::ReaderThreadFunc, this));
+		}
+
+		ThreadedAsyncReader::~ThreadedAsyncReader()
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_isShuttingDown = true;
+			}
+
+			m_requestCondition.notify_all();
+
+			for (std::thread& thread : m_threads)
+				thread.join();
+		}
+
+		bool ThreadedAsyncReader::Submit(const IOStream& stream, uint32_t pos, void* dest, size_t size, uintptr_t tag)
+		{
+			Request request;
+			request.m_stream = &stream;
+			request.m_pos = pos;
+			request.m_dest = dest;
+			request.m_size = size;
+			request.m_tag = tag;
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				if (m_numInFlight == m_maxInFlight)
+					return false;
+
+				m_numInFlight++;
+				m_requests.push_back(request);
+			}
+
+			m_requestCondition.notify_one();
+			return true;
+		}
+
+		bool ThreadedAsyncReader::WaitForCompletion(uintptr_t& outTag, bool& outSucceeded)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (m_numInFlight == 0)
+				return false;
+
+			while (m_completions.empty())
+				m_completionCondition.wait(lock);
+
+			const Completion& completion = m_completions.front();
+			outTag = completion.m_tag;
+			outSucceeded = completion.m_succeeded;
+			m_completions.pop_front();
+			m_numInFlight--;
+
+			return true;
+		}
+
+		void ThreadedAsyncReader::CancelAll()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			// Reads that a thread has started are left to finish
+			m_numInFlight -= m_requests.size();
+			m_requests.clear();
+
+			while (m_completions.size() < m_numInFlight)
+				m_completionCondition.wait(lock);
+
+			m_completions.clear();
+			m_numInFlight = 0;
+		}
+
+		size_t ThreadedAsyncReader::NumInFlight() const
+		{
+			return m_numInFlight;
+		}
+
+		size_t ThreadedAsyncReader::MaxInFlight() const
+		{
+			return m_maxInFlight;
+		}
+
+		const char* ThreadedAsyncReader::GetName() const
+		{
+			return "threads";
+		}
+
+		void ThreadedAsyncReader::ReaderThreadFunc()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			for (;;)
+			{
+				while (m_requests.empty() && !m_isShuttingDown)
+					m_requestCondition.wait(lock);
+
+				if (m_requests.empty())
+					return;
+
+				Request request = m_requests.front();
+				m_requests.pop_front();
+
+				lock.unlock();
+				bool succeeded = request.m_stream->ReadAt(request.m_pos, request.m_dest, request.m_size);
+				lock.lock();
+
+				Completion completion;
+				completion.m_tag = request.m_tag;
+				completion.m_succeeded = succeeded;
+				m_completions.push_back(completion);
+
+				m_completionCondition.notify_one();
+			}
+		}
+
+#ifdef MTDISASM_HAVE_IO_URING
+		// Submits reads to an io_uring instance using the raw system calls.  Reads of streams
+		// that aren't backed by a file descriptor are done synchronously on submission.
+		class IOURingAsyncReader final : public AsyncReader
+		{
+		public:
+			IOURingAsyncReader();
+			~IOURingAsyncReader();
+
+			bool Init(size_t maxInFlight);
+
+			bool Submit(const IOStream& stream, uint32_t pos, void* dest, size_t size, uintptr_t tag) override;
+			bool WaitForCompletion(uintptr_t& outTag, bool& outSucceeded) override;
+			void CancelAll() override;
+
+			size_t NumInFlight() const override;
+			size_t MaxInFlight() const override;
+			const char* GetName() const override;
+
+		private:
+			struct Slot
+			{
+				int m_fd;
+				uint64_t m_pos;
+				uint8_t* m_dest;
+				size_t m_remaining;
+				uintptr_t m_tag;
+				struct iovec m_iovec;
+			};
+
+			struct Completion
+			{
+				uintptr_t m_tag;
+				bool m_succeeded;
+			};
+
+			void QueueSlotRead(size_t slotIndex);
+			void QueueSlotCancel(size_t slotIndex);
+			bool HasFreeEntry() const;
+			bool EnterRing(unsigned int minComplete);
+			void CloseRing();
+
+			// user_data of cancellations, which can't be a slot index
+			static const uint64_t kCancelUserData = ~static_cast<uint64_t>(0);
+
+			int m_ringFD;
+
+			void* m_sqRing;
+			size_t m_sqRingSize;
+			void* m_cqRing;
+			size_t m_cqRingSize;
+			struct io_uring_sqe* m_sqes;
+			size_t m_sqesSize;
+
+			unsigned int* m_sqHead;
+			unsigned int* m_sqTail;
+			unsigned int m_sqMask;
+			unsigned int m_sqEntries;
+			unsigned int* m_sqArray;
+			unsigned int* m_cqHead;
+			unsigned int* m_cqTail;
+			unsigned int m_cqMask;
+			struct io_uring_cqe* m_cqes;
+
+			std::vector<Slot> m_slots;
+			std::vector<size_t> m_freeSlots;
+			std::deque<Completion> m_syncCompletions;
+
+			unsigned int m_numUnsubmitted;
+			size_t m_numInFlight;
+			bool m_isCancelling;
+		};
+
+		IOURingAsyncReader::IOURingAsyncReader()
+			: m_ringFD(-1)
+			, m_sqRing(MAP_FAILED)
+			, m_sqRingSize(0)
+			, m_cqRing(MAP_FAILED)
+			, m_cqRingSize(0)
+			, m_sqes(nullptr)
+			, m_sqesSize(0)
+			, m_sqHead(nullptr)
+			, m_sqTail(nullptr)
+			, m_sqMask(0)
+			, m_sqEntries(0)
+			, m_sqArray(nullptr)
+			, m_cqHead(nullptr)
+			, m_cqTail(nullptr)
+			, m_cqMask(0)
+			, m_cqes(nullptr)
+			, m_numUnsubmitted(0)
+			, m_numInFlight(0)
+			, m_isCancelling(false)
+		{
+		}
+
+		IOURingAsyncReader::~IOURingAsyncReader()
+		{
+			// Reads still in the ring would write into buffers that are about to be freed
+			if (m_ringFD >= 0)
+				CancelAll();
+
+			CloseRing();
+		}
+
+		void IOURingAsyncReader::CloseRing()
+		{
+			if (m_sqes)
+				munmap(m_sqes, m_sqesSize);
+			if (m_cqRing != MAP_FAILED && m_cqRing != m_sqRing)
+				munmap(m_cqRing, m_cqRingSize);
+			if (m_sqRing != MAP_FAILED)
+				munmap(m_sqRing, m_sqRingSize);
+			if (m_ringFD >= 0)
+				close(m_ringFD);
+
+			m_sqes = nullptr;
+			m_cqRing = MAP_FAILED;
+			m_sqRing = MAP_FAILED;
+			m_ringFD = -1;
+		}
+
+		bool IOURingAsyncReader::Init(size_t maxInFlight)
+		{
+			struct io_uring_params params;
+			memset(&params, 0, sizeof(params));
+
+			m_ringFD = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned int>(maxInFlight), &params));
+			if (m_ringFD < 0)
+				return false;
+
+			m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+			m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+			if (params.features & IORING_FEAT_SINGLE_MMAP)
+			{
+				if (m_cqRingSize > m_sqRingSize)
+					m_sqRingSize = m_cqRingSize;
+				m_cqRingSize = m_sqRingSize;
+			}
+
+			m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFD, IORING_OFF_SQ_RING);
+			if (m_sqRing == MAP_FAILED)
+				return false;
+
+			if (params.features & IORING_FEAT_SINGLE_MMAP)
+				m_cqRing = m_sqRing;
+			else
+			{
+				m_cqRing = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFD, IORING_OFF_CQ_RING);
+				if (m_cqRing == MAP_FAILED)
+					return false;
+			}
+
+			m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+			void* sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFD, IORING_OFF_SQES);
+			if (sqes == MAP_FAILED)
+				return false;
+
+			m_sqes = static_cast<struct io_uring_sqe*>(sqes);
+
+			uint8_t* sqRingBytes = static_cast<uint8_t*>(m_sqRing);
+			uint8_t* cqRingBytes = static_cast<uint8_t*>(m_cqRing);
+
+			m_sqHead = reinterpret_cast<unsigned int*>(sqRingBytes + params.sq_off.head);
+			m_sqTail = reinterpret_cast<unsigned int*>(sqRingBytes + params.sq_off.tail);
+			m_sqMask = *reinterpret_cast<unsigned int*>(sqRingBytes + params.sq_off.ring_mask);
+			m_sqEntries = params.sq_entries;
+			m_sqArray = reinterpret_cast<unsigned int*>(sqRingBytes + params.sq_off.array);
+			m_cqHead = reinterpret_cast<unsigned int*>(cqRingBytes + params.cq_off.head);
+			m_cqTail = reinterpret_cast<unsigned int*>(cqRingBytes + params.cq_off.tail);
+			m_cqMask = *reinterpret_cast<unsigned int*>(cqRingBytes + params.cq_off.ring_mask);
+			m_cqes = reinterpret_cast<struct io_uring_cqe*>(cqRingBytes + params.cq_off.cqes);
+
+			// The completion ring has twice as many entries as the submission ring, so it can't
+			// overflow as long as each slot has at most a read and a cancellation in flight
+			size_t numSlots = params.sq_entries;
+			if (numSlots > maxInFlight)
+				numSlots = maxInFlight;
+
+			m_slots.resize(numSlots);
+			m_freeSlots.reserve(numSlots);
+			for (size_t i = numSlots; i > 0; i--)
+				m_freeSlots.push_back(i - 1);
+
+			return true;
+		}
+
+		bool IOURingAsyncReader::Submit(const IOStream& stream, uint32_t pos, void* dest, size_t size, uintptr_t tag)
+		{
+			if (m_ringFD < 0 || m_numInFlight == m_slots.size())
+				return false;
+
+			int fd = -1;
+			if (size == 0 || !stream.GetFileDescriptor(fd))
+			{
+				Completion completion;
+				completion.m_tag = tag;
+				completion.m_succeeded = stream.ReadAt(pos, dest, size);
+				m_syncCompletions.push_back(completion);
+				m_numInFlight++;
+				return true;
+			}
+
+			size_t slotIndex = m_freeSlots.back();
+			m_freeSlots.pop_back();
+
+			Slot& slot = m_slots[slotIndex];
+			slot.m_fd = fd;
+			slot.m_pos = pos;
+			slot.m_dest = static_cast<uint8_t*>(dest);
+			slot.m_remaining = size;
+			slot.m_tag = tag;
+
+			QueueSlotRead(slotIndex);
+			m_numInFlight++;
+
+			// A failure here leaves the read queued, and it's reported by WaitForCompletion
+			EnterRing(0);
+
+			return true;
+		}
+
+		void IOURingAsyncReader::QueueSlotRead(size_t slotIndex)
+		{
+			Slot& slot = m_slots[slotIndex];
+			slot.m_iovec.iov_base = slot.m_dest;
+			slot.m_iovec.iov_len = slot.m_remaining;
+
+			// Only this thread produces entries, so the tail only needs to be published
+			unsigned int tail = *m_sqTail;
+			unsigned int index = tail & m_sqMask;
+
+			struct io_uring_sqe* sqe = &m_sqes[index];
+			memset(sqe, 0, sizeof(*sqe));
+			sqe->opcode = IORING_OP_READV;
+			sqe->fd = slot.m_fd;
+			sqe->off = slot.m_pos;
+			sqe->addr = reinterpret_cast<uintptr_t>(&slot.m_iovec);
+			sqe->len = 1;
+			sqe->user_data = slotIndex;
+
+			m_sqArray[index] = index;
+			__atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+			m_numUnsubmitted++;
+		}
+
+		void IOURingAsyncReader::QueueSlotCancel(size_t slotIndex)
+		{
+			unsigned int tail = *m_sqTail;
+			unsigned int index = tail & m_sqMask;
+
+			struct io_uring_sqe* sqe = &m_sqes[index];
+			memset(sqe, 0, sizeof(*sqe));
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->fd = -1;
+			sqe->addr = slotIndex;
+			sqe->user_data = kCancelUserData;
+
+			m_sqArray[index] = index;
+			__atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+			m_numUnsubmitted++;
+		}
+
+		bool IOURingAsyncReader::HasFreeEntry() const
+		{
+			return *m_sqTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) < m_sqEntries;
+		}
+
+		// Submits the queued entries and waits for minComplete completions.  Entries the kernel
+		// can't take yet stay queued and are submitted by a later call.
+		bool IOURingAsyncReader::EnterRing(unsigned int minComplete)
+		{
+			unsigned int flags = (minComplete > 0) ? IORING_ENTER_GETEVENTS : 0;
+			unsigned int toSubmit = m_numUnsubmitted;
+
+			for (;;)
+			{
+				long result = syscall(__NR_io_uring_enter, m_ringFD, toSubmit, minComplete, flags, nullptr, 0);
+				if (result >= 0)
+				{
+					m_numUnsubmitted -= static_cast<unsigned int>(result);
+					return true;
+				}
+
+				if (errno == EINTR)
+					continue;
+
+				if (errno != EAGAIN && errno != EBUSY)
+					return false;
+
+				// The kernel is out of room for completions, so they have to be reaped before
+				// anything else is submitted.  Just wait for them if the caller wants them.
+				if (minComplete == 0 || toSubmit == 0)
+					return true;
+
+				toSubmit = 0;
+			}
+		}
+
+		bool IOURingAsyncReader::WaitForCompletion(uintptr_t& outTag, bool& outSucceeded)
+		{
+			if (m_numInFlight == 0)
+				return false;
+
+			// Short reads requeued by the last call, or reads the kernel had no room for
+			if (m_numUnsubmitted > 0 && !EnterRing(0))
+				return false;
+
+			if (!m_syncCompletions.empty())
+			{
+				outTag = m_syncCompletions.front().m_tag;
+				outSucceeded = m_syncCompletions.front().m_succeeded;
+				m_syncCompletions.pop_front();
+				m_numInFlight--;
+				return true;
+			}
+
+			for (;;)
+			{
+				unsigned int head = *m_cqHead;
+				if (head == __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE))
+				{
+					if (!EnterRing(1))
+						return false;
+					continue;
+				}
+
+				const struct io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+				uint64_t userData = cqe.user_data;
+				int result = cqe.res;
+
+				__atomic_store_n(m_cqHead, head + 1, __ATOMIC_RELEASE);
+
+				if (userData == kCancelUserData)
+					continue;
+
+				size_t slotIndex = static_cast<size_t>(userData);
+				Slot& slot = m_slots[slotIndex];
+
+				bool isFinished = true;
+				bool succeeded = false;
+				if (result > 0 && static_cast<size_t>(result) < slot.m_remaining)
+				{
+					// Short read, queue the rest
+					slot.m_dest += result;
+					slot.m_pos += static_cast<uint64_t>(result);
+					slot.m_remaining -= static_cast<size_t>(result);
+					isFinished = false;
+				}
+				else if (result == -EINTR || result == -EAGAIN)
+					isFinished = false;
+				else
+					succeeded = (result > 0);
+
+				if (!isFinished && !m_isCancelling)
+				{
+					QueueSlotRead(slotIndex);
+					continue;
+				}
+
+				outTag = slot.m_tag;
+				outSucceeded = succeeded;
+				m_freeSlots.push_back(slotIndex);
+				m_numInFlight--;
+
+				return true;
+			}
+		}
+
+		// Cancels each read that's still in the ring, then reaps completions until every read
+		// has finished one way or the other.  A read that has already started may finish
+		// instead of being cancelled.
+		void IOURingAsyncReader::CancelAll()
+		{
+			m_numInFlight -= m_syncCompletions.size();
+			m_syncCompletions.clear();
+
+			if (m_numInFlight == 0)
+				return;
+
+			std::vector<bool> isSlotCancelled(m_slots.size(), false);
+			for (size_t slotIndex : m_freeSlots)
+				isSlotCancelled[slotIndex] = true;
+
+			m_isCancelling = true;
+
+			size_t nextSlotIndex = 0;
+			while (m_numInFlight > 0)
+			{
+				for (; nextSlotIndex < m_slots.size() && HasFreeEntry(); nextSlotIndex++)
+				{
+					if (!isSlotCancelled[nextSlotIndex])
+					{
+						QueueSlotCancel(nextSlotIndex);
+						isSlotCancelled[nextSlotIndex] = true;
+					}
+				}
+
+				uintptr_t tag = 0;
+				bool succeeded = false;
+				if (!WaitForCompletion(tag, succeeded))
+				{
+					// The ring can't be used any more.  Closing it makes the kernel cancel
+					// what's left.
+					CloseRing();
+					break;
+				}
+			}
+
+			m_isCancelling = false;
+
+			// Slots freed by reaping are in m_freeSlots already, so only the ones
+			// abandoned with the ring need to be returned
+			if (m_numInFlight > 0)
+			{
+				m_freeSlots.clear();
+				for (size_t i = m_slots.size(); i > 0; i--)
+					m_freeSlots.push_back(i - 1);
+
+				m_numUnsubmitted = 0;
+				m_numInFlight = 0;
+			}
+		}
+
+		size_t IOURingAsyncReader::NumInFlight() const
+		{
+			return m_numInFlight;
+		}
+
+		size_t IOURingAsyncReader::MaxInFlight() const
+		{
+			return m_slots.size();
+		}
+
+		const char* IOURingAsyncReader::GetName() const
+		{
+			return "io_uring";
+		}
+#endif
+	}
+
+	AsyncReader* AsyncReader::Create(AsyncReadEngine engine, size_t maxInFlight)
+	{
+		if (maxInFlight == 0)
+			maxInFlight = 1;
+
+		if (engine == AsyncReadEngine::kAuto || engine == AsyncReadEngine::kIOURing)
+		{
+#ifdef MTDISASM_HAVE_IO_URING
+			IOURingAsyncReader* reader = new IOURingAsyncReader();
+			if (reader->Init(maxInFlight))
+				return reader;
+
+			delete reader;
+#endif
+
+			if (engine == AsyncReadEngine::kIOURing)
+				return nullptr;
+		}
+
+		// Reads are mostly waiting on the device, so a few threads are enough to keep it busy
+		size_t numThreads = maxInFlight;
+		if (numThreads > 4)
+			numThreads = 4;
+
+		return new ThreadedAsyncReader(numThreads, maxInFlight);
+	}
+}
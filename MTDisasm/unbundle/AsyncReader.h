@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mtdisasm
+{
+	struct IOStream;
+
+	enum class AsyncReadEngine
+	{
+		kAuto,		// io_uring if the build and kernel support it, otherwise threads
+		kIOURing,
+		kThreads,
+	};
+
+	// Keeps several reads in flight and returns them as they finish.  Submit and
+	// WaitForCompletion must be called from the same thread.
+	class AsyncReader
+	{
+	public:
+		virtual ~AsyncReader() {}
+
+		// Queues a read of the whole range.  The destination must stay valid until the read's
+		// completion is returned.  Fails if MaxInFlight reads are already queued.
+		virtual bool Submit(const IOStream& stream, uint32_t pos, void* dest, size_t size, uintptr_t tag) = 0;
+
+		// Waits for a queued read to finish.  Returns false if no reads are queued.
+		virtual bool WaitForCompletion(uintptr_t& outTag, bool& outSucceeded) = 0;
+
+		// Drops every queued read, returning once none of them can still write to its
+		// destination.  Their completions aren't returned.
+		virtual void CancelAll() = 0;
+
+		virtual size_t NumInFlight() const = 0;
+		virtual size_t MaxInFlight() const = 0;
+		virtual const char* GetName() const = 0;
+
+		// Returns null if the engine isn't available
+		static AsyncReader* Create(AsyncReadEngine engine, size_t maxInFlight);
+	};
+}
@@ -0,0 +1,64 @@
+#include "AtlasPacker.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mtdisasm
+{
+	void PackAtlas(std::vector<AtlasSlot>& slots, size_t maxPageSize, std::vector<AtlasPage>& outPages)
+	{
+		outPages.clear();
+
+		double totalArea = 0.0;
+		size_t maxSlotWidth = 0;
+		size_t maxSlotHeight = 0;
+		for (const AtlasSlot& slot : slots)
+		{
+			totalArea += static_cast<double>(slot.m_width) * static_cast<double>(slot.m_height);
+			maxSlotWidth = std::max(maxSlotWidth, slot.m_width);
+			maxSlotHeight = std::max(maxSlotHeight, slot.m_height);
+		}
+
+		const size_t targetWidth = static_cast<size_t>(std::ceil(std::sqrt(totalArea)));
+		const size_t shelfWidth = std::max(maxSlotWidth, std::min(targetWidth, maxPageSize));
+		const size_t pageHeightLimit = std::max(maxSlotHeight, maxPageSize);
+
+		AtlasPage page = { 0, 0 };
+		size_t shelfLeft = 0;
+		size_t shelfTop = 0;
+		size_t shelfHeight = 0;
+
+		for (AtlasSlot& slot : slots)
+		{
+			if (shelfLeft + slot.m_width > shelfWidth)
+			{
+				shelfTop += shelfHeight;
+				shelfLeft = 0;
+				shelfHeight = 0;
+			}
+
+			if (shelfTop + slot.m_height > pageHeightLimit)
+			{
+				outPages.push_back(page);
+				page.m_width = 0;
+				page.m_height = 0;
+				shelfTop = 0;
+				shelfLeft = 0;
+				shelfHeight = 0;
+			}
+
+			slot.m_page = outPages.size();
+			slot.m_left = shelfLeft;
+			slot.m_top = shelfTop;
+
+			shelfLeft += slot.m_width;
+			shelfHeight = std::max(shelfHeight, slot.m_height);
+
+			page.m_width = std::max(page.m_width, shelfLeft);
+			page.m_height = std::max(page.m_height, shelfTop + shelfHeight);
+		}
+
+		if (!slots.empty())
+			outPages.push_back(page);
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace mtdisasm
+{
+	struct AtlasSlot
+	{
+		size_t m_width;
+		size_t m_height;
+
+		// Set by PackAtlas
+		size_t m_page;
+		size_t m_left;
+		size_t m_top;
+	};
+
+	struct AtlasPage
+	{
+		size_t m_width;
+		size_t m_height;
+	};
+
+	// Packs slots onto pages in shelves, in order, so that every slot on a page comes before
+	// every slot on the next page and each page can be finished before the next is started.
+	// Pages are kept to about the square root of the total area wide and to maxPageSize,
+	// except that a page always fits its largest slot.
+	void PackAtlas(std::vector<AtlasSlot>& slots, size_t maxPageSize, std::vector<AtlasPage>& outPages);
+}
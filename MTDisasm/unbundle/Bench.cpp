@@ -0,0 +1,1443 @@
+#include "Catalog.h"
+#include "DataObject.h"
+#include "DataReader.h"
+#include "ImageEncoder.h"
+#include "MemIOStream.h"
+#include "MToonCompositor.h"
+#include "MToonRLEDecoder.h"
+#include "ObjectArena.h"
+#include "ObjectStreamCursor.h"
+#include "ObjectTypeRegistry.h"
+#include "PixelConvert.h"
+#include "StructuredWriter.h"
+#include "TextWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Decoders from MTDisasm.cpp, which is linked in without its main
+void GenerateMacStandardPalette();
+bool DecompileMiniscript(const mtdisasm::DOMiniscriptProgram& obj, const mtdisasm::SerializationProperties& sp, bool isExpression, mtdisasm::TextWriter& f);
+extern uint32_t g_macStandardPaletteRGBA[256];
+
+struct BenchResult
+{
+	std::string m_name;
+	const char* m_itemName;		// What m_numItems counts, such as "objects" or "pixels"
+	int m_iterations;
+	double m_seconds;
+	double m_numBytes;			// Input bytes over all iterations
+	double m_numItems;
+	uint64_t m_checksum;		// Keeps the work from being optimized out
+};
+
+// Prints results as a table, or as JSON Lines for comparing runs between commits
+class BenchReport
+{
+public:
+	explicit BenchReport(bool isJSON);
+
+	void Add(const BenchResult& result);
+	void Fail(const char* name, const char* reason);
+
+	void PrintHeading(const char* heading);
+
+	bool Succeeded() const;
+
+private:
+	bool m_isJSON;
+	bool m_succeeded;
+	mtdisasm::TextWriter m_textWriter;
+	mtdisasm::JSONLinesWriter m_jsonWriter;
+};
+
+BenchReport::BenchReport(bool isJSON)
+	: m_isJSON(isJSON)
+	, m_succeeded(true)
+	, m_textWriter(stdout)
+	, m_jsonWriter(m_textWriter)
+{
+}
+
+void BenchReport::Add(const BenchResult& result)
+{
+	const double megaBytesPerSecond = result.m_numBytes / result.m_seconds / 1000000.0;
+	const double itemsPerSecond = result.m_numItems / result.m_seconds;
+
+	if (m_isJSON)
+	{
+		mtdisasm::StructuredWriter& w = m_jsonWriter;
+
+		w.BeginRecord();
+		w.WriteString("Name", result.m_name.c_str());
+		w.WriteUInt("Iterations", static_cast<uint32_t>(result.m_iterations));
+		w.WriteDouble("Seconds", result.m_seconds);
+		w.WriteDouble("MBPerSecond", megaBytesPerSecond);
+		w.WriteString("Unit", result.m_itemName);
+		w.WriteDouble("PerSecond", itemsPerSecond);
+		w.WriteUInt("Checksum", result.m_checksum);
+		w.EndRecord();
+	}
+	else
+		m_textWriter.Printf("%-42s %10.1f MB/s %12.2f M%s/s  (checksum %llx)\n", result.m_name.c_str(), megaBytesPerSecond, itemsPerSecond / 1000000.0, result.m_itemName, static_cast<unsigned long long>(result.m_checksum));
+
+	m_textWriter.Flush();
+	fflush(stdout);
+}
+
+void BenchReport::Fail(const char* name, const char* reason)
+{
+	fprintf(stderr, "%s: %s\n", name, reason);
+	m_succeeded = false;
+}
+
+void BenchReport::PrintHeading(const char* heading)
+{
+	if (!m_isJSON)
+	{
+		m_textWriter.Printf("\n%s\n", heading);
+		m_textWriter.Flush();
+		fflush(stdout);
+	}
+}
+
+bool BenchReport::Succeeded() const
+{
+	return m_succeeded;
+}
+
+// Runs func iterations times and returns the elapsed time, or a negative time if func fails
+template<class TFunc>
+double TimeIterations(int iterations, const TFunc& func)
+{
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++)
+	{
+		if (!func())
+			return -1.0;
+	}
+	std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double>(endTime - startTime).count();
+}
+
+uint32_t NextRandom(uint32_t& state)
+{
+	state = state * 1664525u + 1013904223u;
+	return state >> 8;
+}
+
+// Builds fixtures in the Windows layout.  Values are written in this machine's byte order
+// so that they're loaded with the native order reader.
+class FixtureWriter
+{
+public:
+	void WriteU8(uint8_t v) { m_buffer.push_back(v); }
+	void WriteU16(uint16_t v) { WriteBytes(&v, 2); }
+	void WriteU32(uint32_t v) { WriteBytes(&v, 4); }
+	void WriteS16(int16_t v) { WriteBytes(&v, 2); }
+	void WriteS32(int32_t v) { WriteBytes(&v, 4); }
+	void WriteF64(double v) { WriteBytes(&v, 8); }
+	void WriteZeros(size_t size) { m_buffer.resize(m_buffer.size() + size, 0); }
+
+	void WriteBytes(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+	}
+
+	// Windows rects are left, top, right, bottom
+	void WriteRect(int16_t left, int16_t top, int16_t right, int16_t bottom)
+	{
+		WriteS16(left);
+		WriteS16(top);
+		WriteS16(right);
+		WriteS16(bottom);
+	}
+
+	// Name with its terminator
+	void WriteName(const char* name)
+	{
+		WriteBytes(name, strlen(name) + 1);
+	}
+
+	// Length including the terminator, then the name
+	void WritePStr16(const char* str)
+	{
+		WriteU16(static_cast<uint16_t>(strlen(str) + 1));
+		WriteName(str);
+	}
+
+	void WriteObjectHeader(uint32_t typeCode, uint16_t revision)
+	{
+		WriteU32(typeCode);
+		WriteU16(revision);
+	}
+
+	size_t Size() const { return m_buffer.size(); }
+	std::vector<uint8_t>& GetBuffer() { return m_buffer; }
+
+private:
+	std::vector<uint8_t> m_buffer;
+};
+
+const mtdisasm::SerializationProperties g_fixtureSP = { false, false, mtdisasm::SystemType::kWindows };
+
+// Field decode
+
+// Each record mixes the field types that dominate object loading
+struct BenchRecord
+{
+	uint32_t m_u32;
+	uint16_t m_u16;
+	int16_t m_s16[4];
+	int32_t m_s32;
+	uint64_t m_u64;
+	double m_f64;
+};
+
+static const size_t kRecordSize = 4 + 2 + 4 * 2 + 4 + 8 + 8;
+static const size_t kFieldsPerRecord = 9;
+
+void GenerateRecords(std::vector<uint8_t>& buffer, size_t numRecords)
+{
+	buffer.resize(numRecords * kRecordSize);
+
+	uint32_t state = 0x12345678u;
+	for (size_t i = 0; i < buffer.size(); i++)
+	{
+		state = state * 1664525u + 1013904223u;
+		buffer[i] = static_cast<uint8_t>(state >> 24);
+	}
+}
+
+template<class TReader>
+bool DecodeRecords(TReader& reader, size_t numRecords, uint64_t& checksum)
+{
+	BenchRecord rec;
+	for (size_t i = 0; i < numRecords; i++)
+	{
+		if (!reader.ReadU32(rec.m_u32)
+			|| !reader.ReadU16(rec.m_u16)
+			|| !reader.ReadS16(rec.m_s16[0])
+			|| !reader.ReadS16(rec.m_s16[1])
+			|| !reader.ReadS16(rec.m_s16[2])
+			|| !reader.ReadS16(rec.m_s16[3])
+			|| !reader.ReadS32(rec.m_s32)
+			|| !reader.ReadU64(rec.m_u64)
+			|| !reader.ReadF64(rec.m_f64))
+			return false;
+
+		uint64_t f64Bits;
+		memcpy(&f64Bits, &rec.m_f64, 8);
+
+		checksum += rec.m_u32 + rec.m_u16 + static_cast<uint16_t>(rec.m_s16[0] ^ rec.m_s16[1] ^ rec.m_s16[2] ^ rec.m_s16[3]) + static_cast<uint32_t>(rec.m_s32) + rec.m_u64 + f64Bits;
+	}
+
+	return true;
+}
+
+struct RuntimeReaderFactory
+{
+	explicit RuntimeReaderFactory(bool byteSwap)
+		: m_byteSwap(byteSwap)
+	{
+	}
+
+	bool Decode(mtdisasm::IOStream& stream, size_t numRecords, uint64_t& checksum) const
+	{
+		mtdisasm::DataReader reader(stream, m_byteSwap);
+		return DecodeRecords(reader, numRecords, checksum);
+	}
+
+	bool m_byteSwap;
+};
+
+template<bool TByteSwap>
+struct FixedReaderFactory
+{
+	bool Decode(mtdisasm::IOStream& stream, size_t numRecords, uint64_t& checksum) const
+	{
+		mtdisasm::FixedByteOrderDataReader<TByteSwap> reader(stream);
+		return DecodeRecords(reader, numRecords, checksum);
+	}
+};
+
+template<class TFactory>
+void RunFieldDecodeBench(BenchReport& report, const char* name, const TFactory& factory, const std::vector<uint8_t>& buffer, int iterations)
+{
+	const size_t numRecords = buffer.size() / kRecordSize;
+	uint64_t checksum = 0;
+
+	double seconds = TimeIterations(iterations, [&]() -> bool
+	{
+		mtdisasm::MemIOStream stream(&buffer[0], buffer.size());
+		return factory.Decode(stream, numRecords, checksum);
+	});
+
+	if (seconds < 0.0)
+	{
+		report.Fail(name, "Decode failed");
+		return;
+	}
+
+	BenchResult result = { name, "fields", iterations, seconds, static_cast<double>(buffer.size()) * iterations, static_cast<double>(numRecords) * kFieldsPerRecord * iterations, checksum };
+	report.Add(result);
+}
+
+// Catalog
+
+void GenerateCatalog(FixtureWriter& w, uint16_t numStreams, uint16_t numSegments)
+{
+	static const char* const kStreamTypes[] = { "assetStream", "bootStream", "sceneStream" };
+
+	w.WriteU16(1);	// Windows
+	w.WriteU32(0xaa55a5a5);
+	w.WriteU32(0);
+	w.WriteU32(0x0e);
+	w.WriteU32(0x3ea);
+	w.WriteU16(0);
+	w.WriteU32(0x0100004b);
+	w.WriteU32(0x14);
+	w.WriteU16(0);
+	w.WriteU32(0x22);
+	w.WriteU32(0x3e8);
+	w.WriteU16(2);
+	w.WriteU32(0x0100004b);
+	w.WriteU32(numStreams * 34);
+	w.WriteU16(numStreams);
+	w.WriteU16(0);
+	w.WriteU16(1);
+	w.WriteU16(numSegments);
+
+	uint32_t pos = 0;
+	for (uint16_t i = 0; i < numStreams; i++)
+	{
+		char streamType[24];
+		memset(streamType, 0, sizeof(streamType));
+		strcpy(streamType, kStreamTypes[i % 3]);
+
+		const uint32_t size = 0x1000 + (i * 37) % 0x4000;
+
+		w.WriteBytes(streamType, 24);
+		w.WriteU16(static_cast<uint16_t>(1 + i % numSegments));
+		w.WriteU32(pos);
+		w.WriteU32(size);
+
+		pos += size;
+	}
+
+	w.WriteU32(1);
+	for (uint16_t i = 0; i < numSegments; i++)
+	{
+		std::string label = "Segment " + std::to_string(i + 1);
+		std::string path = "PROJ" + std::to_string(i + 1) + ".MPX";
+
+		w.WriteU32(i + 1);
+		w.WritePStr16(label.c_str());
+		w.WritePStr16(path.c_str());
+	}
+}
+
+void RunCatalogLoadBench(BenchReport& report, int iterations)
+{
+	const char* name = "Catalog::Load";
+	const uint16_t numStreams = 4000;
+	const uint16_t numSegments = 8;
+	const int loadsPerIteration = 16;
+
+	FixtureWriter w;
+	GenerateCatalog(w, numStreams, numSegments);
+	const std::vector<uint8_t>& buffer = w.GetBuffer();
+
+	uint64_t checksum = 0;
+	double seconds = TimeIterations(iterations, [&]() -> bool
+	{
+		for (int i = 0; i < loadsPerIteration; i++)
+		{
+			mtdisasm::MemIOStream stream(&buffer[0], buffer.size());
+			mtdisasm::DataReader reader(stream, false);
+
+			mtdisasm::Catalog catalog;
+			if (!catalog.Load(reader) || catalog.NumStreams() != numStreams)
+				return false;
+
+			checksum += catalog.GetStream(numStreams - 1).m_pos;
+		}
+		return true;
+	});
+
+	if (seconds < 0.0)
+	{
+		report.Fail(name, "Catalog failed to load");
+		return;
+	}
+
+	const double numLoads = static_cast<double>(loadsPerIteration) * iterations;
+	BenchResult result = { name, "streams", iterations, seconds, static_cast<double>(buffer.size()) * numLoads, static_cast<double>(numStreams) * numLoads, checksum };
+	report.Add(result);
+}
+
+// Object loading
+
+void WriteModifierHeader(FixtureWriter& w, uint32_t guid, const char* name)
+{
+	w.WriteU32(0);		// Flags
+	w.WriteU32(0);		// Size including tag, not checked
+	w.WriteU32(guid);
+	w.WriteZeros(6);
+	w.WriteU32(0);
+	w.WriteZeros(4);
+	w.WriteU16(static_cast<uint16_t>(strlen(name) + 1));
+	w.WriteName(name);
+}
+
+void WriteStreamHeader(FixtureWriter& w, uint32_t index)
+{
+	char name[16];
+	memset(name, 0, sizeof(name));
+	snprintf(name, sizeof(name), "Stream %u", index);
+
+	w.WriteObjectHeader(0x3e9, 0);
+	w.WriteU32(0x3e9);
+	w.WriteU32(38);
+	w.WriteBytes(name, 16);
+	w.WriteZeros(2 + 4);
+	w.WriteU16(0);
+}
+
+void WritePresentationSettings(FixtureWriter& w, uint32_t index)
+{
+	w.WriteObjectHeader(0x3ec, 2);
+	w.WriteU32(0x3ec);
+	w.WriteU32(24);
+	w.WriteZeros(2);
+	w.WriteS16(640);
+	w.WriteS16(480);
+	w.WriteU16(8);
+	w.WriteU16(0);
+}
+
+void WriteGlobalObjectInfo(FixtureWriter& w, uint32_t index)
+{
+	w.WriteObjectHeader(0x17, 0);
+	w.WriteU32(0x17);
+	w.WriteU32(0x14);
+	w.WriteU16(static_cast<uint16_t>(index));
+	w.WriteZeros(4);
+}
+
+void WriteUnknown19(FixtureWriter& w, uint32_t index)
+{
+	w.WriteObjectHeader(0x19, 0);
+	w.WriteU32(0x19);
+	w.WriteU32(0x10);
+	w.WriteZeros(2);
+}
+
+void WriteDebris(FixtureWriter& w, uint32_t index)
+{
+	w.WriteObjectHeader(0xfffffffe, 0);
+	w.WriteU32(0xfffffffe);
+	w.WriteU32(0xe);
+}
+
+void WriteColorTableAsset(FixtureWriter& w, uint32_t index)
+{
+	w.WriteObjectHeader(0x1e, 0);
+	w.WriteU32(0x1e);
+	w.WriteU32(0x428);
+	w.WriteZeros(4);
+	w.WriteU32(index + 1);
+	w.WriteU32(0);
+	w.WriteZeros(14);
+	for (uint32_t i = 0; i < 256; i++)
+		w.WriteU32(i * 0x010101u);
+}
+
+void WriteNotYetImplemented(FixtureWriter& w, uint32_t index)
+{
+	w.WriteObjectHeader(0x140, 0);
+	w.WriteU32(0);
+	w.WriteU32(14 + 2 + index % 32);
+	w.WriteZeros(2 + index % 32);
+}
+
+void WriteAssetDataSection(FixtureWriter& w, uint32_t index)
+{
+	w.WriteObjectHeader(0xffff, 0);
+	w.WriteU32(0);
+	w.WriteU32(14 + 64 + index % 256);
+	w.WriteZeros(64 + index % 256);
+}
+
+void WriteMessengerModifier(FixtureWriter& w, uint32_t index)
+{
+	static const char kWith[] = "incoming";
+
+	w.WriteObjectHeader(0x2da, 0x3ea);
+	WriteModifierHeader(w, 0x10000 + index, "Messenger");
+	w.WriteU32(0);				// Message flags
+	w.WriteU32(0x3ea);			// When event
+	w.WriteU32(0x3eb);			// Send event
+	w.WriteU32(index);
+	w.WriteU16(0);
+	w.WriteU32(0x5a);			// Destination
+	w.WriteZeros(10);
+	w.WriteU16(0);				// With
+	w.WriteZeros(44);
+	w.WriteU32(0);				// When event info
+	w.WriteU8(sizeof(kWith) - 1);
+	w.WriteU8(0);
+	w.WriteBytes(kWith, sizeof(kWith) - 1);
+}
+
+void WriteIntegerVariableModifier(FixtureWriter& w, uint32_t index)
+{
+	w.WriteObjectHeader(0x322, 0x3e8);
+	WriteModifierHeader(w, 0x20000 + index, "Counter");
+	w.WriteZeros(4);
+	w.WriteS32(static_cast<int32_t>(index));
+}
+
+void WriteBooleanVariableModifier(FixtureWriter& w, uint32_t index)
+{
+	w.WriteObjectHeader(0x321, 0x3e8);
+	WriteModifierHeader(w, 0x30000 + index, "Flag");
+	w.WriteU8(index & 1);
+	w.WriteU8(0);
+}
+
+void WriteGraphicStructuralDef(FixtureWriter& w, uint32_t index)
+{
+	static const char kName[] = "Graphic Element";
+
+	w.WriteObjectHeader(0x8, 1);
+	w.WriteU32(0);
+	w.WriteU32(0);
+	w.WriteU32(0x40000 + index);
+	w.WriteU16(sizeof(kName));
+	w.WriteU32(0);
+	w.WriteU16(static_cast<uint16_t>(index % 100));
+	w.WriteU16(1);
+	w.WriteRect(0, 0, 640, 480);
+	w.WriteRect(16, 16, 32, 32);
+	w.WriteU32(0);
+	w.WriteZeros(4);
+	w.WriteBytes(kName, sizeof(kName));
+}
+
+void WriteImageAsset(FixtureWriter& w, uint32_t index)
+{
+	w.WriteObjectHeader(0xe, 1);
+	w.WriteU32(0);
+	w.WriteU32(0);
+	w.WriteZeros(4);
+	w.WriteU32(index + 1);		// Asset ID
+	w.WriteU32(0);
+	w.WriteZeros(10);
+	w.WriteRect(0, 0, 64, 64);
+	w.WriteU32(72 << 16);
+	w.WriteU32(72 << 16);
+	w.WriteU16(8);
+	w.WriteZeros(2 + 4 + 8);
+	w.WriteRect(0, 0, 64, 64);
+	w.WriteU32(index * 4096);
+	w.WriteU32(4096);
+}
+
+void WriteMToonAsset(FixtureWriter& w, uint32_t index)
+{
+	static const char* const kRangeNames[] = { "Idle", "Walk" };
+	const uint16_t numFrames = 8;
+
+	w.WriteObjectHeader(0xf, 1);
+	w.WriteU32(0);
+	w.WriteZeros(8);
+	w.WriteU32(index + 1);		// Asset ID
+	w.WriteZeros(54);
+	w.WriteU32(index * 0x10000);
+	w.WriteU32(numFrames * 0x800);
+	w.WriteU32(0);
+	w.WriteU32(0x546f6f6e);
+	w.WriteU16(1);
+	w.WriteZeros(4);
+	w.WriteU32(mtdisasm::DOMToonAsset::kEncodingFlag_HasRanges | mtdisasm::DOMToonAsset::kEncodingFlag_TemporalCompression);
+	w.WriteRect(0, 0, 64, 64);
+	w.WriteU16(numFrames);
+	w.WriteZeros(14);
+	w.WriteU16(8);
+	w.WriteU32(0x2e524c45);		// .RLE
+	w.WriteZeros(8);
+	w.WriteU32(0);				// Codec data size
+	w.WriteZeros(4);
+
+	for (uint16_t i = 0; i < numFrames; i++)
+	{
+		w.WriteZeros(4);
+		w.WriteRect(0, 0, 64, 64);
+		w.WriteU32(i * 0x800);
+		w.WriteZeros(2);
+		w.WriteU32(0x800);
+		w.WriteU8(0);
+		w.WriteU8(i == 0 ? 1 : 0);
+		w.WriteU8(0);
+		w.WriteU8(0);
+		w.WriteRect(0, 0, 64, 64);
+		w.WriteU32(72 << 16);
+		w.WriteU32(72 << 16);
+		w.WriteU16(8);
+		w.WriteU32(0);
+		w.WriteU16(64);
+		w.WriteZeros(2);
+		w.WriteU32(64 * 64);
+	}
+
+	const uint32_t numRanges = sizeof(kRangeNames) / sizeof(kRangeNames[0]);
+	uint32_t rangesSize = 12;
+	for (uint32_t i = 0; i < numRanges; i++)
+		rangesSize += 10 + static_cast<uint32_t>(strlen(kRangeNames[i]) + 1);
+
+	w.WriteU32(1);
+	w.WriteU32(rangesSize);
+	w.WriteU32(numRanges);
+	for (uint32_t i = 0; i < numRanges; i++)
+	{
+		w.WriteU32(1 + i * numFrames / numRanges);
+		w.WriteU32((i + 1) * numFrames / numRanges);
+		w.WriteU8(static_cast<uint8_t>(strlen(kRangeNames[i]) + 1));
+		w.WriteU8(0);
+		w.WriteName(kRangeNames[i]);
+	}
+}
+
+// Bytecode of a Miniscript program.  Each instruction is an opcode, flags, and its size
+// including those, followed by its operands.
+class MiniscriptCodeWriter
+{
+public:
+	MiniscriptCodeWriter()
+		: m_numInstructions(0)
+	{
+	}
+
+	// The caller writes contentsSize bytes of operands after this
+	FixtureWriter& BeginInstruction(uint16_t opcode, uint16_t flags, size_t contentsSize)
+	{
+		m_code.WriteU16(opcode);
+		m_code.WriteU16(flags);
+		m_code.WriteU16(static_cast<uint16_t>(6 + contentsSize));
+		m_numInstructions++;
+		return m_code;
+	}
+
+	void PushLocal(uint32_t localIndex)
+	{
+		BeginInstruction(0x191, 0, 6);
+		m_code.WriteU16(0x1f9);
+		m_code.WriteU32(localIndex);
+	}
+
+	FixtureWriter& GetCode() { return m_code; }
+	uint32_t NumInstructions() const { return m_numInstructions; }
+
+private:
+	FixtureWriter m_code;
+	uint32_t m_numInstructions;
+};
+
+// Writes a Miniscript program that cycles through assignments with arithmetic, conditionals,
+// and sends, so that decompiling it resolves expressions and control flow.
+void WriteMiniscriptProgram(FixtureWriter& w, size_t numStatements)
+{
+	static const char* const kLocalNames[] = { "counter", "limit" };
+	const uint32_t numLocalRefs = sizeof(kLocalNames) / sizeof(kLocalNames[0]);
+
+	MiniscriptCodeWriter cw;
+	FixtureWriter* operands = nullptr;
+
+	for (size_t i = 0; i < numStatements; i++)
+	{
+		switch (i % 3)
+		{
+		case 0:
+			// set counter to limit + <n>
+			cw.PushLocal(0);
+			cw.PushLocal(1);
+			operands = &cw.BeginInstruction(0x191, 0, 10);
+			operands->WriteU16(0x15);
+			operands->WriteF64(static_cast<double>(i) + 0.5);
+			cw.BeginInstruction(0xc9, 0, 0);
+			cw.BeginInstruction(0x834, 0, 0);
+			break;
+		case 1:
+			// if counter = true then set limit to counter end if
+			cw.PushLocal(0);
+			operands = &cw.BeginInstruction(0x191, 0, 3);
+			operands->WriteU16(0x1a);
+			operands->WriteU8(1);
+			cw.BeginInstruction(0xd2, 0, 0);
+			operands = &cw.BeginInstruction(0x7d3, 0, 12);
+			operands->WriteU32(2);	// Conditional
+			operands->WriteU32(0);
+			operands->WriteU32(4);	// Skips the 3 instructions of the body
+			cw.PushLocal(1);
+			cw.PushLocal(0);
+			cw.BeginInstruction(0x834, 0, 0);
+			break;
+		case 2:
+			// send <event> to modifier with NULL
+			operands = &cw.BeginInstruction(0x191, 0, 2);
+			operands->WriteU16(0);
+			operands = &cw.BeginInstruction(0x192, 0, 4);
+			operands->WriteU32(2);
+			operands = &cw.BeginInstruction(0x898, 0, 8);
+			operands->WriteU32(0x3eb);
+			operands->WriteU32(static_cast<uint32_t>(i));
+			break;
+		}
+	}
+
+	FixtureWriter& code = cw.GetCode();
+
+	w.WriteU32(0);
+	w.WriteU32(static_cast<uint32_t>(code.Size()));
+	w.WriteU32(cw.NumInstructions());
+	w.WriteU32(numLocalRefs);
+	w.WriteU32(0);
+	w.WriteBytes(&code.GetBuffer()[0], code.Size());
+
+	for (uint32_t i = 0; i < numLocalRefs; i++)
+	{
+		w.WriteU32(0x50000 + i);
+		w.WriteU8(static_cast<uint8_t>(strlen(kLocalNames[i]) + 1));
+		w.WriteU8(0);
+		w.WriteName(kLocalNames[i]);
+	}
+}
+
+void WriteMiniscriptModifier(FixtureWriter& w, uint32_t index, size_t numStatements)
+{
+	w.WriteObjectHeader(0x3c0, 0x3eb);
+	WriteModifierHeader(w, 0x60000 + index, "Miniscript");
+	w.WriteU32(0x3ea);		// Enable when
+	w.WriteU32(0);
+	w.WriteZeros(11);
+	w.WriteU8(0);
+	WriteMiniscriptProgram(w, numStatements);
+}
+
+void WriteMiniscriptModifier(FixtureWriter& w, uint32_t index)
+{
+	WriteMiniscriptModifier(w, index, 6);
+}
+
+struct ObjectFixture
+{
+	const char* m_name;
+	void (*m_write)(FixtureWriter& w, uint32_t index);
+};
+
+static const uint32_t kObjectsPerFixture = 20000;
+
+void RunObjectLoadBench(BenchReport& report, const ObjectFixture& fixture, int iterations)
+{
+	const uint32_t numObjects = kObjectsPerFixture;
+
+	std::string name = std::string("DataObject::Load ") + fixture.m_name;
+
+	FixtureWriter w;
+	for (uint32_t i = 0; i < numObjects; i++)
+		fixture.m_write(w, i);
+
+	const std::vector<uint8_t>& buffer = w.GetBuffer();
+
+	uint64_t checksum = 0;
+	double seconds = TimeIterations(iterations, [&]() -> bool
+	{
+		mtdisasm::ObjectArena arena;
+		mtdisasm::ObjectArena::Scope arenaScope(arena);
+
+		mtdisasm::MemIOStream stream(&buffer[0], buffer.size());
+		mtdisasm::NativeOrderDataReader reader(stream);
+		mtdisasm::ObjectStreamCursor<mtdisasm::NativeOrderDataReader> cursor(reader, buffer.size(), g_fixtureSP);
+
+		uint32_t numLoaded = 0;
+		while (cursor.Next())
+		{
+			mtdisasm::DataObject* dataObject = cursor.Load();
+			if (!dataObject)
+				return false;
+
+			checksum += static_cast<uint64_t>(dataObject->GetType()) + reader.Tell();
+			dataObject->Delete();
+			numLoaded++;
+		}
+
+		return cursor.GetStatus() == mtdisasm::ObjectStreamStatus::kEndOfStream && numLoaded == numObjects;
+	});
+
+	if (seconds < 0.0)
+	{
+		report.Fail(name.c_str(), "Objects failed to load");
+		return;
+	}
+
+	BenchResult result = { name, "objects", iterations, seconds, static_cast<double>(buffer.size()) * iterations, static_cast<double>(numObjects) * iterations, checksum };
+	report.Add(result);
+}
+
+// Size tag skipping
+
+// Checks that skipping each object by its size tag ends where loading it does, then times
+// walking the stream without loading anything
+void RunSizeTagSkipBench(BenchReport& report, const ObjectFixture& fixture, int iterations)
+{
+	const uint32_t numObjects = kObjectsPerFixture;
+
+	std::string name = std::string("ObjectStreamCursor::Skip ") + fixture.m_name;
+
+	FixtureWriter w;
+	for (uint32_t i = 0; i < numObjects; i++)
+		fixture.m_write(w, i);
+
+	const std::vector<uint8_t>& buffer = w.GetBuffer();
+
+	std::vector<uint32_t> loadedEnds;
+	{
+		mtdisasm::ObjectArena arena;
+		mtdisasm::ObjectArena::Scope arenaScope(arena);
+
+		mtdisasm::MemIOStream stream(&buffer[0], buffer.size());
+		mtdisasm::NativeOrderDataReader reader(stream);
+		mtdisasm::ObjectStreamCursor<mtdisasm::NativeOrderDataReader> cursor(reader, buffer.size(), g_fixtureSP);
+
+		while (cursor.Next())
+		{
+			if (!cursor.GetTypeInfo().m_hasSizeTag)
+			{
+				report.Fail(name.c_str(), "Type isn't skipped by its size tag");
+				return;
+			}
+
+			mtdisasm::DataObject* dataObject = cursor.Load();
+			if (!dataObject)
+			{
+				report.Fail(name.c_str(), "Objects failed to load");
+				return;
+			}
+
+			dataObject->Delete();
+			loadedEnds.push_back(static_cast<uint32_t>(reader.Tell()));
+		}
+	}
+
+	if (loadedEnds.size() != numObjects)
+	{
+		report.Fail(name.c_str(), "Objects failed to load");
+		return;
+	}
+
+	bool isMismatched = false;
+	uint64_t checksum = 0;
+	double seconds = TimeIterations(iterations, [&]() -> bool
+	{
+		mtdisasm::MemIOStream stream(&buffer[0], buffer.size());
+		mtdisasm::NativeOrderDataReader reader(stream);
+		mtdisasm::ObjectStreamCursor<mtdisasm::NativeOrderDataReader> cursor(reader, buffer.size(), g_fixtureSP);
+
+		uint32_t numSkipped = 0;
+		while (cursor.Next())
+		{
+			if (numSkipped > 0 && cursor.GetPosition() != loadedEnds[numSkipped - 1])
+			{
+				isMismatched = true;
+				return false;
+			}
+
+			checksum += cursor.GetPosition();
+			numSkipped++;
+		}
+
+		return cursor.GetStatus() == mtdisasm::ObjectStreamStatus::kEndOfStream && numSkipped == numObjects;
+	});
+
+	if (seconds < 0.0)
+	{
+		report.Fail(name.c_str(), isMismatched ? "Skipping and loading ended in different places" : "Objects failed to skip");
+		return;
+	}
+
+	BenchResult result = { name, "objects", iterations, seconds, static_cast<double>(buffer.size()) * iterations, static_cast<double>(numObjects) * iterations, checksum };
+	report.Add(result);
+}
+
+// Miniscript decompiling
+
+void RunDecompileMiniscriptBench(BenchReport& report, int iterations)
+{
+	const char* name = "DecompileMiniscript";
+	const int decompilesPerIteration = 16;
+
+	// Sized like a long script from a real title.  Control flow resolution grows faster
+	// than linearly with the number of branches, so much larger programs measure only that.
+	FixtureWriter w;
+	WriteMiniscriptModifier(w, 0, 60);
+	const std::vector<uint8_t>& buffer = w.GetBuffer();
+
+	mtdisasm::MemIOStream stream(&buffer[0], buffer.size());
+	mtdisasm::NativeOrderDataReader reader(stream);
+	mtdisasm::ObjectStreamCursor<mtdisasm::NativeOrderDataReader> cursor(reader, buffer.size(), g_fixtureSP);
+
+	mtdisasm::DataObject* dataObject = nullptr;
+	if (cursor.Next())
+		dataObject = cursor.Load();
+
+	if (!dataObject)
+	{
+		report.Fail(name, "Program failed to load");
+		return;
+	}
+
+	const mtdisasm::DOMiniscriptProgram& program = static_cast<const mtdisasm::DOMiniscriptModifier*>(dataObject)->m_program;
+
+	uint64_t checksum = 0;
+	double seconds = TimeIterations(iterations, [&]() -> bool
+	{
+		for (int i = 0; i < decompilesPerIteration; i++)
+		{
+			std::string text;
+			mtdisasm::TextWriter f(text);
+			if (!DecompileMiniscript(program, g_fixtureSP, false, f) || !f.Flush())
+				return false;
+
+			checksum += text.size();
+		}
+		return true;
+	});
+
+	const double numDecompiles = static_cast<double>(decompilesPerIteration) * iterations;
+	BenchResult result = { name, "instructions", iterations, seconds, static_cast<double>(program.m_sizeOfInstructions) * numDecompiles, static_cast<double>(program.m_numOfInstructions) * numDecompiles, checksum };
+
+	dataObject->Delete();
+
+	if (seconds < 0.0)
+	{
+		report.Fail(name, "Program failed to decompile");
+		return;
+	}
+
+	report.Add(result);
+}
+
+// mToon RLE decoding
+
+// Fills every row exactly with a mix of runs, literals, and, in delta frames, transparent
+// runs, in the proportions of typical sprite animation.
+void GenerateMToonRLE8Frame(std::vector<uint8_t>& compressedData, size_t cols, size_t rows, bool isKeyframe, uint32_t seed)
+{
+	uint32_t state = seed;
+
+	compressedData.clear();
+	for (size_t row = 0; row < rows; row++)
+	{
+		for (size_t col = 0; col < cols; )
+		{
+			const size_t remaining = cols - col;
+			const uint32_t kind = NextRandom(state) % 8;
+
+			if (!isKeyframe && kind < 3)
+			{
+				size_t numTransparent = 1 + NextRandom(state) % std::min<size_t>(remaining, 127);
+				compressedData.push_back(0);
+				compressedData.push_back(static_cast<uint8_t>(numTransparent));
+				col += numTransparent;
+			}
+			else if (kind < 5)
+			{
+				size_t numLiterals = 1 + NextRandom(state) % std::min<size_t>(remaining, 16);
+				compressedData.push_back(static_cast<uint8_t>(0x80 | numLiterals));
+				for (size_t i = 0; i < numLiterals; i++)
+					compressedData.push_back(static_cast<uint8_t>(NextRandom(state)));
+				col += numLiterals;
+			}
+			else
+			{
+				size_t numRepeats = 1 + NextRandom(state) % std::min<size_t>(remaining, 64);
+				compressedData.push_back(static_cast<uint8_t>(numRepeats));
+				compressedData.push_back(static_cast<uint8_t>(NextRandom(state)));
+				col += numRepeats;
+			}
+		}
+	}
+}
+
+void GenerateMToonRLE16Frame(std::vector<uint16_t>& compressedData, size_t cols, size_t rows, uint32_t seed)
+{
+	uint32_t state = seed;
+
+	compressedData.clear();
+	for (size_t row = 0; row < rows; row++)
+	{
+		for (size_t col = 0; col < cols; )
+		{
+			const size_t remaining = cols - col;
+			const uint32_t kind = NextRandom(state) % 8;
+
+			if (kind < 2)
+			{
+				size_t numTransparent = 1 + NextRandom(state) % std::min<size_t>(remaining, 127);
+				compressedData.push_back(0);
+				compressedData.push_back(static_cast<uint16_t>(numTransparent));
+				col += numTransparent;
+			}
+			else if (kind < 5)
+			{
+				size_t numLiterals = 1 + NextRandom(state) % std::min<size_t>(remaining, 16);
+				compressedData.push_back(static_cast<uint16_t>(0x8000 | numLiterals));
+				for (size_t i = 0; i < numLiterals; i++)
+					compressedData.push_back(static_cast<uint16_t>(NextRandom(state) & 0x7fff));
+				col += numLiterals;
+			}
+			else
+			{
+				size_t numRepeats = 1 + NextRandom(state) % std::min<size_t>(remaining, 64);
+				compressedData.push_back(static_cast<uint16_t>(numRepeats));
+				compressedData.push_back(static_cast<uint16_t>(NextRandom(state) & 0x7fff));
+				col += numRepeats;
+			}
+		}
+	}
+}
+
+uint64_t ChecksumImage(const std::vector<uint8_t>& imageData)
+{
+	uint64_t checksum = 0;
+	for (size_t i = 0; i < imageData.size(); i += 61)
+		checksum = checksum * 31 + imageData[i];
+	return checksum;
+}
+
+static const size_t kRLEFrameCols = 640;
+static const size_t kRLEFrameRows = 480;
+static const int kRLEFramesPerIteration = 16;
+
+mtdisasm::MToonRLESurface MakeRLESurface(std::vector<uint8_t>& imageData, mtdisasm::MToonRLEPixelFormat format)
+{
+	const size_t bytesPerPixel = (format == mtdisasm::MToonRLEPixelFormat::kRGBA32) ? 4 : 1;
+	imageData.resize(kRLEFrameCols * kRLEFrameRows * bytesPerPixel);
+
+	// Bottom-up, as on Windows
+	return mtdisasm::MakeMToonRLESurface(imageData.data(), kRLEFrameCols, kRLEFrameRows, kRLEFrameCols * bytesPerPixel, format, true);
+}
+
+void RunMToonRLE8Bench(BenchReport& report, const char* name, bool isKeyframe, mtdisasm::MToonRLEPixelFormat format, int iterations)
+{
+	std::vector<uint8_t> compressedData;
+	GenerateMToonRLE8Frame(compressedData, kRLEFrameCols, kRLEFrameRows, isKeyframe, 0x2468ace0u);
+
+	std::vector<uint8_t> imageData;
+	const mtdisasm::MToonRLESurface surface = MakeRLESurface(imageData, format);
+
+	mtdisasm::MToonRLEDecoder decoder;
+	decoder.SetPalette(g_macStandardPaletteRGBA);
+
+	uint64_t checksum = 0;
+	double seconds = TimeIterations(iterations, [&]() -> bool
+	{
+		for (int i = 0; i < kRLEFramesPerIteration; i++)
+		{
+			if (!decoder.DecodeFrame8(compressedData.data(), compressedData.size(), isKeyframe, surface))
+				return false;
+		}
+
+		checksum += ChecksumImage(imageData);
+		return true;
+	});
+
+	if (seconds < 0.0)
+	{
+		report.Fail(name, "Failed to decode frame");
+		return;
+	}
+
+	const double numFrames = static_cast<double>(kRLEFramesPerIteration) * iterations;
+	BenchResult result = { name, "pixels", iterations, seconds, static_cast<double>(compressedData.size()) * numFrames, static_cast<double>(kRLEFrameCols * kRLEFrameRows) * numFrames, checksum };
+	report.Add(result);
+}
+
+void RunMToonRLE16Bench(BenchReport& report, const char* name, bool isBigEndian, int iterations)
+{
+	std::vector<uint16_t> compressedWords;
+	GenerateMToonRLE16Frame(compressedWords, kRLEFrameCols, kRLEFrameRows, 0x13579bdfu);
+
+	std::vector<uint8_t> compressedData;
+	compressedData.resize(compressedWords.size() * 2);
+	for (size_t i = 0; i < compressedWords.size(); i++)
+	{
+		const uint16_t word = compressedWords[i];
+		compressedData[i * 2 + 0] = static_cast<uint8_t>(isBigEndian ? (word >> 8) : (word & 0xff));
+		compressedData[i * 2 + 1] = static_cast<uint8_t>(isBigEndian ? (word & 0xff) : (word >> 8));
+	}
+
+	std::vector<uint8_t> imageData;
+	const mtdisasm::MToonRLESurface surface = MakeRLESurface(imageData, mtdisasm::MToonRLEPixelFormat::kRGBA32);
+
+	mtdisasm::MToonRLEDecoder decoder;
+
+	uint64_t checksum = 0;
+	double seconds = TimeIterations(iterations, [&]() -> bool
+	{
+		for (int i = 0; i < kRLEFramesPerIteration; i++)
+		{
+			if (!decoder.DecodeFrame16(compressedData.data(), compressedData.size(), isBigEndian, surface))
+				return false;
+		}
+
+		checksum += ChecksumImage(imageData);
+		return true;
+	});
+
+	if (seconds < 0.0)
+	{
+		report.Fail(name, "Failed to decode frame");
+		return;
+	}
+
+	const double numFrames = static_cast<double>(kRLEFramesPerIteration) * iterations;
+	BenchResult result = { name, "pixels", iterations, seconds, static_cast<double>(compressedData.size()) * numFrames, static_cast<double>(kRLEFrameCols * kRLEFrameRows) * numFrames, checksum };
+	report.Add(result);
+}
+
+// Draws delta frames over a canvas with the frames offset from its corner, as temporally
+// compressed mToons are composited
+void RunMToonCompositeBench(BenchReport& report, const char* name, int iterations)
+{
+	std::vector<uint8_t> compressedData;
+	GenerateMToonRLE8Frame(compressedData, kRLEFrameCols, kRLEFrameRows, false, 0x2468ace0u);
+
+	mtdisasm::MToonRLEDecoder decoder;
+	decoder.SetPalette(g_macStandardPaletteRGBA);
+
+	mtdisasm::MToonCompositor compositor;
+	compositor.Reset(kRLEFrameCols + 16, kRLEFrameRows + 16);
+
+	uint64_t checksum = 0;
+	double seconds = TimeIterations(iterations, [&]() -> bool
+	{
+		for (int i = 0; i < kRLEFramesPerIteration; i++)
+		{
+			const mtdisasm::MToonRLESurface surface = compositor.BeginFrame(kRLEFrameCols, kRLEFrameRows, true);
+			if (!decoder.DecodeFrame8(compressedData.data(), compressedData.size(), false, surface))
+				return false;
+
+			const mtdisasm::MToonCanvasRect dirtyRect = compositor.EndFrame(i % 16, i % 16, false);
+			checksum += dirtyRect.m_right - dirtyRect.m_left;
+		}
+
+		checksum += compositor.GetPixels()[(kRLEFrameCols + 16) * 4 * 100 + 400];
+		return true;
+	});
+
+	if (seconds < 0.0)
+	{
+		report.Fail(name, "Failed to decode frame");
+		return;
+	}
+
+	const double numFrames = static_cast<double>(kRLEFramesPerIteration) * iterations;
+	BenchResult result = { name, "pixels", iterations, seconds, static_cast<double>(compressedData.size()) * numFrames, static_cast<double>(kRLEFrameCols * kRLEFrameRows) * numFrames, checksum };
+	report.Add(result);
+}
+
+// Odd so that every kernel runs its scalar tail
+static const size_t kPixelConvertCols = 1021;
+static const size_t kPixelConvertRows = 768;
+
+struct PixelConvertKernel
+{
+	const char* m_name;
+	size_t m_srcBitsPerPixel;
+	size_t m_destBytesPerPixel;
+	void (*m_convertRow)(const mtdisasm::PixelRowConverters& converters, const uint8_t* src, uint8_t* dest, size_t width);
+};
+
+static const PixelConvertKernel kPixelConvertKernels[] =
+{
+	{ "Win32 to RGB24", 32, 3, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertWin32ToRGB24(src, dest, width); } },
+	{ "Mac32 to RGB24", 32, 3, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertMac32ToRGB24(src, dest, width); } },
+	{ "RGB555LE to RGB24", 16, 3, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertRGB555LEToRGB24(src, dest, width); } },
+	{ "RGB555BE to RGB24", 16, 3, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertRGB555BEToRGB24(src, dest, width); } },
+	{ "Gray8 to RGB24", 8, 3, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertGray8ToRGB24(src, dest, width); } },
+	{ "Gray4 to RGB24", 4, 3, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertGray4ToRGB24(src, dest, width); } },
+	{ "Gray2 to RGB24", 2, 3, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertGray2ToRGB24(src, dest, width); } },
+	{ "Gray1 to RGB24", 1, 3, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertGray1ToRGB24(src, dest, width); } },
+	{ "Indexed8 to RGBA32", 8, 4, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertIndexed8ToRGBA32(src, dest, width, g_macStandardPaletteRGBA); } },
+	{ "RGB555LE to RGBA32", 16, 4, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertRGB555LEToRGBA32(src, dest, width); } },
+	{ "RGB555BE to RGBA32", 16, 4, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertRGB555BEToRGBA32(src, dest, width); } },
+	{ "RGBX32 to RGBA32", 32, 4, [](const mtdisasm::PixelRowConverters& c, const uint8_t* src, uint8_t* dest, size_t width) { c.m_convertRGBX32ToRGBA32(src, dest, width); } },
+};
+
+void ConvertPixelImage(const PixelConvertKernel& kernel, const mtdisasm::PixelRowConverters& converters, const std::vector<uint8_t>& srcImage, std::vector<uint8_t>& destImage)
+{
+	const size_t srcBytesPerRow = (kPixelConvertCols * kernel.m_srcBitsPerPixel + 7) / 8;
+	const size_t destBytesPerRow = kPixelConvertCols * kernel.m_destBytesPerPixel;
+
+	for (size_t row = 0; row < kPixelConvertRows; row++)
+		kernel.m_convertRow(converters, &srcImage[row * srcBytesPerRow], &destImage[row * destBytesPerRow], kPixelConvertCols);
+}
+
+// Times one kernel on one instruction set and fails if its output differs from the scalar converters
+void RunPixelConvertBench(BenchReport& report, const PixelConvertKernel& kernel, mtdisasm::PixelConvertISA isa, int iterations)
+{
+	const mtdisasm::PixelRowConverters* converters = mtdisasm::GetPixelRowConverters(isa);
+	const mtdisasm::PixelRowConverters* scalarConverters = mtdisasm::GetPixelRowConverters(mtdisasm::PixelConvertISA::kScalar);
+
+	std::string name = std::string(kernel.m_name) + " " + converters->m_name;
+
+	const size_t srcBytesPerRow = (kPixelConvertCols * kernel.m_srcBitsPerPixel + 7) / 8;
+
+	std::vector<uint8_t> srcImage;
+	srcImage.resize(srcBytesPerRow * kPixelConvertRows);
+
+	uint32_t randomState = 0x0badf00du;
+	for (uint8_t& b : srcImage)
+		b = static_cast<uint8_t>(NextRandom(randomState));
+
+	std::vector<uint8_t> expectedImage;
+	expectedImage.resize(kPixelConvertCols * kPixelConvertRows * kernel.m_destBytesPerPixel);
+	ConvertPixelImage(kernel, *scalarConverters, srcImage, expectedImage);
+
+	std::vector<uint8_t> destImage;
+	destImage.resize(expectedImage.size());
+	ConvertPixelImage(kernel, *converters, srcImage, destImage);
+
+	if (destImage != expectedImage)
+	{
+		report.Fail(name.c_str(), "Output differs from the scalar converter");
+		return;
+	}
+
+	uint64_t checksum = 0;
+	double seconds = TimeIterations(iterations, [&]() -> bool
+	{
+		ConvertPixelImage(kernel, *converters, srcImage, destImage);
+		checksum += ChecksumImage(destImage);
+		return true;
+	});
+
+	BenchResult result = { name, "pixels", iterations, seconds, static_cast<double>(srcImage.size()) * iterations, static_cast<double>(kPixelConvertCols * kPixelConvertRows) * iterations, checksum };
+	report.Add(result);
+}
+
+// Image encoding
+
+// Large enough that the png encoder splits it into chunks for its threads
+static const size_t kImageEncodeCols = 1280;
+static const size_t kImageEncodeRows = 960;
+
+struct ImageEncoderBench
+{
+	const char* m_name;
+	mtdisasm::ImageEncoderOptions m_options;
+};
+
+static const ImageEncoderBench kImageEncoderBenches[] =
+{
+	{ "stb PNG", { mtdisasm::ImageEncoderBackend::kSTBPNG, 0, 1, nullptr } },
+	{ "PNG level 0", { mtdisasm::ImageEncoderBackend::kPNG, 0, 1, nullptr } },
+	{ "PNG level 1", { mtdisasm::ImageEncoderBackend::kPNG, 1, 1, nullptr } },
+	{ "PNG level 2", { mtdisasm::ImageEncoderBackend::kPNG, 2, 1, nullptr } },
+	{ "PNG level 3", { mtdisasm::ImageEncoderBackend::kPNG, 3, 1, nullptr } },
+	{ "PNG level 1, 4 threads", { mtdisasm::ImageEncoderBackend::kPNG, 1, 4, nullptr } },
+	{ "PNG level 3, 4 threads", { mtdisasm::ImageEncoderBackend::kPNG, 3, 4, nullptr } },
+	{ "PAM", { mtdisasm::ImageEncoderBackend::kPNM, 0, 1, nullptr } },
+	{ "QOI", { mtdisasm::ImageEncoderBackend::kQOI, 0, 1, nullptr } },
+};
+
+// Tiles decoded RLE keyframes, which have the flat areas and noise of typical frames
+void GenerateImageEncodeImage(std::vector<uint8_t>& imageData)
+{
+	imageData.resize(kImageEncodeCols * kImageEncodeRows * 4);
+
+	mtdisasm::MToonRLEDecoder decoder;
+	decoder.SetPalette(g_macStandardPaletteRGBA);
+
+	const size_t bytesPerRow = kImageEncodeCols * 4;
+	std::vector<uint8_t> compressedData;
+	for (size_t tileRow = 0; tileRow < kImageEncodeRows / kRLEFrameRows; tileRow++)
+	{
+		for (size_t tileCol = 0; tileCol < kImageEncodeCols / kRLEFrameCols; tileCol++)
+		{
+			GenerateMToonRLE8Frame(compressedData, kRLEFrameCols, kRLEFrameRows, true, static_cast<uint32_t>(0x1234567u + tileRow * 2 + tileCol));
+
+			uint8_t* tilePixels = imageData.data() + tileRow * kRLEFrameRows * bytesPerRow + tileCol * kRLEFrameCols * 4;
+			const mtdisasm::MToonRLESurface surface = mtdisasm::MakeMToonRLESurface(tilePixels, kRLEFrameCols, kRLEFrameRows, bytesPerRow, mtdisasm::MToonRLEPixelFormat::kRGBA32, false);
+			decoder.DecodeFrame8(compressedData.data(), compressedData.size(), true, surface);
+		}
+	}
+}
+
+void RunImageEncodeBench(BenchReport& report, const ImageEncoderBench& bench, const std::vector<uint8_t>& imageData, int iterations)
+{
+	std::vector<uint8_t> encoded;
+	if (!mtdisasm::EncodeImage(bench.m_options, imageData.data(), kImageEncodeCols, kImageEncodeRows, 4, kImageEncodeCols * 4, encoded))
+	{
+		report.Fail(bench.m_name, "Failed to encode image");
+		return;
+	}
+
+	// The size is part of the name since it matters as much as the speed
+	char name[128];
+	snprintf(name, sizeof(name), "%s (%.1f%% size)", bench.m_name, 100.0 * static_cast<double>(encoded.size()) / static_cast<double>(imageData.size()));
+
+	uint64_t checksum = 0;
+	double seconds = TimeIterations(iterations, [&]() -> bool
+	{
+		if (!mtdisasm::EncodeImage(bench.m_options, imageData.data(), kImageEncodeCols, kImageEncodeRows, 4, kImageEncodeCols * 4, encoded))
+			return false;
+
+		checksum += encoded.size();
+		return true;
+	});
+
+	if (seconds < 0.0)
+	{
+		report.Fail(name, "Failed to encode image");
+		return;
+	}
+
+	BenchResult result = { name, "pixels", iterations, seconds, static_cast<double>(imageData.size()) * iterations, static_cast<double>(kImageEncodeCols * kImageEncodeRows) * iterations, checksum };
+	report.Add(result);
+}
+
+void PrintBenchUsage()
+{
+	fprintf(stderr, "Usage: unbundle_bench [-json] [iterations]\n");
+	fprintf(stderr, "    -json: Writes one JSON object per benchmark instead of a table\n");
+}
+
+int main(int argc, const char** argv)
+{
+	size_t numRecords = 1 << 20;
+	int iterations = 20;
+	bool isJSON = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-json"))
+			isJSON = true;
+		else
+		{
+			iterations = atoi(argv[i]);
+			if (iterations <= 0)
+			{
+				PrintBenchUsage();
+				return -1;
+			}
+		}
+	}
+
+	GenerateMacStandardPalette();
+
+	BenchReport report(isJSON);
+
+	std::vector<uint8_t> buffer;
+	GenerateRecords(buffer, numRecords);
+
+	char heading[128];
+	snprintf(heading, sizeof(heading), "Field decode, %u records of %u bytes, %i iterations", static_cast<unsigned int>(numRecords), static_cast<unsigned int>(kRecordSize), iterations);
+	report.PrintHeading(heading);
+
+	RunFieldDecodeBench(report, "DataReader native", RuntimeReaderFactory(false), buffer, iterations);
+	RunFieldDecodeBench(report, "DataReader swapped", RuntimeReaderFactory(true), buffer, iterations);
+	RunFieldDecodeBench(report, "NativeOrderDataReader", FixedReaderFactory<false>(), buffer, iterations);
+	RunFieldDecodeBench(report, "SwappedOrderDataReader", FixedReaderFactory<true>(), buffer, iterations);
+
+	report.PrintHeading("Catalog");
+	RunCatalogLoadBench(report, iterations);
+
+	static const ObjectFixture kObjectFixtures[] =
+	{
+		{ "StreamHeader", WriteStreamHeader },
+		{ "MessengerModifier", WriteMessengerModifier },
+		{ "IntegerVariableModifier", WriteIntegerVariableModifier },
+		{ "BooleanVariableModifier", WriteBooleanVariableModifier },
+		{ "GraphicStructuralDef", WriteGraphicStructuralDef },
+		{ "ImageAsset", WriteImageAsset },
+		{ "MToonAsset", WriteMToonAsset },
+		{ "MiniscriptModifier", WriteMiniscriptModifier },
+	};
+
+	snprintf(heading, sizeof(heading), "Object loading, %u objects per type", static_cast<unsigned int>(kObjectsPerFixture));
+	report.PrintHeading(heading);
+	for (const ObjectFixture& fixture : kObjectFixtures)
+		RunObjectLoadBench(report, fixture, iterations);
+
+	// Every type that's skipped by its size tag should be here
+	static const ObjectFixture kSizeTagFixtures[] =
+	{
+		{ "StreamHeader", WriteStreamHeader },
+		{ "PresentationSettings", WritePresentationSettings },
+		{ "GlobalObjectInfo", WriteGlobalObjectInfo },
+		{ "Unknown19", WriteUnknown19 },
+		{ "Debris", WriteDebris },
+		{ "ColorTable", WriteColorTableAsset },
+		{ "NotYetImplemented", WriteNotYetImplemented },
+		{ "AssetDataSection", WriteAssetDataSection },
+	};
+
+	snprintf(heading, sizeof(heading), "Size tag skipping, %u objects per type", static_cast<unsigned int>(kObjectsPerFixture));
+	report.PrintHeading(heading);
+	for (const ObjectFixture& fixture : kSizeTagFixtures)
+		RunSizeTagSkipBench(report, fixture, iterations);
+
+	report.PrintHeading("Miniscript");
+	RunDecompileMiniscriptBench(report, iterations);
+
+	report.PrintHeading("mToon RLE, 640x480 frames");
+	RunMToonRLE8Bench(report, "mToon RLE 8-bit keyframe", true, mtdisasm::MToonRLEPixelFormat::kRGBA32, iterations);
+	RunMToonRLE8Bench(report, "mToon RLE 8-bit delta", false, mtdisasm::MToonRLEPixelFormat::kRGBA32, iterations);
+	RunMToonRLE8Bench(report, "mToon RLE 8-bit keyframe to indices", true, mtdisasm::MToonRLEPixelFormat::kIndexed8, iterations);
+	RunMToonRLE8Bench(report, "mToon RLE 8-bit delta to indices", false, mtdisasm::MToonRLEPixelFormat::kIndexed8, iterations);
+	RunMToonRLE16Bench(report, "mToon RLE 16-bit little endian", false, iterations);
+	RunMToonRLE16Bench(report, "mToon RLE 16-bit big endian", true, iterations);
+	RunMToonCompositeBench(report, "mToon RLE 8-bit delta composited", iterations);
+
+	snprintf(heading, sizeof(heading), "Pixel conversion, %ux%u images", static_cast<unsigned int>(kPixelConvertCols), static_cast<unsigned int>(kPixelConvertRows));
+	report.PrintHeading(heading);
+
+	static const mtdisasm::PixelConvertISA kPixelConvertISAs[] =
+	{
+		mtdisasm::PixelConvertISA::kScalar,
+		mtdisasm::PixelConvertISA::kSSE2,
+		mtdisasm::PixelConvertISA::kAVX2,
+	};
+
+	for (const PixelConvertKernel& kernel : kPixelConvertKernels)
+	{
+		for (mtdisasm::PixelConvertISA isa : kPixelConvertISAs)
+		{
+			if (mtdisasm::IsPixelConvertISASupported(isa))
+				RunPixelConvertBench(report, kernel, isa, iterations);
+		}
+	}
+
+	snprintf(heading, sizeof(heading), "Image encoding, %ux%u RGBA", static_cast<unsigned int>(kImageEncodeCols), static_cast<unsigned int>(kImageEncodeRows));
+	report.PrintHeading(heading);
+
+	std::vector<uint8_t> encodeImage;
+	GenerateImageEncodeImage(encodeImage);
+
+	// Encoding is much slower per iteration than the other benchmarks
+	const int encodeIterations = std::max(1, iterations / 4);
+	for (const ImageEncoderBench& bench : kImageEncoderBenches)
+		RunImageEncodeBench(report, bench, encodeImage, encodeIterations);
+
+	return report.Succeeded() ? 0 : -1;
+}
@@ -1,5 +1,10 @@
 #include "CFileIOStream.h"
 
+#ifndef _WIN32
+#include <errno.h>
+#include <unistd.h>
+#endif
+
 namespace mtdisasm
 {
 	CFileIOStream::CFileIOStream(FILE* f)
@@ -17,6 +22,51 @@ namespace mtdisasm
 		return fwrite(src, 1, sz, m_f);
 	}
 
+#ifdef _WIN32
+	size_t CFileIOStream::ReadAtPartial(uint32_t pos, void* dest, size_t sz) const
+	{
+		// No positional read that leaves the CRT's view of the file intact, so seek and
+		// restore while holding the FILE's lock.
+		_lock_file(m_f);
+
+		size_t amountRead = 0;
+		long prevPos = ftell(m_f);
+		if (prevPos >= 0 && fseek(m_f, static_cast<long>(pos), SEEK_SET) == 0)
+		{
+			amountRead = fread(dest, 1, sz, m_f);
+			fseek(m_f, prevPos, SEEK_SET);
+		}
+
+		_unlock_file(m_f);
+
+		return amountRead;
+	}
+#else
+	size_t CFileIOStream::ReadAtPartial(uint32_t pos, void* dest, size_t sz) const
+	{
+		int fd = fileno(m_f);
+
+		size_t amountRead = 0;
+		while (amountRead < sz)
+		{
+			ssize_t result = pread(fd, static_cast<char*>(dest) + amountRead, sz - amountRead, static_cast<off_t>(pos) + static_cast<off_t>(amountRead));
+			if (result < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				break;
+			}
+
+			if (result == 0)
+				break;
+
+			amountRead += static_cast<size_t>(result);
+		}
+
+		return amountRead;
+	}
+#endif
+
 	bool CFileIOStream::SeekSet(int32_t pos)
 	{
 		return fseek(m_f, pos, SEEK_SET) == 0;
@@ -41,5 +91,14 @@ namespace mtdisasm
 	{
 		return this->Tell();
 	}
-}
 
+	bool CFileIOStream::GetFileDescriptor(int& outFD) const
+	{
+#ifdef _WIN32
+		return false;
+#else
+		outFD = fileno(m_f);
+		return outFD >= 0;
+#endif
+	}
+}
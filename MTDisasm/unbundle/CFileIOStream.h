@@ -13,6 +13,7 @@ namespace mtdisasm
 
 		size_t ReadPartial(void* dest, size_t sz) override;
 		size_t WritePartial(const void* src, size_t sz) override;
+		size_t ReadAtPartial(uint32_t pos, void* dest, size_t sz) const override;
 
 		bool SeekSet(int32_t pos) override;
 		bool SeekCur(int32_t pos) override;
@@ -21,6 +22,8 @@ namespace mtdisasm
 		uint32_t Tell() const override;
 		uint32_t TellGlobal() const override;
 
+		bool GetFileDescriptor(int& outFD) const override;
+
 	private:
 		FILE* m_f;
 	};
@@ -3,7 +3,8 @@
 
 namespace mtdisasm
 {
-	bool DORect::Load(DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool DORect::Load(TReader& reader, const SerializationProperties& sp)
 	{
 		if (sp.m_systemType == SystemType::kMac)
 			return reader.ReadS16(m_top) && reader.ReadS16(m_left) && reader.ReadS16(m_bottom) && reader.ReadS16(m_right);
@@ -13,7 +14,8 @@ namespace mtdisasm
 			return false;
 	}
 
-	bool DOPoint::Load(DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOPoint::Load(TReader& reader, const SerializationProperties& sp)
 	{
 		if (sp.m_systemType == SystemType::kMac)
 			return reader.ReadS16(m_top) && reader.ReadS16(m_left);
@@ -23,18 +25,21 @@ namespace mtdisasm
 			return false;
 	}
 
-	bool DOEvent::Load(DataReader& reader)
+	template<class TReader>
+	bool DOEvent::Load(TReader& reader)
 	{
 		return reader.ReadU32(m_eventID) && reader.ReadU32(m_eventInfo);
 	}
 
-	bool DOLabel::Load(DataReader &reader)
+	template<class TReader>
+	bool DOLabel::Load(TReader& reader)
 	{
 		return reader.ReadU32(m_superGroupID) && reader.ReadU32(m_id);
 	}
 
 
-	bool DOColor::Load(DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOColor::Load(TReader& reader, const SerializationProperties& sp)
 	{
 		uint32_t colorPos = reader.TellGlobal();
 		if (sp.m_systemType == mtdisasm::SystemType::kMac)
@@ -57,7 +62,8 @@ namespace mtdisasm
 		return false;
 	}
 
-	bool DOFloat::Load(DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOFloat::Load(TReader& reader, const SerializationProperties& sp)
 	{
 		if (sp.m_systemType == mtdisasm::SystemType::kMac)
 			return reader.ReadF80BE(m_value);
@@ -68,12 +74,14 @@ namespace mtdisasm
 		return false;
 	}
 
-	bool DOVector::Load(DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOVector::Load(TReader& reader, const SerializationProperties& sp)
 	{
 		return m_angleRadians.Load(reader, sp) && m_magnitude.Load(reader, sp);
 	}
 
-	bool DOTypicalModifierHeader::Load(DataReader& reader)
+	template<class TReader>
+	bool DOTypicalModifierHeader::Load(TReader& reader)
 	{
 		if (!reader.ReadU32(m_modifierFlags)
 			|| !reader.ReadU32(m_sizeIncludingTag)
@@ -95,7 +103,8 @@ namespace mtdisasm
 		return true;
 	}
 
-	bool DOMessageDataSpec::Load(DataReader& reader)
+	template<class TReader>
+	bool DOMessageDataSpec::Load(TReader& reader)
 	{
 		if (!reader.ReadU16(m_typeCode)
 			|| !reader.ReadBytes(m_value.m_unknown, 44))
@@ -113,149 +122,13 @@ namespace mtdisasm
 		delete this;
 	}
 
-	DataObject* CreateObjectFromType(uint32_t objectType)
-	{
-		switch (objectType)
-		{
-		case 0x002:
-			return new DOProjectStructuralDef();
-		case 0x003:
-			return new DOSectionStructuralDef();
-		case 0x005:
-			return new DOMovieStructuralDef();
-		case 0x006:
-			return new DOMToonStructuralDef();
-		case 0x007:
-			return new DOImageStructuralDef();
-		case 0x008:
-			return new DOGraphicStructuralDef();
-		case 0x0015:
-			return new DOTextStructuralDef();
-		case 0xa:
-			return new DOSoundStructuralDef();
-		case 0x001f:
-			return new DOTextAsset();
-		case 0x00d:
-			return new DOAssetCatalog();
-		case 0x017:
-			return new DOGlobalObjectInfo();
-		case 0x019:
-			return new DOUnknown19();
-		case 0xfffffffe:
-			return new DODebris();
-		case 0x00e:
-			return new DOImageAsset();
-		case 0x00f:
-			return new DOMToonAsset();
-		case 0x010:
-			return new DOMovieAsset();
-		case 0x011:
-			return new DOAudioAsset();
-		case 0x01e:
-			return new DOColorTableAsset();
-		case 0x021:
-			return new DOSubsectionStructuralDef();
-		case 0x022:
-			return new DOProjectLabelMap();
-		case 0x3e9:
-			return new DOStreamHeader();
-		case 0x3ec:
-			return new DOPresentationSettings();
-		case 0x2c6:
-			return new DOBehaviorModifier();
-		case 0x3c0:
-			return new DOMiniscriptModifier();
-		case 0x2da:
-			return new DOMessengerModifier();
-		case 0x2bc:
-			return new DOIfMessengerModifier();
-		case 0x2e4:
-			return new DOTimerMessengerModifier();
-		case 0x2f8:
-			return new DOBoundaryDetectionMessengerModifier();
-		case 0x2ee:
-			return new DOCollisionDetectionMessengerModifier();
-		case 0x302:
-			return new DOKeyboardMessengerModifier();
-		case 0x321:
-			return new DOBooleanVariableModifier();
-		case 0x2c7:
-			return new DOCompoundVariableModifier();
-		case 0x322:
-			return new DOIntegerVariableModifier();
-		case 0x329:
-			return new DOStringVariableModifier();
-		case 0x324:
-			return new DOIntegerRangeVariableModifier();
-		case 0x328:
-			return new DOFloatVariableModifier();
-		case 0x327:
-			return new DOVectorVariableModifier();
-		case 0x326:
-			return new DOPointVariableModifier();
-		case 0x136:
-			return new DOChangeSceneModifier();
-		case 0x140:
-			return new DONotYetImplemented(objectType, "Return modifier");
-		case 0x29a:
-			return new DOSharedSceneModifier();
-		case 0x2df:
-			return new DOSetModifier();
-		case 0x4d8:
-			return new DOSaveAndRestoreModifier();
-		case 0x26c:
-			return new DOSceneTransitionModifier();
-		case 0x276:
-			return new DOElementTransitionModifier();
-		case 0x1fe:
-			return new DOSimpleMotionModifier();
-		case 0x21b:
-			return new DOPathMotionModifierV2();
-		case 0x21c:
-			return new DOPathMotionModifierV1();
-		case 0x208:
-			return new DODragMotionModifier();
-		case 0x226:
-			return new DOVectorMotionModifier();
-		case 0x1a4:
-			return new DOSoundEffectModifier();
-		case 0x32a:
-			return new DOTextStyleModifier();
-		case 0x334:
-			return new DOGraphicModifier();
-		case 0x4c4:
-			return new DONotYetImplemented(objectType, "Color Table modifier");
-		case 0x4b0:
-			return new DONotYetImplemented(objectType, "Gradient modifier");
-		case 0x384:
-			return new DOImageEffectModifier();
-		case 0x4ce:
-			return new DOSoundFadeModifier();
-		case 0x27:
-			return new DOAliasModifier();
-		case 0xffffffff:
-			return new DOPlugInModifier();
-		case 0x3ca:
-			return new DOMacOnlyCursorModifier();
-		case 0xffff:
-			return new DOAssetDataSection();
-		case 0x33e:
-			return new DONotYetImplemented(objectType, "Unknown33e");
-		case 0x24:
-			return new DOExtVideoAsset();
-		case 0x25:
-			return new DOExternalMovieStructuralDef();
-		default:
-			return nullptr;
-		};
-	}
-
 	DataObjectType DOStreamHeader::GetType() const
 	{
 		return DataObjectType::kStreamHeader;
 	}
 
-	bool DOStreamHeader::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOStreamHeader::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0)
 			return false;
@@ -281,7 +154,8 @@ namespace mtdisasm
 		return DataObjectType::kPresentationSettings;
 	}
 
-	bool DOPresentationSettings::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOPresentationSettings::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 2)
 			return false;
@@ -305,7 +179,8 @@ namespace mtdisasm
 		return DataObjectType::kAssetCatalog;
 	}
 
-	bool DOAssetCatalog::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOAssetCatalog::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision == 4 || revision == 2)
 		{
@@ -359,7 +234,8 @@ namespace mtdisasm
 		return DataObjectType::kGlobalObjectInfo;
 	}
 
-	bool DOGlobalObjectInfo::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOGlobalObjectInfo::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0)
 			return false;
@@ -381,7 +257,8 @@ namespace mtdisasm
 		return DataObjectType::kUnknown19;
 	}
 
-	bool DOUnknown19::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOUnknown19::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0)
 			return false;
@@ -402,7 +279,8 @@ namespace mtdisasm
 		return DataObjectType::kDebris;
 	}
 
-	bool DODebris::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DODebris::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0)
 			return false;
@@ -433,7 +311,8 @@ namespace mtdisasm
 		return DataObjectType::kProjectLabelMap;
 	}
 
-	bool DOProjectLabelMap::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOProjectLabelMap::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0)
 			return false;
@@ -480,7 +359,8 @@ namespace mtdisasm
 			delete[] m_tree;
 	}
 
-	bool DOProjectLabelMap::LoadSuperGroup(SuperGroup& sg, DataReader& reader, uint16_t revision)
+	template<class TReader>
+	bool DOProjectLabelMap::LoadSuperGroup(SuperGroup& sg, TReader& reader, uint16_t revision)
 	{
 		if (revision != 0)
 			return false;
@@ -513,7 +393,8 @@ namespace mtdisasm
 		return true;
 	}
 
-	bool DOProjectLabelMap::LoadLabelTree(LabelTree& lt, DataReader& reader, uint16_t revision)
+	template<class TReader>
+	bool DOProjectLabelMap::LoadLabelTree(LabelTree& lt, TReader& reader, uint16_t revision)
 	{
 		if (revision != 0)
 			return false;
@@ -559,7 +440,8 @@ namespace mtdisasm
 		return DataObjectType::kProjectStructuralDef;
 	}
 
-	bool DOProjectStructuralDef::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOProjectStructuralDef::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 1 && revision != 2)
 			return false;
@@ -589,7 +471,8 @@ namespace mtdisasm
 		return DataObjectType::kColorTableAsset;
 	}
 
-	bool DOColorTableAsset::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOColorTableAsset::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0)
 			return false;
@@ -669,7 +552,8 @@ namespace mtdisasm
 		return DataObjectType::kSectionStructuralDef;
 	}
 
-	bool DOSectionStructuralDef::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOSectionStructuralDef::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 1)
 			return false;
@@ -702,7 +586,8 @@ namespace mtdisasm
 		return DataObjectType::kSubsectionStructuralDef;
 	}
 
-	bool DOSubsectionStructuralDef::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOSubsectionStructuralDef::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0)
 			return false;
@@ -733,7 +618,8 @@ namespace mtdisasm
 		return DataObjectType::kGraphicStructuralDef;
 	}
 
-	bool DOGraphicStructuralDef::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOGraphicStructuralDef::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 1)
 			return false;
@@ -769,7 +655,8 @@ namespace mtdisasm
 		return DataObjectType::kTextStructuralDef;
 	}
 
-	bool DOTextStructuralDef::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOTextStructuralDef::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0 && revision != 2)
 			return false;
@@ -820,7 +707,8 @@ namespace mtdisasm
 		return DataObjectType::kSoundStructuralDef;
 	}
 
-	bool DOSoundStructuralDef::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOSoundStructuralDef::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 3)
 			return false;
@@ -849,7 +737,8 @@ namespace mtdisasm
 		return DataObjectType::kImageStructuralDef;
 	}
 
-	bool DOImageStructuralDef::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOImageStructuralDef::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 2)
 			return false;
@@ -886,7 +775,8 @@ namespace mtdisasm
 		return DataObjectType::kMovieStructuralDef;
 	}
 
-	bool DOMovieStructuralDef::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOMovieStructuralDef::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 2)
 			return false;
@@ -935,7 +825,8 @@ namespace mtdisasm
 		return DataObjectType::kMToonStructuralDef;
 	}
 
-	bool DOMToonStructuralDef::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOMToonStructuralDef::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		// No known structural changes in revision 3
 		if (revision != 2 && revision != 3)
@@ -976,7 +867,8 @@ namespace mtdisasm
 		return DataObjectType::kMessengerModifier;
 	}
 
-	bool DOMessengerModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOMessengerModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3ea)
 			return false;
@@ -1036,7 +928,8 @@ namespace mtdisasm
 		return DataObjectType::kSharedSceneModifier;
 	}
 
-	bool DOSharedSceneModifier::Load(DataReader &reader, uint16_t revision, const SerializationProperties &sp)
+	template<class TReader>
+	bool DOSharedSceneModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -1053,7 +946,8 @@ namespace mtdisasm
 		return DataObjectType::kSetModifier;
 	}
 
-	bool DOSetModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOSetModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -1078,7 +972,8 @@ namespace mtdisasm
 		return DataObjectType::kSaveAndRestoreModifier;
 	}
 
-	bool DOSaveAndRestoreModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOSaveAndRestoreModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 1000 && revision != 1001)
 			return false;
@@ -1134,7 +1029,8 @@ namespace mtdisasm
 		return DataObjectType::kIfMessengerModifier;
 	}
 
-	bool DOIfMessengerModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOIfMessengerModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 1002)
 			return false;
@@ -1182,7 +1078,8 @@ namespace mtdisasm
 		return DataObjectType::kTimerMessengerModifier;
 	}
 
-	bool DOTimerMessengerModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOTimerMessengerModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3ea)
 			return false;
@@ -1225,7 +1122,8 @@ namespace mtdisasm
 		return DataObjectType::kBoundaryDetectionMessengerModifier;
 	}
 
-	bool DOBoundaryDetectionMessengerModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOBoundaryDetectionMessengerModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3ea)
 			return false;
@@ -1261,7 +1159,8 @@ namespace mtdisasm
 		return DataObjectType::kCollisionDetectionMessengerModifier;
 	}
 
-	bool DOCollisionDetectionMessengerModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOCollisionDetectionMessengerModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3ea)
 			return false;
@@ -1297,7 +1196,8 @@ namespace mtdisasm
 		return DataObjectType::kKeyboardMessengerModifier;
 	}
 
-	bool DOKeyboardMessengerModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOKeyboardMessengerModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3eb)
 			return false;
@@ -1343,7 +1243,8 @@ namespace mtdisasm
 		return DataObjectType::kBehaviorModifier;
 	}
 
-	bool DOBehaviorModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOBehaviorModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 1)
 			return false;
@@ -1379,7 +1280,8 @@ namespace mtdisasm
 		return true;
 	}
 
-	bool DOMiniscriptProgram::Load(DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOMiniscriptProgram::Load(TReader& reader, const SerializationProperties& sp)
 	{
 		m_sp = sp;
 
@@ -1443,7 +1345,8 @@ namespace mtdisasm
 		return DataObjectType::kBooleanVariableModifier;
 	}
 
-	bool DOBooleanVariableModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOBooleanVariableModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -1463,7 +1366,8 @@ namespace mtdisasm
 		return DataObjectType::kIntegerVariableModifier;
 	}
 
-	bool DOIntegerVariableModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOIntegerVariableModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -1481,7 +1385,8 @@ namespace mtdisasm
 		return DataObjectType::kStringVariableModifier;
 	}
 
-	bool DOStringVariableModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOStringVariableModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -1506,7 +1411,8 @@ namespace mtdisasm
 		return DataObjectType::kCompoundVariableModifier;
 	}
 
-	bool DOCompoundVariableModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOCompoundVariableModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 1)
 			return false;
@@ -1532,7 +1438,8 @@ namespace mtdisasm
 		return DataObjectType::kFloatVariableModifier;
 	}
 
-	bool DOFloatVariableModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOFloatVariableModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -1550,7 +1457,8 @@ namespace mtdisasm
 		return DataObjectType::kVectorVariableModifier;
 	}
 
-	bool DOVectorVariableModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOVectorVariableModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -1568,7 +1476,8 @@ namespace mtdisasm
 		return DataObjectType::kIntegerRangeVariableModifier;
 	}
 
-	bool DOIntegerRangeVariableModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOIntegerRangeVariableModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -1587,7 +1496,8 @@ namespace mtdisasm
 		return DataObjectType::kPointVariableModifier;
 	}
 
-	bool DOPointVariableModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOPointVariableModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -1605,7 +1515,8 @@ namespace mtdisasm
 		return DataObjectType::kMiniscriptModifier;
 	}
 
-	bool DOMiniscriptModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOMiniscriptModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3eb)
 			return false;
@@ -1642,7 +1553,8 @@ namespace mtdisasm
 		return DataObjectType::kNotYetImplemented;
 	}
 
-	bool DONotYetImplemented::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DONotYetImplemented::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		m_revision = revision;
 
@@ -1749,7 +1661,8 @@ namespace mtdisasm
 		m_type = other.m_type;
 	}
 
-	bool PlugInTypeTaggedValue::Load(DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool PlugInTypeTaggedValue::Load(TReader& reader, const SerializationProperties& sp)
 	{
 		uint16_t type;
 		if (!reader.ReadU16(type))
@@ -1804,7 +1717,8 @@ namespace mtdisasm
 		return PlugInObjectType::kMediaCue;
 	}
 
-	bool POMediaCueModifier::Load(const DOPlugInModifier& base, DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool POMediaCueModifier::LoadImpl(const DOPlugInModifier& base, TReader& reader, const SerializationProperties& sp)
 	{
 		if (base.m_plugInRevision != 1)
 			return false;
@@ -1834,7 +1748,8 @@ namespace mtdisasm
 		return PlugInObjectType::kCursorMod;
 	}
 
-	bool POCursorMod::Load(const DOPlugInModifier& base, DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool POCursorMod::LoadImpl(const DOPlugInModifier& base, TReader& reader, const SerializationProperties& sp)
 	{
 		if (base.m_plugInRevision != 0 && base.m_plugInRevision != 1)
 			return false;
@@ -1876,7 +1791,8 @@ namespace mtdisasm
 		return PlugInObjectType::kUnknown;
 	}
 
-	bool POUnknown::Load(const DOPlugInModifier& base, DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool POUnknown::LoadImpl(const DOPlugInModifier& base, TReader& reader, const SerializationProperties& sp)
 	{
 		m_data.resize(base.m_privateDataSize);
 		if (base.m_privateDataSize > 0 && !reader.ReadBytes(&m_data[0], base.m_privateDataSize))
@@ -1890,7 +1806,8 @@ namespace mtdisasm
 		return PlugInObjectType::kMIDIModf;
 	}
 
-	bool POMidiModifier::Load(const DOPlugInModifier& base, DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool POMidiModifier::LoadImpl(const DOPlugInModifier& base, TReader& reader, const SerializationProperties& sp)
 	{
 		if (base.m_plugInRevision != 1 && base.m_plugInRevision != 2)
 			return false;
@@ -1951,7 +1868,8 @@ namespace mtdisasm
 		return DataObjectType::kPlugInModifier;
 	}
 
-	bool DOPlugInModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOPlugInModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e9)
 			return false;
@@ -2017,7 +1935,8 @@ namespace mtdisasm
 		return DataObjectType::kMacOnlyCursorModifier;
 	}
 
-	bool DOMacOnlyCursorModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOMacOnlyCursorModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e9)
 			return false;
@@ -2067,7 +1986,8 @@ namespace mtdisasm
 		return DataObjectType::kGraphicModifier;
 	}
 
-	bool DOGraphicModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOGraphicModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e9)
 			return false;
@@ -2132,7 +2052,8 @@ namespace mtdisasm
 		return DataObjectType::kTextStyleModifier;
 	}
 
-	bool DOTextStyleModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOTextStyleModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -2171,7 +2092,8 @@ namespace mtdisasm
 		return DataObjectType::kSceneTransitionModifier;
 	}
 
-	bool DOSceneTransitionModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOSceneTransitionModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e9)
 			return false;
@@ -2197,7 +2119,8 @@ namespace mtdisasm
 		return DataObjectType::kElementTransitionModifier;
 	}
 
-	bool DOElementTransitionModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOElementTransitionModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e9)
 			return false;
@@ -2223,7 +2146,8 @@ namespace mtdisasm
 		return DataObjectType::kSimpleMotionModifier;
 	}
 
-	bool DOSimpleMotionModifier::Load(DataReader &reader, uint16_t revision, const SerializationProperties &sp)
+	template<class TReader>
+	bool DOSimpleMotionModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e9)
 			return false;
@@ -2246,7 +2170,8 @@ namespace mtdisasm
 		return DataObjectType::kPathMotionModifierV2;
 	}
 
-	bool DOPathMotionModifierV2::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOPathMotionModifierV2::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e9)
 			return false;
@@ -2275,7 +2200,8 @@ namespace mtdisasm
 		return true;
 	}
 
-	bool DOPathMotionModifierV2::PointDef::Load(DataReader& reader, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOPathMotionModifierV2::PointDef::Load(TReader& reader, const SerializationProperties& sp)
 	{
 		if (!m_point.Load(reader, sp)
 			|| !reader.ReadU32(m_frame)
@@ -2300,7 +2226,8 @@ namespace mtdisasm
 		return DataObjectType::kPathMotionModifierV1;
 	}
 
-	bool DOPathMotionModifierV1::Load(DataReader &reader, uint16_t revision, const SerializationProperties &sp)
+	template<class TReader>
+	bool DOPathMotionModifierV1::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e9)
 			return false;
@@ -2329,7 +2256,8 @@ namespace mtdisasm
 		return true;
 	}
 
-	bool DOPathMotionModifierV1::PointDef::Load(DataReader &reader, const SerializationProperties &sp)
+	template<class TReader>
+	bool DOPathMotionModifierV1::PointDef::Load(TReader& reader, const SerializationProperties& sp)
 	{
 		if (!m_point.Load(reader, sp)
 			|| !reader.ReadU32(m_frame)
@@ -2344,7 +2272,8 @@ namespace mtdisasm
 		return DataObjectType::kDragMotionModifier;
 	}
 
-	bool DODragMotionModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DODragMotionModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -2392,7 +2321,8 @@ namespace mtdisasm
 		return DataObjectType::kVectorMotionModifier;
 	}
 
-	bool DOVectorMotionModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOVectorMotionModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e9)
 			return false;
@@ -2424,7 +2354,8 @@ namespace mtdisasm
 		return DataObjectType::kChangeSceneModifier;
 	}
 
-	bool DOChangeSceneModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOChangeSceneModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e9)
 			return false;
@@ -2447,7 +2378,8 @@ namespace mtdisasm
 		return DataObjectType::kImageEffectModifier;
 	}
 
-	bool DOImageEffectModifier::Load(DataReader &reader, uint16_t revision, const SerializationProperties &sp)
+	template<class TReader>
+	bool DOImageEffectModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 1000)
 			return false;
@@ -2472,7 +2404,8 @@ namespace mtdisasm
 		return DataObjectType::kSoundFadeModifier;
 	}
 
-	bool DOSoundFadeModifier::Load(DataReader &reader, uint16_t revision, const SerializationProperties &sp)
+	template<class TReader>
+	bool DOSoundFadeModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 1000)
 			return false;
@@ -2492,7 +2425,8 @@ namespace mtdisasm
 		return DataObjectType::kAliasModifier;
 	}
 
-	bool DOAliasModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOAliasModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision < 0 || revision > 2)
 			return false;
@@ -2526,7 +2460,8 @@ namespace mtdisasm
 		return DataObjectType::kSoundEffectModifier;
 	}
 
-	bool DOSoundEffectModifier::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOSoundEffectModifier::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0x3e8)
 			return false;
@@ -2551,7 +2486,8 @@ namespace mtdisasm
 		return DataObjectType::kAudioAsset;
 	}
 
-	bool DOAudioAsset::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOAudioAsset::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 2)
 			return false;
@@ -2637,7 +2573,8 @@ namespace mtdisasm
 		return DataObjectType::kImageAsset;
 	}
 
-	bool DOImageAsset::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOImageAsset::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 1)
 			return false;
@@ -2687,7 +2624,8 @@ namespace mtdisasm
 		return DataObjectType::kAssetDataSection;
 	}
 
-	bool DOAssetDataSection::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOAssetDataSection::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0)
 			return false;
@@ -2710,7 +2648,8 @@ namespace mtdisasm
 		return DataObjectType::kMovieAsset;
 	}
 
-	bool DOMovieAsset::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOMovieAsset::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 0)
 			return false;
@@ -2770,7 +2709,8 @@ namespace mtdisasm
 		return DataObjectType::kMToonAsset;
 	}
 
-	bool DOMToonAsset::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOMToonAsset::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 1)
 			return false;
@@ -2916,7 +2856,8 @@ namespace mtdisasm
 		return DataObjectType::kTextAsset;
 	}
 
-	bool DOTextAsset::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOTextAsset::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (revision != 3)
 			return false;
@@ -2999,7 +2940,8 @@ namespace mtdisasm
 		return DataObjectType::kExtVideoAsset;
 	}
 
-	bool DOExtVideoAsset::Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	template<class TReader>
+	bool DOExtVideoAsset::LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp)
 	{
 		if (!reader.ReadBytes(m_unknown1_0, 12)
 			|| !reader.ReadU32(m_assetID)
@@ -3011,4 +2953,7 @@ namespace mtdisasm
 
 		return true;
 	}
+
+	// Events are also decoded outside of object streams (e.g. miniscript operands)
+	template bool DOEvent::Load<DataReader>(DataReader& reader);
 }
@@ -5,9 +5,15 @@
 #include <cstring>
 #include <vector>
 
+#include "ObjectArena.h"
+
 namespace mtdisasm
 {
-	class DataReader;
+	template<bool TByteSwap>
+	class FixedByteOrderDataReader;
+
+	typedef FixedByteOrderDataReader<false> NativeOrderDataReader;
+	typedef FixedByteOrderDataReader<true> SwappedOrderDataReader;
 
 	namespace AssetTypeIDs
 	{
@@ -136,7 +142,8 @@ namespace mtdisasm
 
 	struct DORect
 	{
-		bool Load(DataReader& reader, const SerializationProperties& sp);
+		template<class TReader>
+		bool Load(TReader& reader, const SerializationProperties& sp);
 
 		int16_t m_top;
 		int16_t m_left;
@@ -146,7 +153,8 @@ namespace mtdisasm
 
 	struct DOPoint
 	{
-		bool Load(DataReader& reader, const SerializationProperties& sp);
+		template<class TReader>
+		bool Load(TReader& reader, const SerializationProperties& sp);
 
 		int16_t m_top;
 		int16_t m_left;
@@ -154,7 +162,8 @@ namespace mtdisasm
 
 	struct DOEvent
 	{
-		bool Load(DataReader& reader);
+		template<class TReader>
+		bool Load(TReader& reader);
 
 		uint32_t m_eventID;
 		uint32_t m_eventInfo;
@@ -162,7 +171,8 @@ namespace mtdisasm
 
 	struct DOLabel
 	{
-		bool Load(DataReader &reader);
+		template<class TReader>
+		bool Load(TReader& reader);
 
 		uint32_t m_superGroupID;
 		uint32_t m_id;
@@ -170,7 +180,8 @@ namespace mtdisasm
 
 	struct DOColor
 	{
-		bool Load(DataReader& reader, const SerializationProperties& sp);
+		template<class TReader>
+		bool Load(TReader& reader, const SerializationProperties& sp);
 
 		uint16_t m_red;
 		uint16_t m_green;
@@ -179,14 +190,16 @@ namespace mtdisasm
 
 	struct DOFloat
 	{
-		bool Load(DataReader& reader, const SerializationProperties& sp);
+		template<class TReader>
+		bool Load(TReader& reader, const SerializationProperties& sp);
 
 		double m_value;
 	};
 
 	struct DOVector
 	{
-		bool Load(DataReader& reader, const SerializationProperties& sp);
+		template<class TReader>
+		bool Load(TReader& reader, const SerializationProperties& sp);
 
 		DOFloat m_angleRadians;
 		DOFloat m_magnitude;
@@ -202,9 +215,10 @@ namespace mtdisasm
 		uint8_t m_unknown4[4];	// ff
 		uint16_t m_lengthOfName;
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 
-		bool Load(DataReader& reader);
+		template<class TReader>
+		bool Load(TReader& reader);
 	};
 
 	struct DOMessageDataSpec
@@ -255,25 +269,50 @@ namespace mtdisasm
 		uint16_t m_typeCode;
 		ValueUnion m_value;
 
-		bool Load(DataReader& reader);
+		template<class TReader>
+		bool Load(TReader& reader);
 	};
 
-	class DataObject
+	class DataObject : public ArenaAllocated
 	{
 	public:
 		virtual ~DataObject() = 0;
 
 		virtual DataObjectType GetType() const = 0;
-		virtual bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) = 0;
+		virtual bool Load(NativeOrderDataReader& reader, uint16_t revision, const SerializationProperties& sp) = 0;
+		virtual bool Load(SwappedOrderDataReader& reader, uint16_t revision, const SerializationProperties& sp) = 0;
 
 		virtual void Delete();
 	};
 
-	struct DOStreamHeader final : public DataObject
+	// Implements both byte order overloads of DataObject::Load by forwarding to TDerived::LoadImpl,
+	// so that each object is decoded by a reader specialized for the stream's byte order.
+	template<class TDerived>
+	class LoadableDataObject : public DataObject
+	{
+	public:
+		bool Load(NativeOrderDataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		bool Load(SwappedOrderDataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+	};
+
+	template<class TDerived>
+	bool LoadableDataObject<TDerived>::Load(NativeOrderDataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	{
+		return static_cast<TDerived*>(this)->LoadImpl(reader, revision, sp);
+	}
+
+	template<class TDerived>
+	bool LoadableDataObject<TDerived>::Load(SwappedOrderDataReader& reader, uint16_t revision, const SerializationProperties& sp)
+	{
+		return static_cast<TDerived*>(this)->LoadImpl(reader, revision, sp);
+	}
+
+	struct DOStreamHeader final : public LoadableDataObject<DOStreamHeader>
 	{
 		DataObjectType GetType() const override;
 
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_marker;
 		uint32_t m_sizeIncludingTag;
@@ -283,10 +322,11 @@ namespace mtdisasm
 		uint16_t m_unknown2;	// 0
 	};
 
-	struct DOPresentationSettings final : public DataObject
+	struct DOPresentationSettings final : public LoadableDataObject<DOPresentationSettings>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_marker;
 		uint32_t m_sizeIncludingTag;
@@ -296,10 +336,11 @@ namespace mtdisasm
 		uint16_t m_unknown4;
 	};
 
-	struct DOAssetCatalog final : public DataObject
+	struct DOAssetCatalog final : public LoadableDataObject<DOAssetCatalog>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		enum
 		{
@@ -323,7 +364,7 @@ namespace mtdisasm
 
 			Rev4Fields m_rev4Fields;
 
-			std::vector<char> m_name;
+			ArenaVector<char> m_name;
 		};
 
 		bool m_haveRev4Fields;
@@ -332,13 +373,14 @@ namespace mtdisasm
 		uint32_t m_totalNameSizePlus22;
 		uint8_t m_unknown1[4];
 		uint32_t m_numAssets;
-		std::vector<AssetInfo> m_assets;
+		ArenaVector<AssetInfo> m_assets;
 	};
 
-	struct DOGlobalObjectInfo final : public DataObject
+	struct DOGlobalObjectInfo final : public LoadableDataObject<DOGlobalObjectInfo>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_marker;
 		uint32_t m_sizeIncludingTag;
@@ -346,34 +388,37 @@ namespace mtdisasm
 		uint8_t m_unknown1[4];
 	};
 
-	struct DOUnknown19 final : public DataObject
+	struct DOUnknown19 final : public LoadableDataObject<DOUnknown19>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_marker;
 		uint32_t m_sizeIncludingTag;
 		uint8_t m_unknown1[2];
 	};
 
-	struct DODebris final : public DataObject
+	struct DODebris final : public LoadableDataObject<DODebris>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_marker;
 		uint32_t m_sizeIncludingTag;
 	};
 
-	struct DOProjectLabelMap final : public DataObject
+	struct DOProjectLabelMap final : public LoadableDataObject<DOProjectLabelMap>
 	{
 		DOProjectLabelMap();
 		~DOProjectLabelMap();
 
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
-		struct LabelTree
+		struct LabelTree : public ArenaAllocated
 		{
 			LabelTree();
 			~LabelTree();
@@ -389,13 +434,13 @@ namespace mtdisasm
 			uint32_t m_unknown1;
 			uint32_t m_flags;
 
-			std::vector<char> m_name;
+			ArenaVector<char> m_name;
 
 			uint32_t m_numChildren;
 			LabelTree* m_children;
 		};
 
-		struct SuperGroup
+		struct SuperGroup : public ArenaAllocated
 		{
 			SuperGroup();
 			~SuperGroup();
@@ -403,7 +448,7 @@ namespace mtdisasm
 			uint32_t m_nameLength;
 			uint32_t m_id;
 			uint32_t m_unknown2;
-			std::vector<char> m_name;
+			ArenaVector<char> m_name;
 
 			uint32_t m_numChildren;
 			LabelTree* m_tree;
@@ -417,8 +462,10 @@ namespace mtdisasm
 		SuperGroup* m_superGroups;
 
 	private:
-		static bool LoadSuperGroup(SuperGroup& sg, DataReader& reader, uint16_t revision);
-		static bool LoadLabelTree(LabelTree& lt, DataReader& reader, uint16_t revision);
+		template<class TReader>
+		static bool LoadSuperGroup(SuperGroup& sg, TReader& reader, uint16_t revision);
+		template<class TReader>
+		static bool LoadLabelTree(LabelTree& lt, TReader& reader, uint16_t revision);
 	};
 
 	namespace AnimationFlags
@@ -459,10 +506,11 @@ namespace mtdisasm
 		};
 	}
 
-	struct DOProjectStructuralDef final : public DataObject
+	struct DOProjectStructuralDef final : public LoadableDataObject<DOProjectStructuralDef>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		enum
 		{
@@ -475,13 +523,14 @@ namespace mtdisasm
 		uint32_t m_flags;
 		uint16_t m_nameLength;
 
-		std::vector<char> m_name;	// Null terminated
+		ArenaVector<char> m_name;	// Null terminated
 	};
 
-	struct DOColorTableAsset final : public DataObject
+	struct DOColorTableAsset final : public LoadableDataObject<DOColorTableAsset>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_marker;
 		uint32_t m_sizeIncludingTag;
@@ -499,10 +548,11 @@ namespace mtdisasm
 		ColorDef m_colors[256];
 	};
 
-	struct DOSectionStructuralDef final : public DataObject
+	struct DOSectionStructuralDef final : public LoadableDataObject<DOSectionStructuralDef>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		enum
 		{
@@ -518,13 +568,14 @@ namespace mtdisasm
 		uint16_t m_sectionID;
 		uint32_t m_segmentID;
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 	};
 
-	struct DOSubsectionStructuralDef final : public DataObject
+	struct DOSubsectionStructuralDef final : public LoadableDataObject<DOSubsectionStructuralDef>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		enum
 		{
@@ -538,13 +589,14 @@ namespace mtdisasm
 		uint32_t m_flags;
 		uint16_t m_sectionID;
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 	};
 
-	struct DOGraphicStructuralDef final : public DataObject
+	struct DOGraphicStructuralDef final : public LoadableDataObject<DOGraphicStructuralDef>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_structuralFlags;
 		uint32_t m_sizeIncludingTag;
@@ -558,13 +610,14 @@ namespace mtdisasm
 		uint32_t m_streamLocator;	// 1-based index, sometimes observed with 0x10000000 flag set, not sure of the meaning
 		uint8_t m_unknown11[4];
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 	};
 
-	struct DOTextStructuralDef final : public DataObject
+	struct DOTextStructuralDef final : public LoadableDataObject<DOTextStructuralDef>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_structuralFlags;
 		uint32_t m_sizeIncludingTag;
@@ -599,13 +652,14 @@ namespace mtdisasm
 		bool m_haveWinPart;
 		PlatformPart m_platform;
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 	};
 
-	struct DOSoundStructuralDef final : public DataObject
+	struct DOSoundStructuralDef final : public LoadableDataObject<DOSoundStructuralDef>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_structuralFlags;
 		uint32_t m_sizeIncludingTag;
@@ -621,13 +675,14 @@ namespace mtdisasm
 		uint32_t m_assetID;
 		uint8_t m_unknown5[8];
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 	};
 
-	struct DOImageStructuralDef final : public DataObject
+	struct DOImageStructuralDef final : public LoadableDataObject<DOImageStructuralDef>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_structuralFlags;
 		uint32_t m_sizeIncludingTag;
@@ -642,13 +697,14 @@ namespace mtdisasm
 		uint32_t m_streamLocator;
 		uint8_t m_unknown7[4];
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 	};
 
-	struct DOMovieStructuralDef : public DataObject
+	struct DOMovieStructuralDef : public LoadableDataObject<DOMovieStructuralDef>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_unknown1;
 		uint32_t m_sizeIncludingTag;
@@ -670,7 +726,7 @@ namespace mtdisasm
 		uint32_t m_streamLocator;
 		uint8_t m_unknown13[4];
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 	};
 
 	struct DOExternalMovieStructuralDef final : public DOMovieStructuralDef
@@ -678,10 +734,11 @@ namespace mtdisasm
 		DataObjectType GetType() const override;
 	};
 
-	struct DOMToonStructuralDef final : public DataObject
+	struct DOMToonStructuralDef final : public LoadableDataObject<DOMToonStructuralDef>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_structuralFlags;
 		uint32_t m_sizeIncludingTag;
@@ -699,12 +756,13 @@ namespace mtdisasm
 		uint32_t m_streamLocator;
 		uint32_t m_unknown6;
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 	};
 
 	struct DOMiniscriptProgram
 	{
-		bool Load(DataReader& reader, const SerializationProperties& sp);
+		template<class TReader>
+		bool Load(TReader& reader, const SerializationProperties& sp);
 
 		struct LocalRef
 		{
@@ -712,7 +770,7 @@ namespace mtdisasm
 			uint8_t m_lengthOfName;
 			uint8_t m_unknown10;
 
-			std::vector<char> m_name;
+			ArenaVector<char> m_name;
 		};
 
 		struct Attribute
@@ -720,7 +778,7 @@ namespace mtdisasm
 			uint8_t m_lengthOfName;
 			uint8_t m_unknown11;
 
-			std::vector<char> m_name;
+			ArenaVector<char> m_name;
 		};
 
 		uint32_t m_unknown1;
@@ -730,9 +788,9 @@ namespace mtdisasm
 		uint32_t m_numLocalRefs;
 		uint32_t m_numAttributes;
 
-		std::vector<uint8_t> m_bytecode;
-		std::vector<LocalRef> m_localRefs;
-		std::vector<Attribute> m_attributes;
+		ArenaVector<uint8_t> m_bytecode;
+		ArenaVector<LocalRef> m_localRefs;
+		ArenaVector<Attribute> m_attributes;
 
 		SerializationProperties m_sp;
 	};
@@ -744,10 +802,11 @@ namespace mtdisasm
 		kMessageFlagNoImmediate = 0x80000000,
 	};
 
-	struct DOMessengerModifier final : public DataObject
+	struct DOMessengerModifier final : public LoadableDataObject<DOMessengerModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_unknown1;
 		uint32_t m_sizeIncludingTag;
@@ -766,15 +825,16 @@ namespace mtdisasm
 		uint8_t m_withSourceLength;
 		uint8_t m_withStringLength;
 
-		std::vector<char> m_name;
-		std::vector<char> m_withSource;
-		std::vector<char> m_withString;
+		ArenaVector<char> m_name;
+		ArenaVector<char> m_withSource;
+		ArenaVector<char> m_withString;
 	};
 
-	struct DOSharedSceneModifier final : public DataObject
+	struct DOSharedSceneModifier final : public LoadableDataObject<DOSharedSceneModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader &reader, uint16_t revision, const SerializationProperties &sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 
@@ -785,10 +845,11 @@ namespace mtdisasm
 		uint32_t m_sceneGUID;
 	};
 
-	struct DOSetModifier final : public DataObject
+	struct DOSetModifier final : public LoadableDataObject<DOSetModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 
@@ -803,16 +864,17 @@ namespace mtdisasm
 		uint8_t m_targetStrLength;
 		uint8_t m_unknown4;
 
-		std::vector<char> m_sourceName;
-		std::vector<char> m_targetName;
-		std::vector<char> m_sourceStr;
-		std::vector<char> m_targetStr;
+		ArenaVector<char> m_sourceName;
+		ArenaVector<char> m_targetName;
+		ArenaVector<char> m_sourceStr;
+		ArenaVector<char> m_targetStr;
 	};
 
-	struct DOSaveAndRestoreModifier final : public DataObject
+	struct DOSaveAndRestoreModifier final : public LoadableDataObject<DOSaveAndRestoreModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 
@@ -831,16 +893,17 @@ namespace mtdisasm
 		uint8_t m_lengthOfVariableName;
 		uint8_t m_lengthOfVariableString;
 
-		std::vector<char> m_varName;
-		std::vector<char> m_varString;
-		std::vector<char> m_filePath;
-		std::vector<char> m_fileName;
+		ArenaVector<char> m_varName;
+		ArenaVector<char> m_varString;
+		ArenaVector<char> m_filePath;
+		ArenaVector<char> m_fileName;
 	};
 
-	struct DOIfMessengerModifier final : public DataObject
+	struct DOIfMessengerModifier final : public LoadableDataObject<DOIfMessengerModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint32_t m_messageFlags;
@@ -858,14 +921,15 @@ namespace mtdisasm
 		uint8_t m_unknown10;
 		DOMiniscriptProgram m_program;
 
-		std::vector<char> m_withSource;
-		std::vector<char> m_sourceCode;
+		ArenaVector<char> m_withSource;
+		ArenaVector<char> m_sourceCode;
 	};
 
-	struct DOBoundaryDetectionMessengerModifier final : public DataObject
+	struct DOBoundaryDetectionMessengerModifier final : public LoadableDataObject<DOBoundaryDetectionMessengerModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		enum HighFlags
 		{
@@ -889,13 +953,14 @@ namespace mtdisasm
 		uint8_t m_withSourceLength;
 		uint8_t m_unknown4;
 
-		std::vector<char> m_withSource;
+		ArenaVector<char> m_withSource;
 	};
 
-	struct DOCollisionDetectionMessengerModifier final : public DataObject
+	struct DOCollisionDetectionMessengerModifier final : public LoadableDataObject<DOCollisionDetectionMessengerModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		enum ModifierFlags
 		{
@@ -925,13 +990,14 @@ namespace mtdisasm
 		uint8_t m_withSourceLength;
 		uint8_t m_unknown4;
 
-		std::vector<char> m_withSource;
+		ArenaVector<char> m_withSource;
 	};
 
-	struct DOTimerMessengerModifier final : public DataObject
+	struct DOTimerMessengerModifier final : public LoadableDataObject<DOTimerMessengerModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint32_t m_messageAndTimerFlags;
@@ -952,13 +1018,14 @@ namespace mtdisasm
 		uint8_t m_withSourceLength;
 		uint8_t m_unknown9;
 
-		std::vector<char> m_withSource;
+		ArenaVector<char> m_withSource;
 	};
 
-	struct DOKeyboardMessengerModifier final : public DataObject
+	struct DOKeyboardMessengerModifier final : public LoadableDataObject<DOKeyboardMessengerModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		enum MessageFlagEmbeds
 		{
@@ -989,14 +1056,15 @@ namespace mtdisasm
 		DOMessageDataSpec m_with;
 		uint8_t m_withSourceLength;
 		uint8_t m_withStringLength;
-		std::vector<char> m_withSource;
-		std::vector<char> m_withString;
+		ArenaVector<char> m_withSource;
+		ArenaVector<char> m_withString;
 	};
 
-	struct DOBehaviorModifier final : public DataObject
+	struct DOBehaviorModifier final : public LoadableDataObject<DOBehaviorModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_modifierFlags;
 		uint32_t m_sizeIncludingTag;
@@ -1013,54 +1081,59 @@ namespace mtdisasm
 		DOEvent m_disableWhen;
 		uint8_t m_unknown7[2];
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 	};
 
-	struct DOBooleanVariableModifier final : public DataObject
+	struct DOBooleanVariableModifier final : public LoadableDataObject<DOBooleanVariableModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint8_t m_value;
 		uint8_t m_unknown5;
 	};
 
-	struct DOIntegerVariableModifier final : public DataObject
+	struct DOIntegerVariableModifier final : public LoadableDataObject<DOIntegerVariableModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint8_t m_unknown1[4];
 		int32_t m_value;
 	};
 
-	struct DOStringVariableModifier final : public DataObject
+	struct DOStringVariableModifier final : public LoadableDataObject<DOStringVariableModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint32_t m_lengthOfString;
 		uint8_t m_unknown1[4];
-		std::vector<char> m_string;
+		ArenaVector<char> m_string;
 	};
 
-	struct DOFloatVariableModifier final : public DataObject
+	struct DOFloatVariableModifier final : public LoadableDataObject<DOFloatVariableModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint8_t m_unknown1[4];
 		DOFloat m_value;
 	};
 
-	struct DOCompoundVariableModifier final : public DataObject
+	struct DOCompoundVariableModifier final : public LoadableDataObject<DOCompoundVariableModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_modifierFlags;
 		uint32_t m_sizeIncludingTag;
@@ -1071,24 +1144,26 @@ namespace mtdisasm
 		DOPoint m_editorLayoutPosition;
 		uint16_t m_lengthOfName;
 		uint16_t m_numChildren;
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 		uint8_t m_unknown7[4];
 	};
 
-	struct DOVectorVariableModifier final : public DataObject
+	struct DOVectorVariableModifier final : public LoadableDataObject<DOVectorVariableModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint8_t m_unknown1[4];
 		DOVector m_value;
 	};
 
-	struct DOIntegerRangeVariableModifier final : public DataObject
+	struct DOIntegerRangeVariableModifier final : public LoadableDataObject<DOIntegerRangeVariableModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint8_t m_unknown1[4];
@@ -1096,20 +1171,22 @@ namespace mtdisasm
 		int32_t m_max;
 	};
 
-	struct DOPointVariableModifier final : public DataObject
+	struct DOPointVariableModifier final : public LoadableDataObject<DOPointVariableModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint8_t m_unknown5[4];
 		DOPoint m_value;
 	};
 
-	struct DOMiniscriptModifier final : public DataObject
+	struct DOMiniscriptModifier final : public LoadableDataObject<DOMiniscriptModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_unknown1;
 		uint32_t m_sizeIncludingTag;
@@ -1123,17 +1200,18 @@ namespace mtdisasm
 		uint8_t m_unknown7;
 		DOMiniscriptProgram m_program;
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 
 		SerializationProperties m_sp;
 	};
 
-	struct DONotYetImplemented final : public DataObject
+	struct DONotYetImplemented final : public LoadableDataObject<DONotYetImplemented>
 	{
 		explicit DONotYetImplemented(uint32_t actualType, const char* name);
 
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_unknown;
 		uint32_t m_sizeIncludingTag;
@@ -1145,13 +1223,34 @@ namespace mtdisasm
 
 	struct DOPlugInModifier;
 
-	struct PlugInObject
+	struct PlugInObject : public ArenaAllocated
 	{
 		virtual ~PlugInObject();
 		virtual PlugInObjectType GetType() const = 0;
-		virtual bool Load(const DOPlugInModifier& base, DataReader& reader, const SerializationProperties& sp) = 0;
+		virtual bool Load(const DOPlugInModifier& base, NativeOrderDataReader& reader, const SerializationProperties& sp) = 0;
+		virtual bool Load(const DOPlugInModifier& base, SwappedOrderDataReader& reader, const SerializationProperties& sp) = 0;
 	};
 
+	// Implements both byte order overloads of PlugInObject::Load by forwarding to TDerived::LoadImpl
+	template<class TDerived>
+	struct LoadablePlugInObject : public PlugInObject
+	{
+		bool Load(const DOPlugInModifier& base, NativeOrderDataReader& reader, const SerializationProperties& sp) override;
+		bool Load(const DOPlugInModifier& base, SwappedOrderDataReader& reader, const SerializationProperties& sp) override;
+	};
+
+	template<class TDerived>
+	bool LoadablePlugInObject<TDerived>::Load(const DOPlugInModifier& base, NativeOrderDataReader& reader, const SerializationProperties& sp)
+	{
+		return static_cast<TDerived*>(this)->LoadImpl(base, reader, sp);
+	}
+
+	template<class TDerived>
+	bool LoadablePlugInObject<TDerived>::Load(const DOPlugInModifier& base, SwappedOrderDataReader& reader, const SerializationProperties& sp)
+	{
+		return static_cast<TDerived*>(this)->LoadImpl(base, reader, sp);
+	}
+
 	struct PlugInTypeTaggedValue
 	{
 		enum Type
@@ -1185,7 +1284,8 @@ namespace mtdisasm
 			uint16_t m_bool;
 		};
 
-		bool Load(DataReader& reader, const SerializationProperties& sp);
+		template<class TReader>
+		bool Load(TReader& reader, const SerializationProperties& sp);
 
 		uint16_t m_type;
 		ValueUnion m_value;
@@ -1201,10 +1301,11 @@ namespace mtdisasm
 		void CopyFrom(const PlugInTypeTaggedValue& other);
 	};
 
-	struct POMediaCueModifier final : public PlugInObject
+	struct POMediaCueModifier final : public LoadablePlugInObject<POMediaCueModifier>
 	{
 		PlugInObjectType GetType() const override;
-		bool Load(const DOPlugInModifier& base, DataReader& reader, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(const DOPlugInModifier& base, TReader& reader, const SerializationProperties& sp);
 
 		enum TriggerTiming
 		{
@@ -1239,10 +1340,11 @@ namespace mtdisasm
 		uint32_t m_triggerTiming;
 	};
 
-	struct POCursorMod final : public PlugInObject
+	struct POCursorMod final : public LoadablePlugInObject<POCursorMod>
 	{
 		PlugInObjectType GetType() const override;
-		bool Load(const DOPlugInModifier& base, DataReader& reader, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(const DOPlugInModifier& base, TReader& reader, const SerializationProperties& sp);
 
 		uint16_t m_unknown1;
 		DOEvent m_applyWhen;
@@ -1267,10 +1369,11 @@ namespace mtdisasm
 		Rev1Fields m_rev1Fields;
 	};
 
-	struct POSTransCt final : public PlugInObject
+	struct POSTransCt final : public LoadablePlugInObject<POSTransCt>
 	{
 		PlugInObjectType GetType() const override;
-		bool Load(const DOPlugInModifier& base, DataReader& reader, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(const DOPlugInModifier& base, TReader& reader, const SerializationProperties& sp);
 
 		uint16_t m_unknown1;
 		DOEvent m_applyWhen;
@@ -1282,18 +1385,20 @@ namespace mtdisasm
 		uint8_t m_unknown4[4];
 	};
 
-	struct POUnknown final : public PlugInObject
+	struct POUnknown final : public LoadablePlugInObject<POUnknown>
 	{
 		PlugInObjectType GetType() const override;
-		bool Load(const DOPlugInModifier& base, DataReader& reader, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(const DOPlugInModifier& base, TReader& reader, const SerializationProperties& sp);
 
-		std::vector<uint8_t> m_data;
+		ArenaVector<uint8_t> m_data;
 	};
 
-	struct POMidiModifier final : public PlugInObject
+	struct POMidiModifier final : public LoadablePlugInObject<POMidiModifier>
 	{
 		PlugInObjectType GetType() const override;
-		bool Load(const DOPlugInModifier& base, DataReader& reader, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(const DOPlugInModifier& base, TReader& reader, const SerializationProperties& sp);
 
 		struct EmbeddedPart
 		{
@@ -1334,16 +1439,17 @@ namespace mtdisasm
 
 		TypeDependentPart m_typeDependent;
 
-		std::vector<uint8_t> m_data;
+		ArenaVector<uint8_t> m_data;
 	};
 
-	struct DOPlugInModifier final : public DataObject
+	struct DOPlugInModifier final : public LoadableDataObject<DOPlugInModifier>
 	{
 		DOPlugInModifier();
 		~DOPlugInModifier();
 
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		char m_plugin[17];
 		uint32_t m_unknown1;
@@ -1357,15 +1463,16 @@ namespace mtdisasm
 
 		uint32_t m_privateDataSize;
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 
 		PlugInObject* m_plugInData;
 	};
 
-	struct DOMacOnlyCursorModifier final : public DataObject
+	struct DOMacOnlyCursorModifier final : public LoadableDataObject<DOMacOnlyCursorModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		struct MacOnlyPart
 		{
@@ -1402,16 +1509,17 @@ namespace mtdisasm
 		uint32_t m_unknown5;
 		uint8_t m_unknown6[4];
 		uint16_t m_lengthOfName;
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 
 		bool m_hasMacOnlyPart;
 		MacOnlyPart m_macOnlyPart;
 	};
 
-	struct DOGraphicModifier final : public DataObject
+	struct DOGraphicModifier final : public LoadableDataObject<DOGraphicModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint16_t m_unknown1;
@@ -1453,14 +1561,15 @@ namespace mtdisasm
 		uint16_t m_numPolygonPoints;
 		uint8_t m_unknown6[8];
 
-		std::vector<DOPoint> m_polyPoints;
+		ArenaVector<DOPoint> m_polyPoints;
 	};
 
-	struct DOTextStyleModifier final : public DataObject
+	struct DOTextStyleModifier final : public LoadableDataObject<DOTextStyleModifier>
 	{
 
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint8_t m_unknown1[4];
@@ -1476,13 +1585,14 @@ namespace mtdisasm
 		DOEvent m_removeWhen;
 		uint16_t m_lengthOfFontName;
 
-		std::vector<char> m_fontName;
+		ArenaVector<char> m_fontName;
 	};
 
-	struct DOSceneTransitionModifier final : public DataObject
+	struct DOSceneTransitionModifier final : public LoadableDataObject<DOSceneTransitionModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		enum TransitionTypes
 		{
@@ -1515,10 +1625,11 @@ namespace mtdisasm
 		uint8_t m_unknown5[2];
 	};
 
-	struct DOElementTransitionModifier final : public DataObject
+	struct DOElementTransitionModifier final : public LoadableDataObject<DOElementTransitionModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		enum TransitionType
 		{
@@ -1545,10 +1656,11 @@ namespace mtdisasm
 		uint16_t m_rate;
 	};
 
-	struct DOSimpleMotionModifier final : public DataObject
+	struct DOSimpleMotionModifier final : public LoadableDataObject<DOSimpleMotionModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader &reader, uint16_t revision, const SerializationProperties &sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 
@@ -1561,10 +1673,11 @@ namespace mtdisasm
 		uint8_t m_unknown5[4];
 	};
 
-	struct DOPathMotionModifierV2 final : public DataObject
+	struct DOPathMotionModifierV2 final : public LoadableDataObject<DOPathMotionModifierV2>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		struct PointDef
 		{
@@ -1580,10 +1693,11 @@ namespace mtdisasm
 			uint8_t m_withSourceLength;
 			uint8_t m_withStringLength;
 
-			std::vector<char> m_withSource;
-			std::vector<char> m_withString;
+			ArenaVector<char> m_withSource;
+			ArenaVector<char> m_withString;
 
-			bool Load(DataReader& reader, const SerializationProperties& sp);
+			template<class TReader>
+			bool Load(TReader& reader, const SerializationProperties& sp);
 		};
 
 		DOTypicalModifierHeader m_modHeader;
@@ -1597,10 +1711,10 @@ namespace mtdisasm
 		uint8_t m_unknown5[4];
 		uint32_t m_unknown6;
 
-		std::vector<PointDef> m_pointDefs;
+		ArenaVector<PointDef> m_pointDefs;
 	};
 
-	struct DOPathMotionModifierV1 final : public DataObject
+	struct DOPathMotionModifierV1 final : public LoadableDataObject<DOPathMotionModifierV1>
 	{
 		struct PointDef
 		{
@@ -1608,11 +1722,13 @@ namespace mtdisasm
 			uint32_t m_frame;
 			uint32_t m_frameFlags;
 
-			bool Load(DataReader &reader, const SerializationProperties &sp);
+			template<class TReader>
+			bool Load(TReader& reader, const SerializationProperties& sp);
 		};
 
 		DataObjectType GetType() const override;
-		bool Load(DataReader &reader, uint16_t revision, const SerializationProperties &sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint32_t m_flags;
@@ -1625,13 +1741,14 @@ namespace mtdisasm
 		uint8_t m_unknown5[4];
 		uint32_t m_unknown6;
 
-		std::vector<PointDef> m_pointDefs;
+		ArenaVector<PointDef> m_pointDefs;
 	};
 
-	struct DODragMotionModifier final : public DataObject
+	struct DODragMotionModifier final : public LoadableDataObject<DODragMotionModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 
@@ -1673,10 +1790,11 @@ namespace mtdisasm
 		uint16_t m_unknown1;
 	};
 
-	struct DOVectorMotionModifier final : public DataObject
+	struct DOVectorMotionModifier final : public LoadableDataObject<DOVectorMotionModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 
@@ -1687,14 +1805,15 @@ namespace mtdisasm
 		uint8_t m_varSourceNameLength;
 		uint8_t m_varStringLength;
 
-		std::vector<char> m_varSourceName;
-		std::vector<char> m_varString;
+		ArenaVector<char> m_varSourceName;
+		ArenaVector<char> m_varString;
 	};
 
-	struct DOChangeSceneModifier final : public DataObject
+	struct DOChangeSceneModifier final : public LoadableDataObject<DOChangeSceneModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint32_t m_sceneChangeFlags;
@@ -1704,10 +1823,11 @@ namespace mtdisasm
 		uint32_t m_targetSceneGUID;
 	};
 
-	struct DOImageEffectModifier final : public DataObject
+	struct DOImageEffectModifier final : public LoadableDataObject<DOImageEffectModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader &reader, uint16_t revision, const SerializationProperties &sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint32_t m_flags;
@@ -1719,10 +1839,11 @@ namespace mtdisasm
 		uint8_t m_unknown2[2];
 	};
 
-	struct DOSoundFadeModifier final : public DataObject
+	struct DOSoundFadeModifier final : public LoadableDataObject<DOSoundFadeModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader &reader, uint16_t revision, const SerializationProperties &sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint8_t m_unknown1[4];
@@ -1733,10 +1854,11 @@ namespace mtdisasm
 		uint8_t m_unknown2[18];
 	};
 
-	struct DOAliasModifier final : public DataObject
+	struct DOAliasModifier final : public LoadableDataObject<DOAliasModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_modifierFlags;
 		uint32_t m_sizeIncludingTag;
@@ -1747,15 +1869,16 @@ namespace mtdisasm
 		uint32_t m_guid;
 		DOPoint m_editorLayoutPosition;
 
-		std::vector<char> m_name;
+		ArenaVector<char> m_name;
 
 		bool m_haveGUID;
 	};
 
-	struct DOSoundEffectModifier final : public DataObject
+	struct DOSoundEffectModifier final : public LoadableDataObject<DOSoundEffectModifier>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		DOTypicalModifierHeader m_modHeader;
 		uint8_t m_unknown1[4];
@@ -1767,10 +1890,11 @@ namespace mtdisasm
 		uint8_t m_unknown5[4];
 	};
 
-	struct DOAudioAsset final : public DataObject
+	struct DOAudioAsset final : public LoadableDataObject<DOAudioAsset>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		struct MacPart
 		{
@@ -1813,7 +1937,7 @@ namespace mtdisasm
 		uint32_t m_filePosition;
 		uint32_t m_size;
 
-		std::vector<CuePoint> m_cuePoints;
+		ArenaVector<CuePoint> m_cuePoints;
 
 		bool m_isBigEndian;
 
@@ -1824,10 +1948,11 @@ namespace mtdisasm
 		WinPart m_winPart;
 	};
 
-	struct DOImageAsset final : public DataObject
+	struct DOImageAsset final : public LoadableDataObject<DOImageAsset>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		struct MacPart
 		{
@@ -1868,10 +1993,11 @@ namespace mtdisasm
 		PlatformPart m_platform;
 	};
 
-	struct DOMovieAsset final : public DataObject
+	struct DOMovieAsset final : public LoadableDataObject<DOMovieAsset>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		struct MacPart
 		{
@@ -1903,13 +2029,14 @@ namespace mtdisasm
 		bool m_haveWinPart;
 		WinPart m_winPart;
 
-		std::vector<char> m_extFileName;
+		ArenaVector<char> m_extFileName;
 	};
 
-	struct DOMToonAsset final : public DataObject
+	struct DOMToonAsset final : public LoadableDataObject<DOMToonAsset>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		struct MacPart
 		{
@@ -1966,7 +2093,7 @@ namespace mtdisasm
 			uint8_t m_lengthOfName;
 			uint8_t m_unknown14;
 
-			std::vector<char> m_name;	// Null terminated
+			ArenaVector<char> m_name;	// Null terminated
 		};
 
 		enum
@@ -2007,9 +2134,9 @@ namespace mtdisasm
 		uint32_t m_codecDataSize;
 		uint8_t m_unknown4_2[4];
 
-		std::vector<FrameDef> m_frames;
+		ArenaVector<FrameDef> m_frames;
 
-		std::vector<uint8_t> m_codecData;
+		ArenaVector<uint8_t> m_codecData;
 
 		struct FrameRangePart
 		{
@@ -2017,14 +2144,15 @@ namespace mtdisasm
 			uint32_t m_sizeIncludingTag;
 
 			uint32_t m_numFrameRanges;
-			std::vector<FrameRangeDef> m_frameRanges;
+			ArenaVector<FrameRangeDef> m_frameRanges;
 		} m_frameRangesPart;
 	};
 
-	struct DOTextAsset final : public DataObject
+	struct DOTextAsset final : public LoadableDataObject<DOTextAsset>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		struct MacFormattingSpan
 		{
@@ -2077,34 +2205,33 @@ namespace mtdisasm
 		bool m_haveWinPart;
 		PlatformPart m_platform;
 
-		std::vector<char> m_text;
-		std::vector<uint8_t> m_bitmapData;
+		ArenaVector<char> m_text;
+		ArenaVector<uint8_t> m_bitmapData;
 
-		std::vector<MacFormattingSpan> m_macFormattingSpans;
+		ArenaVector<MacFormattingSpan> m_macFormattingSpans;
 	};
 
-	struct DOAssetDataSection final : public DataObject
+	struct DOAssetDataSection final : public LoadableDataObject<DOAssetDataSection>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint32_t m_unknown1;
 		uint32_t m_sizeIncludingTag;
 	};
 
-	struct DOExtVideoAsset final : public DataObject
+	struct DOExtVideoAsset final : public LoadableDataObject<DOExtVideoAsset>
 	{
 		DataObjectType GetType() const override;
-		bool Load(DataReader& reader, uint16_t revision, const SerializationProperties& sp) override;
+		template<class TReader>
+		bool LoadImpl(TReader& reader, uint16_t revision, const SerializationProperties& sp);
 
 		uint8_t m_unknown1_0[12];
 		uint32_t m_assetID;
 		uint8_t m_unknown1_1[4];
 		uint16_t m_lengthOfName;
 		uint8_t m_unknown2[15*4];
-		std::vector<char> m_extFilename;
+		ArenaVector<char> m_extFilename;
 	};
-
-
-	DataObject* CreateObjectFromType(uint32_t objectType);
 }
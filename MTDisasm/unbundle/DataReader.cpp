@@ -1,111 +1,32 @@
 #include "DataReader.h"
 
-#include "Endian.h"
-#include "IOStream.h"
-
 namespace mtdisasm
 {
-	DataReader::DataReader(IOStream& stream, bool byteSwap)
+	DataReaderBase::DataReaderBase(IOStream& stream)
 		: m_stream(stream)
-		, m_byteSwap(byteSwap)
-	{
-	}
-
-	bool DataReader::ReadU64(uint64_t& v)
-	{
-		uint64_t result = 0;
-		if (!m_stream.ReadAll(&result, 8))
-			return false;
-
-		if (m_byteSwap)
-			result = endian::SwapU64(result);
-
-		v = result;
-		return true;
-	}
-
-	bool DataReader::ReadS64(int64_t& v)
-	{
-		int64_t result = 0;
-		if (!m_stream.ReadAll(&result, 8))
-			return false;
-
-		if (m_byteSwap)
-			result = endian::SwapS64(result);
-
-		v = result;
-		return true;
-	}
-
-	bool DataReader::ReadU32(uint32_t& v)
-	{
-		uint32_t result = 0;
-		if (!m_stream.ReadAll(&result, 4))
-			return false;
-
-		if (m_byteSwap)
-			result = endian::SwapU32(result);
-
-		v = result;
-		return true;
-	}
-
-	bool DataReader::ReadS32(int32_t& v)
-	{
-		int32_t result = 0;
-		if (!m_stream.ReadAll(&result, 4))
-			return false;
-
-		if (m_byteSwap)
-			result = endian::SwapS32(result);
-
-		v = result;
-		return true;
-	}
-
-	bool DataReader::ReadU16(uint16_t& v)
-	{
-		uint16_t result = 0;
-		if (!m_stream.ReadAll(&result, 2))
-			return false;
-
-		if (m_byteSwap)
-			result = endian::SwapU16(result);
-
-		v = result;
-		return true;
-	}
-
-	bool DataReader::ReadS16(int16_t& v)
-	{
-		int16_t result = 0;
-		if (!m_stream.ReadAll(&result, 2))
-			return false;
-
-		if (m_byteSwap)
-			result = endian::SwapS16(result);
-
-		v = result;
-		return true;
-	}
-
-	bool DataReader::ReadU8(uint8_t& v)
-	{
-		return m_stream.ReadAll(&v, 1);
-	}
-
-	bool DataReader::ReadS8(int8_t& v)
-	{
-		return m_stream.ReadAll(&v, 1);
+		, m_spanStart(nullptr)
+		, m_spanEnd(nullptr)
+		, m_spanCursor(nullptr)
+		, m_spanGlobalBase(0)
+	{
+		const void* spanData = nullptr;
+		size_t spanSize = 0;
+		uint32_t spanGlobalBase = 0;
+		if (stream.GetContiguousSpan(spanData, spanSize, spanGlobalBase) && spanData != nullptr)
+		{
+			uint32_t pos = stream.Tell();
+			if (pos <= spanSize)
+			{
+				m_spanStart = static_cast<const uint8_t*>(spanData);
+				m_spanEnd = m_spanStart + spanSize;
+				m_spanCursor = m_spanStart + pos;
+				m_spanGlobalBase = spanGlobalBase;
+			}
+		}
 	}
 
-	bool DataReader::ReadF80BE(double& v)
+	double DataReaderBase::ConvertF80(uint16_t signAndExponent, uint64_t mantissa)
 	{
-		uint16_t signAndExponent;
-		uint64_t mantissa;
-		if (!ReadU16(signAndExponent) || !ReadU64(mantissa))
-			return false;
-
 		uint8_t sign = (signAndExponent >> 15) & 1;
 		int16_t exponent = signAndExponent & 0x7fff;
 
@@ -141,37 +62,30 @@ namespace mtdisasm
 		}
 
 		uint64_t recombined = (static_cast<uint64_t>(sign) << 63) | (static_cast<uint64_t>(exponent) << 52) | static_cast<uint64_t>(mantissa);
+		double v;
 		memcpy(&v, &recombined, 8);
 
-		return true;
+		return v;
 	}
 
-	bool DataReader::ReadF64(double& v)
+	bool DataReaderBase::ReadPStr16Body(std::string& str, uint16_t length)
 	{
-		uint64_t u64;
-		if (!this->ReadU64(u64))
+		if (length == 0)
 			return false;
 
-		memcpy(&v, &u64, 8);
-		return true;
-	}
-
-	bool DataReader::ReadF32(float& v)
-	{
-		uint32_t u32;
-		if (!this->ReadU32(u32))
-			return false;
-
-		memcpy(&v, &u32, 4);
-		return true;
-	}
+		if (m_spanStart)
+		{
+			if (static_cast<size_t>(m_spanEnd - m_spanCursor) < length)
+				return false;
 
+			const char* chars = reinterpret_cast<const char*>(m_spanCursor);
+			if (chars[length - 1] != 0)
+				return false;
 
-	bool DataReader::ReadPStr16(std::string& str)
-	{
-		uint16_t length = 0;
-		if (!ReadU16(length) || length == 0)
-			return false;
+			str.assign(chars, length - 1);
+			m_spanCursor += length;
+			return true;
+		}
 
 		str.resize(length - 1, 0);
 		if (length > 1)
@@ -190,102 +104,50 @@ namespace mtdisasm
 		return true;
 	}
 
-	bool DataReader::ReadRawU32(uint32_t& v)
-	{
-		return m_stream.ReadAll(&v, 4);
-	}
-
-	bool DataReader::ReadRawS32(int32_t& v)
-	{
-		return m_stream.ReadAll(&v, 4);
-	}
-
-	bool DataReader::ReadRawU16(uint16_t& v)
+	bool DataReaderBase::Seek(uint32_t pos)
 	{
-		return m_stream.ReadAll(&v, 2);
-	}
-
-	bool DataReader::ReadRawS16(int16_t& v)
-	{
-		return m_stream.ReadAll(&v, 2);
-	}
-
-	bool DataReader::ReadLimitedTerminatedStr(std::vector<char> &chars, size_t size, size_t maxSize)
-	{
-		if (size == maxSize)
-			return ReadNonTerminatedStr(chars, size);
-		else if (size < maxSize)
-			return ReadTerminatedStr(chars, size);
-		else
+		if (pos > INT32_MAX)
 			return false;
-	}
 
-	bool DataReader::ReadTerminatedStr(std::vector<char>& chars, size_t size)
-	{
-		if (size > 0)
+		if (m_spanStart)
 		{
-			chars.resize(size);
-			if (!ReadBytes(&chars[0], size))
-				return false;
-			if (chars[size - 1] != 0)
+			if (pos > static_cast<size_t>(m_spanEnd - m_spanStart))
 				return false;
+
+			m_spanCursor = m_spanStart + pos;
 			return true;
 		}
-		chars.clear();
-		return true;
+
+		return m_stream.SeekSet(static_cast<int32_t>(pos));
 	}
 
-	bool DataReader::ReadMaybeTerminatedStr(std::vector<char> &chars, size_t size)
+	bool DataReaderBase::Skip(uint32_t amount)
 	{
-		if (size > 0)
+		if (m_spanStart)
 		{
-			chars.resize(size);
-			if (!ReadBytes(&chars[0], size))
+			if (amount > static_cast<size_t>(m_spanEnd - m_spanCursor))
 				return false;
-			if (chars[size - 1] == 0)
-				chars.resize(size - 1);
-			return true;
-		}
-		chars.clear();
-		return true;
-	}
 
-	bool DataReader::ReadNonTerminatedStr(std::vector<char>& chars, size_t size)
-	{
-		if (size > 0)
-		{
-			chars.resize(size + 1);
-			chars[size] = 0;
-			return ReadBytes(&chars[0], size);
+			m_spanCursor += amount;
+			return true;
 		}
-		chars.clear();
-		return true;
-	}
-
-	bool DataReader::ReadBytes(void* dest, size_t sz)
-	{
-		return m_stream.ReadAll(dest, sz);
-	}
-
-	bool DataReader::Seek(uint32_t pos)
-	{
-		if (pos > INT32_MAX)
-			return false;
-		return m_stream.SeekSet(static_cast<int32_t>(pos));
-	}
 
-	bool DataReader::Skip(uint32_t amount)
-	{
 		return m_stream.SeekCur(amount);
 	}
 
-	uint32_t DataReader::Tell() const
+	uint32_t DataReaderBase::Tell() const
 	{
+		if (m_spanStart)
+			return static_cast<uint32_t>(m_spanCursor - m_spanStart);
+
 		return m_stream.Tell();
 	}
 
-	uint32_t DataReader::TellGlobal() const
+	uint32_t DataReaderBase::TellGlobal() const
 	{
+		if (m_spanStart)
+			return m_spanGlobalBase + static_cast<uint32_t>(m_spanCursor - m_spanStart);
+
 		return m_stream.TellGlobal();
 	}
 }
@@ -6,14 +6,76 @@
 #include <string>
 #include <vector>
 
+#include "Endian.h"
+#include "IOStream.h"
+
 namespace mtdisasm
 {
-	struct IOStream;
+	// If the stream is backed by contiguous memory, the reader decodes directly from it
+	// using its own cursor, and the stream's position is not updated.  Use the reader's
+	// Tell/Seek/Skip instead of the stream's while the reader is in use.
+	//
+	// DataReaderBase contains everything that doesn't depend on byte order.  The byte order
+	// is either fixed at compile time (FixedByteOrderDataReader) so that multi-byte reads
+	// don't branch on it, or chosen at runtime (DataReader).
+	class DataReaderBase
+	{
+	public:
+		bool ReadU8(uint8_t& v);
+		bool ReadS8(int8_t& v);
+
+		bool ReadRawU32(uint32_t& v);
+		bool ReadRawS32(int32_t& v);
+		bool ReadRawU16(uint16_t& v);
+		bool ReadRawS16(int16_t& v);
+
+		template<class TAllocator>
+		bool ReadLimitedTerminatedStr(std::vector<char, TAllocator>& chars, size_t size, size_t maxSize);
+		template<class TAllocator>
+		bool ReadTerminatedStr(std::vector<char, TAllocator>& chars, size_t size);
+		template<class TAllocator>
+		bool ReadNonTerminatedStr(std::vector<char, TAllocator>& chars, size_t size);
+		template<class TAllocator>
+		bool ReadMaybeTerminatedStr(std::vector<char, TAllocator>& chars, size_t size);
+
+		bool ReadBytes(void* dest, size_t sz);
+
+		bool Skip(uint32_t pos);
+		bool Seek(uint32_t pos);
+		uint32_t Tell() const;
+		uint32_t TellGlobal() const;
+
+	protected:
+		explicit DataReaderBase(IOStream& stream);
 
-	class DataReader
+		bool ReadRaw(void* dest, size_t sz);
+
+		bool ReadSwappable(uint64_t& v, bool byteSwap);
+		bool ReadSwappable(int64_t& v, bool byteSwap);
+		bool ReadSwappable(uint32_t& v, bool byteSwap);
+		bool ReadSwappable(int32_t& v, bool byteSwap);
+		bool ReadSwappable(uint16_t& v, bool byteSwap);
+		bool ReadSwappable(int16_t& v, bool byteSwap);
+
+		// Reads the string body and terminator of a PStr16 after its length was read
+		bool ReadPStr16Body(std::string& str, uint16_t length);
+
+		static double ConvertF80(uint16_t signAndExponent, uint64_t mantissa);
+
+	private:
+		IOStream& m_stream;
+
+		const uint8_t* m_spanStart;
+		const uint8_t* m_spanEnd;
+		const uint8_t* m_spanCursor;
+		uint32_t m_spanGlobalBase;
+	};
+
+	template<bool TByteSwap>
+	class FixedByteOrderDataReader final : public DataReaderBase
 	{
 	public:
-		DataReader(IOStream& stream, bool byteSwap);
+		explicit FixedByteOrderDataReader(IOStream& stream);
 
 		bool ReadU64(uint64_t& v);
 		bool ReadS64(int64_t& v);
@@ -21,35 +83,362 @@ namespace mtdisasm
 		bool ReadS32(int32_t& v);
 		bool ReadU16(uint16_t& v);
 		bool ReadS16(int16_t& v);
-		bool ReadU8(uint8_t& v);
-		bool ReadS8(int8_t& v);
 		bool ReadF64(double& v);
 		bool ReadF80BE(double& v);
 		bool ReadF32(float& v);
 
 		bool ReadPStr16(std::string& str);
+	};
 
-		bool ReadRawU32(uint32_t& v);
-		bool ReadRawS32(int32_t& v);
-		bool ReadRawU16(uint16_t& v);
-		bool ReadRawS16(int16_t& v);
-		bool ReadRawF64(double& v);
-		bool ReadRawF32(float& v);
+	typedef FixedByteOrderDataReader<false> NativeOrderDataReader;
+	typedef FixedByteOrderDataReader<true> SwappedOrderDataReader;
 
-		bool ReadLimitedTerminatedStr(std::vector<char> &chars, size_t size, size_t maxSize);
-		bool ReadTerminatedStr(std::vector<char>& chars, size_t size);
-		bool ReadNonTerminatedStr(std::vector<char>& chars, size_t size);
-		bool ReadMaybeTerminatedStr(std::vector<char> &chars, size_t size);
+	class DataReader final : public DataReaderBase
+	{
+	public:
+		DataReader(IOStream& stream, bool byteSwap);
 
-		bool ReadBytes(void* dest, size_t sz);
+		bool ReadU64(uint64_t& v);
+		bool ReadS64(int64_t& v);
+		bool ReadU32(uint32_t& v);
+		bool ReadS32(int32_t& v);
+		bool ReadU16(uint16_t& v);
+		bool ReadS16(int16_t& v);
+		bool ReadF64(double& v);
+		bool ReadF80BE(double& v);
+		bool ReadF32(float& v);
 
-		bool Skip(uint32_t pos);
-		bool Seek(uint32_t pos);
-		uint32_t Tell() const;
-		uint32_t TellGlobal() const;
+		bool ReadPStr16(std::string& str);
 
 	private:
-		IOStream& m_stream;
 		bool m_byteSwap;
 	};
+
+	inline bool DataReaderBase::ReadRaw(void* dest, size_t sz)
+	{
+		if (m_spanStart)
+		{
+			if (static_cast<size_t>(m_spanEnd - m_spanCursor) < sz)
+				return false;
+
+			memcpy(dest, m_spanCursor, sz);
+			m_spanCursor += sz;
+			return true;
+		}
+
+		return m_stream.ReadAll(dest, sz);
+	}
+
+	inline bool DataReaderBase::ReadU8(uint8_t& v)
+	{
+		return ReadRaw(&v, 1);
+	}
+
+	inline bool DataReaderBase::ReadS8(int8_t& v)
+	{
+		return ReadRaw(&v, 1);
+	}
+
+	inline bool DataReaderBase::ReadRawU32(uint32_t& v)
+	{
+		return ReadRaw(&v, 4);
+	}
+
+	inline bool DataReaderBase::ReadRawS32(int32_t& v)
+	{
+		return ReadRaw(&v, 4);
+	}
+
+	inline bool DataReaderBase::ReadRawU16(uint16_t& v)
+	{
+		return ReadRaw(&v, 2);
+	}
+
+	inline bool DataReaderBase::ReadRawS16(int16_t& v)
+	{
+		return ReadRaw(&v, 2);
+	}
+
+	inline bool DataReaderBase::ReadBytes(void* dest, size_t sz)
+	{
+		return ReadRaw(dest, sz);
+	}
+
+	template<class TAllocator>
+	bool DataReaderBase::ReadLimitedTerminatedStr(std::vector<char, TAllocator>& chars, size_t size, size_t maxSize)
+	{
+		if (size == maxSize)
+			return ReadNonTerminatedStr(chars, size);
+		else if (size < maxSize)
+			return ReadTerminatedStr(chars, size);
+		else
+			return false;
+	}
+
+	template<class TAllocator>
+	bool DataReaderBase::ReadTerminatedStr(std::vector<char, TAllocator>& chars, size_t size)
+	{
+		if (size > 0)
+		{
+			chars.resize(size);
+			if (!ReadBytes(&chars[0], size))
+				return false;
+			if (chars[size - 1] != 0)
+				return false;
+			return true;
+		}
+		chars.clear();
+		return true;
+	}
+
+	template<class TAllocator>
+	bool DataReaderBase::ReadMaybeTerminatedStr(std::vector<char, TAllocator>& chars, size_t size)
+	{
+		if (size > 0)
+		{
+			chars.resize(size);
+			if (!ReadBytes(&chars[0], size))
+				return false;
+			if (chars[size - 1] == 0)
+				chars.resize(size - 1);
+			return true;
+		}
+		chars.clear();
+		return true;
+	}
+
+	template<class TAllocator>
+	bool DataReaderBase::ReadNonTerminatedStr(std::vector<char, TAllocator>& chars, size_t size)
+	{
+		if (size > 0)
+		{
+			chars.resize(size + 1);
+			chars[size] = 0;
+			return ReadBytes(&chars[0], size);
+		}
+		chars.clear();
+		return true;
+	}
+
+	inline bool DataReaderBase::ReadSwappable(uint64_t& v, bool byteSwap)
+	{
+		uint64_t result = 0;
+		if (!ReadRaw(&result, 8))
+			return false;
+
+		v = byteSwap ? endian::SwapU64(result) : result;
+		return true;
+	}
+
+	inline bool DataReaderBase::ReadSwappable(int64_t& v, bool byteSwap)
+	{
+		int64_t result = 0;
+		if (!ReadRaw(&result, 8))
+			return false;
+
+		v = byteSwap ? endian::SwapS64(result) : result;
+		return true;
+	}
+
+	inline bool DataReaderBase::ReadSwappable(uint32_t& v, bool byteSwap)
+	{
+		uint32_t result = 0;
+		if (!ReadRaw(&result, 4))
+			return false;
+
+		v = byteSwap ? endian::SwapU32(result) : result;
+		return true;
+	}
+
+	inline bool DataReaderBase::ReadSwappable(int32_t& v, bool byteSwap)
+	{
+		int32_t result = 0;
+		if (!ReadRaw(&result, 4))
+			return false;
+
+		v = byteSwap ? endian::SwapS32(result) : result;
+		return true;
+	}
+
+	inline bool DataReaderBase::ReadSwappable(uint16_t& v, bool byteSwap)
+	{
+		uint16_t result = 0;
+		if (!ReadRaw(&result, 2))
+			return false;
+
+		v = byteSwap ? endian::SwapU16(result) : result;
+		return true;
+	}
+
+	inline bool DataReaderBase::ReadSwappable(int16_t& v, bool byteSwap)
+	{
+		int16_t result = 0;
+		if (!ReadRaw(&result, 2))
+			return false;
+
+		v = byteSwap ? endian::SwapS16(result) : result;
+		return true;
+	}
+
+	template<bool TByteSwap>
+	inline FixedByteOrderDataReader<TByteSwap>::FixedByteOrderDataReader(IOStream& stream)
+		: DataReaderBase(stream)
+	{
+	}
+
+	template<bool TByteSwap>
+	inline bool FixedByteOrderDataReader<TByteSwap>::ReadU64(uint64_t& v)
+	{
+		return ReadSwappable(v, TByteSwap);
+	}
+
+	template<bool TByteSwap>
+	inline bool FixedByteOrderDataReader<TByteSwap>::ReadS64(int64_t& v)
+	{
+		return ReadSwappable(v, TByteSwap);
+	}
+
+	template<bool TByteSwap>
+	inline bool FixedByteOrderDataReader<TByteSwap>::ReadU32(uint32_t& v)
+	{
+		return ReadSwappable(v, TByteSwap);
+	}
+
+	template<bool TByteSwap>
+	inline bool FixedByteOrderDataReader<TByteSwap>::ReadS32(int32_t& v)
+	{
+		return ReadSwappable(v, TByteSwap);
+	}
+
+	template<bool TByteSwap>
+	inline bool FixedByteOrderDataReader<TByteSwap>::ReadU16(uint16_t& v)
+	{
+		return ReadSwappable(v, TByteSwap);
+	}
+
+	template<bool TByteSwap>
+	inline bool FixedByteOrderDataReader<TByteSwap>::ReadS16(int16_t& v)
+	{
+		return ReadSwappable(v, TByteSwap);
+	}
+
+	template<bool TByteSwap>
+	inline bool FixedByteOrderDataReader<TByteSwap>::ReadF64(double& v)
+	{
+		uint64_t u64;
+		if (!ReadSwappable(u64, TByteSwap))
+			return false;
+
+		memcpy(&v, &u64, 8);
+		return true;
+	}
+
+	template<bool TByteSwap>
+	inline bool FixedByteOrderDataReader<TByteSwap>::ReadF80BE(double& v)
+	{
+		uint16_t signAndExponent;
+		uint64_t mantissa;
+		if (!ReadSwappable(signAndExponent, TByteSwap) || !ReadSwappable(mantissa, TByteSwap))
+			return false;
+
+		v = ConvertF80(signAndExponent, mantissa);
+		return true;
+	}
+
+	template<bool TByteSwap>
+	inline bool FixedByteOrderDataReader<TByteSwap>::ReadF32(float& v)
+	{
+		uint32_t u32;
+		if (!ReadSwappable(u32, TByteSwap))
+			return false;
+
+		memcpy(&v, &u32, 4);
+		return true;
+	}
+
+	template<bool TByteSwap>
+	inline bool FixedByteOrderDataReader<TByteSwap>::ReadPStr16(std::string& str)
+	{
+		uint16_t length = 0;
+		if (!ReadSwappable(length, TByteSwap))
+			return false;
+
+		return ReadPStr16Body(str, length);
+	}
+
+	inline DataReader::DataReader(IOStream& stream, bool byteSwap)
+		: DataReaderBase(stream)
+		, m_byteSwap(byteSwap)
+	{
+	}
+
+	inline bool DataReader::ReadU64(uint64_t& v)
+	{
+		return ReadSwappable(v, m_byteSwap);
+	}
+
+	inline bool DataReader::ReadS64(int64_t& v)
+	{
+		return ReadSwappable(v, m_byteSwap);
+	}
+
+	inline bool DataReader::ReadU32(uint32_t& v)
+	{
+		return ReadSwappable(v, m_byteSwap);
+	}
+
+	inline bool DataReader::ReadS32(int32_t& v)
+	{
+		return ReadSwappable(v, m_byteSwap);
+	}
+
+	inline bool DataReader::ReadU16(uint16_t& v)
+	{
+		return ReadSwappable(v, m_byteSwap);
+	}
+
+	inline bool DataReader::ReadS16(int16_t& v)
+	{
+		return ReadSwappable(v, m_byteSwap);
+	}
+
+	inline bool DataReader::ReadF64(double& v)
+	{
+		uint64_t u64;
+		if (!ReadSwappable(u64, m_byteSwap))
+			return false;
+
+		memcpy(&v, &u64, 8);
+		return true;
+	}
+
+	inline bool DataReader::ReadF80BE(double& v)
+	{
+		uint16_t signAndExponent;
+		uint64_t mantissa;
+		if (!ReadSwappable(signAndExponent, m_byteSwap) || !ReadSwappable(mantissa, m_byteSwap))
+			return false;
+
+		v = ConvertF80(signAndExponent, mantissa);
+		return true;
+	}
+
+	inline bool DataReader::ReadF32(float& v)
+	{
+		uint32_t u32;
+		if (!ReadSwappable(u32, m_byteSwap))
+			return false;
+
+		memcpy(&v, &u32, 4);
+		return true;
+	}
+
+	inline bool DataReader::ReadPStr16(std::string& str)
+	{
+		uint16_t length = 0;
+		if (!ReadSwappable(length, m_byteSwap))
+			return false;
+
+		return ReadPStr16Body(str, length);
+	}
 }
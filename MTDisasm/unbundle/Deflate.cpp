@@ -0,0 +1,456 @@
+#include "Deflate.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mtdisasm
+{
+	namespace
+	{
+		const size_t kWindowSize = 32768;
+		const size_t kWindowMask = kWindowSize - 1;
+		const size_t kHashBits = 15;
+		const size_t kMinMatch = 3;
+		const size_t kMaxMatch = 258;
+		const size_t kMaxStoredBlockSize = 65535;
+
+		// Lazy matching only looks for a better match after a short one
+		const size_t kMaxLazyMatch = 32;
+
+		const uint16_t kLengthBases[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		const uint8_t kLengthExtraBits[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		const uint16_t kDistanceBases[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		const uint8_t kDistanceExtraBits[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+		// Bits to write for a code, already reversed to the order deflate writes them in
+		struct FixedCode
+		{
+			uint32_t m_bits;
+			uint32_t m_numBits;
+		};
+
+		// The fixed Huffman codes for every literal and every match length with its extra
+		// bits, and the distance code for every distance
+		struct FixedCodeTables
+		{
+			FixedCode m_literals[257];
+			FixedCode m_lengths[kMaxMatch + 1];
+			uint8_t m_distanceCodes[512];
+
+			FixedCodeTables();
+		};
+
+		uint32_t ReverseBits(uint32_t bits, uint32_t numBits)
+		{
+			uint32_t reversed = 0;
+			for (uint32_t i = 0; i < numBits; i++)
+				reversed |= ((bits >> i) & 1) << (numBits - 1 - i);
+			return reversed;
+		}
+
+		FixedCode GetFixedLiteralLengthCode(uint32_t symbol)
+		{
+			FixedCode code;
+			if (symbol < 144)
+			{
+				code.m_bits = ReverseBits(0x30 + symbol, 8);
+				code.m_numBits = 8;
+			}
+			else if (symbol < 256)
+			{
+				code.m_bits = ReverseBits(0x190 + symbol - 144, 9);
+				code.m_numBits = 9;
+			}
+			else if (symbol < 280)
+			{
+				code.m_bits = ReverseBits(symbol - 256, 7);
+				code.m_numBits = 7;
+			}
+			else
+			{
+				code.m_bits = ReverseBits(0xc0 + symbol - 280, 8);
+				code.m_numBits = 8;
+			}
+
+			return code;
+		}
+
+		FixedCodeTables::FixedCodeTables()
+		{
+			for (uint32_t i = 0; i < 257; i++)
+				m_literals[i] = GetFixedLiteralLengthCode(i);
+
+			m_lengths[0].m_bits = 0;
+			m_lengths[0].m_numBits = 0;
+			m_lengths[1] = m_lengths[0];
+			m_lengths[2] = m_lengths[0];
+
+			for (uint32_t lengthCode = 0; lengthCode < 29; lengthCode++)
+			{
+				const FixedCode symbolCode = GetFixedLiteralLengthCode(257 + lengthCode);
+				const uint32_t numLengths = (lengthCode == 28) ? 1 : (1u << kLengthExtraBits[lengthCode]);
+
+				for (uint32_t extra = 0; extra < numLengths; extra++)
+				{
+					const size_t length = kLengthBases[lengthCode] + extra;
+
+					// Length 258 has its own code, so the longest length of code 27 isn't used
+					if (length > kMaxMatch || (length == kMaxMatch && lengthCode != 28))
+						continue;
+
+					m_lengths[length].m_bits = symbolCode.m_bits | (extra << symbolCode.m_numBits);
+					m_lengths[length].m_numBits = symbolCode.m_numBits + kLengthExtraBits[lengthCode];
+				}
+			}
+
+			// Distances up to 256 are looked up directly and longer ones by their top bits
+			for (uint8_t distanceCode = 0; distanceCode < 30; distanceCode++)
+			{
+				const uint32_t first = kDistanceBases[distanceCode] - 1;
+				const uint32_t last = first + (1u << kDistanceExtraBits[distanceCode]);
+				for (uint32_t d = first; d < last; d++)
+				{
+					if (d < 256)
+						m_distanceCodes[d] = distanceCode;
+					else
+						m_distanceCodes[256 + (d >> 7)] = distanceCode;
+				}
+			}
+		}
+
+		const FixedCodeTables& GetFixedCodeTables()
+		{
+			static const FixedCodeTables tables;
+			return tables;
+		}
+
+		inline uint32_t HashAt(const uint8_t* bytes)
+		{
+			const uint32_t key = (static_cast<uint32_t>(bytes[0]) << 16) | (static_cast<uint32_t>(bytes[1]) << 8) | bytes[2];
+			return (key * 2654435761u) >> (32 - kHashBits);
+		}
+
+		inline size_t MatchLength(const uint8_t* a, const uint8_t* b, size_t maxLength)
+		{
+			size_t length = 0;
+			while (length + 8 <= maxLength)
+			{
+				uint64_t wordA;
+				uint64_t wordB;
+				memcpy(&wordA, a + length, 8);
+				memcpy(&wordB, b + length, 8);
+				if (wordA != wordB)
+					break;
+				length += 8;
+			}
+
+			while (length < maxLength && a[length] == b[length])
+				length++;
+
+			return length;
+		}
+	}
+
+	// Writes bits least significant first into output that was already sized for them
+	class DeflateCompressor::BitWriter
+	{
+	public:
+		BitWriter(uint8_t* dest)
+			: m_dest(dest)
+			, m_pos(0)
+			, m_bits(0)
+			, m_numBits(0)
+		{
+		}
+
+		// numBits can be up to 32
+		inline void Put(uint32_t bits, uint32_t numBits)
+		{
+			m_bits |= static_cast<uint64_t>(bits) << m_numBits;
+			m_numBits += numBits;
+			if (m_numBits >= 32)
+			{
+				m_dest[m_pos + 0] = static_cast<uint8_t>(m_bits);
+				m_dest[m_pos + 1] = static_cast<uint8_t>(m_bits >> 8);
+				m_dest[m_pos + 2] = static_cast<uint8_t>(m_bits >> 16);
+				m_dest[m_pos + 3] = static_cast<uint8_t>(m_bits >> 24);
+				m_pos += 4;
+				m_bits >>= 32;
+				m_numBits -= 32;
+			}
+		}
+
+		// Pads with zero bits to the next byte
+		void Align()
+		{
+			while (m_numBits > 0)
+			{
+				m_dest[m_pos++] = static_cast<uint8_t>(m_bits);
+				m_bits >>= 8;
+				m_numBits = (m_numBits > 8) ? (m_numBits - 8) : 0;
+			}
+
+			m_bits = 0;
+		}
+
+		void PutBytes(const uint8_t* bytes, size_t size)
+		{
+			Align();
+			if (size > 0)
+				memcpy(m_dest + m_pos, bytes, size);
+			m_pos += size;
+		}
+
+		size_t GetSize() const
+		{
+			return m_pos;
+		}
+
+	private:
+		uint8_t* m_dest;
+		size_t m_pos;
+		uint64_t m_bits;
+		uint32_t m_numBits;
+	};
+
+	DeflateCompressor::DeflateCompressor(int level)
+		: m_level(level)
+		, m_maxChainLength(1)
+		, m_isLazy(false)
+	{
+		if (m_level < 0)
+			m_level = 0;
+		else if (m_level > kMaxLevel)
+			m_level = kMaxLevel;
+
+		if (m_level >= 2)
+			m_maxChainLength = 8;
+		if (m_level >= 3)
+		{
+			m_maxChainLength = 32;
+			m_isLazy = true;
+		}
+
+		if (m_level > 0)
+			m_hashHeads.resize(static_cast<size_t>(1) << kHashBits);
+		if (m_maxChainLength > 1)
+			m_hashChain.resize(kWindowSize);
+	}
+
+	void DeflateCompressor::Compress(const uint8_t* data, size_t size, bool isLast, std::vector<uint8_t>& output)
+	{
+		if (m_level == 0)
+			CompressStored(data, size, isLast, output);
+		else
+			CompressFixed(data, size, isLast, output);
+	}
+
+	void DeflateCompressor::CompressStored(const uint8_t* data, size_t size, bool isLast, std::vector<uint8_t>& output)
+	{
+		const size_t numBlocks = std::max<size_t>(1, (size + kMaxStoredBlockSize - 1) / kMaxStoredBlockSize);
+		const size_t startSize = output.size();
+		output.resize(startSize + size + numBlocks * 5 + 8);
+
+		BitWriter writer(output.data() + startSize);
+
+		size_t pos = 0;
+		for (size_t i = 0; i < numBlocks; i++)
+		{
+			const size_t blockSize = std::min(size - pos, kMaxStoredBlockSize);
+			const bool isLastBlock = (isLast && i == numBlocks - 1);
+
+			writer.Put(isLastBlock ? 1 : 0, 1);
+			writer.Put(0, 2);
+			writer.Align();
+
+			const uint8_t lengths[4] = { static_cast<uint8_t>(blockSize), static_cast<uint8_t>(blockSize >> 8), static_cast<uint8_t>(~blockSize), static_cast<uint8_t>(~blockSize >> 8) };
+			writer.PutBytes(lengths, 4);
+			writer.PutBytes(data + pos, blockSize);
+
+			pos += blockSize;
+		}
+
+		output.resize(startSize + writer.GetSize());
+	}
+
+	void DeflateCompressor::CompressFixed(const uint8_t* data, size_t size, bool isLast, std::vector<uint8_t>& output)
+	{
+		const FixedCodeTables& tables = GetFixedCodeTables();
+
+		std::fill(m_hashHeads.begin(), m_hashHeads.end(), 0);
+
+		// No code is longer than 9 bits per byte, plus the block header, end code, and an
+		// empty stored block
+		const size_t startSize = output.size();
+		output.resize(startSize + size + size / 8 + 16);
+
+		BitWriter writer(output.data() + startSize);
+
+		writer.Put(isLast ? 1 : 0, 1);
+		writer.Put(1, 2);
+
+		const size_t hashEnd = (size >= kMinMatch) ? (size - kMinMatch + 1) : 0;
+		size_t nextInsert = 0;
+
+		size_t pos = 0;
+		while (pos < size)
+		{
+			while (nextInsert < pos && nextInsert < hashEnd)
+				InsertHash(data, nextInsert++);
+
+			size_t distance = 0;
+			size_t length = FindMatch(data, size, pos, distance);
+
+			if (m_isLazy && length >= kMinMatch && length < kMaxLazyMatch && pos + 1 < size)
+			{
+				if (nextInsert == pos && nextInsert < hashEnd)
+					InsertHash(data, nextInsert++);
+
+				size_t nextDistance = 0;
+				const size_t nextLength = FindMatch(data, size, pos + 1, nextDistance);
+				if (nextLength > length)
+				{
+					const FixedCode& code = tables.m_literals[data[pos]];
+					writer.Put(code.m_bits, code.m_numBits);
+					pos++;
+
+					length = nextLength;
+					distance = nextDistance;
+				}
+			}
+
+			if (length >= kMinMatch)
+			{
+				const FixedCode& lengthCode = tables.m_lengths[length];
+				writer.Put(lengthCode.m_bits, lengthCode.m_numBits);
+
+				const size_t distanceIndex = distance - 1;
+				const uint8_t distanceCode = (distanceIndex < 256) ? tables.m_distanceCodes[distanceIndex] : tables.m_distanceCodes[256 + (distanceIndex >> 7)];
+				const uint32_t distanceExtra = static_cast<uint32_t>(distance - kDistanceBases[distanceCode]);
+				writer.Put(ReverseBits(distanceCode, 5) | (distanceExtra << 5), 5 + kDistanceExtraBits[distanceCode]);
+
+				pos += length;
+			}
+			else
+			{
+				const FixedCode& code = tables.m_literals[data[pos]];
+				writer.Put(code.m_bits, code.m_numBits);
+				pos++;
+			}
+		}
+
+		const FixedCode& endCode = tables.m_literals[256];
+		writer.Put(endCode.m_bits, endCode.m_numBits);
+
+		if (!isLast)
+		{
+			static const uint8_t kEmptyStoredLengths[4] = { 0, 0, 0xff, 0xff };
+
+			writer.Put(0, 3);
+			writer.PutBytes(kEmptyStoredLengths, 4);
+		}
+
+		writer.Align();
+
+		output.resize(startSize + writer.GetSize());
+	}
+
+	size_t DeflateCompressor::FindMatch(const uint8_t* data, size_t size, size_t pos, size_t& outDistance) const
+	{
+		const size_t maxLength = std::min(size - pos, kMaxMatch);
+		if (maxLength < kMinMatch)
+			return 0;
+
+		size_t bestLength = 0;
+		uint32_t candidateLink = m_hashHeads[HashAt(data + pos)];
+
+		for (size_t i = 0; i < m_maxChainLength && candidateLink != 0; i++)
+		{
+			const size_t candidate = candidateLink - 1;
+			if (candidate >= pos || pos - candidate > kWindowSize)
+				break;
+
+			// Only a match longer than the best one so far can be worth comparing
+			if (data[candidate + bestLength] == data[pos + bestLength])
+			{
+				const size_t length = MatchLength(data + candidate, data + pos, maxLength);
+				if (length > bestLength)
+				{
+					bestLength = length;
+					outDistance = pos - candidate;
+					if (length == maxLength)
+						break;
+				}
+			}
+
+			if (m_hashChain.empty())
+				break;
+
+			// Entries overwritten by newer positions in the window end the chain
+			const uint32_t previousLink = m_hashChain[candidate & kWindowMask];
+			if (previousLink >= candidateLink)
+				break;
+
+			candidateLink = previousLink;
+		}
+
+		return (bestLength >= kMinMatch) ? bestLength : 0;
+	}
+
+	void DeflateCompressor::InsertHash(const uint8_t* data, size_t pos)
+	{
+		uint32_t& head = m_hashHeads[HashAt(data + pos)];
+		if (!m_hashChain.empty())
+			m_hashChain[pos & kWindowMask] = head;
+		head = static_cast<uint32_t>(pos + 1);
+	}
+
+	uint32_t DeflateCompressor::Adler32(uint32_t adler, const uint8_t* data, size_t size)
+	{
+		// The most bytes that can be summed before the sums have to be reduced
+		const size_t kMaxRun = 5552;
+
+		uint32_t a = adler & 0xffff;
+		uint32_t b = adler >> 16;
+
+		while (size > 0)
+		{
+			const size_t runSize = std::min(size, kMaxRun);
+			for (size_t i = 0; i < runSize; i++)
+			{
+				a += data[i];
+				b += a;
+			}
+
+			a %= 65521;
+			b %= 65521;
+			data += runSize;
+			size -= runSize;
+		}
+
+		return (b << 16) | a;
+	}
+
+	uint32_t DeflateCompressor::CombineAdler32(uint32_t adler1, uint32_t adler2, size_t size2)
+	{
+		const uint32_t kBase = 65521;
+
+		const uint32_t remainder = static_cast<uint32_t>(size2 % kBase);
+		uint32_t a = adler1 & 0xffff;
+		uint32_t b = static_cast<uint32_t>((static_cast<uint64_t>(remainder) * a) % kBase);
+
+		a += (adler2 & 0xffff) + kBase - 1;
+		b += (adler1 >> 16) + (adler2 >> 16) + kBase - remainder;
+
+		if (a >= kBase)
+			a -= kBase;
+		if (a >= kBase)
+			a -= kBase;
+		if (b >= kBase * 2)
+			b -= kBase * 2;
+		if (b >= kBase)
+			b -= kBase;
+
+		return (b << 16) | a;
+	}
+}
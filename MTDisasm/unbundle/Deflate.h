@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mtdisasm
+{
+	// Deflate compressor for image data, using fixed Huffman codes like stb_image_write's.
+	// Each call compresses a separate buffer with no history from the one before it, so that
+	// buffers can be compressed on different threads and their outputs joined into one stream.
+	class DeflateCompressor
+	{
+	public:
+		// 0 stores the data uncompressed.  1 looks at one earlier match per position, 2 looks
+		// further back in the hash chain, and 3 also waits a byte for a longer match.
+		explicit DeflateCompressor(int level);
+
+		// Appends raw deflate blocks to output.  Unless isLast is set, they end with an empty
+		// stored block so that the next output starts on a byte boundary.
+		void Compress(const uint8_t* data, size_t size, bool isLast, std::vector<uint8_t>& output);
+
+		static uint32_t Adler32(uint32_t adler, const uint8_t* data, size_t size);
+
+		// Returns the Adler-32 of two buffers joined, given the second buffer's size
+		static uint32_t CombineAdler32(uint32_t adler1, uint32_t adler2, size_t size2);
+
+		static const int kMaxLevel = 3;
+
+	private:
+		class BitWriter;
+
+		void CompressStored(const uint8_t* data, size_t size, bool isLast, std::vector<uint8_t>& output);
+		void CompressFixed(const uint8_t* data, size_t size, bool isLast, std::vector<uint8_t>& output);
+
+		size_t FindMatch(const uint8_t* data, size_t size, size_t pos, size_t& outDistance) const;
+		void InsertHash(const uint8_t* data, size_t pos);
+
+		int m_level;
+		size_t m_maxChainLength;
+		bool m_isLazy;
+
+		std::vector<uint32_t> m_hashHeads;	// Position + 1 of the latest string with each hash
+		std::vector<uint32_t> m_hashChain;	// Position + 1 of the string before, by position in the window
+	};
+}
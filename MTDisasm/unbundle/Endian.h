@@ -2,15 +2,89 @@
 
 #include <cstdint>
 
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
+
 namespace mtdisasm
 {
 	namespace endian
 	{
-		uint64_t SwapU64(uint64_t v);
-		int64_t SwapS64(int64_t v);
-		uint32_t SwapU32(uint32_t v);
-		int32_t SwapS32(int32_t v);
-		uint16_t SwapU16(uint16_t v);
-		int16_t SwapS16(int16_t v);
+		inline uint64_t SwapU64(uint64_t v);
+		inline int64_t SwapS64(int64_t v);
+		inline uint32_t SwapU32(uint32_t v);
+		inline int32_t SwapS32(int32_t v);
+		inline uint16_t SwapU16(uint16_t v);
+		inline int16_t SwapS16(int16_t v);
+	}
+}
+
+#ifdef _MSC_VER
+
+namespace mtdisasm
+{
+	inline uint64_t endian::SwapU64(uint64_t v)
+	{
+		return _byteswap_uint64(v);
+	}
+
+	inline int64_t endian::SwapS64(int64_t v)
+	{
+		return static_cast<int64_t>(_byteswap_uint64(static_cast<uint64_t>(v)));
+	}
+
+	inline uint32_t endian::SwapU32(uint32_t v)
+	{
+		return _byteswap_ulong(v);
+	}
+
+	inline int32_t endian::SwapS32(int32_t v)
+	{
+		return static_cast<int32_t>(_byteswap_ulong(static_cast<uint32_t>(v)));
+	}
+
+	inline uint16_t endian::SwapU16(uint16_t v)
+	{
+		return _byteswap_ushort(v);
+	}
+
+	inline int16_t endian::SwapS16(int16_t v)
+	{
+		return static_cast<int16_t>(_byteswap_ushort(static_cast<uint16_t>(v)));
+	}
+}
+#else
+
+namespace mtdisasm
+{
+	inline uint64_t endian::SwapU64(uint64_t v)
+	{
+		return __builtin_bswap64(v);
+	}
+
+	inline int64_t endian::SwapS64(int64_t v)
+	{
+		return static_cast<int64_t>(__builtin_bswap64(static_cast<uint64_t>(v)));
+	}
+
+	inline uint32_t endian::SwapU32(uint32_t v)
+	{
+		return __builtin_bswap32(v);
+	}
+
+	inline int32_t endian::SwapS32(int32_t v)
+	{
+		return static_cast<int32_t>(__builtin_bswap32(static_cast<uint32_t>(v)));
+	}
+
+	inline uint16_t endian::SwapU16(uint16_t v)
+	{
+		return __builtin_bswap16(v);
+	}
+
+	inline int16_t endian::SwapS16(int16_t v)
+	{
+		return static_cast<int16_t>(__builtin_bswap16(static_cast<uint16_t>(v)));
 	}
 }
+#endif
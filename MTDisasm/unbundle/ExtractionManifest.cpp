@@ -0,0 +1,385 @@
+#include "ExtractionManifest.h"
+
+#include "IOStream.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mtdisasm
+{
+	namespace
+	{
+		const uint32_t kByteOrderMark = 0x01020304;
+
+		const size_t kHashReadChunkSize = 256 * 1024;
+
+		static_assert(sizeof(ExtractionSettings) == 16, "Manifest settings layout changed");
+		static_assert(sizeof(ExtractionManifestHeader) == 48, "Manifest header layout changed");
+		static_assert(sizeof(ExtractionManifestStream) == 40, "Manifest stream layout changed");
+		static_assert(sizeof(ExtractionManifestAsset) == 24, "Manifest asset layout changed");
+
+		const uint64_t kPrime1 = 0x9e3779b185ebca87ull;
+		const uint64_t kPrime2 = 0xc2b2ae3d27d4eb4full;
+		const uint64_t kPrime3 = 0x165667b19e3779f9ull;
+		const uint64_t kPrime4 = 0x85ebca77c2b2ae63ull;
+		const uint64_t kPrime5 = 0x27d4eb2f165667c5ull;
+
+		inline uint64_t RotateLeft(uint64_t value, int bits)
+		{
+			return (value << bits) | (value >> (64 - bits));
+		}
+
+		// Words are loaded in native byte order, which the manifest is tied to anyway
+		inline uint64_t Load64(const uint8_t* bytes)
+		{
+			uint64_t value;
+			memcpy(&value, bytes, 8);
+			return value;
+		}
+
+		inline uint32_t Load32(const uint8_t* bytes)
+		{
+			uint32_t value;
+			memcpy(&value, bytes, 4);
+			return value;
+		}
+
+		inline uint64_t HashRound(uint64_t acc, uint64_t input)
+		{
+			acc += input * kPrime2;
+			acc = RotateLeft(acc, 31);
+			return acc * kPrime1;
+		}
+
+		inline uint64_t MergeRound(uint64_t acc, uint64_t lane)
+		{
+			acc ^= HashRound(0, lane);
+			return acc * kPrime1 + kPrime4;
+		}
+
+		// XXH64 of data that arrives in pieces of any size
+		class ContentHasher
+		{
+		public:
+			explicit ContentHasher(uint64_t seed);
+
+			void Update(const void* data, size_t size);
+			uint64_t Finish() const;
+
+		private:
+			static const size_t kStripeSize = 32;
+
+			void ConsumeStripe(const uint8_t* stripe);
+
+			uint64_t m_lanes[4];
+			uint64_t m_seed;
+			uint64_t m_totalSize;
+			uint8_t m_pending[kStripeSize];
+			size_t m_numPending;
+		};
+
+		ContentHasher::ContentHasher(uint64_t seed)
+			: m_seed(seed)
+			, m_totalSize(0)
+			, m_numPending(0)
+		{
+			m_lanes[0] = seed + kPrime1 + kPrime2;
+			m_lanes[1] = seed + kPrime2;
+			m_lanes[2] = seed;
+			m_lanes[3] = seed - kPrime1;
+		}
+
+		void ContentHasher::Update(const void* data, size_t size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			m_totalSize += size;
+
+			if (m_numPending > 0)
+			{
+				size_t numToFill = std::min(kStripeSize - m_numPending, size);
+				memcpy(m_pending + m_numPending, bytes, numToFill);
+				m_numPending += numToFill;
+				bytes += numToFill;
+				size -= numToFill;
+
+				if (m_numPending < kStripeSize)
+					return;
+
+				ConsumeStripe(m_pending);
+				m_numPending = 0;
+			}
+
+			while (size >= kStripeSize)
+			{
+				ConsumeStripe(bytes);
+				bytes += kStripeSize;
+				size -= kStripeSize;
+			}
+
+			if (size > 0)
+			{
+				memcpy(m_pending, bytes, size);
+				m_numPending = size;
+			}
+		}
+
+		uint64_t ContentHasher::Finish() const
+		{
+			uint64_t hash = 0;
+			if (m_totalSize >= kStripeSize)
+			{
+				hash = RotateLeft(m_lanes[0], 1) + RotateLeft(m_lanes[1], 7) + RotateLeft(m_lanes[2], 12) + RotateLeft(m_lanes[3], 18);
+				for (int i = 0; i < 4; i++)
+					hash = MergeRound(hash, m_lanes[i]);
+			}
+			else
+				hash = m_seed + kPrime5;
+
+			hash += m_totalSize;
+
+			const uint8_t* bytes = m_pending;
+			size_t remaining = m_numPending;
+			while (remaining >= 8)
+			{
+				hash ^= HashRound(0, Load64(bytes));
+				hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+				bytes += 8;
+				remaining -= 8;
+			}
+
+			if (remaining >= 4)
+			{
+				hash ^= static_cast<uint64_t>(Load32(bytes)) * kPrime1;
+				hash = RotateLeft(hash, 23) * kPrime2 + kPrime3;
+				bytes += 4;
+				remaining -= 4;
+			}
+
+			while (remaining > 0)
+			{
+				hash ^= (*bytes) * kPrime5;
+				hash = RotateLeft(hash, 11) * kPrime1;
+				bytes++;
+				remaining--;
+			}
+
+			hash ^= hash >> 33;
+			hash *= kPrime2;
+			hash ^= hash >> 29;
+			hash *= kPrime3;
+			hash ^= hash >> 32;
+
+			return hash;
+		}
+
+		void ContentHasher::ConsumeStripe(const uint8_t* stripe)
+		{
+			for (int i = 0; i < 4; i++)
+				m_lanes[i] = HashRound(m_lanes[i], Load64(stripe + i * 8));
+		}
+	}
+
+	ExtractionManifest::ExtractionManifest()
+	{
+		memset(&m_header, 0, sizeof(m_header));
+		memcpy(m_header.m_magic, "MTXM", 4);
+		m_header.m_version = kVersion;
+		m_header.m_byteOrderMark = kByteOrderMark;
+	}
+
+	bool ExtractionManifest::Load(FILE* f)
+	{
+		std::vector<uint8_t> data;
+		uint8_t chunk[16 * 1024];
+		for (;;)
+		{
+			size_t numRead = fread(chunk, 1, sizeof(chunk), f);
+			data.insert(data.end(), chunk, chunk + numRead);
+			if (numRead < sizeof(chunk))
+				break;
+		}
+
+		if (ferror(f) || data.size() < sizeof(ExtractionManifestHeader))
+			return false;
+
+		ExtractionManifestHeader header;
+		memcpy(&header, &data[0], sizeof(header));
+		if (memcmp(header.m_magic, "MTXM", 4) != 0 || header.m_version != kVersion || header.m_byteOrderMark != kByteOrderMark)
+			return false;
+
+		const uint64_t keysOffset = sizeof(ExtractionManifestHeader);
+		const uint64_t streamsOffset = keysOffset + static_cast<uint64_t>(header.m_numSegments) * sizeof(ObjectIndexSegmentKey);
+		const uint64_t assetsOffset = streamsOffset + static_cast<uint64_t>(header.m_numStreams) * sizeof(ExtractionManifestStream);
+		const uint64_t totalSize = assetsOffset + static_cast<uint64_t>(header.m_numAssets) * sizeof(ExtractionManifestAsset);
+
+		if (totalSize != data.size())
+			return false;
+
+		std::vector<ObjectIndexSegmentKey> segmentKeys(header.m_numSegments);
+		std::vector<ExtractionManifestStream> streams(header.m_numStreams);
+		std::vector<ExtractionManifestAsset> assets(header.m_numAssets);
+
+		if (!segmentKeys.empty())
+			memcpy(&segmentKeys[0], &data[keysOffset], segmentKeys.size() * sizeof(ObjectIndexSegmentKey));
+		if (!streams.empty())
+			memcpy(&streams[0], &data[streamsOffset], streams.size() * sizeof(ExtractionManifestStream));
+		if (!assets.empty())
+			memcpy(&assets[0], &data[assetsOffset], assets.size() * sizeof(ExtractionManifestAsset));
+
+		for (const ExtractionManifestStream& stream : streams)
+		{
+			if (stream.m_firstAsset > header.m_numAssets || stream.m_numAssets > header.m_numAssets - stream.m_firstAsset)
+				return false;
+		}
+
+		m_header = header;
+		m_segmentKeys.swap(segmentKeys);
+		m_streams.swap(streams);
+		m_assets.swap(assets);
+
+		return true;
+	}
+
+	bool ExtractionManifest::Save(FILE* f) const
+	{
+		if (fwrite(&m_header, sizeof(m_header), 1, f) != 1)
+			return false;
+
+		if (!m_segmentKeys.empty() && fwrite(&m_segmentKeys[0], sizeof(ObjectIndexSegmentKey), m_segmentKeys.size(), f) != m_segmentKeys.size())
+			return false;
+		if (!m_streams.empty() && fwrite(&m_streams[0], sizeof(ExtractionManifestStream), m_streams.size(), f) != m_streams.size())
+			return false;
+		if (!m_assets.empty() && fwrite(&m_assets[0], sizeof(ExtractionManifestAsset), m_assets.size(), f) != m_assets.size())
+			return false;
+
+		return true;
+	}
+
+	bool ExtractionManifest::HasSettings(const ExtractionSettings& settings) const
+	{
+		const ExtractionSettings& mySettings = m_header.m_settings;
+
+		return mySettings.m_mode == settings.m_mode
+			&& mySettings.m_systemType == settings.m_systemType
+			&& mySettings.m_is112Compatible == settings.m_is112Compatible
+			&& mySettings.m_isByteSwapped == settings.m_isByteSwapped
+			&& mySettings.m_mtoonFrameMode == settings.m_mtoonFrameMode
+			&& mySettings.m_imageEncoder == settings.m_imageEncoder
+			&& mySettings.m_imageLevel == settings.m_imageLevel
+			&& mySettings.m_typeFilterHash == settings.m_typeFilterHash;
+	}
+
+	void ExtractionManifest::SetSettings(const ExtractionSettings& settings)
+	{
+		m_header.m_settings = settings;
+		m_header.m_settings.m_unused07 = 0;
+	}
+
+	uint64_t ExtractionManifest::GetCatalogHash() const
+	{
+		return m_header.m_catalogHash;
+	}
+
+	void ExtractionManifest::SetCatalogHash(uint64_t catalogHash)
+	{
+		m_header.m_catalogHash = catalogHash;
+	}
+
+	size_t ExtractionManifest::NumSegments() const
+	{
+		return m_segmentKeys.size();
+	}
+
+	const ObjectIndexSegmentKey& ExtractionManifest::GetSegmentKey(size_t index) const
+	{
+		return m_segmentKeys[index];
+	}
+
+	void ExtractionManifest::SetSegmentKeys(const std::vector<ObjectIndexSegmentKey>& segmentKeys)
+	{
+		m_segmentKeys = segmentKeys;
+		m_header.m_numSegments = static_cast<uint32_t>(segmentKeys.size());
+	}
+
+	size_t ExtractionManifest::NumStreams() const
+	{
+		return m_streams.size();
+	}
+
+	const ExtractionManifestStream& ExtractionManifest::GetStream(size_t index) const
+	{
+		return m_streams[index];
+	}
+
+	const ExtractionManifestAsset& ExtractionManifest::GetAsset(size_t index) const
+	{
+		return m_assets[index];
+	}
+
+	bool ExtractionManifest::AddStream(uint32_t segmentNumber, uint32_t pos, uint32_t size, uint32_t streamTypeHash, uint64_t contentHash, const std::vector<ExtractionManifestAsset>& assets, uint32_t numFailedAssets)
+	{
+		if (m_streams.size() >= UINT32_MAX || assets.size() > UINT32_MAX - m_assets.size())
+			return false;
+
+		ExtractionManifestStream stream;
+		stream.m_segmentNumber = segmentNumber;
+		stream.m_pos = pos;
+		stream.m_size = size;
+		stream.m_firstAsset = static_cast<uint32_t>(m_assets.size());
+		stream.m_numAssets = static_cast<uint32_t>(assets.size());
+		stream.m_streamTypeHash = streamTypeHash;
+		stream.m_numFailedAssets = numFailedAssets;
+		stream.m_unused1c = 0;
+		stream.m_contentHash = contentHash;
+
+		m_streams.push_back(stream);
+		m_assets.insert(m_assets.end(), assets.begin(), assets.end());
+
+		m_header.m_numStreams = static_cast<uint32_t>(m_streams.size());
+		m_header.m_numAssets = static_cast<uint32_t>(m_assets.size());
+
+		return true;
+	}
+
+	uint64_t ExtractionManifest::HashMemory(const void* data, size_t size, uint64_t seed)
+	{
+		ContentHasher hasher(seed);
+		hasher.Update(data, size);
+		return hasher.Finish();
+	}
+
+	bool ExtractionManifest::HashStreamRange(const IOStream& stream, uint32_t pos, size_t size, uint64_t seed, uint64_t& outHash)
+	{
+		ContentHasher hasher(seed);
+
+		const void* spanData = nullptr;
+		size_t spanSize = 0;
+		uint32_t spanGlobalBase = 0;
+		if (stream.GetContiguousSpan(spanData, spanSize, spanGlobalBase))
+		{
+			if (pos < spanGlobalBase || pos - spanGlobalBase > spanSize || size > spanSize - (pos - spanGlobalBase))
+				return false;
+
+			if (size > 0)
+				hasher.Update(static_cast<const uint8_t*>(spanData) + (pos - spanGlobalBase), size);
+		}
+		else
+		{
+			std::vector<uint8_t> buffer(std::min(size, kHashReadChunkSize));
+
+			size_t numHashed = 0;
+			while (numHashed < size)
+			{
+				size_t chunkSize = std::min(size - numHashed, buffer.size());
+				if (static_cast<uint64_t>(pos) + numHashed > UINT32_MAX || !stream.ReadAt(static_cast<uint32_t>(pos + numHashed), &buffer[0], chunkSize))
+					return false;
+
+				hasher.Update(&buffer[0], chunkSize);
+				numHashed += chunkSize;
+			}
+		}
+
+		outHash = hasher.Finish();
+		return true;
+	}
+}
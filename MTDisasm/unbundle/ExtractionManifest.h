@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "ObjectIndex.h"
+
+namespace mtdisasm
+{
+	struct IOStream;
+
+	enum class ExtractionMode : uint8_t
+	{
+		kBin,
+		kText,
+		kAssets,
+	};
+
+	// Everything other than the project that the outputs depend on.  Outputs written with
+	// different settings are all redone.
+	struct ExtractionSettings
+	{
+		ExtractionMode m_mode;
+		uint8_t m_systemType;
+		uint8_t m_is112Compatible;
+		uint8_t m_isByteSwapped;
+		uint8_t m_mtoonFrameMode;
+		uint8_t m_imageEncoder;
+		uint8_t m_imageLevel;
+		uint8_t m_unused07;
+		uint64_t m_typeFilterHash;
+	};
+
+	// Records what the outputs in a directory were extracted from, so that a later run can
+	// redo only the streams and assets that changed.  The file is the header followed by
+	// the segment keys, stream records, and asset records, all in native byte order.
+	struct ExtractionManifestHeader
+	{
+		char m_magic[4];			// "MTXM"
+		uint32_t m_version;
+		uint32_t m_byteOrderMark;	// 0x01020304 in the byte order of the machine that wrote it
+		uint32_t m_numSegments;
+		uint32_t m_numStreams;
+		uint32_t m_numAssets;
+		ExtractionSettings m_settings;
+		uint64_t m_catalogHash;
+	};
+
+	struct ExtractionManifestStream
+	{
+		uint32_t m_segmentNumber;
+		uint32_t m_pos;
+		uint32_t m_size;
+		uint32_t m_firstAsset;
+		uint32_t m_numAssets;
+		uint32_t m_streamTypeHash;	// The stream type names the output file
+		uint32_t m_numFailedAssets;	// Definitions left out because their assets failed to extract
+		uint32_t m_unused1c;
+		uint64_t m_contentHash;
+	};
+
+	// An asset definition in a stream, in the order they appear in the stream.  Payloads
+	// are usually stored outside of the stream that defines them, so they're hashed separately.
+	// Only assets that were extracted are listed.
+	struct ExtractionManifestAsset
+	{
+		uint32_t m_assetID;
+		uint32_t m_payloadPosition;
+		uint32_t m_payloadSize;
+		uint32_t m_numOutputFiles;	// Files named after the asset in the output directory
+		uint64_t m_payloadHash;
+	};
+
+	class ExtractionManifest
+	{
+	public:
+		ExtractionManifest();
+
+		// Fails if the file isn't a well-formed manifest of this version written in this
+		// machine's byte order
+		bool Load(FILE* f);
+		bool Save(FILE* f) const;
+
+		bool HasSettings(const ExtractionSettings& settings) const;
+		void SetSettings(const ExtractionSettings& settings);
+
+		uint64_t GetCatalogHash() const;
+		void SetCatalogHash(uint64_t catalogHash);
+
+		size_t NumSegments() const;
+		const ObjectIndexSegmentKey& GetSegmentKey(size_t index) const;
+		void SetSegmentKeys(const std::vector<ObjectIndexSegmentKey>& segmentKeys);
+
+		size_t NumStreams() const;
+		const ExtractionManifestStream& GetStream(size_t index) const;
+		const ExtractionManifestAsset& GetAsset(size_t index) const;
+
+		// Adds the next stream and the assets that it defines
+		bool AddStream(uint32_t segmentNumber, uint32_t pos, uint32_t size, uint32_t streamTypeHash, uint64_t contentHash, const std::vector<ExtractionManifestAsset>& assets, uint32_t numFailedAssets);
+
+		// XXH64
+		static uint64_t HashMemory(const void* data, size_t size, uint64_t seed);
+
+		// Hashes a range of a stream the same as HashMemory.  Reads it in place if the stream
+		// is in memory.
+		static bool HashStreamRange(const IOStream& stream, uint32_t pos, size_t size, uint64_t seed, uint64_t& outHash);
+
+		static const uint32_t kVersion = 2;
+
+	private:
+		ExtractionManifestHeader m_header;
+		std::vector<ObjectIndexSegmentKey> m_segmentKeys;
+		std::vector<ExtractionManifestStream> m_streams;
+		std::vector<ExtractionManifestAsset> m_assets;
+	};
+}
@@ -0,0 +1,179 @@
+#include "FileSystem.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <utility>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+namespace mtdisasm
+{
+	namespace
+	{
+		bool HasExtension(const std::string& name, const char* extension)
+		{
+			size_t extensionLength = strlen(extension);
+			if (name.size() <= extensionLength)
+				return false;
+
+			const char* nameExtension = name.c_str() + name.size() - extensionLength;
+			for (size_t i = 0; i < extensionLength; i++)
+			{
+				if (tolower(static_cast<unsigned char>(nameExtension[i])) != tolower(static_cast<unsigned char>(extension[i])))
+					return false;
+			}
+
+			return true;
+		}
+
+		// Directories are identified by device and inode so that symlinks that loop back
+		// to a directory being searched are only followed once.  Windows skips reparse points
+		// instead.
+		bool FindFilesWithExtensionInDir(const std::string& dirPath, const char* extension, std::set<std::pair<uint64_t, uint64_t>>& visitedDirs, std::vector<std::string>& outPaths)
+		{
+			std::vector<std::string> subdirPaths;
+
+#ifdef _WIN32
+			WIN32_FIND_DATAA findData;
+			HANDLE findHandle = FindFirstFileA((dirPath + "\\*").c_str(), &findData);
+			if (findHandle == INVALID_HANDLE_VALUE)
+				return false;
+
+			do
+			{
+				std::string name = findData.cFileName;
+				if (name == "." || name == "..")
+					continue;
+
+				std::string path = dirPath + "/" + name;
+				if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+				{
+					if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+						subdirPaths.push_back(path);
+				}
+				else if (HasExtension(name, extension))
+					outPaths.push_back(path);
+			} while (FindNextFileA(findHandle, &findData));
+
+			FindClose(findHandle);
+#else
+			struct stat dirStat;
+			if (stat(dirPath.c_str(), &dirStat) != 0)
+				return false;
+
+			if (!visitedDirs.insert(std::make_pair(static_cast<uint64_t>(dirStat.st_dev), static_cast<uint64_t>(dirStat.st_ino))).second)
+				return true;
+
+			DIR* dir = opendir(dirPath.c_str());
+			if (!dir)
+				return false;
+
+			while (struct dirent* entry = readdir(dir))
+			{
+				std::string name = entry->d_name;
+				if (name == "." || name == "..")
+					continue;
+
+				std::string path = dirPath + "/" + name;
+				if (IsDirectory(path))
+					subdirPaths.push_back(path);
+				else if (HasExtension(name, extension))
+					outPaths.push_back(path);
+			}
+
+			closedir(dir);
+#endif
+
+			for (const std::string& subdirPath : subdirPaths)
+			{
+				if (!FindFilesWithExtensionInDir(subdirPath, extension, visitedDirs, outPaths))
+					return false;
+			}
+
+			return true;
+		}
+	}
+
+	bool IsDirectory(const std::string& path)
+	{
+#ifdef _WIN32
+		struct _stat64 st;
+		if (_stat64(path.c_str(), &st) != 0)
+			return false;
+
+		return (st.st_mode & _S_IFDIR) != 0;
+#else
+		struct stat st;
+		if (stat(path.c_str(), &st) != 0)
+			return false;
+
+		return S_ISDIR(st.st_mode);
+#endif
+	}
+
+	bool MakeDirectory(const std::string& path)
+	{
+#ifdef _WIN32
+		if (_mkdir(path.c_str()) == 0)
+			return true;
+#else
+		if (mkdir(path.c_str(), 0777) == 0)
+			return true;
+#endif
+
+		return errno == EEXIST && IsDirectory(path);
+	}
+
+	bool ListFiles(const std::string& dirPath, std::vector<std::string>& outNames)
+	{
+#ifdef _WIN32
+		WIN32_FIND_DATAA findData;
+		HANDLE findHandle = FindFirstFileA((dirPath + "\\*").c_str(), &findData);
+		if (findHandle == INVALID_HANDLE_VALUE)
+			return false;
+
+		do
+		{
+			if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+				outNames.push_back(findData.cFileName);
+		} while (FindNextFileA(findHandle, &findData));
+
+		FindClose(findHandle);
+#else
+		DIR* dir = opendir(dirPath.c_str());
+		if (!dir)
+			return false;
+
+		while (struct dirent* entry = readdir(dir))
+		{
+			std::string name = entry->d_name;
+			if (name == "." || name == "..")
+				continue;
+
+			if (!IsDirectory(dirPath + "/" + name))
+				outNames.push_back(name);
+		}
+
+		closedir(dir);
+#endif
+
+		return true;
+	}
+
+	bool FindFilesWithExtension(const std::string& dirPath, const char* extension, std::vector<std::string>& outPaths)
+	{
+		std::set<std::pair<uint64_t, uint64_t>> visitedDirs;
+		return FindFilesWithExtensionInDir(dirPath, extension, visitedDirs, outPaths);
+	}
+}
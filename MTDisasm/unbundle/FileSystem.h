@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace mtdisasm
+{
+	bool IsDirectory(const std::string& path);
+
+	// Creates a directory.  Succeeds if it already exists.
+	bool MakeDirectory(const std::string& path);
+
+	// Appends the names of the files directly in a directory, leaving out subdirectories
+	bool ListFiles(const std::string& dirPath, std::vector<std::string>& outNames);
+
+	// Appends the paths of all files under a directory and its subdirectories whose names end
+	// in the extension, compared case-insensitively.  The extension includes the dot.
+	bool FindFilesWithExtension(const std::string& dirPath, const char* extension, std::vector<std::string>& outPaths);
+}
@@ -7,9 +7,15 @@ namespace mtdisasm
 {
 	struct IOStream
 	{
+		virtual ~IOStream() {}
+
 		virtual size_t ReadPartial(void* dest, size_t sz) = 0;
 		virtual size_t WritePartial(const void* src, size_t sz) = 0;
 
+		// Reads from a position without using or changing the stream position.
+		// May be called from multiple threads at once.
+		virtual size_t ReadAtPartial(uint32_t pos, void* dest, size_t sz) const = 0;
+
 		virtual bool SeekSet(int32_t pos) = 0;
 		virtual bool SeekCur(int32_t pos) = 0;
 		virtual bool SeekEnd(int32_t pos) = 0;
@@ -17,10 +23,29 @@ namespace mtdisasm
 		virtual uint32_t Tell() const = 0;
 		virtual uint32_t TellGlobal() const = 0;
 
+		// If the entire stream is backed by contiguous memory, returns the memory range
+		// and the global position of its first byte.
+		virtual bool GetContiguousSpan(const void*& outData, size_t& outSize, uint32_t& outGlobalBase) const;
+
+		// If reads at a position are reads at the same offset of a file, returns the file's
+		// descriptor so that the reads can be issued to the OS directly.
+		virtual bool GetFileDescriptor(int& outFD) const;
+
 		bool ReadAll(void* dest, size_t sz);
 		bool WriteAll(const void* src, size_t sz);
+		bool ReadAt(uint32_t pos, void* dest, size_t sz) const;
 	};
 
+	inline bool IOStream::GetContiguousSpan(const void*& outData, size_t& outSize, uint32_t& outGlobalBase) const
+	{
+		return false;
+	}
+
+	inline bool IOStream::GetFileDescriptor(int& outFD) const
+	{
+		return false;
+	}
+
 	inline bool IOStream::ReadAll(void* dest, size_t sz)
 	{
 		return this->ReadPartial(dest, sz) == sz;
@@ -30,4 +55,9 @@ namespace mtdisasm
 	{
 		return this->WritePartial(src, sz) == sz;
 	}
+
+	inline bool IOStream::ReadAt(uint32_t pos, void* dest, size_t sz) const
+	{
+		return this->ReadAtPartial(pos, dest, sz) == sz;
+	}
 }
@@ -0,0 +1,533 @@
+#include "ImageEncoder.h"
+
+#include "Deflate.h"
+#include "ThreadPool.h"
+
+#include "stb_image_write.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+// Part of stb_image_write's implementation, but not declared by its header
+extern "C" unsigned char* stbi_write_png_to_mem(const unsigned char* pixels, int stride_bytes, int x, int y, int n, int* out_len);
+
+namespace mtdisasm
+{
+	namespace
+	{
+		// PNG rows are filtered and compressed in chunks of about this many bytes, each on its
+		// own thread if there are enough threads
+		const size_t kPNGChunkSize = 1024 * 1024;
+
+		const size_t kMaxIDATSize = 1 << 30;
+
+		enum PNGFilter
+		{
+			kPNGFilterNone,
+			kPNGFilterSub,
+			kPNGFilterUp,
+			kPNGFilterAverage,
+			kPNGFilterPaeth,
+
+			kNumPNGFilters,
+		};
+
+		void AppendBE32(std::vector<uint8_t>& data, uint32_t value)
+		{
+			data.push_back(static_cast<uint8_t>(value >> 24));
+			data.push_back(static_cast<uint8_t>(value >> 16));
+			data.push_back(static_cast<uint8_t>(value >> 8));
+			data.push_back(static_cast<uint8_t>(value));
+		}
+
+		void AppendString(std::vector<uint8_t>& data, const char* str)
+		{
+			data.insert(data.end(), str, str + strlen(str));
+		}
+
+		struct CRC32Table
+		{
+			uint32_t m_table[256];
+
+			CRC32Table()
+			{
+				for (uint32_t i = 0; i < 256; i++)
+				{
+					uint32_t crc = i;
+					for (int bit = 0; bit < 8; bit++)
+						crc = (crc & 1) ? (0xedb88320u ^ (crc >> 1)) : (crc >> 1);
+					m_table[i] = crc;
+				}
+			}
+		};
+
+		uint32_t CRC32(uint32_t crc, const uint8_t* data, size_t size)
+		{
+			static const CRC32Table table;
+
+			crc = ~crc;
+			for (size_t i = 0; i < size; i++)
+				crc = table.m_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+			return ~crc;
+		}
+
+		void AppendPNGChunk(std::vector<uint8_t>& png, const char* type, const uint8_t* data, size_t size)
+		{
+			AppendBE32(png, static_cast<uint32_t>(size));
+
+			const size_t typePos = png.size();
+			AppendString(png, type);
+			png.insert(png.end(), data, data + size);
+
+			AppendBE32(png, CRC32(0, png.data() + typePos, 4 + size));
+		}
+
+		inline uint8_t PaethPredictor(int left, int up, int upLeft)
+		{
+			const int p = left + up - upLeft;
+			const int pa = abs(p - left);
+			const int pb = abs(p - up);
+			const int pc = abs(p - upLeft);
+
+			if (pa <= pb && pa <= pc)
+				return static_cast<uint8_t>(left);
+			if (pb <= pc)
+				return static_cast<uint8_t>(up);
+			return static_cast<uint8_t>(upLeft);
+		}
+
+		// Filters one row, with prev being the unfiltered row above
+		void FilterPNGRow(PNGFilter filter, const uint8_t* row, const uint8_t* prev, size_t rowSize, size_t bytesPerPixel, uint8_t* dest)
+		{
+			const size_t firstPixelSize = std::min(bytesPerPixel, rowSize);
+
+			switch (filter)
+			{
+			case kPNGFilterNone:
+				memcpy(dest, row, rowSize);
+				break;
+			case kPNGFilterSub:
+				memcpy(dest, row, firstPixelSize);
+				for (size_t i = bytesPerPixel; i < rowSize; i++)
+					dest[i] = static_cast<uint8_t>(row[i] - row[i - bytesPerPixel]);
+				break;
+			case kPNGFilterUp:
+				for (size_t i = 0; i < rowSize; i++)
+					dest[i] = static_cast<uint8_t>(row[i] - prev[i]);
+				break;
+			case kPNGFilterAverage:
+				for (size_t i = 0; i < firstPixelSize; i++)
+					dest[i] = static_cast<uint8_t>(row[i] - (prev[i] >> 1));
+				for (size_t i = bytesPerPixel; i < rowSize; i++)
+					dest[i] = static_cast<uint8_t>(row[i] - ((row[i - bytesPerPixel] + prev[i]) >> 1));
+				break;
+			case kPNGFilterPaeth:
+				for (size_t i = 0; i < firstPixelSize; i++)
+					dest[i] = static_cast<uint8_t>(row[i] - prev[i]);
+				for (size_t i = bytesPerPixel; i < rowSize; i++)
+					dest[i] = static_cast<uint8_t>(row[i] - PaethPredictor(row[i - bytesPerPixel], prev[i], prev[i - bytesPerPixel]));
+				break;
+			default:
+				break;
+			}
+		}
+
+		// The usual heuristic for picking a filter: the smallest sum of the filtered bytes as
+		// signed values tends to compress best
+		size_t ScoreFilteredRow(const uint8_t* filtered, size_t rowSize)
+		{
+			size_t score = 0;
+			for (size_t i = 0; i < rowSize; i++)
+				score += static_cast<size_t>(abs(static_cast<int8_t>(filtered[i])));
+			return score;
+		}
+
+		struct PNGEncodeJob
+		{
+			const uint8_t* m_pixels;
+			size_t m_width;
+			size_t m_height;
+			size_t m_numChannels;
+			size_t m_bytesPerRow;
+			int m_level;
+
+			size_t m_rowsPerChunk;
+			size_t m_numChunks;
+
+			std::vector<std::vector<uint8_t> > m_chunkDeflateData;
+			std::vector<uint32_t> m_chunkAdlers;
+			std::vector<size_t> m_chunkSizes;
+
+			std::atomic<size_t> m_nextChunk;
+		};
+
+		// Filters and compresses chunks until there are none left
+		void RunPNGEncodeWorker(PNGEncodeJob& job)
+		{
+			const size_t rowSize = job.m_width * job.m_numChannels;
+			const size_t filteredRowSize = rowSize + 1;
+
+			DeflateCompressor compressor(job.m_level);
+
+			PNGFilter candidateFilters[kNumPNGFilters];
+			size_t numCandidateFilters = 0;
+			if (job.m_level == 0)
+				candidateFilters[numCandidateFilters++] = kPNGFilterNone;
+			else if (job.m_level == 1)
+			{
+				candidateFilters[numCandidateFilters++] = kPNGFilterSub;
+				candidateFilters[numCandidateFilters++] = kPNGFilterUp;
+			}
+			else
+			{
+				for (int filter = 0; filter < kNumPNGFilters; filter++)
+					candidateFilters[numCandidateFilters++] = static_cast<PNGFilter>(filter);
+			}
+
+			std::vector<uint8_t> zeroRow(rowSize, 0);
+			std::vector<uint8_t> filtered;
+			std::vector<uint8_t> candidateRows(numCandidateFilters > 1 ? rowSize * 2 : 0);
+
+			for (;;)
+			{
+				const size_t chunkIndex = job.m_nextChunk.fetch_add(1);
+				if (chunkIndex >= job.m_numChunks)
+					break;
+
+				const size_t firstRow = chunkIndex * job.m_rowsPerChunk;
+				const size_t numRows = std::min(job.m_rowsPerChunk, job.m_height - firstRow);
+
+				filtered.resize(numRows * filteredRowSize);
+
+				for (size_t i = 0; i < numRows; i++)
+				{
+					const size_t rowIndex = firstRow + i;
+					const uint8_t* row = job.m_pixels + rowIndex * job.m_bytesPerRow;
+					const uint8_t* prev = (rowIndex == 0) ? zeroRow.data() : (row - job.m_bytesPerRow);
+					uint8_t* dest = filtered.data() + i * filteredRowSize;
+
+					if (numCandidateFilters == 1)
+					{
+						dest[0] = static_cast<uint8_t>(candidateFilters[0]);
+						FilterPNGRow(candidateFilters[0], row, prev, rowSize, job.m_numChannels, dest + 1);
+						continue;
+					}
+
+					// Filters into two rows, keeping the best one so far in one of them
+					uint8_t* bestRow = candidateRows.data();
+					uint8_t* scratchRow = candidateRows.data() + rowSize;
+					PNGFilter bestFilter = candidateFilters[0];
+					FilterPNGRow(bestFilter, row, prev, rowSize, job.m_numChannels, bestRow);
+					size_t bestScore = ScoreFilteredRow(bestRow, rowSize);
+
+					for (size_t f = 1; f < numCandidateFilters; f++)
+					{
+						FilterPNGRow(candidateFilters[f], row, prev, rowSize, job.m_numChannels, scratchRow);
+						const size_t score = ScoreFilteredRow(scratchRow, rowSize);
+						if (score < bestScore)
+						{
+							bestScore = score;
+							bestFilter = candidateFilters[f];
+							std::swap(bestRow, scratchRow);
+						}
+					}
+
+					dest[0] = static_cast<uint8_t>(bestFilter);
+					memcpy(dest + 1, bestRow, rowSize);
+				}
+
+				job.m_chunkAdlers[chunkIndex] = DeflateCompressor::Adler32(1, filtered.data(), filtered.size());
+				job.m_chunkSizes[chunkIndex] = filtered.size();
+				compressor.Compress(filtered.data(), filtered.size(), chunkIndex == job.m_numChunks - 1, job.m_chunkDeflateData[chunkIndex]);
+			}
+		}
+
+		bool EncodePNG(const ImageEncoderOptions& options, const uint8_t* pixels, size_t width, size_t height, size_t numChannels, size_t bytesPerRow, std::vector<uint8_t>& outData)
+		{
+			if (width > 0x7fffffff || height > 0x7fffffff)
+				return false;
+
+			const size_t filteredRowSize = width * numChannels + 1;
+
+			// Chunks are split by size alone so that the output doesn't depend on the threads
+			PNGEncodeJob job;
+			job.m_pixels = pixels;
+			job.m_width = width;
+			job.m_height = height;
+			job.m_numChannels = numChannels;
+			job.m_bytesPerRow = bytesPerRow;
+			job.m_level = options.m_level;
+			if (job.m_level < 0)
+				job.m_level = 0;
+			else if (job.m_level > ImageEncoderOptions::kMaxLevel)
+				job.m_level = ImageEncoderOptions::kMaxLevel;
+			job.m_rowsPerChunk = std::max<size_t>(1, kPNGChunkSize / filteredRowSize);
+			job.m_numChunks = (height + job.m_rowsPerChunk - 1) / job.m_rowsPerChunk;
+			job.m_chunkDeflateData.resize(job.m_numChunks);
+			job.m_chunkAdlers.resize(job.m_numChunks);
+			job.m_chunkSizes.resize(job.m_numChunks);
+			job.m_nextChunk = 0;
+
+			const size_t numThreads = std::max<size_t>(1, std::min(options.m_numThreads, job.m_numChunks));
+
+			size_t numHelpers = numThreads - 1;
+			if (options.m_threadBudget)
+				numHelpers = options.m_threadBudget->TryAcquire(numHelpers);
+
+			std::vector<std::thread> helperThreads;
+			for (size_t i = 0; i < numHelpers; i++)
+				helperThreads.push_back(std::thread(RunPNGEncodeWorker, std::ref(job)));
+
+			RunPNGEncodeWorker(job);
+
+			for (std::thread& thread : helperThreads)
+				thread.join();
+
+			if (options.m_threadBudget)
+				options.m_threadBudget->Release(numHelpers);
+
+			static const uint8_t kPNGSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+			static const uint8_t kZlibLevelFlags[ImageEncoderOptions::kMaxLevel + 1] = { 0x01, 0x5e, 0x9c, 0xda };
+
+			std::vector<uint8_t> header;
+			AppendBE32(header, static_cast<uint32_t>(width));
+			AppendBE32(header, static_cast<uint32_t>(height));
+			header.push_back(8);
+			header.push_back(numChannels == 4 ? 6 : 2);
+			header.push_back(0);
+			header.push_back(0);
+			header.push_back(0);
+
+			std::vector<uint8_t> zlibData;
+			size_t zlibSize = 6;
+			for (const std::vector<uint8_t>& deflateData : job.m_chunkDeflateData)
+				zlibSize += deflateData.size();
+			zlibData.reserve(zlibSize);
+
+			zlibData.push_back(0x78);
+			zlibData.push_back(kZlibLevelFlags[job.m_level]);
+
+			uint32_t adler = 1;
+			for (size_t i = 0; i < job.m_numChunks; i++)
+			{
+				zlibData.insert(zlibData.end(), job.m_chunkDeflateData[i].begin(), job.m_chunkDeflateData[i].end());
+				adler = DeflateCompressor::CombineAdler32(adler, job.m_chunkAdlers[i], job.m_chunkSizes[i]);
+
+				std::vector<uint8_t>().swap(job.m_chunkDeflateData[i]);
+			}
+
+			AppendBE32(zlibData, adler);
+
+			outData.clear();
+			outData.reserve(zlibSize + 64);
+			outData.insert(outData.end(), kPNGSignature, kPNGSignature + 8);
+			AppendPNGChunk(outData, "IHDR", header.data(), header.size());
+
+			for (size_t pos = 0; pos < zlibData.size(); pos += kMaxIDATSize)
+				AppendPNGChunk(outData, "IDAT", zlibData.data() + pos, std::min(kMaxIDATSize, zlibData.size() - pos));
+
+			AppendPNGChunk(outData, "IEND", nullptr, 0);
+
+			return true;
+		}
+
+		bool EncodeSTBPNG(const uint8_t* pixels, size_t width, size_t height, size_t numChannels, size_t bytesPerRow, std::vector<uint8_t>& outData)
+		{
+			if (width > 0x7fffffff || height > 0x7fffffff || bytesPerRow > 0x7fffffff)
+				return false;
+
+			int pngSize = 0;
+			unsigned char* png = stbi_write_png_to_mem(pixels, static_cast<int>(bytesPerRow), static_cast<int>(width), static_cast<int>(height), static_cast<int>(numChannels), &pngSize);
+			if (!png)
+				return false;
+
+			outData.assign(png, png + pngSize);
+			free(png);
+			return true;
+		}
+
+		void EncodePNM(const uint8_t* pixels, size_t width, size_t height, size_t numChannels, size_t bytesPerRow, std::vector<uint8_t>& outData)
+		{
+			char header[128];
+			if (numChannels == 4)
+				sprintf(header, "P7\nWIDTH %u\nHEIGHT %u\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", static_cast<unsigned int>(width), static_cast<unsigned int>(height));
+			else
+				sprintf(header, "P6\n%u %u\n255\n", static_cast<unsigned int>(width), static_cast<unsigned int>(height));
+
+			const size_t rowSize = width * numChannels;
+
+			outData.clear();
+			outData.reserve(strlen(header) + rowSize * height);
+			AppendString(outData, header);
+
+			for (size_t row = 0; row < height; row++)
+			{
+				const uint8_t* rowPixels = pixels + row * bytesPerRow;
+				outData.insert(outData.end(), rowPixels, rowPixels + rowSize);
+			}
+		}
+
+		void EncodeQOI(const uint8_t* pixels, size_t width, size_t height, size_t numChannels, size_t bytesPerRow, std::vector<uint8_t>& outData)
+		{
+			static const uint8_t kEndMarker[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+			// Worst case is every pixel being an RGBA op
+			outData.resize(14 + width * height * (numChannels + 1) + sizeof(kEndMarker));
+			uint8_t* out = outData.data();
+			size_t outPos = 0;
+
+			memcpy(out, "qoif", 4);
+			out[4] = static_cast<uint8_t>(width >> 24);
+			out[5] = static_cast<uint8_t>(width >> 16);
+			out[6] = static_cast<uint8_t>(width >> 8);
+			out[7] = static_cast<uint8_t>(width);
+			out[8] = static_cast<uint8_t>(height >> 24);
+			out[9] = static_cast<uint8_t>(height >> 16);
+			out[10] = static_cast<uint8_t>(height >> 8);
+			out[11] = static_cast<uint8_t>(height);
+			out[12] = static_cast<uint8_t>(numChannels);
+			out[13] = 0;	// sRGB with linear alpha
+			outPos = 14;
+
+			uint8_t index[64][4];
+			memset(index, 0, sizeof(index));
+
+			uint8_t prev[4] = { 0, 0, 0, 255 };
+			uint8_t px[4] = { 0, 0, 0, 255 };
+			size_t run = 0;
+
+			for (size_t row = 0; row < height; row++)
+			{
+				const uint8_t* rowPixels = pixels + row * bytesPerRow;
+				for (size_t col = 0; col < width; col++)
+				{
+					memcpy(px, rowPixels + col * numChannels, numChannels);
+
+					if (memcmp(px, prev, 4) == 0)
+					{
+						run++;
+						if (run == 62)
+						{
+							out[outPos++] = static_cast<uint8_t>(0xc0 | (run - 1));
+							run = 0;
+						}
+						continue;
+					}
+
+					if (run > 0)
+					{
+						out[outPos++] = static_cast<uint8_t>(0xc0 | (run - 1));
+						run = 0;
+					}
+
+					const size_t hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+					if (memcmp(index[hash], px, 4) == 0)
+						out[outPos++] = static_cast<uint8_t>(hash);
+					else
+					{
+						memcpy(index[hash], px, 4);
+
+						if (px[3] == prev[3])
+						{
+							const int8_t dr = static_cast<int8_t>(px[0] - prev[0]);
+							const int8_t dg = static_cast<int8_t>(px[1] - prev[1]);
+							const int8_t db = static_cast<int8_t>(px[2] - prev[2]);
+							const int drdg = dr - dg;
+							const int dbdg = db - dg;
+
+							if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+								out[outPos++] = static_cast<uint8_t>(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+							else if (dg >= -32 && dg <= 31 && drdg >= -8 && drdg <= 7 && dbdg >= -8 && dbdg <= 7)
+							{
+								out[outPos++] = static_cast<uint8_t>(0x80 | (dg + 32));
+								out[outPos++] = static_cast<uint8_t>(((drdg + 8) << 4) | (dbdg + 8));
+							}
+							else
+							{
+								out[outPos++] = 0xfe;
+								memcpy(out + outPos, px, 3);
+								outPos += 3;
+							}
+						}
+						else
+						{
+							out[outPos++] = 0xff;
+							memcpy(out + outPos, px, 4);
+							outPos += 4;
+						}
+					}
+
+					memcpy(prev, px, 4);
+				}
+			}
+
+			if (run > 0)
+				out[outPos++] = static_cast<uint8_t>(0xc0 | (run - 1));
+
+			memcpy(out + outPos, kEndMarker, sizeof(kEndMarker));
+			outPos += sizeof(kEndMarker);
+
+			outData.resize(outPos);
+		}
+	}
+
+	const char* GetImageFileExtension(ImageEncoderBackend backend, size_t numChannels)
+	{
+		switch (backend)
+		{
+		case ImageEncoderBackend::kPNM:
+			return (numChannels == 4) ? ".pam" : ".ppm";
+		case ImageEncoderBackend::kQOI:
+			return ".qoi";
+		default:
+			return ".png";
+		}
+	}
+
+	bool EncodeImage(const ImageEncoderOptions& options, const uint8_t* pixels, size_t width, size_t height, size_t numChannels, size_t bytesPerRow, std::vector<uint8_t>& outData)
+	{
+		if (width == 0 || height == 0 || (numChannels != 3 && numChannels != 4))
+			return false;
+
+		switch (options.m_backend)
+		{
+		case ImageEncoderBackend::kSTBPNG:
+			return EncodeSTBPNG(pixels, width, height, numChannels, bytesPerRow, outData);
+		case ImageEncoderBackend::kPNG:
+			return EncodePNG(options, pixels, width, height, numChannels, bytesPerRow, outData);
+		case ImageEncoderBackend::kPNM:
+			EncodePNM(pixels, width, height, numChannels, bytesPerRow, outData);
+			return true;
+		case ImageEncoderBackend::kQOI:
+			if (width > 0xffffffffu || height > 0xffffffffu)
+				return false;
+			EncodeQOI(pixels, width, height, numChannels, bytesPerRow, outData);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool WriteImageFile(const ImageEncoderOptions& options, const std::string& path, const uint8_t* pixels, size_t width, size_t height, size_t numChannels, size_t bytesPerRow)
+	{
+		// stb_image_write writes the file itself, as it always has
+		if (options.m_backend == ImageEncoderBackend::kSTBPNG)
+			return stbi_write_png(path.c_str(), static_cast<int>(width), static_cast<int>(height), static_cast<int>(numChannels), pixels, static_cast<int>(bytesPerRow)) != 0;
+
+		std::vector<uint8_t> data;
+		if (!EncodeImage(options, pixels, width, height, numChannels, bytesPerRow, data))
+			return false;
+
+		FILE* f = fopen(path.c_str(), "wb");
+		if (!f)
+			return false;
+
+		const bool succeeded = (fwrite(data.data(), 1, data.size(), f) == data.size());
+		return (fclose(f) == 0) && succeeded;
+	}
+}
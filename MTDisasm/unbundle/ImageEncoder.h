@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mtdisasm
+{
+	class ThreadBudget;
+
+	enum class ImageEncoderBackend : uint8_t
+	{
+		kSTBPNG,	// PNG from stb_image_write at its default settings
+		kPNG,		// PNG from DeflateCompressor at m_level
+		kPNM,		// Uncompressed PPM, or PAM for images with alpha
+		kQOI,
+	};
+
+	struct ImageEncoderOptions
+	{
+		ImageEncoderBackend m_backend;
+
+		// For kPNG.  0 stores the pixels unfiltered, 1 picks between the Sub and Up filters
+		// for each row, and 2 and up try every filter.  Deflate uses the same level.
+		int m_level;
+
+		// Threads that may compress parts of one large PNG at once.  The output is the same
+		// for any number of threads.
+		size_t m_numThreads;
+
+		// If set, threads beyond the calling thread are only used while the budget has them
+		ThreadBudget* m_threadBudget;
+
+		static const int kMaxLevel = 3;
+	};
+
+	// Returns the extension, including the dot, of files from the backend
+	const char* GetImageFileExtension(ImageEncoderBackend backend, size_t numChannels);
+
+	// Encodes 8-bit RGB (3 channels) or RGBA (4 channels) pixels, top row first, with rows
+	// bytesPerRow apart.  Fails if the image is empty or too large for the format, except that
+	// WriteImageFile leaves kSTBPNG images to stb_image_write as the extractors always have.
+	bool EncodeImage(const ImageEncoderOptions& options, const uint8_t* pixels, size_t width, size_t height, size_t numChannels, size_t bytesPerRow, std::vector<uint8_t>& outData);
+	bool WriteImageFile(const ImageEncoderOptions& options, const std::string& path, const uint8_t* pixels, size_t width, size_t height, size_t numChannels, size_t bytesPerRow);
+}
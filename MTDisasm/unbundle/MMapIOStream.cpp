@@ -0,0 +1,185 @@
+#include "MMapIOStream.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace mtdisasm
+{
+#ifdef _WIN32
+	MMapIOStream::MMapIOStream(FILE* f)
+		: m_buf(nullptr)
+		, m_size(0)
+		, m_pos(0)
+		, m_isValid(false)
+		, m_mappingHandle(nullptr)
+	{
+		HANDLE fileHandle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(f)));
+		if (fileHandle == INVALID_HANDLE_VALUE)
+			return;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize))
+			return;
+
+		// Streams are addressed with 32-bit positions, so anything larger can't be used anyway
+		if (fileSize.QuadPart > INT32_MAX)
+			return;
+
+		m_size = static_cast<size_t>(fileSize.QuadPart);
+		if (m_size == 0)
+		{
+			m_isValid = true;
+			return;
+		}
+
+		HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mappingHandle)
+			return;
+
+		m_buf = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+		if (!m_buf)
+		{
+			CloseHandle(mappingHandle);
+			return;
+		}
+
+		m_mappingHandle = mappingHandle;
+		m_isValid = true;
+	}
+
+	MMapIOStream::~MMapIOStream()
+	{
+		if (m_buf)
+			UnmapViewOfFile(m_buf);
+		if (m_mappingHandle)
+			CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+	}
+#else
+	MMapIOStream::MMapIOStream(FILE* f)
+		: m_buf(nullptr)
+		, m_size(0)
+		, m_pos(0)
+		, m_isValid(false)
+	{
+		int fd = fileno(f);
+
+		struct stat st;
+		if (fstat(fd, &st) != 0)
+			return;
+
+		// Pipes and devices report no size, so only regular files are mapped
+		if (!S_ISREG(st.st_mode))
+			return;
+
+		// Streams are addressed with 32-bit positions, so anything larger can't be used anyway
+		if (st.st_size < 0 || st.st_size > INT32_MAX)
+			return;
+
+		m_size = static_cast<size_t>(st.st_size);
+		if (m_size == 0)
+		{
+			m_isValid = true;
+			return;
+		}
+
+		void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED)
+			return;
+
+		m_buf = mapping;
+		m_isValid = true;
+	}
+
+	MMapIOStream::~MMapIOStream()
+	{
+		if (m_buf)
+			munmap(const_cast<void*>(m_buf), m_size);
+	}
+#endif
+
+	bool MMapIOStream::IsValid() const
+	{
+		return m_isValid;
+	}
+
+	size_t MMapIOStream::ReadPartial(void* dest, size_t sz)
+	{
+		size_t available = m_size - m_pos;
+		if (available < sz)
+			sz = available;
+
+		if (sz > 0)
+			memcpy(dest, static_cast<const char*>(m_buf) + m_pos, sz);
+		m_pos += static_cast<uint32_t>(sz);
+
+		return sz;
+	}
+
+	size_t MMapIOStream::WritePartial(const void* src, size_t sz)
+	{
+		return 0;
+	}
+
+	size_t MMapIOStream::ReadAtPartial(uint32_t pos, void* dest, size_t sz) const
+	{
+		if (pos >= m_size)
+			return 0;
+
+		size_t available = m_size - pos;
+		if (available < sz)
+			sz = available;
+
+		memcpy(dest, static_cast<const char*>(m_buf) + pos, sz);
+
+		return sz;
+	}
+
+	bool MMapIOStream::SeekSet(int32_t pos)
+	{
+		if (pos < 0)
+			return false;
+		if (static_cast<size_t>(pos) > m_size)
+			return false;
+
+		m_pos = static_cast<uint32_t>(pos);
+
+		return true;
+	}
+
+	bool MMapIOStream::SeekCur(int32_t pos)
+	{
+		return SeekSet(static_cast<int32_t>(m_pos) + pos);
+	}
+
+	bool MMapIOStream::SeekEnd(int32_t pos)
+	{
+		if (pos > 0)
+			return false;
+		return SeekSet(static_cast<int32_t>(m_size) + pos);
+	}
+
+	uint32_t MMapIOStream::Tell() const
+	{
+		return m_pos;
+	}
+
+	uint32_t MMapIOStream::TellGlobal() const
+	{
+		return m_pos;
+	}
+
+	bool MMapIOStream::GetContiguousSpan(const void*& outData, size_t& outSize, uint32_t& outGlobalBase) const
+	{
+		outData = m_buf;
+		outSize = m_size;
+		outGlobalBase = 0;
+		return true;
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "IOStream.h"
+
+#include <stdio.h>
+
+namespace mtdisasm
+{
+	// Read-only stream backed by a memory mapping of an entire file.
+	// The FILE is only used to obtain the file handle and may be closed
+	// independently of the mapping.
+	class MMapIOStream final : public IOStream
+	{
+	public:
+		explicit MMapIOStream(FILE* f);
+		~MMapIOStream();
+
+		bool IsValid() const;
+
+		size_t ReadPartial(void* dest, size_t sz) override;
+		size_t WritePartial(const void* src, size_t sz) override;
+		size_t ReadAtPartial(uint32_t pos, void* dest, size_t sz) const override;
+
+		bool SeekSet(int32_t pos) override;
+		bool SeekCur(int32_t pos) override;
+		bool SeekEnd(int32_t pos) override;
+
+		uint32_t Tell() const override;
+		uint32_t TellGlobal() const override;
+
+		bool GetContiguousSpan(const void*& outData, size_t& outSize, uint32_t& outGlobalBase) const override;
+
+	private:
+		MMapIOStream(const MMapIOStream&) = delete;
+		MMapIOStream& operator=(const MMapIOStream&) = delete;
+
+		const void* m_buf;
+		size_t m_size;
+		uint32_t m_pos;
+		bool m_isValid;
+
+#ifdef _WIN32
+		void* m_mappingHandle;
+#endif
+	};
+}
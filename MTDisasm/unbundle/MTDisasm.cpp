@@ -1,25 +1,54 @@
+#include "AsyncReader.h"
+#include "AtlasPacker.h"
 #include "IOStream.h"
 #include "CFileIOStream.h"
 #include "Catalog.h"
 #include "DataObject.h"
 #include "DataReader.h"
+#include "ExtractionManifest.h"
+#include "ImageEncoder.h"
+#include "FileSystem.h"
 #include "SliceIOStream.h"
 #include "MemIOStream.h"
+#include "MMapIOStream.h"
+#include "ObjectArena.h"
+#include "MToonCompositor.h"
+#include "MToonRLEDecoder.h"
+#include "ObjectIndex.h"
+#include "ObjectStreamCursor.h"
+#include "ObjectTypeRegistry.h"
+#include "PayloadIOStream.h"
+#include "PixelConvert.h"
+#include "ReadAheadIOStream.h"
+#include "StructuredWriter.h"
+#include "TextWriter.h"
+#include "ThreadPool.h"
 
 #include <string>
 #include <vector>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <cstring>
 #include <cstdio>
 #include <cassert>
+#include <cerrno>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 
-extern "C"
-{
-#include "stb_image_write.h"
-}
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
 
 struct RGBColor
 {
@@ -27,6 +56,7 @@ struct RGBColor
 };
 
 RGBColor g_macStandardPalette[256];
+uint32_t g_macStandardPaletteRGBA[256];	// For the pixel converters
 
 void GenerateMacStandardPalette()
 {
@@ -90,138 +120,11 @@ void GenerateMacStandardPalette()
 
 	RGBColor& lastClr = g_macStandardPalette[outColor++];
 	lastClr.r = lastClr.g = lastClr.b = 0;
-}
 
-const char* NameObjectType(mtdisasm::DataObjectType dot)
-{
-	switch (dot)
-	{
-	case mtdisasm::DataObjectType::kUnknown:
-		return "Unknown";
-	case mtdisasm::DataObjectType::kStreamHeader:
-		return "StreamHeader";
-	case mtdisasm::DataObjectType::kPresentationSettings:
-		return "PresentationSettings";
-	case mtdisasm::DataObjectType::kGlobalObjectInfo:
-		return "GlobalObjectInfo";
-	case mtdisasm::DataObjectType::kUnknown19:
-		return "Unknown19";
-	case mtdisasm::DataObjectType::kDebris:
-		return "Debris";
-	case mtdisasm::DataObjectType::kProjectLabelMap:
-		return "ProjectLabelMap";
-	case mtdisasm::DataObjectType::kAssetCatalog:
-		return "AssetCatalog";
-	case mtdisasm::DataObjectType::kColorTableAsset:
-		return "ColorTable";
-	case mtdisasm::DataObjectType::kAudioAsset:
-		return "AudioAsset";
-	case mtdisasm::DataObjectType::kImageAsset:
-		return "ImageAsset";
-	case mtdisasm::DataObjectType::kMovieAsset:
-		return "MovieAsset";
-	case mtdisasm::DataObjectType::kMToonAsset:
-		return "MToonAsset";
-	case mtdisasm::DataObjectType::kTextAsset:
-		return "TextAsset";
-	case mtdisasm::DataObjectType::kProjectStructuralDef:
-		return "ProjectStructuralDef";
-	case mtdisasm::DataObjectType::kSectionStructuralDef:
-		return "SectionStructuralDef";
-	case mtdisasm::DataObjectType::kSubsectionStructuralDef:
-		return "SubsectionStructuralDef";
-	case mtdisasm::DataObjectType::kGraphicStructuralDef:
-		return "GraphicStructuralDef";
-	case mtdisasm::DataObjectType::kTextStructuralDef:
-		return "TextStructuralDef";
-	case mtdisasm::DataObjectType::kSoundStructuralDef:
-		return "SoundStructuralDef";
-	case mtdisasm::DataObjectType::kImageStructuralDef:
-		return "ImageStructuralDef";
-	case mtdisasm::DataObjectType::kMovieStructuralDef:
-		return "MovieStructuralDef";
-	case mtdisasm::DataObjectType::kExternalMovieStructuralDef:
-		return "ExternalMovieStructuralDef";
-	case mtdisasm::DataObjectType::kMToonStructuralDef:
-		return "MToonStructuralDef";
-	case mtdisasm::DataObjectType::kBehaviorModifier:
-		return "BehaviorModifier";
-	case mtdisasm::DataObjectType::kMessengerModifier:
-		return "MessengerModifier";
-	case mtdisasm::DataObjectType::kIfMessengerModifier:
-		return "IfMessengerModifier";
-	case mtdisasm::DataObjectType::kTimerMessengerModifier:
-		return "TimerMessengerModifier";
-	case mtdisasm::DataObjectType::kBoundaryDetectionMessengerModifier:
-		return "BoundaryDetectionMessengerModifier";
-	case mtdisasm::DataObjectType::kCollisionDetectionMessengerModifier:
-		return "CollisionDetectionMessengerModifier";
-	case mtdisasm::DataObjectType::kSetModifier:
-		return "SetModifier";
-	case mtdisasm::DataObjectType::kSharedSceneModifier:
-		return "SharedSceneModifier";
-	case mtdisasm::DataObjectType::kSaveAndRestoreModifier:
-		return "SaveAndRestoreModifier";
-	case mtdisasm::DataObjectType::kKeyboardMessengerModifier:
-		return "KeyboardMessengerModifier";
-	case mtdisasm::DataObjectType::kBooleanVariableModifier:
-		return "BooleanVariableModifier";
-	case mtdisasm::DataObjectType::kIntegerVariableModifier:
-		return "IntegerVariableModifier";
-	case mtdisasm::DataObjectType::kIntegerRangeVariableModifier:
-		return "IntegerRangeVariableModifier";
-	case mtdisasm::DataObjectType::kStringVariableModifier:
-		return "StringVariableModifier";
-	case mtdisasm::DataObjectType::kFloatVariableModifier:
-		return "FloatVariableModifier";
-	case mtdisasm::DataObjectType::kCompoundVariableModifier:
-		return "CompoundVariableModifier";
-	case mtdisasm::DataObjectType::kVectorVariableModifier:
-		return "VectorVariableModifier";
-	case mtdisasm::DataObjectType::kPointVariableModifier:
-		return "PointVariableModifier";
-	case mtdisasm::DataObjectType::kGraphicModifier:
-		return "GraphicModifier";
-	case mtdisasm::DataObjectType::kTextStyleModifier:
-		return "TextStyleModifier";
-	case mtdisasm::DataObjectType::kSceneTransitionModifier:
-		return "SceneTransitionModifier";
-	case mtdisasm::DataObjectType::kElementTransitionModifier:
-		return "ElementTransitionModifier";
-	case mtdisasm::DataObjectType::kSimpleMotionModifier:
-		return "SimpleMotionModifier";
-	case mtdisasm::DataObjectType::kPathMotionModifierV1:
-		return "PathMotionModifierV1";
-	case mtdisasm::DataObjectType::kPathMotionModifierV2:
-		return "PathMotionModifierV2";
-	case mtdisasm::DataObjectType::kDragMotionModifier:
-		return "DragMotionModifier";
-	case mtdisasm::DataObjectType::kVectorMotionModifier:
-		return "VectorMotionModifier";
-	case mtdisasm::DataObjectType::kChangeSceneModifier:
-		return "ChangeSceneModifier";
-	case mtdisasm::DataObjectType::kImageEffectModifier:
-		return "ImageEffectModifier";
-	case mtdisasm::DataObjectType::kSoundFadeModifier:
-		return "SoundFadeModifier";
-	case mtdisasm::DataObjectType::kAliasModifier:
-		return "AliasModifier";
-	case mtdisasm::DataObjectType::kSoundEffectModifier:
-		return "SoundEffectModifier";
-	case mtdisasm::DataObjectType::kNotYetImplemented:
-		return "NotYetImplemented";
-	case mtdisasm::DataObjectType::kPlugInModifier:
-		return "PlugInModifier";
-	case mtdisasm::DataObjectType::kAssetDataSection:
-		return "AssetDataSection";
-	case mtdisasm::DataObjectType::kMiniscriptModifier:
-		return "MiniscriptModifier";
-	case mtdisasm::DataObjectType::kExtVideoAsset:
-		return "ExtVideoAsset";
-	case mtdisasm::DataObjectType::kMacOnlyCursorModifier:
-		return "MacOnlyCursorModifier";
-	default:
-		return "BUG_NotNamed";
+	for (int i = 0; i < 256; i++)
+	{
+		const uint8_t rgba[4] = { g_macStandardPalette[i].r, g_macStandardPalette[i].g, g_macStandardPalette[i].b, 255 };
+		memcpy(&g_macStandardPaletteRGBA[i], rgba, 4);
 	}
 }
 
@@ -257,196 +160,200 @@ void NameAssetType(char* assetName, uint32_t assetType)
 	}
 }
 
-void PrintSingleVal(uint32_t u32, bool asHex, FILE* f)
+void PrintSingleVal(uint32_t u32, bool asHex, mtdisasm::TextWriter& f)
 {
 	if (asHex)
-		fprintf(f, "%08x", static_cast<unsigned int>(u32));
+		f.WriteHex(u32, 8);
 	else
-		fprintf(f, "%u", static_cast<unsigned int>(u32));
+		f.WriteDec(u32);
 }
 
-void PrintSingleVal(uint16_t u16, bool asHex, FILE* f)
+void PrintSingleVal(uint16_t u16, bool asHex, mtdisasm::TextWriter& f)
 {
 	if (asHex)
-		fprintf(f, "%04x", static_cast<unsigned int>(u16));
+		f.WriteHex(u16, 4);
 	else
-		fprintf(f, "%u", static_cast<unsigned int>(u16));
+		f.WriteDec(static_cast<uint32_t>(u16));
 }
 
-void PrintSingleVal(uint8_t u8, bool asHex, FILE* f)
+void PrintSingleVal(uint8_t u8, bool asHex, mtdisasm::TextWriter& f)
 {
 	if (asHex)
-		fprintf(f, "%02x", static_cast<unsigned int>(u8));
+		f.WriteHex(u8, 2);
 	else
-		fprintf(f, "%u", static_cast<unsigned int>(u8));
+		f.WriteDec(static_cast<uint32_t>(u8));
 }
 
-void PrintSingleVal(int32_t s32, bool asHex, FILE* f)
+void PrintSingleVal(int32_t s32, bool asHex, mtdisasm::TextWriter& f)
 {
 	if (asHex)
-		fprintf(f, "%08x", static_cast<unsigned int>(s32 & 0xffffffff));
+		f.WriteHex(static_cast<uint32_t>(s32), 8);
 	else
-		fprintf(f, "%i", static_cast<int>(s32));
+		f.WriteDec(s32);
 }
 
-void PrintSingleVal(int16_t s16, bool asHex, FILE* f)
+void PrintSingleVal(int16_t s16, bool asHex, mtdisasm::TextWriter& f)
 {
 	if (asHex)
-		fprintf(f, "%04x", static_cast<unsigned int>(s16 & 0xffff));
+		f.WriteHex(static_cast<uint32_t>(s16 & 0xffff), 4);
 	else
-		fprintf(f, "%i", static_cast<int>(s16));
+		f.WriteDec(static_cast<int32_t>(s16));
 }
 
-void PrintSingleVal(int8_t s8, bool asHex, FILE* f)
+void PrintSingleVal(int8_t s8, bool asHex, mtdisasm::TextWriter& f)
 {
 	if (asHex)
-		fprintf(f, "%02x", static_cast<unsigned int>(s8 & 0xff));
+		f.WriteHex(static_cast<uint32_t>(s8 & 0xff), 2);
 	else
-		fprintf(f, "%i", static_cast<int>(s8));
+		f.WriteDec(static_cast<int32_t>(s8));
 }
 
-void PrintSingleVal(const mtdisasm::DORect& rect, bool asHex, FILE* f)
+void PrintSingleVal(const mtdisasm::DORect& rect, bool asHex, mtdisasm::TextWriter& f)
 {
-	fputs("(", f);
+	f.Write("(");
 	PrintSingleVal(rect.m_left, asHex, f);
-	fputs(",", f);
+	f.Write(",");
 	PrintSingleVal(rect.m_top, asHex, f);
-	fputs(")-(", f);
+	f.Write(")-(");
 	PrintSingleVal(rect.m_right, asHex, f);
-	fputs(",", f);
+	f.Write(",");
 	PrintSingleVal(rect.m_bottom, asHex, f);
-	fprintf(f, ") [%i x %i]", static_cast<int>(rect.m_right - rect.m_left), static_cast<int>(rect.m_bottom - rect.m_top));
+	f.Write(") [");
+	f.WriteDec(static_cast<int32_t>(rect.m_right - rect.m_left));
+	f.Write(" x ");
+	f.WriteDec(static_cast<int32_t>(rect.m_bottom - rect.m_top));
+	f.Put(']');
 }
 
-void PrintSingleVal(const mtdisasm::DOPoint& pt, bool asHex, FILE* f)
+void PrintSingleVal(const mtdisasm::DOPoint& pt, bool asHex, mtdisasm::TextWriter& f)
 {
-	fputs("(", f);
+	f.Write("(");
 	PrintSingleVal(pt.m_left, asHex, f);
-	fputs(",", f);
+	f.Write(",");
 	PrintSingleVal(pt.m_top, asHex, f);
-	fputs(")", f);
+	f.Write(")");
 }
 
-void PrintSingleVal(const mtdisasm::DOEvent& pt, bool asHex, FILE* f)
+void PrintSingleVal(const mtdisasm::DOEvent& pt, bool asHex, mtdisasm::TextWriter& f)
 {
-	fputs("event(", f);
+	f.Write("event(");
 	PrintSingleVal(pt.m_eventID, asHex, f);
-	fputs(",", f);
+	f.Write(",");
 	PrintSingleVal(pt.m_eventInfo, asHex, f);
-	fputs(")", f);
+	f.Write(")");
 }
 
-void PrintSingleVal(const mtdisasm::DOLabel &lbl, bool asHex, FILE *f)
+void PrintSingleVal(const mtdisasm::DOLabel &lbl, bool asHex, mtdisasm::TextWriter& f)
 {
-	fputs("label(", f);
+	f.Write("label(");
 	PrintSingleVal(lbl.m_superGroupID, asHex, f);
-	fputs(",", f);
+	f.Write(",");
 	PrintSingleVal(lbl.m_id, asHex, f);
-	fputs(")", f);
+	f.Write(")");
 }
 
-void PrintSingleVal(const mtdisasm::DOColor& clr, bool asHex, FILE* f)
+void PrintSingleVal(const mtdisasm::DOColor& clr, bool asHex, mtdisasm::TextWriter& f)
 {
-	fputs("color(", f);
+	f.Write("color(");
 	PrintSingleVal(clr.m_red, asHex, f);
-	fputs(",", f);
+	f.Write(",");
 	PrintSingleVal(clr.m_green, asHex, f);
-	fputs(",", f);
+	f.Write(",");
 	PrintSingleVal(clr.m_blue, asHex, f);
-	fputs(")", f);
+	f.Write(")");
 }
 
-void PrintSingleVal(const mtdisasm::DOFloat& fl, bool asHex, FILE* f)
+void PrintSingleVal(const mtdisasm::DOFloat& fl, bool asHex, mtdisasm::TextWriter& f)
 {
-	fprintf(f, "%g", fl.m_value);
+	f.Printf("%g", fl.m_value);
 }
 
-void PrintSingleVal(const mtdisasm::DOVector& v, bool asHex, FILE* f)
+void PrintSingleVal(const mtdisasm::DOVector& v, bool asHex, mtdisasm::TextWriter& f)
 {
-	fprintf(f, "(%g rad %g mag)", v.m_angleRadians.m_value, v.m_magnitude.m_value);
+	f.Printf("(%g rad %g mag)", v.m_angleRadians.m_value, v.m_magnitude.m_value);
 }
 
-void PrintSingleVal(const mtdisasm::PlugInTypeTaggedValue& v, bool asHex, FILE* f)
+void PrintSingleVal(const mtdisasm::PlugInTypeTaggedValue& v, bool asHex, mtdisasm::TextWriter& f)
 {
 	switch (v.m_type)
 	{
 	case mtdisasm::PlugInTypeTaggedValue::kLabel:
 		if (asHex)
-			fprintf(f, "label(%08x:%08x)", v.m_value.m_lbl.m_superGroup, v.m_value.m_lbl.m_id);
+			f.Printf("label(%08x:%08x)", v.m_value.m_lbl.m_superGroup, v.m_value.m_lbl.m_id);
 		else
-			fprintf(f, "label(%u:%u)", v.m_value.m_lbl.m_superGroup, v.m_value.m_lbl.m_id);
+			f.Printf("label(%u:%u)", v.m_value.m_lbl.m_superGroup, v.m_value.m_lbl.m_id);
 		break;
 	case mtdisasm::PlugInTypeTaggedValue::kInteger:
 		if (asHex)
-			fprintf(f, "%08x", v.m_value.m_int);
+			f.Printf("%08x", v.m_value.m_int);
 		else
-			fprintf(f, "%i", v.m_value.m_int);
+			f.Printf("%i", v.m_value.m_int);
 		break;
 	case mtdisasm::PlugInTypeTaggedValue::kBoolean:
-		fputs(v.m_value.m_bool ? "true" : "false", f);
+		f.Write(v.m_value.m_bool ? "true" : "false");
 		break;
 	case mtdisasm::PlugInTypeTaggedValue::kNull:
-		fputs("null", f);
+		f.Write("null");
 		break;
 	case mtdisasm::PlugInTypeTaggedValue::kIncomingData:
-		fputs("incoming data", f);
+		f.Write("incoming data");
 		break;
 	case mtdisasm::PlugInTypeTaggedValue::kVariableRef:
-		fprintf(f, "var(%08x)", v.m_value.m_var.m_guid);
+		f.Printf("var(%08x)", v.m_value.m_var.m_guid);
 		break;
 	default:
-		fputs("UNKNOWN_TYPE", f);
+		f.Write("UNKNOWN_TYPE");
 		break;
 	}
 }
 
 template<size_t TSize, class T>
-void PrintSingleVal(const T (&arr)[TSize], bool asHex, FILE* f)
+void PrintSingleVal(const T (&arr)[TSize], bool asHex, mtdisasm::TextWriter& f)
 {
 	for (size_t i = 0; i < TSize; i++)
 	{
 		if (i != 0)
-			fputc(' ', f);
+			f.Put(' ');
 		PrintSingleVal(arr[i], asHex, f);
 	}
 }
 
 template<class T>
-void PrintVal(const char* name, const T& value, FILE* f)
+void PrintVal(const char* name, const T& value, mtdisasm::TextWriter& f)
 {
-	fputs(name, f);
-	fputs(": ", f);
+	f.Write(name);
+	f.Write(": ");
 	PrintSingleVal(value, false, f);
-	fputs("\n", f);
+	f.Write("\n");
 }
 
 template<class T>
-void PrintHex(const char* name, const T& value, FILE* f)
+void PrintHex(const char* name, const T& value, mtdisasm::TextWriter& f)
 {
-	fputs(name, f);
-	fputs(": ", f);
+	f.Write(name);
+	f.Write(": ");
 	PrintSingleVal(value, true, f);
-	fputs("\n", f);
+	f.Write("\n");
 }
 
-void PrintStr(const char* name, const char* value, FILE* f)
+void PrintStr(const char* name, const char* value, mtdisasm::TextWriter& f)
 {
-	fputs(name, f);
-	fputs(": ", f);
-	fputs(value, f);
-	fputs("\n", f);
+	f.Write(name);
+	f.Write(": ");
+	f.Write(value);
+	f.Write("\n");
 }
 
-void PrintStr(const char* name, const std::vector<char>& chars, FILE* f)
+void PrintStr(const char* name, const mtdisasm::ArenaVector<char>& chars, mtdisasm::TextWriter& f)
 {
-	fputs(name, f);
-	fputs(": '", f);
+	f.Write(name);
+	f.Write(": '");
 	if (chars.size() > 1)
-		fwrite(&chars[0], 1, chars.size() - 1, f);
-	fputs("'\n", f);
+		f.Write(&chars[0], chars.size() - 1);
+	f.Write("'\n");
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOStreamHeader& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOStreamHeader& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kStreamHeader);
 
@@ -458,7 +365,7 @@ void PrintObjectDisassembly(const mtdisasm::DOStreamHeader& obj, FILE* f)
 	PrintHex("Unknown2", obj.m_unknown2, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOPresentationSettings& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOPresentationSettings& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kPresentationSettings);
 
@@ -471,7 +378,7 @@ void PrintObjectDisassembly(const mtdisasm::DOPresentationSettings& obj, FILE* f
 	PrintHex("Unknown4", obj.m_unknown4, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOGlobalObjectInfo& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOGlobalObjectInfo& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kGlobalObjectInfo);
 
@@ -481,7 +388,7 @@ void PrintObjectDisassembly(const mtdisasm::DOGlobalObjectInfo& obj, FILE* f)
 	PrintHex("Unknown1", obj.m_unknown1, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOUnknown19& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOUnknown19& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kUnknown19);
 
@@ -491,7 +398,7 @@ void PrintObjectDisassembly(const mtdisasm::DOUnknown19& obj, FILE* f)
 	PrintHex("Unknown1", obj.m_unknown1, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DODebris& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DODebris& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kDebris);
 
@@ -499,22 +406,22 @@ void PrintObjectDisassembly(const mtdisasm::DODebris& obj, FILE* f)
 	PrintVal("Size", obj.m_sizeIncludingTag, f);
 }
 
-void PrintLabelTree(const mtdisasm::DOProjectLabelMap::LabelTree& obj, FILE* f, int indentLevel)
+void PrintLabelTree(const mtdisasm::DOProjectLabelMap::LabelTree& obj, mtdisasm::TextWriter& f, int indentLevel)
 {
 	for (int i = 0; i < indentLevel; i++)
-		fputs("    ", f);
+		f.Write("    ");
 
 
-	fprintf(f, "Item '");
+	f.Write("Item '");
 	if (obj.m_nameLength > 0)
-		fwrite(&obj.m_name[0], 1, obj.m_nameLength, f);
-	fprintf(f, "'  IsGroup=%u  ID=%i  Unknown2=%x  Flags=%x\n", obj.m_isGroup, obj.m_id, obj.m_unknown1, obj.m_flags);
+		f.Write(&obj.m_name[0], obj.m_nameLength);
+	f.Printf("'  IsGroup=%u  ID=%i  Unknown2=%x  Flags=%x\n", obj.m_isGroup, obj.m_id, obj.m_unknown1, obj.m_flags);
 
 	for (size_t i = 0; i < obj.m_numChildren; i++)
 		PrintLabelTree(obj.m_children[i], f, indentLevel + 1);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOProjectLabelMap& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOProjectLabelMap& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kProjectLabelMap);
 
@@ -526,31 +433,31 @@ void PrintObjectDisassembly(const mtdisasm::DOProjectLabelMap& obj, FILE* f)
 	for (size_t i = 0; i < obj.m_numSuperGroups; i++)
 	{
 		const mtdisasm::DOProjectLabelMap::SuperGroup& sg = obj.m_superGroups[i];
-		fprintf(f, "SuperGroup '");
+		f.Write("SuperGroup '");
 		if (sg.m_nameLength > 0)
-			fwrite(&sg.m_name[0], 1, sg.m_nameLength, f);
+			f.Write(&sg.m_name[0], sg.m_nameLength);
 
-		fprintf(f, "'  NumChildren=%u  Unknown1=%x  Unknown2=%x\n", sg.m_numChildren, sg.m_id, sg.m_unknown2);
+		f.Printf("'  NumChildren=%u  Unknown1=%x  Unknown2=%x\n", sg.m_numChildren, sg.m_id, sg.m_unknown2);
 
 		for (size_t j = 0; j < sg.m_numChildren; j++)
 			PrintLabelTree(sg.m_tree[j], f, 1);
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOProjectStructuralDef& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOProjectStructuralDef& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kProjectStructuralDef);
 
 	PrintHex("Unknown1", obj.m_unknown1, f);
 	PrintHex("GUID", obj.m_guid, f);
 	PrintHex("Flags", obj.m_flags, f);
-	fputs("Name: '", f);
+	f.Write("Name: '");
 	if (obj.m_nameLength >= 1)
-		fwrite(&obj.m_name[0], 1, obj.m_nameLength - 1, f);
-	fputs("'\n", f);
+		f.Write(&obj.m_name[0], obj.m_nameLength - 1);
+	f.Write("'\n");
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOAssetCatalog& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOAssetCatalog& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kAssetCatalog);
 
@@ -574,17 +481,17 @@ void PrintObjectDisassembly(const mtdisasm::DOAssetCatalog& obj, FILE* f)
 			memcpy(assetTypeName, "Unknown ", 8);
 
 		assetTypeName[8] = 0;
-		fprintf(f, "Asset % 4u: Flags1=%08x  AlwaysZero=%04x  Unknown1=%08x  FilePosition=%08x  AssetType=%s  Flags2=%08x", static_cast<unsigned int>(i + 1), asset.m_flags1, asset.m_alwaysZero, asset.m_unknown1, asset.m_filePosition, assetTypeName, flags2);
+		f.Printf("Asset % 4u: Flags1=%08x  AlwaysZero=%04x  Unknown1=%08x  FilePosition=%08x  AssetType=%s  Flags2=%08x", static_cast<unsigned int>(i + 1), asset.m_flags1, asset.m_alwaysZero, asset.m_unknown1, asset.m_filePosition, assetTypeName, flags2);
 		if (asset.m_nameLength > 0)
 		{
-			fputs("  ", f);
-			fwrite(&asset.m_name[0], 1, asset.m_nameLength - 1, f);
+			f.Write("  ");
+			f.Write(&asset.m_name[0], asset.m_nameLength - 1);
 		}
-		fputs("\n", f);
+		f.Write("\n");
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOColorTableAsset& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOColorTableAsset& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kColorTableAsset);
 
@@ -593,21 +500,21 @@ void PrintObjectDisassembly(const mtdisasm::DOColorTableAsset& obj, FILE* f)
 	PrintHex("Unknown1", obj.m_unknown1, f);
 	PrintVal("AssetID", obj.m_assetID, f);
 	PrintHex("Unknown2", obj.m_unknown2, f);
-	fprintf(f, "Colors:");
+	f.Write("Colors:");
 
 	for (uint32_t i = 0; i < 256; i++)
 	{
 		if (i % 16 == 0)
-			fputs("\n   ", f);
-		fputc(' ', f);
+			f.Write("\n   ");
+		f.Put(' ');
 
 		const mtdisasm::DOColorTableAsset::ColorDef& cdef = obj.m_colors[i];
-		fprintf(f, "%02x%02x%02x", (cdef.m_red / 0x101), (cdef.m_green / 0x101), (cdef.m_blue / 0x101));
+		f.Printf("%02x%02x%02x", (cdef.m_red / 0x101), (cdef.m_green / 0x101), (cdef.m_blue / 0x101));
 	}
-	fputc('\n', f);
+	f.Put('\n');
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOSectionStructuralDef& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOSectionStructuralDef& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kSectionStructuralDef);
 
@@ -618,13 +525,13 @@ void PrintObjectDisassembly(const mtdisasm::DOSectionStructuralDef& obj, FILE* f
 	PrintHex("GUID", obj.m_guid, f);
 	PrintHex("Flags", obj.m_flags, f);
 	PrintHex("Unknown4", obj.m_unknown4, f);
-	fputs("Name: '", f);
+	f.Write("Name: '");
 	if (obj.m_lengthOfName > 0)
-		fwrite(&obj.m_name[0], 1, obj.m_lengthOfName - 1, f);
-	fputs("'\n", f);
+		f.Write(&obj.m_name[0], obj.m_lengthOfName - 1);
+	f.Write("'\n");
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOSubsectionStructuralDef& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOSubsectionStructuralDef& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kSubsectionStructuralDef);
 
@@ -633,13 +540,13 @@ void PrintObjectDisassembly(const mtdisasm::DOSubsectionStructuralDef& obj, FILE
 	PrintHex("GUID", obj.m_guid, f);
 	PrintHex("Flags", obj.m_flags, f);
 	PrintVal("SectionID", obj.m_sectionID, f);
-	fputs("Name: '", f);
+	f.Write("Name: '");
 	if (obj.m_lengthOfName > 0)
-		fwrite(&obj.m_name[0], 1, obj.m_lengthOfName - 1, f);
-	fputs("'\n", f);
+		f.Write(&obj.m_name[0], obj.m_lengthOfName - 1);
+	f.Write("'\n");
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOGraphicStructuralDef& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOGraphicStructuralDef& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kGraphicStructuralDef);
 
@@ -652,16 +559,16 @@ void PrintObjectDisassembly(const mtdisasm::DOGraphicStructuralDef& obj, FILE* f
 	PrintVal("Rect1", obj.m_rect1, f);
 	PrintVal("Rect2", obj.m_rect2, f);
 	PrintHex("StreamLocator", obj.m_streamLocator, f);
-	fprintf(f, "    Stream ID: %i\n", static_cast<int>(obj.m_streamLocator & mtdisasm::kSceneLocatorStreamIDMask));
+	f.Printf("    Stream ID: %i\n", static_cast<int>(obj.m_streamLocator & mtdisasm::kSceneLocatorStreamIDMask));
 
 	PrintHex("Unknown11", obj.m_unknown11, f);
-	fputs("Name: '", f);
+	f.Write("Name: '");
 	if (obj.m_lengthOfName > 0)
-		fwrite(&obj.m_name[0], 1, obj.m_lengthOfName - 1, f);
-	fputs("'\n", f);
+		f.Write(&obj.m_name[0], obj.m_lengthOfName - 1);
+	f.Write("'\n");
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOTextStructuralDef& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOTextStructuralDef& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kTextStructuralDef);
 
@@ -688,7 +595,7 @@ void PrintObjectDisassembly(const mtdisasm::DOTextStructuralDef& obj, FILE* f)
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOSoundStructuralDef& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOSoundStructuralDef& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kSoundStructuralDef);
 
@@ -708,7 +615,7 @@ void PrintObjectDisassembly(const mtdisasm::DOSoundStructuralDef& obj, FILE* f)
 	PrintStr("Name", obj.m_name, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOImageStructuralDef& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOImageStructuralDef& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kImageStructuralDef);
 
@@ -722,15 +629,15 @@ void PrintObjectDisassembly(const mtdisasm::DOImageStructuralDef& obj, FILE* f)
 	PrintVal("Rect2", obj.m_rect2, f);
 	PrintVal("ImageAssetID", obj.m_imageAssetID, f);
 	PrintVal("StreamLocator", obj.m_streamLocator, f);
-	fprintf(f, "    Stream ID: %i\n", static_cast<int>(obj.m_streamLocator & mtdisasm::kSceneLocatorStreamIDMask));
+	f.Printf("    Stream ID: %i\n", static_cast<int>(obj.m_streamLocator & mtdisasm::kSceneLocatorStreamIDMask));
 	PrintHex("Unknown7", obj.m_unknown7, f);
-	fputs("Name: '", f);
+	f.Write("Name: '");
 	if (obj.m_lengthOfName > 0)
-		fwrite(&obj.m_name[0], 1, obj.m_lengthOfName - 1, f);
-	fputs("'\n", f);
+		f.Write(&obj.m_name[0], obj.m_lengthOfName - 1);
+	f.Write("'\n");
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOMovieStructuralDef& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOMovieStructuralDef& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kMovieStructuralDef || obj.GetType() == mtdisasm::DataObjectType::kExternalMovieStructuralDef);
 
@@ -751,15 +658,15 @@ void PrintObjectDisassembly(const mtdisasm::DOMovieStructuralDef& obj, FILE* f)
 	PrintHex("Unknown10", obj.m_unknown10, f);
 	PrintHex("Unknown11", obj.m_unknown11, f);
 	PrintHex("StreamLocator", obj.m_streamLocator, f);
-	fprintf(f, "    Stream ID: %i\n", static_cast<int>(obj.m_streamLocator & mtdisasm::kSceneLocatorStreamIDMask));
+	f.Printf("    Stream ID: %i\n", static_cast<int>(obj.m_streamLocator & mtdisasm::kSceneLocatorStreamIDMask));
 	PrintHex("Unknown13", obj.m_unknown13, f);
-	fputs("Name: '", f);
+	f.Write("Name: '");
 	if (obj.m_lengthOfName > 0)
-		fwrite(&obj.m_name[0], 1, obj.m_lengthOfName - 1, f);
-	fputs("'\n", f);
+		f.Write(&obj.m_name[0], obj.m_lengthOfName - 1);
+	f.Write("'\n");
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOMToonStructuralDef& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOMToonStructuralDef& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kMToonStructuralDef);
 
@@ -779,13 +686,13 @@ void PrintObjectDisassembly(const mtdisasm::DOMToonStructuralDef& obj, FILE* f)
 	PrintHex("StreamLocator", obj.m_streamLocator, f);
 	PrintHex("Unknown6", obj.m_unknown6, f);
 
-	fputs("Name: '", f);
+	f.Write("Name: '");
 	if (obj.m_lengthOfName > 0)
-		fwrite(&obj.m_name[0], 1, obj.m_lengthOfName - 1, f);
-	fputs("'\n", f);
+		f.Write(&obj.m_name[0], obj.m_lengthOfName - 1);
+	f.Write("'\n");
 }
 
-bool PrintMiniscriptInstructionDisassembly(FILE* f, mtdisasm::DataReader& reader, const mtdisasm::SerializationProperties& sp, int opcode, int sizeOfInstrData)
+bool PrintMiniscriptInstructionDisassembly(mtdisasm::TextWriter& f, mtdisasm::DataReader& reader, const mtdisasm::SerializationProperties& sp, int opcode, int sizeOfInstrData)
 {
 	switch (opcode)
 	{
@@ -812,27 +719,27 @@ bool PrintMiniscriptInstructionDisassembly(FILE* f, mtdisasm::DataReader& reader
 			if (!reader.ReadU32(globID))
 				return false;
 			if (globID == 1)
-				fputs("default", f);
+				f.Write("default");
 			else if (globID == 2)
-				fputs("modifier", f);
+				f.Write("modifier");
 			else if (globID == 3)
-				fputs("source", f);
+				f.Write("source");
 			else if (globID == 4)
-				fputs("incoming", f);
+				f.Write("incoming");
 			else if (globID == 5)
-				fputs("mouse", f);
+				f.Write("mouse");
 			else if (globID == 6)
-				fputs("ticks", f);
+				f.Write("ticks");
 			else if (globID == 7)
-				fputs("scene", f);
+				f.Write("scene");
 			else if (globID == 8)
-				fputs("sharedScene", f);
+				f.Write("sharedScene");
 			else if (globID == 9)
-				fputs("section", f);
+				f.Write("section");
 			else if (globID == 10)
-				fputs("project", f);
+				f.Write("project");
 			else if (globID == 11)
-				fputs("activeScene", f);
+				f.Write("activeScene");
 			else
 				PrintSingleVal(globID, true, f);
 		}
@@ -843,14 +750,14 @@ bool PrintMiniscriptInstructionDisassembly(FILE* f, mtdisasm::DataReader& reader
 			if (!reader.ReadU32(flags) || !reader.ReadU32(unknown) || !reader.ReadU32(instrOffset))
 				return false;
 			if (flags == 2)
-				fputs("conditional ", f);
+				f.Write("conditional ");
 			else if (flags == 1)
 			{
 			}
 			else
-				fprintf(f, "unknown_flags(%08x)", flags);
+				f.Printf("unknown_flags(%08x)", flags);
 
-			fprintf(f, "  unknown=%x  skip=%u", unknown, instrOffset);
+			f.Printf("  unknown=%x  skip=%u", unknown, instrOffset);
 
 		}
 		break;
@@ -861,7 +768,7 @@ bool PrintMiniscriptInstructionDisassembly(FILE* f, mtdisasm::DataReader& reader
 				return false;
 
 			if (dataType == 0)
-				fputs("null", f);
+				f.Write("null");
 			else if (dataType == 0x15)
 			{
 				double d;
@@ -875,38 +782,38 @@ bool PrintMiniscriptInstructionDisassembly(FILE* f, mtdisasm::DataReader& reader
 					if (!reader.ReadF64(d))
 						return false;
 				}
-				fprintf(f, "double %g", d);
+				f.Printf("double %g", d);
 			}
 			else if (dataType == 0x1a)
 			{
 				uint8_t b;
 				if (!reader.ReadU8(b))
 					return false;
-				fprintf(f, "bool %s", ((b == 0) ? "false" : "true"));
+				f.Printf("bool %s", ((b == 0) ? "false" : "true"));
 			}
 			else if (dataType == 0x1f9)
 			{
 				uint32_t u;
 				if (!reader.ReadU32(u))
 					return false;
-				fprintf(f, "local %u", u);
+				f.Printf("local %u", u);
 			}
 			else if (dataType == 0x1fa)
 			{
 				uint32_t u;
 				if (!reader.ReadU32(u))
 					return false;
-				fprintf(f, "global %08x", u);
+				f.Printf("global %08x", u);
 			}
 			else if (dataType == 0x1d)
 			{
 				uint32_t superGroup, lbl;
 				if (!reader.ReadU32(superGroup) || !reader.ReadU32(lbl))
 					return false;
-				fprintf(f, "label %u %u", superGroup, lbl);
+				f.Printf("label %u %u", superGroup, lbl);
 			}
 			else
-				fprintf(f, "unknown_type %x", static_cast<int>(dataType));
+				f.Printf("unknown_type %x", static_cast<int>(dataType));
 		}
 		break;
 	case 0x193:
@@ -921,10 +828,10 @@ bool PrintMiniscriptInstructionDisassembly(FILE* f, mtdisasm::DataReader& reader
 				str.resize(strLength + 1);
 				if (!reader.ReadBytes(&str[0], strLength + 1) || str[strLength] != 0)
 					return false;
-				fprintf(f, "str '%s'", &str[0]);
+				f.Printf("str '%s'", &str[0]);
 			}
 			else
-				fputs("str ''", f);
+				f.Write("str ''");
 		}
 		break;
 	default:
@@ -935,8 +842,8 @@ bool PrintMiniscriptInstructionDisassembly(FILE* f, mtdisasm::DataReader& reader
 				return false;
 
 			if (i != 0)
-				fputc(' ', f);
-			fprintf(f, "%02x", static_cast<int>(byte));
+				f.Put(' ');
+			f.WriteHex(byte, 2);
 		}
 		break;
 	}
@@ -1148,10 +1055,10 @@ MiniscriptExpressionTree* PopOne(MiniscriptExpressionTree& stack)
 	return tree;
 }
 
-void PrintIndent(int indentationLevel, FILE* f)
+void PrintIndent(int indentationLevel, mtdisasm::TextWriter& f)
 {
 	for (int i = 0; i < indentationLevel; i++)
-		fputc('\t', f);
+		f.Put('\t');
 }
 
 enum MiniscriptOperatorPrecedence
@@ -1317,7 +1224,7 @@ void ResolveExprFragmentationPrecedence(const MiniscriptExpressionTree* expr, Mi
 	}
 }
 
-void PrintExpression(const MiniscriptExpressionTree* expr, const mtdisasm::DOMiniscriptProgram& obj, FILE* f);
+void PrintExpression(const MiniscriptExpressionTree* expr, const mtdisasm::DOMiniscriptProgram& obj, mtdisasm::TextWriter& f);
 
 bool GetBuiltinFunctionProperties(uint32_t builtinId, uint32_t& outNumParams, const char*& outName)
 {
@@ -1350,7 +1257,7 @@ bool GetBuiltinFunctionProperties(uint32_t builtinId, uint32_t& outNumParams, co
 	}
 }
 
-void PrintBinaryExpression(const MiniscriptExpressionTree* expr, const mtdisasm::DOMiniscriptProgram& obj, FILE* f)
+void PrintBinaryExpression(const MiniscriptExpressionTree* expr, const mtdisasm::DOMiniscriptProgram& obj, mtdisasm::TextWriter& f)
 {
 	const char* op = "???";
 
@@ -1384,21 +1291,21 @@ void PrintBinaryExpression(const MiniscriptExpressionTree* expr, const mtdisasm:
 	ResolveBinaryOpExprFragmentationPrecedence(expr, leftPrec, rightPrec, leftNeedsParen, rightNeedsParen);
 
 	if (leftNeedsParen)
-		fputc('(', f);
+		f.Put('(');
 	PrintExpression(expr->m_children[0], obj, f);
 	if (leftNeedsParen)
-		fputc(')', f);
-	fputc(' ', f);
-	fputs(op, f);
-	fputc(' ', f);
+		f.Put(')');
+	f.Put(' ');
+	f.Write(op);
+	f.Put(' ');
 	if (rightNeedsParen)
-		fputc('(', f);
+		f.Put('(');
 	PrintExpression(expr->m_children[1], obj, f);
 	if (rightNeedsParen)
-		fputc(')', f);
+		f.Put(')');
 }
 
-void PrintUnaryExpression(const MiniscriptExpressionTree* expr, const mtdisasm::DOMiniscriptProgram& obj, FILE* f)
+void PrintUnaryExpression(const MiniscriptExpressionTree* expr, const mtdisasm::DOMiniscriptProgram& obj, mtdisasm::TextWriter& f)
 {
 	const char* op = "???";
 
@@ -1416,20 +1323,20 @@ void PrintUnaryExpression(const MiniscriptExpressionTree* expr, const mtdisasm::
 	bool needsParen;
 	ResolveUnaryOpExprFragmentationPrecedence(expr, leftPrec, rightPrec, needsParen);
 
-	fputs(op, f);
+	f.Write(op);
 	if (needsParen)
-		fputc('(', f);
+		f.Put('(');
 	PrintExpression(expr->m_children[0], obj, f);
 	if (needsParen)
-		fputc(')', f);
+		f.Put(')');
 }
 
-void EmitStr(const std::vector<char>& str, FILE* f)
+void EmitStr(const mtdisasm::ArenaVector<char>& str, mtdisasm::TextWriter& f)
 {
 	size_t len = str.size();
 	if (len == 0)
 	{
-		fputs("\"\"", f);
+		f.Write("\"\"");
 		return;
 	}
 
@@ -1456,13 +1363,13 @@ void EmitStr(const std::vector<char>& str, FILE* f)
 	}
 
 	if (needsQuotes)
-		fputc('\"', f);
-	fwrite(&str[0], 1, len, f);
+		f.Put('\"');
+	f.Write(&str[0], len);
 	if (needsQuotes)
-		fputc('\"', f);
+		f.Put('\"');
 }
 
-void EmitPushValue(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscriptProgram& obj, FILE* f)
+void EmitPushValue(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscriptProgram& obj, mtdisasm::TextWriter& f)
 {
 	if (instr.m_contents.size() != 0)
 	{
@@ -1475,7 +1382,7 @@ void EmitPushValue(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscr
 			switch (type)
 			{
 			case 0x00:
-				fputs("NULL", f);
+				f.Write("NULL");
 				return;
 			case 0x15:
 				{
@@ -1488,7 +1395,7 @@ void EmitPushValue(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscr
 
 					if (readOK)
 					{
-						fprintf(f, "%g", d);
+						f.Printf("%g", d);
 						return;
 					}
 				}
@@ -1498,7 +1405,7 @@ void EmitPushValue(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscr
 					uint8_t b;
 					if (reader.ReadU8(b))
 					{
-						fprintf(f, "%s", ((b == 0) ? "false" : "true"));
+						f.Write((b == 0) ? "false" : "true");
 						return;
 					}
 				}
@@ -1510,7 +1417,7 @@ void EmitPushValue(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscr
 					{
 						if (u32 < obj.m_numLocalRefs)
 						{
-							fputs("local:", f);
+							f.Write("local:");
 							EmitStr(obj.m_localRefs[u32].m_name, f);
 							return;
 						}
@@ -1522,7 +1429,7 @@ void EmitPushValue(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscr
 					uint32_t u32;
 					if (reader.ReadU32(u32))
 					{
-						fprintf(f, "global:%08x", static_cast<int>(u32));
+						f.Printf("global:%08x", static_cast<int>(u32));
 						return;
 					}
 				}
@@ -1533,7 +1440,7 @@ void EmitPushValue(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscr
 					uint32_t label;
 					if (reader.ReadU32(superGroup) && reader.ReadU32(label))
 					{
-						fprintf(f, "label:(%i:%x)", static_cast<int>(superGroup), static_cast<int>(label));
+						f.Printf("label:(%i:%x)", static_cast<int>(superGroup), static_cast<int>(label));
 						return;
 					}
 				}
@@ -1542,10 +1449,10 @@ void EmitPushValue(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscr
 		}
 	}
 
-	fputs("<BAD VALUE>", f);
+	f.Write("<BAD VALUE>");
 }
 
-void EmitPushGlobal(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscriptProgram& obj, FILE* f)
+void EmitPushGlobal(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscriptProgram& obj, mtdisasm::TextWriter& f)
 {
 	if (instr.m_contents.size() < 4)
 		return;
@@ -1571,16 +1478,16 @@ void EmitPushGlobal(const MiniscriptInstruction& instr, const mtdisasm::DOMinisc
 	case 10: name = "project"; break;
 	case 11: name = "activeScene"; break;
 	default:
-		fprintf(f, "unknown_env_%08x", static_cast<int>(globID));
+		f.Printf("unknown_env_%08x", static_cast<int>(globID));
 		return;
 	}
 
-	fputs(name, f);
+	f.Write(name);
 }
 
-void EmitPushStr(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscriptProgram& obj, FILE* f)
+void EmitPushStr(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscriptProgram& obj, mtdisasm::TextWriter& f)
 {
-	fputc('\"', f);
+	f.Put('\"');
 
 	if (instr.m_contents.size() >= 2)
 	{
@@ -1589,13 +1496,13 @@ void EmitPushStr(const MiniscriptInstruction& instr, const mtdisasm::DOMiniscrip
 
 		uint16_t strLength = 0;
 		if (reader.ReadU16(strLength) && instr.m_contents.size() >= (3 + strLength))
-			fwrite(&instr.m_contents[2], 1, strLength, f);
+			f.Write(reinterpret_cast<const char*>(&instr.m_contents[2]), strLength);
 	}
 
-	fputc('\"', f);
+	f.Put('\"');
 }
 
-void EmitGetChild(const MiniscriptExpressionTree* expr, const mtdisasm::DOMiniscriptProgram& obj, FILE* f)
+void EmitGetChild(const MiniscriptExpressionTree* expr, const mtdisasm::DOMiniscriptProgram& obj, mtdisasm::TextWriter& f)
 {
 	if (expr->m_instr->m_contents.size() < 4)
 		return;
@@ -1607,22 +1514,22 @@ void EmitGetChild(const MiniscriptExpressionTree* expr, const mtdisasm::DOMinisc
 	reader.ReadU32(attribID);
 
 	PrintExpression(expr->m_children[0], obj, f);
-	fputc('.', f);
+	f.Put('.');
 
 	if (attribID < obj.m_attributes.size())
 		EmitStr(obj.m_attributes[attribID].m_name, f);
 	else
-		fprintf(f, "unknown_attrib_%08x", static_cast<int>(attribID));
+		f.Printf("unknown_attrib_%08x", static_cast<int>(attribID));
 
 	if (expr->m_instr->m_flags & 0x20)
 	{
-		fputc('[', f);
+		f.Put('[');
 		PrintExpression(expr->m_children[1], obj, f);
-		fputc(']', f);
+		f.Put(']');
 	}
 }
 
-void PrintExpression(const MiniscriptExpressionTree* expr, const mtdisasm::DOMiniscriptProgram& obj, FILE* f)
+void PrintExpression(const MiniscriptExpressionTree* expr, const mtdisasm::DOMiniscriptProgram& obj, mtdisasm::TextWriter& f)
 {
 	switch (expr->m_instr->m_opcode)
 	{
@@ -1666,46 +1573,46 @@ void PrintExpression(const MiniscriptExpressionTree* expr, const mtdisasm::DOMin
 			const char* name = nullptr;
 			if (GetBuiltinFunctionProperties(funcID, numArgs, name))
 			{
-				fputs(name, f);
-				fputc('(', f);
+				f.Write(name);
+				f.Put('(');
 				for (size_t i = 0; i < numArgs; i++)
 				{
 					PrintExpression(expr->m_children[i], obj, f);
 					if (i != numArgs - 1)
-						fputs(", ", f);
+						f.Write(", ");
 				}
-				fputc(')', f);
+				f.Put(')');
 			}
 		}
 		break;
 	
 	case 0x12f:
 		{
-			fputs("(", f);
+			f.Write("(");
 			PrintExpression(expr->m_children[0], obj, f);
-			fputs(", ", f);
+			f.Write(", ");
 			PrintExpression(expr->m_children[1], obj, f);
-			fputs(")", f);
+			f.Write(")");
 
 		}
 		break;
 	case 0x130:
 		{
-			fputs("(", f);
+			f.Write("(");
 			PrintExpression(expr->m_children[0], obj, f);
-			fputs(" thru ", f);
+			f.Write(" thru ");
 			PrintExpression(expr->m_children[1], obj, f);
-			fputs(")", f);
+			f.Write(")");
 
 		}
 		break;
 	case 0x131:
 		{
-			fputs("(", f);
+			f.Write("(");
 			PrintExpression(expr->m_children[0], obj, f);
-			fputs(" deg ", f);
+			f.Write(" deg ");
 			PrintExpression(expr->m_children[1], obj, f);
-			fputs(" mag)", f);
+			f.Write(" mag)");
 		}
 		break;
 	case 0x135:
@@ -1719,20 +1626,20 @@ void PrintExpression(const MiniscriptExpressionTree* expr, const mtdisasm::DOMin
 				rsExprs.push_back(expr->m_children[1]);
 				expr = expr->m_children[0];
 			}
-			fputs("{ ", f);
+			f.Write("{ ");
 			PrintExpression(expr, obj, f);
 			for (size_t i = 0; i < rsExprs.size(); i++)
 			{
-				fputs(", ", f);
+				f.Write(", ");
 				PrintExpression(rsExprs[rsExprs.size() - 1 - i], obj, f);
 			}
-			fputs(" }", f);
+			f.Write(" }");
 		}
 		break;
 	case 0x137:
 		{
 			PrintExpression(expr->m_children[0], obj, f);
-			fputs(", ", f);
+			f.Write(", ");
 			PrintExpression(expr->m_children[1], obj, f);
 		}
 		break;
@@ -1748,7 +1655,7 @@ void PrintExpression(const MiniscriptExpressionTree* expr, const mtdisasm::DOMin
 	}
 }
 
-void PrintEvent(const mtdisasm::DOEvent& evt, FILE* f)
+void PrintEvent(const mtdisasm::DOEvent& evt, mtdisasm::TextWriter& f)
 {
 	PrintSingleVal(evt, false, f);
 }
@@ -1772,7 +1679,7 @@ bool CombineExpr(MiniscriptExpressionTree& stack, const MiniscriptInstruction* i
 }
 
 
-bool EmitMiniscriptIsland(int indentationLevel, const MiniscriptControlFlowIsland* island, const mtdisasm::DOMiniscriptProgram& obj, bool forceExpression, FILE* f)
+bool EmitMiniscriptIsland(int indentationLevel, const MiniscriptControlFlowIsland* island, const mtdisasm::DOMiniscriptProgram& obj, bool forceExpression, mtdisasm::TextWriter& f)
 {
 	MiniscriptExpressionTree stack;
 
@@ -1789,11 +1696,11 @@ bool EmitMiniscriptIsland(int indentationLevel, const MiniscriptControlFlowIslan
 					MiniscriptExpressionTree* value = PopOne(stack);
 					MiniscriptExpressionTree* dest = PopOne(stack);
 					PrintIndent(indentationLevel, f);
-					fputs("set ", f);
+					f.Write("set ");
 					PrintExpression(dest, obj, f);
-					fputs(" to ", f);
+					f.Write(" to ");
 					PrintExpression(value, obj, f);
-					fputs("\n", f);
+					f.Write("\n");
 
 					delete value;
 					delete dest;
@@ -1818,25 +1725,25 @@ bool EmitMiniscriptIsland(int indentationLevel, const MiniscriptControlFlowIslan
 					MiniscriptExpressionTree* dest = PopOne(stack);
 					MiniscriptExpressionTree* addl = PopOne(stack);
 					PrintIndent(indentationLevel, f);
-					fputs("send ", f);
+					f.Write("send ");
 					PrintEvent(evt, f);
-					fputs(" to ", f);
+					f.Write(" to ");
 					PrintExpression(dest, obj, f);
-					fputs(" with ", f);
+					f.Write(" with ");
 					PrintExpression(addl, obj, f);
 					if ((instr.m_flags & 0x1c) == 0x1c)
-						fputs(" options none", f);
+						f.Write(" options none");
 					else if ((instr.m_flags & 0x1c) != 0)
 					{
-						fputs(" options", f);
+						f.Write(" options");
 						if ((instr.m_flags & 0x04) == 0)
-							fputs(" immediate", f);
+							f.Write(" immediate");
 						if ((instr.m_flags & 0x08) == 0)
-							fputs(" cascade", f);
+							f.Write(" cascade");
 						if ((instr.m_flags & 0x10) == 0)
-							fputs(" relay", f);
+							f.Write(" relay");
 					}
-					fputs("\n", f);
+					f.Write("\n");
 
 					delete dest;
 					delete addl;
@@ -1932,9 +1839,9 @@ bool EmitMiniscriptIsland(int indentationLevel, const MiniscriptControlFlowIslan
 			MiniscriptExpressionTree* condition = PopOne(stack);
 
 			PrintIndent(indentationLevel, f);
-			fputs("if ", f);
+			f.Write("if ");
 			PrintExpression(condition, obj, f);
-			fputs(" then\n", f);
+			f.Write(" then\n");
 
 			const MiniscriptControlFlowIsland* trueIsland = island->m_successorIslands[0];
 			const MiniscriptControlFlowIsland* falseIsland = island->m_successorIslands[1];
@@ -1945,13 +1852,13 @@ bool EmitMiniscriptIsland(int indentationLevel, const MiniscriptControlFlowIslan
 			if (falseIsland)
 			{
 				PrintIndent(indentationLevel, f);
-				fputs("else\n", f);
+				f.Write("else\n");
 				if (falseIsland && !EmitMiniscriptIsland(indentationLevel + 1, falseIsland, obj, false, f))
 					return false;
 			}
 
 			PrintIndent(indentationLevel, f);
-			fputs("end if\n", f);
+			f.Write("end if\n");
 
 			delete condition;
 		}
@@ -1966,17 +1873,17 @@ bool EmitMiniscriptIsland(int indentationLevel, const MiniscriptControlFlowIslan
 			MiniscriptExpressionTree* expr = PopOne(stack);
 			PrintIndent(indentationLevel, f);
 			PrintExpression(expr, obj, f);
-			fputs("\n", f);
+			f.Write("\n");
 			delete expr;
 		}
 		else
-			fputs("Program ended with trailing stack values!\n", f);
+			f.Write("Program ended with trailing stack values!\n");
 	}
 
 	return true;
 }
 
-bool DecompileMiniscript(const mtdisasm::DOMiniscriptProgram& obj, const mtdisasm::SerializationProperties& sp, bool isExpression, FILE* f)
+bool DecompileMiniscript(const mtdisasm::DOMiniscriptProgram& obj, const mtdisasm::SerializationProperties& sp, bool isExpression, mtdisasm::TextWriter& f)
 {
 	if (obj.m_numOfInstructions == 0)
 		return true;
@@ -2237,7 +2144,48 @@ bool DecompileMiniscript(const mtdisasm::DOMiniscriptProgram& obj, const mtdisas
 	return true;
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOMiniscriptProgram& obj, FILE* f, bool isExpression)
+// Returns null for unknown opcodes
+const char* GetMiniscriptOpName(uint16_t opcode)
+{
+	switch (opcode)
+	{
+	case 0x834: return "set";
+	case 0x898: return "send";
+	case 0xc9: return "add";
+	case 0xca: return "sub";
+	case 0xcb: return "mul";
+	case 0xcc: return "div";
+	case 0xcd: return "pow";
+	case 0xce: return "and";
+	case 0xcf: return "or";
+	case 0xd0: return "neg";
+	case 0xd1: return "not";
+	case 0xd2: return "cmp_eq";
+	case 0xd3: return "cmp_neq";
+	case 0xd4: return "cmp_le";
+	case 0xd5: return "cmp_lt";
+	case 0xd6: return "cmp_ge";
+	case 0xd7: return "cmp_gt";
+	case 0xd8: return "builtin_func";
+	case 0xd9: return "div_int";
+	case 0xda: return "mod";
+	case 0xdb: return "str_concat";
+	case 0x12f: return "point_create";
+	case 0x130: return "range_create";
+	case 0x131: return "vector_create";
+	case 0x135: return "get_child";
+	case 0x136: return "list_append";
+	case 0x137: return "list_create";
+	case 0x191: return "push_value";
+	case 0x192: return "push_global";
+	case 0x193: return "push_str";
+	case 0x7d3: return "jump";
+	default:
+		return nullptr;
+	}
+}
+
+void PrintObjectDisassembly(const mtdisasm::DOMiniscriptProgram& obj, mtdisasm::TextWriter& f, bool isExpression)
 {
 	PrintHex("Unknown1", obj.m_unknown1, f);
 	PrintHex("SizeOfInstructions", obj.m_sizeOfInstructions, f);
@@ -2245,27 +2193,27 @@ void PrintObjectDisassembly(const mtdisasm::DOMiniscriptProgram& obj, FILE* f, b
 	PrintHex("NumLocalRefs", obj.m_numLocalRefs, f);
 	PrintHex("NumAttributes", obj.m_numAttributes, f);
 
-	fputs("Attributes:\n", f);
+	f.Write("Attributes:\n");
 	for (size_t i = 0; i < obj.m_numAttributes; i++)
 	{
 		const mtdisasm::DOMiniscriptProgram::Attribute& attrib = obj.m_attributes[i];
-		fprintf(f, "    % 5i: %02x '", static_cast<int>(i), static_cast<int>(attrib.m_unknown11));
+		f.Printf("    % 5i: %02x '", static_cast<int>(i), static_cast<int>(attrib.m_unknown11));
 		if (attrib.m_name.size() > 1)
-			fwrite(&attrib.m_name[0], 1, attrib.m_name.size() - 1, f);
-		fputs("'\n", f);
+			f.Write(&attrib.m_name[0], attrib.m_name.size() - 1);
+		f.Write("'\n");
 	}
 
-	fputs("Local references:\n", f);
+	f.Write("Local references:\n");
 	for (size_t i = 0; i < obj.m_numLocalRefs; i++)
 	{
 		const mtdisasm::DOMiniscriptProgram::LocalRef& ref = obj.m_localRefs[i];
-		fprintf(f, "    % 5i: %08x %02x '", static_cast<int>(i), static_cast<int>(ref.m_guid), static_cast<int>(ref.m_unknown10));
+		f.Printf("    % 5i: %08x %02x '", static_cast<int>(i), static_cast<int>(ref.m_guid), static_cast<int>(ref.m_unknown10));
 		if (ref.m_name.size() > 1)
-			fwrite(&ref.m_name[0], 1, ref.m_name.size() - 1, f);
-		fputs("'\n", f);
+			f.Write(&ref.m_name[0], ref.m_name.size() - 1);
+		f.Write("'\n");
 	}
 
-	fputs("Instructions:\n", f);
+	f.Write("Instructions:\n");
 	bool readFailure = false;
 	if (obj.m_sizeOfInstructions > 0)
 	{
@@ -2275,64 +2223,28 @@ void PrintObjectDisassembly(const mtdisasm::DOMiniscriptProgram& obj, FILE* f, b
 		size_t numInstrsDecoded = 0;
 		for (size_t i = 0; i < obj.m_numOfInstructions; i++)
 		{
-			const char* opName = "???";
-
-			uint32_t instrStartPos = memStream.Tell();
+			uint32_t instrStartPos = reader.Tell();
 
 			uint16_t opcode, unknownField, sizeOfInstruction;
 			if (!reader.ReadU16(opcode) || !reader.ReadU16(unknownField), !reader.ReadU16(sizeOfInstruction))
 				break;
 
-			bool isUnknownOp = false;
-			switch (opcode)
-			{
-			case 0x834: opName = "set"; break;
-			case 0x898: opName = "send"; break;
-			case 0xc9: opName = "add"; break;
-			case 0xca: opName = "sub"; break;
-			case 0xcb: opName = "mul"; break;
-			case 0xcc: opName = "div"; break;
-			case 0xcd: opName = "pow"; break;
-			case 0xce: opName = "and"; break;
-			case 0xcf: opName = "or"; break;
-			case 0xd0: opName = "neg"; break;
-			case 0xd1: opName = "not"; break;
-			case 0xd2: opName = "cmp_eq"; break;
-			case 0xd3: opName = "cmp_neq"; break;
-			case 0xd4: opName = "cmp_le"; break;
-			case 0xd5: opName = "cmp_lt"; break;
-			case 0xd6: opName = "cmp_ge"; break;
-			case 0xd7: opName = "cmp_gt"; break;
-			case 0xd8: opName = "builtin_func"; break;
-			case 0xd9: opName = "div_int"; break;
-			case 0xda: opName = "mod"; break;
-			case 0xdb: opName = "str_concat"; break;
-			case 0x12f: opName = "point_create"; break;
-			case 0x130: opName = "range_create"; break;
-			case 0x131: opName = "vector_create"; break;
-			case 0x135: opName = "get_child"; break;
-			case 0x136: opName = "list_append"; break;
-			case 0x137: opName = "list_create"; break;
-			case 0x191: opName = "push_value"; break;
-			case 0x192: opName = "push_global"; break;
-			case 0x193: opName = "push_str"; break;
-			case 0x7d3: opName = "jump"; break;
-			default:
-				isUnknownOp = true;
-				break;
-			}
+			const char* opName = GetMiniscriptOpName(opcode);
+			bool isUnknownOp = (opName == nullptr);
+			if (isUnknownOp)
+				opName = "???";
 
 			if (!isUnknownOp)
 			{
 				if (unknownField == 0)
-					fprintf(f, "    % 5i: %s  ", static_cast<int>(i), opName);
+					f.Printf("    % 5i: %s  ", static_cast<int>(i), opName);
 				else
-					fprintf(f, "    % 5i: %s,args=%i  ", static_cast<int>(i), opName, static_cast<int>(unknownField));
+					f.Printf("    % 5i: %s,args=%i  ", static_cast<int>(i), opName, static_cast<int>(unknownField));
 			}
 			else
 			{
 
-				fprintf(f, "    % 5i: %s(0x%x),%i  ", static_cast<int>(i), opName, static_cast<int>(opcode), static_cast<int>(unknownField));
+				f.Printf("    % 5i: %s(0x%x),%i  ", static_cast<int>(i), opName, static_cast<int>(opcode), static_cast<int>(unknownField));
 			}
 
 
@@ -2340,28 +2252,28 @@ void PrintObjectDisassembly(const mtdisasm::DOMiniscriptProgram& obj, FILE* f, b
 				break;
 
 			bool decodedOK = PrintMiniscriptInstructionDisassembly(f, reader, obj.m_sp, opcode, sizeOfInstruction - 6);
-			fputs("\n", f);
+			f.Write("\n");
 
 			if (!decodedOK)
 				break;
 
-			memStream.SeekSet(instrStartPos + sizeOfInstruction);
+			reader.Seek(instrStartPos + sizeOfInstruction);
 
 			numInstrsDecoded++;
 		}
 
 		if (numInstrsDecoded != obj.m_numOfInstructions)
-			fprintf(f, "    <An error occurred during disassembly>\n");
+			f.Write("    <An error occurred during disassembly>\n");
 	}
 
-	fputs("Decompiled:\n", f);
+	f.Write("Decompiled:\n");
 	if (!DecompileMiniscript(obj, obj.m_sp, isExpression, f))
 	{
-		fputs("Decompile failed\n", f);
+		f.Write("Decompile failed\n");
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOMiniscriptModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOMiniscriptModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kMiniscriptModifier);
 
@@ -2374,39 +2286,40 @@ void PrintObjectDisassembly(const mtdisasm::DOMiniscriptModifier& obj, FILE* f)
 	PrintVal("EnableWhen", obj.m_enableWhen, f);
 	PrintHex("Unknown6", obj.m_unknown6, f);
 	PrintHex("Unknown7", obj.m_unknown7, f);
-	fputs("Name: '", f);
+	f.Write("Name: '");
 	if (obj.m_lengthOfName > 0)
-		fwrite(&obj.m_name[0], 1, obj.m_lengthOfName - 1, f);
-	fputs("'\n", f);
+		f.Write(&obj.m_name[0], obj.m_lengthOfName - 1);
+	f.Write("'\n");
 
-	fputs("Program:\n", f);
+	f.Write("Program:\n");
 	PrintObjectDisassembly(obj.m_program, f, false);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DONotYetImplemented& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DONotYetImplemented& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kNotYetImplemented);
 
-	fprintf(f, "    Unimplemented '%s'  DataSize=%u\n", obj.m_name, obj.m_sizeIncludingTag - 14);
+	f.Printf("    Unimplemented '%s'  DataSize=%u\n", obj.m_name, obj.m_sizeIncludingTag - 14);
 }
 
-void PrintObjectDisassembly(const mtdisasm::POUnknown& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::POUnknown& obj, mtdisasm::TextWriter& f)
 {
 	for (size_t i = 0; i < obj.m_data.size(); i++)
 	{
 		if (i % 32 == 0)
 		{
 			if (i != 0)
-				fputs("\n", f);
-			fputs("   ", f);
+				f.Write("\n");
+			f.Write("   ");
 		}
-		fprintf(f, " %02x", obj.m_data[i]);
+		f.Put(' ');
+		f.WriteHex(obj.m_data[i], 2);
 	}
 
-	fputs("\n", f);
+	f.Write("\n");
 }
 
-void PrintObjectDisassembly(const mtdisasm::POCursorMod& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::POCursorMod& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::PlugInObjectType::kCursorMod);
 
@@ -2428,7 +2341,7 @@ void PrintObjectDisassembly(const mtdisasm::POCursorMod& obj, FILE* f)
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::POMediaCueModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::POMediaCueModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::PlugInObjectType::kMediaCue);
 
@@ -2446,7 +2359,7 @@ void PrintObjectDisassembly(const mtdisasm::POMediaCueModifier& obj, FILE* f)
 	PrintVal("SendEvent", obj.m_sendEvent, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::POMidiModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::POMidiModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::PlugInObjectType::kMIDIModf);
 
@@ -2482,11 +2395,11 @@ void PrintObjectDisassembly(const mtdisasm::POMidiModifier& obj, FILE* f)
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOPlugInModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOPlugInModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kPlugInModifier);
 
-	fprintf(f, "Plug-in modifier '%s'  PrivateDataSize=%u\n", obj.m_plugin, obj.m_privateDataSize);
+	f.Printf("Plug-in modifier '%s'  PrivateDataSize=%u\n", obj.m_plugin, obj.m_privateDataSize);
 	PrintHex("Unknown1", obj.m_unknown1, f);
 	PrintHex("Unknown2", obj.m_unknown2, f);
 	PrintHex("PlugInRevision", obj.m_plugInRevision, f);
@@ -2495,10 +2408,10 @@ void PrintObjectDisassembly(const mtdisasm::DOPlugInModifier& obj, FILE* f)
 	PrintHex("GUID", obj.m_guid, f);
 	PrintVal("WeirdSize", obj.m_weirdSize, f);
 
-	fputs("Name: '", f);
+	f.Write("Name: '");
 	if (obj.m_lengthOfName > 0)
-		fwrite(&obj.m_name[0], 1, obj.m_lengthOfName - 1, f);
-	fputs("'\n", f);
+		f.Write(&obj.m_name[0], obj.m_lengthOfName - 1);
+	f.Write("'\n");
 
 	switch (obj.m_plugInData->GetType())
 	{
@@ -2519,7 +2432,7 @@ void PrintObjectDisassembly(const mtdisasm::DOPlugInModifier& obj, FILE* f)
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOAudioAsset& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOAudioAsset& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kAudioAsset);
 
@@ -2559,7 +2472,7 @@ void PrintObjectDisassembly(const mtdisasm::DOAudioAsset& obj, FILE* f)
 	for (size_t i = 0; i < obj.m_numCuePoints; i++)
 	{
 		const mtdisasm::DOAudioAsset::CuePoint& cuePoint = obj.m_cuePoints[i];
-		fprintf(f, "Cue point %i:\n", static_cast<int>(i));
+		f.Printf("Cue point %i:\n", static_cast<int>(i));
 		PrintHex("    Unknown13", cuePoint.m_unknown13, f);
 		PrintHex("    Unknown14", cuePoint.m_unknown14, f);
 		PrintVal("    Position", cuePoint.m_position, f);
@@ -2567,7 +2480,7 @@ void PrintObjectDisassembly(const mtdisasm::DOAudioAsset& obj, FILE* f)
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOImageAsset& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOImageAsset& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kImageAsset);
 
@@ -2593,7 +2506,7 @@ void PrintObjectDisassembly(const mtdisasm::DOImageAsset& obj, FILE* f)
 		PrintHex("Unknown8", obj.m_platform.m_win.m_unknown8, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOMovieAsset& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOMovieAsset& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kMovieAsset);
 
@@ -2622,13 +2535,13 @@ void PrintObjectDisassembly(const mtdisasm::DOMovieAsset& obj, FILE* f)
 
 	if (obj.m_extFileNameLength > 1)
 	{
-		fputs("ExternalFileName: '", f);
-		fwrite(&obj.m_extFileName[0], 1, obj.m_extFileNameLength - 1, f);
-		fputs("'\n", f);
+		f.Write("ExternalFileName: '");
+		f.Write(&obj.m_extFileName[0], obj.m_extFileNameLength - 1);
+		f.Write("'\n");
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOMToonAsset& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOMToonAsset& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kMToonAsset);
 
@@ -2659,7 +2572,7 @@ void PrintObjectDisassembly(const mtdisasm::DOMToonAsset& obj, FILE* f)
 
 	for (size_t i = 0; i < obj.m_numFrames; i++)
 	{
-		fprintf(f, "Frame %i:\n", static_cast<int>(i));
+		f.Printf("Frame %i:\n", static_cast<int>(i));
 		const mtdisasm::DOMToonAsset::FrameDef& frame = obj.m_frames[i];
 
 		PrintHex("    Unknown12", frame.m_unknown12, f);
@@ -2686,10 +2599,13 @@ void PrintObjectDisassembly(const mtdisasm::DOMToonAsset& obj, FILE* f)
 			PrintHex("    Unknown13", frame.m_platform.m_win.m_unknown18, f);
 	}
 
-	fprintf(f, "CodecData:");
+	f.Write("CodecData:");
 	for (size_t i = 0; i < obj.m_codecData.size(); i++)
-		fprintf(f, " %02x", static_cast<int>(obj.m_codecData[i]));
-	fprintf(f, "\n");
+	{
+		f.Put(' ');
+		f.WriteHex(obj.m_codecData[i], 2);
+	}
+	f.Write("\n");
 
 	if (obj.m_encodingFlags & mtdisasm::DOMToonAsset::kEncodingFlag_HasRanges)
 	{
@@ -2700,22 +2616,22 @@ void PrintObjectDisassembly(const mtdisasm::DOMToonAsset& obj, FILE* f)
 
 		for (size_t i = 0; i < obj.m_frameRangesPart.m_numFrameRanges; i++)
 		{
-			fprintf(f, "FrameRange %i:\n", static_cast<int>(i));
+			f.Printf("FrameRange %i:\n", static_cast<int>(i));
 			const mtdisasm::DOMToonAsset::FrameRangeDef& frameRange = obj.m_frameRangesPart.m_frameRanges[i];
 
 			PrintVal("StartFrame", frameRange.m_startFrame, f);
 			PrintVal("EndFrame", frameRange.m_startFrame, f);
-			fputs("Name: '", f);
+			f.Write("Name: '");
 			if (frameRange.m_name.size() > 1)
-				fwrite(&frameRange.m_name[0], 1, frameRange.m_name.size() - 1, f);
-			fputs("'\n", f);
+				f.Write(&frameRange.m_name[0], frameRange.m_name.size() - 1);
+			f.Write("'\n");
 			PrintHex("Unknown14", frameRange.m_unknown14, f);
 		}
 	}
 }
 
 
-void PrintObjectDisassembly(const mtdisasm::DOTextAsset& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOTextAsset& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kTextAsset);
 
@@ -2747,7 +2663,7 @@ void PrintObjectDisassembly(const mtdisasm::DOTextAsset& obj, FILE* f)
 
 	for (int i = 0; i < obj.m_macFormattingSpans.size(); i++)
 	{
-		fprintf(f, "Formatting span %i:\n", i);
+		f.Printf("Formatting span %i:\n", i);
 		const mtdisasm::DOTextAsset::MacFormattingSpan& fmtSpan = obj.m_macFormattingSpans[i];
 		PrintHex("Unknown9", fmtSpan.m_unknown9, f);
 		PrintVal("SpanStart", fmtSpan.m_spanStart, f);
@@ -2759,7 +2675,7 @@ void PrintObjectDisassembly(const mtdisasm::DOTextAsset& obj, FILE* f)
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOAssetDataSection& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOAssetDataSection& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kAssetDataSection);
 
@@ -2767,7 +2683,7 @@ void PrintObjectDisassembly(const mtdisasm::DOAssetDataSection& obj, FILE* f)
 	PrintHex("SizeIncludingTag", obj.m_sizeIncludingTag, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOBehaviorModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOBehaviorModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kBehaviorModifier);
 
@@ -2788,19 +2704,19 @@ void PrintObjectDisassembly(const mtdisasm::DOBehaviorModifier& obj, FILE* f)
 
 	if (obj.m_name.size() > 1)
 	{
-		fputs("Name: '", f);
-		fwrite(&obj.m_name[0], 1, obj.m_name.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("Name: '");
+		f.Write(&obj.m_name[0], obj.m_name.size() - 1u);
+		f.Write("'\n");
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOMessageDataSpec& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOMessageDataSpec& obj, mtdisasm::TextWriter& f)
 {
 	PrintHex("    Type", obj.m_typeCode, f);
 	PrintHex("    Value", obj.m_value.m_unknown, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOMessengerModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOMessengerModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kMessengerModifier);
 
@@ -2817,31 +2733,31 @@ void PrintObjectDisassembly(const mtdisasm::DOMessengerModifier& obj, FILE* f)
 	PrintHex("SizeIncludingTag", obj.m_sizeIncludingTag, f);
 	PrintVal("LengthOfName", obj.m_lengthOfName, f);
 	PrintHex("Destination", obj.m_destination, f);
-	fputs("With:\n", f);
+	f.Write("With:\n");
 	PrintObjectDisassembly(obj.m_with, f);
 
 	if (obj.m_withSource.size() > 1)
 	{
-		fputs("WithSource: '", f);
-		fwrite(&obj.m_withSource[0], 1, obj.m_withSource.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("WithSource: '");
+		f.Write(&obj.m_withSource[0], obj.m_withSource.size() - 1u);
+		f.Write("'\n");
 	}
 
 	if (obj.m_withString.size() > 1)
 	{
-		fputs("WithString: '", f);
-		fwrite(&obj.m_withString[0], 1, obj.m_withString.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("WithString: '");
+		f.Write(&obj.m_withString[0], obj.m_withString.size() - 1u);
+		f.Write("'\n");
 	}
 
 	if (obj.m_name.size() > 1)
 	{
-		fputs("Name: '", f);
-		fwrite(&obj.m_name[0], 1, obj.m_name.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("Name: '");
+		f.Write(&obj.m_name[0], obj.m_name.size() - 1u);
+		f.Write("'\n");
 	}
 }
-void PrintObjectDisassembly(const mtdisasm::DOTypicalModifierHeader& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOTypicalModifierHeader& obj, mtdisasm::TextWriter& f)
 {
 	PrintHex("ModifierFlags", obj.m_modifierFlags, f);
 	PrintHex("ModHeader_Unknown3", obj.m_unknown3, f);
@@ -2852,13 +2768,13 @@ void PrintObjectDisassembly(const mtdisasm::DOTypicalModifierHeader& obj, FILE*
 
 	if (obj.m_name.size() > 1)
 	{
-		fputs("Name: '", f);
-		fwrite(&obj.m_name[0], 1, obj.m_name.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("Name: '");
+		f.Write(&obj.m_name[0], obj.m_name.size() - 1u);
+		f.Write("'\n");
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOIfMessengerModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOIfMessengerModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kIfMessengerModifier);
 
@@ -2877,16 +2793,16 @@ void PrintObjectDisassembly(const mtdisasm::DOIfMessengerModifier& obj, FILE* f)
 
 	if (obj.m_withSource.size() > 1)
 	{
-		fputs("WithSource: '", f);
-		fwrite(&obj.m_withSource[0], 1, obj.m_withSource.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("WithSource: '");
+		f.Write(&obj.m_withSource[0], obj.m_withSource.size() - 1u);
+		f.Write("'\n");
 	}
 
-	fputs("Program:\n", f);
+	f.Write("Program:\n");
 	PrintObjectDisassembly(obj.m_program, f, true);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOTimerMessengerModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOTimerMessengerModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kTimerMessengerModifier);
 
@@ -2905,7 +2821,7 @@ void PrintObjectDisassembly(const mtdisasm::DOTimerMessengerModifier& obj, FILE*
 	PrintVal("Send", obj.m_send, f);
 	PrintVal("TerminateWhen", obj.m_terminateWhen, f);
 	PrintHex("MessageFlags", obj.m_destination, f);
-	fputs("With:\n", f);
+	f.Write("With:\n");
 	PrintObjectDisassembly(obj.m_with, f);
 	PrintVal("Minutes", obj.m_minutes, f);
 	PrintVal("Seconds", obj.m_seconds, f);
@@ -2913,13 +2829,13 @@ void PrintObjectDisassembly(const mtdisasm::DOTimerMessengerModifier& obj, FILE*
 
 	if (obj.m_withSource.size() > 1)
 	{
-		fputs("WithSource: '", f);
-		fwrite(&obj.m_withSource[0], 1, obj.m_withSource.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("WithSource: '");
+		f.Write(&obj.m_withSource[0], obj.m_withSource.size() - 1u);
+		f.Write("'\n");
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOBoundaryDetectionMessengerModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOBoundaryDetectionMessengerModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kBoundaryDetectionMessengerModifier);
 
@@ -2934,18 +2850,18 @@ void PrintObjectDisassembly(const mtdisasm::DOBoundaryDetectionMessengerModifier
 	PrintVal("DisableWhen", obj.m_disableWhen, f);
 	PrintVal("Send", obj.m_send, f);
 
-	fputs("With:\n", f);
+	f.Write("With:\n");
 	PrintObjectDisassembly(obj.m_with, f);
 
 	if (obj.m_withSource.size() > 1)
 	{
-		fputs("WithSource: '", f);
-		fwrite(&obj.m_withSource[0], 1, obj.m_withSource.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("WithSource: '");
+		f.Write(&obj.m_withSource[0], obj.m_withSource.size() - 1u);
+		f.Write("'\n");
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOCollisionDetectionMessengerModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOCollisionDetectionMessengerModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kCollisionDetectionMessengerModifier);
 
@@ -2961,18 +2877,18 @@ void PrintObjectDisassembly(const mtdisasm::DOCollisionDetectionMessengerModifie
 	PrintVal("DisableWhen", obj.m_disableWhen, f);
 	PrintVal("Send", obj.m_send, f);
 
-	fputs("With:\n", f);
+	f.Write("With:\n");
 	PrintObjectDisassembly(obj.m_with, f);
 
 	if (obj.m_withSource.size() > 1)
 	{
-		fputs("WithSource: '", f);
-		fwrite(&obj.m_withSource[0], 1, obj.m_withSource.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("WithSource: '");
+		f.Write(&obj.m_withSource[0], obj.m_withSource.size() - 1u);
+		f.Write("'\n");
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOSharedSceneModifier &obj, FILE *f)
+void PrintObjectDisassembly(const mtdisasm::DOSharedSceneModifier &obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kSharedSceneModifier);
 
@@ -2985,7 +2901,7 @@ void PrintObjectDisassembly(const mtdisasm::DOSharedSceneModifier &obj, FILE *f)
 	PrintHex("SceneGUID", obj.m_sceneGUID, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOSetModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOSetModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kSetModifier);
 
@@ -2993,9 +2909,9 @@ void PrintObjectDisassembly(const mtdisasm::DOSetModifier& obj, FILE* f)
 
 	PrintHex("Unknown1", obj.m_unknown1, f);
 	PrintVal("When", obj.m_when, f);
-	fputs("Source:\n", f);
+	f.Write("Source:\n");
 	PrintObjectDisassembly(obj.m_source, f);
-	fputs("Target:\n", f);
+	f.Write("Target:\n");
 	PrintObjectDisassembly(obj.m_target, f);
 	PrintHex("Unknown3", obj.m_unknown3, f);
 	PrintHex("SourceNameLength", obj.m_sourceNameLength, f);
@@ -3004,20 +2920,20 @@ void PrintObjectDisassembly(const mtdisasm::DOSetModifier& obj, FILE* f)
 
 	if (obj.m_sourceName.size() > 1)
 	{
-		fputs("Source: '", f);
-		fwrite(&obj.m_sourceName[0], 1, obj.m_sourceName.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("Source: '");
+		f.Write(&obj.m_sourceName[0], obj.m_sourceName.size() - 1u);
+		f.Write("'\n");
 	}
 
 	if (obj.m_targetName.size() > 1)
 	{
-		fputs("Target: '", f);
-		fwrite(&obj.m_targetName[0], 1, obj.m_targetName.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("Target: '");
+		f.Write(&obj.m_targetName[0], obj.m_targetName.size() - 1u);
+		f.Write("'\n");
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOSaveAndRestoreModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOSaveAndRestoreModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kSaveAndRestoreModifier);
 
@@ -3041,7 +2957,7 @@ void PrintObjectDisassembly(const mtdisasm::DOSaveAndRestoreModifier& obj, FILE*
 	PrintStr("FileName", obj.m_fileName, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOKeyboardMessengerModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOKeyboardMessengerModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kKeyboardMessengerModifier);
 
@@ -3054,7 +2970,7 @@ void PrintObjectDisassembly(const mtdisasm::DOKeyboardMessengerModifier& obj, FI
 	PrintHex("Unknown7", obj.m_unknown7, f);
 	PrintHex("Destination", obj.m_destination, f);
 	PrintHex("Unknown9", obj.m_unknown9, f);
-	fputs("With:\n", f);
+	f.Write("With:\n");
 	PrintObjectDisassembly(obj.m_with, f);
 
 	PrintHex("KeyCode", obj.m_keycode, f);
@@ -3062,21 +2978,21 @@ void PrintObjectDisassembly(const mtdisasm::DOKeyboardMessengerModifier& obj, FI
 
 	if (obj.m_withSource.size() > 1)
 	{
-		fputs("WithSource: '", f);
-		fwrite(&obj.m_withSource[0], 1, obj.m_withSource.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("WithSource: '");
+		f.Write(&obj.m_withSource[0], obj.m_withSource.size() - 1u);
+		f.Write("'\n");
 	}
 
 	PrintHex("WithStringLength", obj.m_withStringLength, f);
 	if (obj.m_withString.size() > 1)
 	{
-		fputs("WithString: '", f);
-		fwrite(&obj.m_withString[0], 1, obj.m_withString.size() - 1u, f);
-		fputs("'\n", f);
+		f.Write("WithString: '");
+		f.Write(&obj.m_withString[0], obj.m_withString.size() - 1u);
+		f.Write("'\n");
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOBooleanVariableModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOBooleanVariableModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kBooleanVariableModifier);
 
@@ -3086,7 +3002,7 @@ void PrintObjectDisassembly(const mtdisasm::DOBooleanVariableModifier& obj, FILE
 	PrintVal("Value", obj.m_value, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOIntegerVariableModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOIntegerVariableModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kIntegerVariableModifier);
 
@@ -3095,7 +3011,7 @@ void PrintObjectDisassembly(const mtdisasm::DOIntegerVariableModifier& obj, FILE
 	PrintVal("Value", obj.m_value, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOIntegerRangeVariableModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOIntegerRangeVariableModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kIntegerRangeVariableModifier);
 
@@ -3105,7 +3021,7 @@ void PrintObjectDisassembly(const mtdisasm::DOIntegerRangeVariableModifier& obj,
 	PrintVal("Max", obj.m_max, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOFloatVariableModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOFloatVariableModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kFloatVariableModifier);
 
@@ -3114,7 +3030,7 @@ void PrintObjectDisassembly(const mtdisasm::DOFloatVariableModifier& obj, FILE*
 	PrintVal("Value", obj.m_value, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOCompoundVariableModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOCompoundVariableModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kCompoundVariableModifier);
 
@@ -3130,7 +3046,7 @@ void PrintObjectDisassembly(const mtdisasm::DOCompoundVariableModifier& obj, FIL
 	PrintVal("EditorLayoutPosition", obj.m_editorLayoutPosition, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOVectorVariableModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOVectorVariableModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kVectorVariableModifier);
 
@@ -3139,21 +3055,21 @@ void PrintObjectDisassembly(const mtdisasm::DOVectorVariableModifier& obj, FILE*
 	PrintVal("Angle", obj.m_value, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOStringVariableModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOStringVariableModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kStringVariableModifier);
 
 	PrintObjectDisassembly(obj.m_modHeader, f);
 
-	fputs("Value: '", f);
+	f.Write("Value: '");
 	if (obj.m_string.size() > 0)
 	{
-		fwrite(&obj.m_string[0], 1, obj.m_string.size() - 1, f);
+		f.Write(&obj.m_string[0], obj.m_string.size() - 1);
 	}
-	fputs("'\n", f);
+	f.Write("'\n");
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOPointVariableModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOPointVariableModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kPointVariableModifier);
 
@@ -3163,7 +3079,7 @@ void PrintObjectDisassembly(const mtdisasm::DOPointVariableModifier& obj, FILE*
 	PrintVal("Value", obj.m_value, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOGraphicModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOGraphicModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kGraphicModifier);
 
@@ -3194,13 +3110,13 @@ void PrintObjectDisassembly(const mtdisasm::DOGraphicModifier& obj, FILE* f)
 	PrintVal("BorderSize", obj.m_borderSize, f);
 	PrintHex("BorderColor", obj.m_borderColor, f);
 
-	fputs("Poly points:\n", f);
+	f.Write("Poly points:\n");
 
 	for (const mtdisasm::DOPoint &pt : obj.m_polyPoints)
 		PrintVal("Pt", pt, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOTextStyleModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOTextStyleModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kTextStyleModifier);
 
@@ -3220,13 +3136,13 @@ void PrintObjectDisassembly(const mtdisasm::DOTextStyleModifier& obj, FILE* f)
 
 	if (obj.m_lengthOfFontName > 0)
 	{
-		fputs("Font Family Name: '", f);
-		fwrite(&obj.m_fontName[0], 1, obj.m_lengthOfFontName, f);
-		fputs("'\n", f);
+		f.Write("Font Family Name: '");
+		f.Write(&obj.m_fontName[0], obj.m_lengthOfFontName);
+		f.Write("'\n");
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOSceneTransitionModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOSceneTransitionModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kSceneTransitionModifier);
 
@@ -3241,7 +3157,7 @@ void PrintObjectDisassembly(const mtdisasm::DOSceneTransitionModifier& obj, FILE
 	PrintVal("Steps", obj.m_steps, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOSimpleMotionModifier &obj, FILE *f)
+void PrintObjectDisassembly(const mtdisasm::DOSimpleMotionModifier &obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kSimpleMotionModifier);
 
@@ -3255,7 +3171,7 @@ void PrintObjectDisassembly(const mtdisasm::DOSimpleMotionModifier &obj, FILE *f
 	PrintHex("Unknown5", obj.m_unknown5, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOElementTransitionModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOElementTransitionModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kElementTransitionModifier);
 
@@ -3271,7 +3187,7 @@ void PrintObjectDisassembly(const mtdisasm::DOElementTransitionModifier& obj, FI
 	PrintVal("Rate", obj.m_rate, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOPathMotionModifierV2& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOPathMotionModifierV2& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kPathMotionModifierV2);
 
@@ -3290,7 +3206,7 @@ void PrintObjectDisassembly(const mtdisasm::DOPathMotionModifierV2& obj, FILE* f
 	{
 		const mtdisasm::DOPathMotionModifierV2::PointDef& point = obj.m_pointDefs[i];
 
-		fprintf(f, "Point %i:\n", static_cast<int>(i));
+		f.Printf("Point %i:\n", static_cast<int>(i));
 		PrintVal("    Point", point.m_point, f);
 		PrintVal("    Frame", point.m_frame, f);
 		PrintHex("    FrameFlags", point.m_frameFlags, f);
@@ -3307,7 +3223,7 @@ void PrintObjectDisassembly(const mtdisasm::DOPathMotionModifierV2& obj, FILE* f
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOPathMotionModifierV1 &obj, FILE *f)
+void PrintObjectDisassembly(const mtdisasm::DOPathMotionModifierV1 &obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kPathMotionModifierV1);
 
@@ -3326,7 +3242,7 @@ void PrintObjectDisassembly(const mtdisasm::DOPathMotionModifierV1 &obj, FILE *f
 	{
 		const mtdisasm::DOPathMotionModifierV1::PointDef &point = obj.m_pointDefs[i];
 
-		fprintf(f, "Point %i:\n", static_cast<int>(i));
+		f.Printf("Point %i:\n", static_cast<int>(i));
 		PrintVal("    Point", point.m_point, f);
 		PrintVal("    Frame", point.m_frame, f);
 		PrintHex("    FrameFlags", point.m_frameFlags, f);
@@ -3334,7 +3250,7 @@ void PrintObjectDisassembly(const mtdisasm::DOPathMotionModifierV1 &obj, FILE *f
 
 }
 
-void PrintObjectDisassembly(const mtdisasm::DODragMotionModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DODragMotionModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kDragMotionModifier);
 
@@ -3359,7 +3275,7 @@ void PrintObjectDisassembly(const mtdisasm::DODragMotionModifier& obj, FILE* f)
 	}
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOVectorMotionModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOVectorMotionModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kVectorMotionModifier);
 
@@ -3368,7 +3284,7 @@ void PrintObjectDisassembly(const mtdisasm::DOVectorMotionModifier& obj, FILE* f
 	PrintHex("Unknown1", obj.m_unknown1, f);
 	PrintVal("EnableWhen", obj.m_enableWhen, f);
 	PrintVal("DisableWhen", obj.m_disableWhen, f);
-	fputs("Var source:\n", f);
+	f.Write("Var source:\n");
 	PrintObjectDisassembly(obj.m_varSource, f);
 
 	PrintHex("VarStringLength", obj.m_varStringLength, f);
@@ -3376,7 +3292,7 @@ void PrintObjectDisassembly(const mtdisasm::DOVectorMotionModifier& obj, FILE* f
 	PrintStr("VarString", obj.m_varString, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOChangeSceneModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOChangeSceneModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kChangeSceneModifier);
 
@@ -3389,7 +3305,7 @@ void PrintObjectDisassembly(const mtdisasm::DOChangeSceneModifier& obj, FILE* f)
 	PrintVal("EnableWhen", obj.m_executeWhen, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOImageEffectModifier &obj, FILE *f)
+void PrintObjectDisassembly(const mtdisasm::DOImageEffectModifier &obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kImageEffectModifier);
 
@@ -3405,7 +3321,7 @@ void PrintObjectDisassembly(const mtdisasm::DOImageEffectModifier &obj, FILE *f)
 }
 
 
-void PrintObjectDisassembly(const mtdisasm::DOSoundFadeModifier &obj, FILE *f)
+void PrintObjectDisassembly(const mtdisasm::DOSoundFadeModifier &obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kSoundFadeModifier);
 
@@ -3420,7 +3336,7 @@ void PrintObjectDisassembly(const mtdisasm::DOSoundFadeModifier &obj, FILE *f)
 	PrintHex("Unknown2", obj.m_unknown2, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOAliasModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOAliasModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kAliasModifier);
 
@@ -3435,7 +3351,7 @@ void PrintObjectDisassembly(const mtdisasm::DOAliasModifier& obj, FILE* f)
 	PrintStr("Name", obj.m_name, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOSoundEffectModifier& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOSoundEffectModifier& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kSoundEffectModifier);
 
@@ -3449,7 +3365,7 @@ void PrintObjectDisassembly(const mtdisasm::DOSoundEffectModifier& obj, FILE* f)
 	PrintHex("Unknown5", obj.m_unknown5, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DOExtVideoAsset& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOExtVideoAsset& obj, mtdisasm::TextWriter& f)
 {
 	assert(obj.GetType() == mtdisasm::DataObjectType::kExtVideoAsset);
 
@@ -3461,1329 +3377,5255 @@ void PrintObjectDisassembly(const mtdisasm::DOExtVideoAsset& obj, FILE* f)
 	PrintStr("ExtFilename", obj.m_extFilename, f);
 }
 
-void PrintObjectDisassembly(const mtdisasm::DataObject& obj, FILE* f)
+void PrintObjectDisassembly(const mtdisasm::DOMacOnlyCursorModifier& obj, mtdisasm::TextWriter& f)
 {
-	switch (obj.GetType())
-	{
-	case mtdisasm::DataObjectType::kStreamHeader:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOStreamHeader&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kPresentationSettings:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOPresentationSettings&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kAssetCatalog:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOAssetCatalog&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kGlobalObjectInfo:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOGlobalObjectInfo&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kUnknown19:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOUnknown19&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kProjectLabelMap:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOProjectLabelMap&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kProjectStructuralDef:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOProjectStructuralDef&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kColorTableAsset:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOColorTableAsset&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kAudioAsset:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOAudioAsset&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kImageAsset:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOImageAsset&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kMovieAsset:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOMovieAsset&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kMToonAsset:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOMToonAsset&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kTextAsset:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOTextAsset&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kSectionStructuralDef:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOSectionStructuralDef&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kSubsectionStructuralDef:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOSubsectionStructuralDef&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kGraphicStructuralDef:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOGraphicStructuralDef&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kTextStructuralDef:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOTextStructuralDef&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kSoundStructuralDef:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOSoundStructuralDef&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kImageStructuralDef:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOImageStructuralDef&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kMovieStructuralDef:
-	case mtdisasm::DataObjectType::kExternalMovieStructuralDef:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOMovieStructuralDef&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kMToonStructuralDef:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOMToonStructuralDef&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kNotYetImplemented:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DONotYetImplemented&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kPlugInModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOPlugInModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kAssetDataSection:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOAssetDataSection&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kBehaviorModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOBehaviorModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kMessengerModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOMessengerModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kIfMessengerModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOIfMessengerModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kTimerMessengerModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOTimerMessengerModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kCollisionDetectionMessengerModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOCollisionDetectionMessengerModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kBoundaryDetectionMessengerModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOBoundaryDetectionMessengerModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kSharedSceneModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOSharedSceneModifier &>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kSetModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOSetModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kSaveAndRestoreModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOSaveAndRestoreModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kKeyboardMessengerModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOKeyboardMessengerModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kMiniscriptModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOMiniscriptModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kBooleanVariableModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOBooleanVariableModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kIntegerVariableModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOIntegerVariableModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kIntegerRangeVariableModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOIntegerRangeVariableModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kStringVariableModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOStringVariableModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kFloatVariableModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOFloatVariableModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kCompoundVariableModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOCompoundVariableModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kVectorVariableModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOVectorVariableModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kPointVariableModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOPointVariableModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kGraphicModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOGraphicModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kTextStyleModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOTextStyleModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kPathMotionModifierV2:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOPathMotionModifierV2&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kPathMotionModifierV1:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOPathMotionModifierV1 &>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kDragMotionModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DODragMotionModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kSceneTransitionModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOSceneTransitionModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kElementTransitionModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOElementTransitionModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kSimpleMotionModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOSimpleMotionModifier &>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kVectorMotionModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOVectorMotionModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kChangeSceneModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOChangeSceneModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kImageEffectModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOImageEffectModifier &>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kSoundFadeModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOSoundFadeModifier &>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kAliasModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOAliasModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kSoundEffectModifier:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOSoundEffectModifier&>(obj), f);
-		break;
-	case mtdisasm::DataObjectType::kExtVideoAsset:
-		PrintObjectDisassembly(static_cast<const mtdisasm::DOExtVideoAsset&>(obj), f);
-		break;
+	f.Write("Unknown contents\n");
+}
 
-	default:
-		fprintf(f, "Unknown contents\n");
-	}
+template<class T>
+void PrintObjectOfType(const mtdisasm::DataObject& obj, mtdisasm::TextWriter& f)
+{
+	PrintObjectDisassembly(static_cast<const T&>(obj), f);
 }
 
-#define ATOM(a,b,c,d) static_cast<uint32_t>((a << 24) + (b << 16) + (c << 8) + d)
+void WriteField(const char* name, uint32_t value, mtdisasm::StructuredWriter& w)
+{
+	w.WriteUInt(name, value);
+}
 
-bool PullData(void* dest, const std::vector<uint8_t>& data, size_t pos, size_t size)
+void WriteField(const char* name, uint16_t value, mtdisasm::StructuredWriter& w)
 {
-	if (size == 0)
-		return true;
+	w.WriteUInt(name, value);
+}
 
-	if (size > data.size())
-		return false;
+void WriteField(const char* name, uint8_t value, mtdisasm::StructuredWriter& w)
+{
+	w.WriteUInt(name, value);
+}
 
-	if (data.size() - size < pos)
-		return false;
+void WriteField(const char* name, int32_t value, mtdisasm::StructuredWriter& w)
+{
+	w.WriteInt(name, value);
+}
 
-	memcpy(dest, &data[pos], size);
-	return true;
+void WriteField(const char* name, int16_t value, mtdisasm::StructuredWriter& w)
+{
+	w.WriteInt(name, value);
 }
 
-bool RecursiveFixupSTCOChunkFromAtomStart(std::vector<uint8_t>& data, uint32_t atomStartPos, uint32_t& outAtomEndPos, uint32_t basePosition, uint32_t atomSize)
+void WriteField(const char* name, int8_t value, mtdisasm::StructuredWriter& w)
 {
-	static const uint32_t descendableAtoms[] = {
-		ATOM('m', 'o', 'o', 'v'),
-		ATOM('t', 'r', 'a', 'k'),
-		ATOM('m', 'd', 'i', 'a'),
-		ATOM('m', 'i', 'n', 'f'),
-		ATOM('s', 't', 'b', 'l')
-	};
+	w.WriteInt(name, value);
+}
 
-	uint8_t atomHeader[8];
-	if (!PullData(atomHeader, data, atomStartPos, 8))
-		return false;
+void WriteField(const char* name, const mtdisasm::DORect& rect, mtdisasm::StructuredWriter& w)
+{
+	w.BeginObject(name);
+	w.WriteInt("Left", rect.m_left);
+	w.WriteInt("Top", rect.m_top);
+	w.WriteInt("Right", rect.m_right);
+	w.WriteInt("Bottom", rect.m_bottom);
+	w.EndObject();
+}
 
-	uint32_t atomCodedSize = (atomHeader[0] << 24) + (atomHeader[1] << 16) + (atomHeader[2] << 8) + atomHeader[3];
-	uint32_t atomID = (atomHeader[4] << 24) + (atomHeader[5] << 16) + (atomHeader[6] << 8) + atomHeader[7];
+void WriteField(const char* name, const mtdisasm::DOPoint& pt, mtdisasm::StructuredWriter& w)
+{
+	w.BeginObject(name);
+	w.WriteInt("Left", pt.m_left);
+	w.WriteInt("Top", pt.m_top);
+	w.EndObject();
+}
 
-	if (atomCodedSize == 0)
-		atomCodedSize = atomSize;
+void WriteField(const char* name, const mtdisasm::DOEvent& evt, mtdisasm::StructuredWriter& w)
+{
+	w.BeginObject(name);
+	w.WriteUInt("EventID", evt.m_eventID);
+	w.WriteUInt("EventInfo", evt.m_eventInfo);
+	w.EndObject();
+}
 
-	if (atomCodedSize < 8)
-		return false;
+void WriteField(const char* name, const mtdisasm::DOLabel& lbl, mtdisasm::StructuredWriter& w)
+{
+	w.BeginObject(name);
+	w.WriteUInt("SuperGroupID", lbl.m_superGroupID);
+	w.WriteUInt("ID", lbl.m_id);
+	w.EndObject();
+}
 
-	uint32_t atomEndPos = atomCodedSize + atomStartPos;
+void WriteField(const char* name, const mtdisasm::DOColor& clr, mtdisasm::StructuredWriter& w)
+{
+	w.BeginObject(name);
+	w.WriteUInt("Red", clr.m_red);
+	w.WriteUInt("Green", clr.m_green);
+	w.WriteUInt("Blue", clr.m_blue);
+	w.EndObject();
+}
 
-	bool isDescendable = false;
-	for (uint32_t descendable : descendableAtoms)
-	{
-		if (descendable == atomID)
-		{
-			isDescendable = true;
-			break;
-		}
-	}
+void WriteField(const char* name, const mtdisasm::DOFloat& fl, mtdisasm::StructuredWriter& w)
+{
+	w.WriteDouble(name, fl.m_value);
+}
 
-	if (isDescendable)
-	{
-		// Descendable atom
-		uint32_t remainingSize = atomCodedSize - 8;
-		uint32_t childStartPos = atomStartPos + 8;
-		while (remainingSize > 0)
-		{
-			uint32_t childEndPos = 0;
-			if (!RecursiveFixupSTCOChunkFromAtomStart(data, childStartPos, childEndPos, basePosition, remainingSize))
-				return false;
+void WriteField(const char* name, const mtdisasm::DOVector& v, mtdisasm::StructuredWriter& w)
+{
+	w.BeginObject(name);
+	w.WriteDouble("AngleRadians", v.m_angleRadians.m_value);
+	w.WriteDouble("Magnitude", v.m_magnitude.m_value);
+	w.EndObject();
+}
 
-			remainingSize = atomEndPos - childEndPos;
-			childStartPos = childEndPos;
-		}
-	}
-	else if (atomID == ATOM('s', 't', 'c', 'o'))
+void WriteField(const char* name, const mtdisasm::PlugInTypeTaggedValue& v, mtdisasm::StructuredWriter& w)
+{
+	w.BeginObject(name);
+	w.WriteUInt("Type", v.m_type);
+
+	switch (v.m_type)
 	{
-		uint8_t stcoData[8];
-		if (!PullData(stcoData, data, atomStartPos + 8, 8))
-			return false;
+	case mtdisasm::PlugInTypeTaggedValue::kLabel:
+		w.WriteUInt("SuperGroup", v.m_value.m_lbl.m_superGroup);
+		w.WriteUInt("ID", v.m_value.m_lbl.m_id);
+		break;
+	case mtdisasm::PlugInTypeTaggedValue::kInteger:
+		w.WriteInt("Value", v.m_value.m_int);
+		break;
+	case mtdisasm::PlugInTypeTaggedValue::kBoolean:
+		w.WriteBool("Value", v.m_value.m_bool != 0);
+		break;
+	case mtdisasm::PlugInTypeTaggedValue::kVariableRef:
+		w.WriteUInt("GUID", v.m_value.m_var.m_guid);
+		break;
+	default:
+		break;
+	}
 
-		uint8_t version = stcoData[0];
-		uint32_t flags = (stcoData[1] << 16) + (stcoData[2] << 8) + stcoData[3];
-		uint32_t numEntries = (stcoData[4] << 24) + (stcoData[5] << 16) + (stcoData[6] << 8) + stcoData[7];
+	w.EndObject();
+}
 
-		for (uint32_t i = 0; i < numEntries; i++)
-		{
-			uint8_t chunkOffsetData[4];
+template<size_t TSize, class T>
+void WriteField(const char* name, const T (&arr)[TSize], mtdisasm::StructuredWriter& w)
+{
+	w.BeginArray(name);
+	for (size_t i = 0; i < TSize; i++)
+		WriteField(nullptr, arr[i], w);
+	w.EndArray();
+}
 
-			uint32_t fileOffsetPos = atomStartPos + 16 + i * 4;
-			if (!PullData(chunkOffsetData, data, fileOffsetPos, 4))
-				return false;
+void WriteStrField(const char* name, const char* value, mtdisasm::StructuredWriter& w)
+{
+	w.WriteString(name, value);
+}
 
-			uint32_t offset = (chunkOffsetData[0] << 24) + (chunkOffsetData[1] << 16) + (chunkOffsetData[2] << 8) + chunkOffsetData[3];
-			offset -= basePosition;
-			data[fileOffsetPos + 0] = (offset >> 24) & 0xff;
-			data[fileOffsetPos + 1] = (offset >> 16) & 0xff;
-			data[fileOffsetPos + 2] = (offset >> 8) & 0xff;
-			data[fileOffsetPos + 3] = offset & 0xff;
-		}
-	}
+// Writes a null-terminated string without its terminator
+void WriteStrField(const char* name, const mtdisasm::ArenaVector<char>& chars, mtdisasm::StructuredWriter& w)
+{
+	if (chars.size() > 1)
+		w.WriteString(name, &chars[0], chars.size() - 1);
+	else
+		w.WriteString(name, "", 0);
+}
 
-	outAtomEndPos = atomEndPos;
+// Writes the first length characters of a string that isn't terminated
+void WriteStrField(const char* name, const mtdisasm::ArenaVector<char>& chars, size_t length, mtdisasm::StructuredWriter& w)
+{
+	if (length > chars.size())
+		length = chars.size();
 
-	return true;
+	if (length > 0)
+		w.WriteString(name, &chars[0], length);
+	else
+		w.WriteString(name, "", 0);
 }
 
-void FixupQuickTimeFileOffsets(std::vector<uint8_t>& data, uint32_t basePosition, uint32_t moovAtomPositionAbsolute, uint32_t moovDataSize)
+void WriteBytesField(const char* name, const mtdisasm::ArenaVector<uint8_t>& bytes, mtdisasm::StructuredWriter& w)
 {
-	uint32_t scratch = 0;
-	RecursiveFixupSTCOChunkFromAtomStart(data, moovAtomPositionAbsolute - basePosition, scratch, basePosition, moovDataSize);
+	if (bytes.size() > 0)
+		w.WriteBytes(name, &bytes[0], bytes.size());
+	else
+		w.WriteBytes(name, nullptr, 0);
 }
 
-void ExtractMovieAsset(std::unordered_set<uint32_t>& assetIDs, const mtdisasm::DOMovieAsset& asset, mtdisasm::IOStream& stream, const mtdisasm::SerializationProperties& sp, const std::string& basePath)
+void SerializeObject(const mtdisasm::DOStreamHeader& obj, mtdisasm::StructuredWriter& w)
 {
-	if (assetIDs.find(asset.m_assetID) != assetIDs.end())
-		return;
+	assert(obj.GetType() == mtdisasm::DataObjectType::kStreamHeader);
 
-	assetIDs.insert(asset.m_assetID);
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("Size", obj.m_sizeIncludingTag, w);
+	WriteStrField("Name", obj.m_name, w);
+	WriteField("ProjectID", obj.m_projectID, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+}
 
-	stream.SeekSet(asset.m_movieDataPos);
+void SerializeObject(const mtdisasm::DOPresentationSettings& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kPresentationSettings);
 
-	std::vector<uint8_t> movieData;
-	movieData.resize(asset.m_movieDataSize);
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("Size", obj.m_sizeIncludingTag, w);
 
-	if (asset.m_movieDataSize == 0)
-		return;
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("Dimensions", obj.m_dimensions, w);
+	WriteField("BitsPerPixel", obj.m_bitsPerPixel, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+}
 
-	if (!stream.ReadAll(&movieData[0], asset.m_movieDataSize))
-		return;
+void SerializeObject(const mtdisasm::DOGlobalObjectInfo& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kGlobalObjectInfo);
 
-	FixupQuickTimeFileOffsets(movieData, asset.m_movieDataPos, asset.m_moovAtomPos, asset.m_movieDataSize);
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("Size", obj.m_sizeIncludingTag, w);
+	WriteField("NumGlobalModifiers", obj.m_numGlobalModifiers, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+}
 
-	std::string outPath = basePath + "/asset_" + std::to_string(asset.m_assetID) + ".mov";
+void SerializeObject(const mtdisasm::DOUnknown19& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kUnknown19);
 
-	FILE* outF = fopen(outPath.c_str(), "w+b");
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("Size", obj.m_sizeIncludingTag, w);
 
-	if (!outF)
-		return;
+	WriteField("Unknown1", obj.m_unknown1, w);
+}
 
-	fwrite(&movieData[0], 1, asset.m_movieDataSize, outF);
+void SerializeObject(const mtdisasm::DODebris& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kDebris);
 
-	fclose(outF);
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("Size", obj.m_sizeIncludingTag, w);
 }
 
-void ExtractImageAsset(std::unordered_set<uint32_t>& assetIDs, const mtdisasm::DOImageAsset& asset, mtdisasm::IOStream& stream, const mtdisasm::SerializationProperties& sp, const std::string& basePath)
+void SerializeLabelTree(const mtdisasm::DOProjectLabelMap::LabelTree& obj, mtdisasm::StructuredWriter& w)
 {
-	if (assetIDs.find(asset.m_assetID) != assetIDs.end())
-		return;
+	w.BeginObject(nullptr);
+	WriteStrField("Name", obj.m_name, obj.m_nameLength, w);
+	WriteField("IsGroup", obj.m_isGroup, w);
+	WriteField("ID", obj.m_id, w);
+	WriteField("Unknown2", obj.m_unknown1, w);
+	WriteField("Flags", obj.m_flags, w);
 
-	assetIDs.insert(asset.m_assetID);
-
-	std::string outPath = basePath + "/asset_" + std::to_string(asset.m_assetID) + ".png";
+	w.BeginArray("Children");
+	for (size_t i = 0; i < obj.m_numChildren; i++)
+		SerializeLabelTree(obj.m_children[i], w);
+	w.EndArray();
 
-	size_t width = asset.m_rect1.m_right - asset.m_rect1.m_left;
-	size_t height = asset.m_rect1.m_bottom - asset.m_rect1.m_top;
-	size_t bytesPerRow = (width * asset.m_bitsPerPixel + 7) / 8;
-	bytesPerRow = (bytesPerRow + 3) / 4 * 4;
+	w.EndObject();
+}
 
-	if (width < 0)
-		return;
+void SerializeObject(const mtdisasm::DOProjectLabelMap& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kProjectLabelMap);
 
-	size_t expectedSize = bytesPerRow * height;
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("NumSuperGroups", obj.m_numSuperGroups, w);
+	WriteField("NextAvailableID", obj.m_nextAvailableID, w);
 
-	if (expectedSize != asset.m_size)
+	w.BeginArray("SuperGroups");
+	for (size_t i = 0; i < obj.m_numSuperGroups; i++)
 	{
-		fprintf(stderr, "Asset %u unexpected data size: Expected %u but was %u\n", static_cast<unsigned int>(asset.m_assetID), static_cast<unsigned int>(expectedSize), static_cast<unsigned int>(asset.m_size));
-		return;
-	}
-	if (asset.m_bitsPerPixel != 1 && asset.m_bitsPerPixel != 2 && asset.m_bitsPerPixel != 4 && asset.m_bitsPerPixel != 8 && asset.m_bitsPerPixel != 16 && asset.m_bitsPerPixel != 32)
-	{
-		fprintf(stderr, "Asset %u unsupported bit depth: %u\n", static_cast<unsigned int>(asset.m_assetID), static_cast<unsigned int>(asset.m_bitsPerPixel));
-		return;
+		const mtdisasm::DOProjectLabelMap::SuperGroup& sg = obj.m_superGroups[i];
+
+		w.BeginObject(nullptr);
+		WriteStrField("Name", sg.m_name, sg.m_nameLength, w);
+		WriteField("Unknown1", sg.m_id, w);
+		WriteField("Unknown2", sg.m_unknown2, w);
+
+		w.BeginArray("Children");
+		for (size_t j = 0; j < sg.m_numChildren; j++)
+			SerializeLabelTree(sg.m_tree[j], w);
+		w.EndArray();
+
+		w.EndObject();
 	}
+	w.EndArray();
+}
 
-	std::vector<uint8_t> rowData;
-	rowData.resize(bytesPerRow);
+void SerializeObject(const mtdisasm::DOProjectStructuralDef& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kProjectStructuralDef);
 
-	uint8_t* rowBytes = &rowData[0];
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("Flags", obj.m_flags, w);
+	WriteStrField("Name", obj.m_name, w);
+}
 
-	size_t outBytesPerRow = width * 3;
+void SerializeObject(const mtdisasm::DOAssetCatalog& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kAssetCatalog);
 
-	std::vector<uint8_t> decoded;
-	decoded.resize(height * outBytesPerRow);
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("TotalNameSizePlus22", obj.m_totalNameSizePlus22, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("NumAssets", obj.m_numAssets, w);
 
-	stream.SeekSet(asset.m_filePosition);
-	for (size_t row = 0; row < height; row++)
+	w.BeginArray("Assets");
+	for (uint32_t i = 0; i < obj.m_numAssets; i++)
 	{
-		stream.ReadAll(rowBytes, bytesPerRow);
-		uint8_t* outRowBytes = nullptr;
-
-		if (sp.m_systemType == mtdisasm::SystemType::kWindows)
-			outRowBytes = &decoded[(height - 1 - row) * outBytesPerRow];
-		else if (sp.m_systemType == mtdisasm::SystemType::kMac)
-			outRowBytes = &decoded[row * outBytesPerRow];
-		else
-			return;
+		const mtdisasm::DOAssetCatalog::AssetInfo& asset = obj.m_assets[i];
 
-		if (asset.m_bitsPerPixel == 32)
-		{
-			if (sp.m_systemType == mtdisasm::SystemType::kWindows)
-			{
-				for (size_t x = 0; x < width; x++)
-				{
-					outRowBytes[x * 3 + 0] = rowBytes[x * 4 + 3];
-					outRowBytes[x * 3 + 1] = rowBytes[x * 4 + 2];
-					outRowBytes[x * 3 + 2] = rowBytes[x * 4 + 1];
-				}
-			}
-			else if (sp.m_systemType == mtdisasm::SystemType::kMac)
-			{
-				for (size_t x = 0; x < width; x++)
-				{
-					outRowBytes[x * 3 + 0] = rowBytes[x * 4 + 0];
-					outRowBytes[x * 3 + 1] = rowBytes[x * 4 + 1];
-					outRowBytes[x * 3 + 2] = rowBytes[x * 4 + 2];
-				}
-			}
-		}
-		else if (asset.m_bitsPerPixel == 16)
+		w.BeginObject(nullptr);
+		WriteField("AssetID", static_cast<uint32_t>(i + 1), w);
+		WriteField("Flags1", asset.m_flags1, w);
+		WriteField("AlwaysZero", asset.m_alwaysZero, w);
+		WriteField("Unknown1", asset.m_unknown1, w);
+		WriteField("FilePosition", asset.m_filePosition, w);
+		if (obj.m_haveRev4Fields)
 		{
-			if (sp.m_systemType == mtdisasm::SystemType::kWindows)
-			{
-				for (size_t x = 0; x < width; x++)
-				{
-					uint16_t packedPixel = rowBytes[x * 2 + 0] + (rowBytes[x * 2 + 1] << 8);
-					outRowBytes[x * 3 + 2] = ((packedPixel & 0x1f) * 33) >> 2;
-					outRowBytes[x * 3 + 1] = (((packedPixel >> 5) & 0x1f) * 33) >> 2;
-					outRowBytes[x * 3 + 0] = (((packedPixel >> 10) & 0x1f) * 33) >> 2;
-				}
-			}
-			else if (sp.m_systemType == mtdisasm::SystemType::kMac)
-			{
-				for (size_t x = 0; x < width; x++)
-				{
-					uint16_t packedPixel = rowBytes[x * 2 + 1] + (rowBytes[x * 2 + 0] << 8);
-					outRowBytes[x * 3 + 2] = ((packedPixel & 0x1f) * 33) >> 2;
-					outRowBytes[x * 3 + 1] = (((packedPixel >> 5) & 0x1f) * 33) >> 2;
-					outRowBytes[x * 3 + 0] = (((packedPixel >> 10) & 0x1f) * 33) >> 2;
-				}
-			}
+			WriteField("AssetType", asset.m_rev4Fields.m_assetType, w);
+			WriteField("Flags2", asset.m_rev4Fields.m_flags2, w);
 		}
-		else if (asset.m_bitsPerPixel == 8)
-		{
-			for (size_t x = 0; x < width; x++)
-			{
-				uint8_t byte = rowBytes[x];
+		WriteStrField("Name", asset.m_name, w);
+		w.EndObject();
+	}
+	w.EndArray();
+}
 
-				outRowBytes[x * 3 + 0] = byte;
-				outRowBytes[x * 3 + 1] = byte;
-				outRowBytes[x * 3 + 2] = byte;
-			}
-		}
-		else if (asset.m_bitsPerPixel == 4)
-		{
-			for (size_t x = 0; x < width; x++)
-			{
-				int bit = (rowBytes[x / 2] >> (1 - (x % 2))) & 15;
-				uint8_t byte = bit * 17;
+void SerializeObject(const mtdisasm::DOColorTableAsset& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kColorTableAsset);
 
-				outRowBytes[x * 3 + 2] = byte;
-				outRowBytes[x * 3 + 1] = byte;
-				outRowBytes[x * 3 + 0] = byte;
-			}
-		}
-		else if (asset.m_bitsPerPixel == 2)
-		{
-			for (size_t x = 0; x < width; x++)
-			{
-				int bit = (rowBytes[x / 4] >> (3 - (x % 4))) & 3;
-				uint8_t byte = bit * 85;
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("AssetID", obj.m_assetID, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
 
-				outRowBytes[x * 3 + 2] = byte;
-				outRowBytes[x * 3 + 1] = byte;
-				outRowBytes[x * 3 + 0] = byte;
-			}
-		}
-		else if (asset.m_bitsPerPixel == 1)
-		{
-			for (size_t x = 0; x < width; x++)
-			{
-				int bit = (rowBytes[x / 8] >> (7 - (x % 8))) & 1;
-				uint8_t byte = bit * 255;
+	w.BeginArray("Colors");
+	for (uint32_t i = 0; i < 256; i++)
+	{
+		const mtdisasm::DOColorTableAsset::ColorDef& cdef = obj.m_colors[i];
 
-				outRowBytes[x * 3 + 2] = byte;
-				outRowBytes[x * 3 + 1] = byte;
-				outRowBytes[x * 3 + 0] = byte;
-			}
-		}
+		w.BeginObject(nullptr);
+		WriteField("Red", cdef.m_red, w);
+		WriteField("Green", cdef.m_green, w);
+		WriteField("Blue", cdef.m_blue, w);
+		w.EndObject();
 	}
-
-	stbi_write_png(outPath.c_str(), width, height, 3, &decoded[0], outBytesPerRow);
+	w.EndArray();
 }
 
-void ExtractAudioAsset(std::unordered_set<uint32_t> &assetIDs, const mtdisasm::DOAudioAsset &asset, mtdisasm::IOStream &stream, const mtdisasm::SerializationProperties &sp, const std::string &basePath)
+void SerializeObject(const mtdisasm::DOSectionStructuralDef& obj, mtdisasm::StructuredWriter& w)
 {
-	if (assetIDs.find(asset.m_assetID) != assetIDs.end())
-		return;
+	assert(obj.GetType() == mtdisasm::DataObjectType::kSectionStructuralDef);
 
-	assetIDs.insert(asset.m_assetID);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("SegmentID", obj.m_segmentID, w);
+	WriteField("SectionID", obj.m_sectionID, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("Flags", obj.m_flags, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteStrField("Name", obj.m_name, w);
+}
 
-	std::string outPath = basePath + "/asset_" + std::to_string(asset.m_assetID) + ".wav";
+void SerializeObject(const mtdisasm::DOSubsectionStructuralDef& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kSubsectionStructuralDef);
 
-	uint8_t encoding = asset.m_encoding1;
-	if (encoding != 0)
-	{
-		fprintf(stderr, "Sound asset %u uses unsupported encoding %i", asset.m_assetID, static_cast<int>(encoding));
-		return;
-	}
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("Flags", obj.m_flags, w);
+	WriteField("SectionID", obj.m_sectionID, w);
+	WriteStrField("Name", obj.m_name, w);
+}
 
-	if (asset.m_bitsPerSample != 8 && asset.m_bitsPerSample != 16)
-	{
-		fprintf(stderr, "Sound asset %u has unsupported bits per sample %i", asset.m_assetID, static_cast<int>(asset.m_bitsPerSample));
-		return;
-	}
+void SerializeObject(const mtdisasm::DOGraphicStructuralDef& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kGraphicStructuralDef);
 
-	uint32_t sizePlus36 = asset.m_size + 36;
-	uint16_t blockSize = asset.m_bitsPerSample * asset.m_channels / 8;
-	uint32_t bytesPerSecond = blockSize * asset.m_sampleRate1;
+	WriteField("StructuralFlags", obj.m_structuralFlags, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("Flags", obj.m_flags, w);
+	WriteField("Layer", obj.m_layer, w);
+	WriteField("SectionID", obj.m_sectionID, w);
+	WriteField("Rect1", obj.m_rect1, w);
+	WriteField("Rect2", obj.m_rect2, w);
+	WriteField("StreamLocator", obj.m_streamLocator, w);
+	WriteField("StreamID", static_cast<uint32_t>(obj.m_streamLocator & mtdisasm::kSceneLocatorStreamIDMask), w);
 
-	uint16_t wavFormatCode = 1;	// PCM
-	uint16_t sampleRate = asset.m_sampleRate1;
+	WriteField("Unknown11", obj.m_unknown11, w);
+	WriteStrField("Name", obj.m_name, w);
+}
 
-	uint8_t wavHeader[] =
-	{
-		'R', 'I', 'F', 'F',
-		((sizePlus36 >> 0) & 0xff), ((sizePlus36 >> 8) & 0xff), ((sizePlus36 >> 16) & 0xff), ((sizePlus36 >> 24) & 0xff),
-		'W', 'A', 'V', 'E', 'f', 'm', 't', ' ',
-		16, 0, 0, 0,	// fmt chunk size
-		((wavFormatCode >> 0) & 0xff), ((wavFormatCode >> 8) & 0xff),
-		asset.m_channels, 0,
-		((sampleRate >> 0) & 0xff), ((sampleRate >> 8) & 0xff), 0, 0,
-		((bytesPerSecond >> 0) & 0xff), ((bytesPerSecond >> 8) & 0xff), ((bytesPerSecond >> 16) & 0xff), ((bytesPerSecond >> 24) & 0xff),
-		((blockSize >> 0) & 0xff), ((blockSize >> 8) & 0xff),
-		((asset.m_bitsPerSample >> 0) & 0xff), 0,
-		'd', 'a', 't', 'a',
-		((asset.m_size >> 0) & 0xff), ((asset.m_size >> 8) & 0xff), ((asset.m_size >> 16) & 0xff), ((asset.m_size >> 24) & 0xff),
-	};
+void SerializeObject(const mtdisasm::DOTextStructuralDef& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kTextStructuralDef);
 
-	std::vector<uint8_t> soundData;
-	soundData.resize(asset.m_size);
+	WriteField("StructuralFlags", obj.m_structuralFlags, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("LengthOfName", obj.m_lengthOfName, w);
+	WriteField("Flags", obj.m_elementFlags, w);
+	WriteField("Layer", obj.m_layer, w);
+	WriteField("SectionID", obj.m_sectionID, w);
+	WriteField("Rect1", obj.m_rect1, w);
+	WriteField("Rect2", obj.m_rect2, w);
+	WriteField("AssetID", obj.m_assetID, w);
+	WriteStrField("Name", obj.m_name, w);
 
-	if (asset.m_bitsPerSample == 16 && asset.m_isBigEndian)
+	if (obj.m_haveMacPart)
 	{
-		for (size_t i = 0; i < soundData.size(); i += 2)
-			std::swap(soundData[i], soundData[i + 1]);
+		WriteField("Unknown2", obj.m_platform.m_mac.m_unknown2, w);
 	}
-
-	if (asset.m_size > 0)
+	else if (obj.m_haveWinPart)
 	{
-		stream.SeekSet(asset.m_filePosition);
-		stream.ReadAll(&soundData[0], asset.m_size);
-
-		FILE *f = fopen(outPath.c_str(), "wb");
-		if (f)
-		{
-			fwrite(wavHeader, 1, sizeof(wavHeader), f);
-			fwrite(&soundData[0], 1, soundData.size(), f);
-			fclose(f);
-		}
+		WriteField("Unknown3", obj.m_platform.m_win.m_unknown3, w);
+		WriteField("Unknown4", obj.m_platform.m_win.m_unknown4, w);
 	}
 }
 
-void DecodeRGB15(uint16_t v, RGBColor& color)
+void SerializeObject(const mtdisasm::DOSoundStructuralDef& obj, mtdisasm::StructuredWriter& w)
 {
-	int b = v & 0x1f;
-	int g = (v >> 5) & 0x1f;
-	int r = (v >> 10) & 0x1f;
+	assert(obj.GetType() == mtdisasm::DataObjectType::kSoundStructuralDef);
 
-	color.r = (r * 33) >> 2;
-	color.g = (g * 33) >> 2;
-	color.b = (b * 33) >> 2;
+	WriteField("StructuralFlags", obj.m_structuralFlags, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("LengthOfName", obj.m_lengthOfName, w);
+	WriteField("ElementFlags", obj.m_elementFlags, w);
+	WriteField("SoundFlags", obj.m_soundFlags, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("Balance", obj.m_balance, w);
+	WriteField("AssetID", obj.m_assetID, w);
+	WriteField("RightVolume", obj.m_rightVolume, w);
+	WriteField("LeftVolume", obj.m_leftVolume, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteStrField("Name", obj.m_name, w);
 }
 
-void ExtractMToonAsset(std::unordered_set<uint32_t>& assetIDs, const mtdisasm::DOMToonAsset& asset, mtdisasm::IOStream& stream, const mtdisasm::SerializationProperties& sp, const std::string& basePath)
+void SerializeObject(const mtdisasm::DOImageStructuralDef& obj, mtdisasm::StructuredWriter& w)
 {
-	if (assetIDs.find(asset.m_assetID) != assetIDs.end())
-		return;
+	assert(obj.GetType() == mtdisasm::DataObjectType::kImageStructuralDef);
+
+	WriteField("StructuralFlags", obj.m_structuralFlags, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("Flags", obj.m_flags, w);
+	WriteField("Layer", obj.m_layer, w);
+	WriteField("SectionID", obj.m_sectionID, w);
+	WriteField("Rect1", obj.m_rect1, w);
+	WriteField("Rect2", obj.m_rect2, w);
+	WriteField("ImageAssetID", obj.m_imageAssetID, w);
+	WriteField("StreamLocator", obj.m_streamLocator, w);
+	WriteField("StreamID", static_cast<uint32_t>(obj.m_streamLocator & mtdisasm::kSceneLocatorStreamIDMask), w);
+	WriteField("Unknown7", obj.m_unknown7, w);
+	WriteStrField("Name", obj.m_name, w);
+}
 
-	assetIDs.insert(asset.m_assetID);
+void SerializeObject(const mtdisasm::DOMovieStructuralDef& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kMovieStructuralDef || obj.GetType() == mtdisasm::DataObjectType::kExternalMovieStructuralDef);
 
-	bool isMToonRLE = (asset.m_codecID == 0x2e524c45);
-	bool isUncompressed = (asset.m_codecID == 0);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("Flags", obj.m_flags, w);
+	WriteField("Layer", obj.m_layer, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("SectionID", obj.m_sectionID, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteField("Rect1", obj.m_rect1, w);
+	WriteField("Rect2", obj.m_rect2, w);
+	WriteField("AssetID", obj.m_assetID, w);
+	WriteField("Unknown7", obj.m_unknown7, w);
+	WriteField("Volume", obj.m_volume, w);
+	WriteField("AnimationFlags", obj.m_animationFlags, w);
+	WriteField("Unknown10", obj.m_unknown10, w);
+	WriteField("Unknown11", obj.m_unknown11, w);
+	WriteField("StreamLocator", obj.m_streamLocator, w);
+	WriteField("StreamID", static_cast<uint32_t>(obj.m_streamLocator & mtdisasm::kSceneLocatorStreamIDMask), w);
+	WriteField("Unknown13", obj.m_unknown13, w);
+	WriteStrField("Name", obj.m_name, w);
+}
+
+void SerializeObject(const mtdisasm::DOMToonStructuralDef& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kMToonStructuralDef);
 
-	if (!isMToonRLE && !isUncompressed)
+	WriteField("StructuralFlags", obj.m_structuralFlags, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("LengthOfName", obj.m_lengthOfName, w);
+	WriteField("ElementFlags", obj.m_elementFlags, w);
+	WriteField("Layer", obj.m_layer, w);
+	WriteField("AnimationFlags", obj.m_animationFlags, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("SectionID", obj.m_sectionID, w);
+	WriteField("Rect1", obj.m_rect1, w);
+	WriteField("Rect2", obj.m_rect2, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteField("RateTimes100000", obj.m_rateTimes100000, w);
+	WriteField("StreamLocator", obj.m_streamLocator, w);
+	WriteField("Unknown6", obj.m_unknown6, w);
+
+	WriteStrField("Name", obj.m_name, w);
+}
+
+void SerializeObject(const mtdisasm::DOMiniscriptProgram& obj, mtdisasm::StructuredWriter& w, bool isExpression)
+{
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("SizeOfInstructions", obj.m_sizeOfInstructions, w);
+	WriteField("NumOfInstructions", obj.m_numOfInstructions, w);
+	WriteField("NumLocalRefs", obj.m_numLocalRefs, w);
+	WriteField("NumAttributes", obj.m_numAttributes, w);
+
+	w.BeginArray("Attributes");
+	for (size_t i = 0; i < obj.m_numAttributes; i++)
 	{
-		char codecID[5] = { static_cast<char>((asset.m_codecID >> 24) & 0xff), static_cast<char>((asset.m_codecID >> 16) & 0xff), static_cast<char>((asset.m_codecID >> 8) & 0xff), static_cast<char>(asset.m_codecID & 0xff), 0 };
-		fprintf(stderr, "Not yet supported mToon compression type '%s' in asset %i\n", codecID, static_cast<int>(asset.m_assetID));
-		return;
+		const mtdisasm::DOMiniscriptProgram::Attribute& attrib = obj.m_attributes[i];
+
+		w.BeginObject(nullptr);
+		WriteField("Unknown11", attrib.m_unknown11, w);
+		WriteStrField("Name", attrib.m_name, w);
+		w.EndObject();
 	}
+	w.EndArray();
 
-	std::vector<uint8_t> frameData;
-	stream.SeekSet(asset.m_frameDataPosition);
-	frameData.resize(asset.m_sizeOfFrameData);
+	w.BeginArray("LocalRefs");
+	for (size_t i = 0; i < obj.m_numLocalRefs; i++)
+	{
+		const mtdisasm::DOMiniscriptProgram::LocalRef& ref = obj.m_localRefs[i];
+
+		w.BeginObject(nullptr);
+		WriteField("GUID", ref.m_guid, w);
+		WriteField("Unknown10", ref.m_unknown10, w);
+		WriteStrField("Name", ref.m_name, w);
+		w.EndObject();
+	}
+	w.EndArray();
 
-	stream.ReadAll(&frameData[0], asset.m_sizeOfFrameData);
+	// Operands and the decompiled source are captured as text from the same printers that
+	// text mode uses
+	std::string text;
+	mtdisasm::TextWriter textWriter(text);
 
-	for (size_t i = 0; i < asset.m_numFrames; i++)
+	w.BeginArray("Instructions");
+	size_t numInstrsDecoded = 0;
+	if (obj.m_sizeOfInstructions > 0)
 	{
-		const mtdisasm::DOMToonAsset::FrameDef& frameDef = asset.m_frames[i];
+		mtdisasm::MemIOStream memStream(&obj.m_bytecode[0], obj.m_bytecode.size());
+		mtdisasm::DataReader reader(memStream, obj.m_sp.m_isByteSwapped);
 
-		size_t numRows = frameDef.m_rect1.m_bottom - frameDef.m_rect1.m_top;
-		size_t numCols = frameDef.m_rect1.m_right - frameDef.m_rect1.m_left;
-		size_t dataOffset = frameDef.m_dataOffset;
-		bool isKeyframe = (frameDef.m_keyframeFlag != 0);
+		for (size_t i = 0; i < obj.m_numOfInstructions; i++)
+		{
+			uint32_t instrStartPos = reader.Tell();
 
-		bool isBottomUp = (sp.m_systemType == mtdisasm::SystemType::kWindows);
+			uint16_t opcode, unknownField, sizeOfInstruction;
+			if (!reader.ReadU16(opcode) || !reader.ReadU16(unknownField) || !reader.ReadU16(sizeOfInstruction))
+				break;
 
-		if (isMToonRLE)
-		{
-			uint8_t rleHeaderBytes[20];
-			for (size_t b = 0; b < 20; b++)
-				rleHeaderBytes[b] = frameData[dataOffset++];
+			if (sizeOfInstruction < 6)
+				break;
 
-			uint32_t rleHeaderInts[5];
-			for (size_t i = 0; i < 5; i++)
-				rleHeaderInts[i] = (rleHeaderBytes[i * 4 + 0] << 24) + (rleHeaderBytes[i * 4 + 1] << 16) + (rleHeaderBytes[i * 4 + 2] << 8) + rleHeaderBytes[i * 4 + 3];
+			text.clear();
+			bool decodedOK = PrintMiniscriptInstructionDisassembly(textWriter, reader, obj.m_sp, opcode, sizeOfInstruction - 6);
+			textWriter.Flush();
 
-			const uint32_t expectedHeader = isKeyframe ? 0x524c4520 : 1;
-			if (isKeyframe && rleHeaderInts[0] == 0x524c4520)
-			{
-				fprintf(stderr, "Keyframe header in non-keyframe mToon frame for some reason?\n");
-			}
+			if (!decodedOK)
+				break;
 
-			if (rleHeaderInts[1] == 0x01000001 && asset.m_bitsPerPixel == 8)
-			{
-				size_t rleCols = rleHeaderInts[2];
-				size_t rleRows = rleHeaderInts[3];
-				size_t rleSize = rleHeaderInts[4];
+			w.BeginObject(nullptr);
+			WriteField("Opcode", opcode, w);
 
-				if (rleSize < 20)
-				{
-					fprintf(stderr, "RLE data size for asset %u frame %zu is too small (was %zu but needs to be >20)\n", asset.m_assetID, i, rleSize);
-					break;
-				}
+			const char* opName = GetMiniscriptOpName(opcode);
+			if (opName)
+				w.WriteString("Op", opName);
+			else
+				w.WriteNull("Op");
 
-				//rleSize -= 20;
-				rleSize = frameDef.m_compressedSize - 20;
+			WriteField("Args", unknownField, w);
+			WriteField("Size", sizeOfInstruction, w);
+			w.WriteString("Operands", text.c_str(), text.size());
+			w.EndObject();
 
-				std::vector<uint8_t> imageData;
-				imageData.resize(rleCols * rleRows * 4);
+			reader.Seek(instrStartPos + sizeOfInstruction);
 
-				std::vector<uint8_t> compressedData;
-				compressedData.resize(rleSize);
+			numInstrsDecoded++;
+		}
+	}
+	w.EndArray();
 
-				for (size_t j = 0; j < rleSize; j++)
-					compressedData[j] = frameData[dataOffset++];
+	w.WriteBool("DisassemblyComplete", numInstrsDecoded == obj.m_numOfInstructions);
 
-				size_t rleDataOffset = 0;
-				for (size_t row = 0; row < rleRows; row++)
-				{
-					size_t colDataStart = row * rleCols * 4;
+	text.clear();
+	bool decompiledOK = DecompileMiniscript(obj, obj.m_sp, isExpression, textWriter);
+	textWriter.Flush();
 
-					if (isBottomUp)
-						colDataStart = (rleRows - 1 - row) * rleCols * 4;
+	if (decompiledOK)
+		w.WriteString("Decompiled", text.c_str(), text.size());
+	else
+		w.WriteNull("Decompiled");
+}
 
-					for (size_t col = 0; col < rleCols; )
-					{
-						size_t numDecompressed = 0;
-						if (rleDataOffset == compressedData.size())
-							break;
+void SerializeObject(const mtdisasm::DOMiniscriptModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kMiniscriptModifier);
 
-						uint8_t rleCode = compressedData[rleDataOffset++];
-						if (rleCode == 0 && !isKeyframe)
-						{
-							uint8_t numTransparent = compressedData[rleDataOffset++];
-
-							if (numTransparent & 0x80)
-							{
-								// Appears to be vertical displacement...?
-								row += (numTransparent & 0x7f) - 1;
-								col = 0;
-								break;
-							}
-							else
-							{
-								for (size_t tr = 0; tr < numTransparent; tr++)
-								{
-									if (col == rleCols)
-										break;	// Last row transparent run sometimes overruns the end of the buffer...
-
-									imageData[colDataStart + col * 4 + 0] = 0;
-									imageData[colDataStart + col * 4 + 1] = 0;
-									imageData[colDataStart + col * 4 + 2] = 0;
-									imageData[colDataStart + col * 4 + 3] = 0;
-									col++;
-								}
-							}
-						}
-						else if (rleCode & 0x80)
-						{
-							uint8_t numLiterals = rleCode & 0x7f;
-							for (size_t lit = 0; lit < numLiterals; lit++)
-							{
-								uint8_t litByte = compressedData[rleDataOffset++];
-								const RGBColor& color = g_macStandardPalette[litByte];
-								imageData[colDataStart + col * 4 + 0] = color.r;
-								imageData[colDataStart + col * 4 + 1] = color.g;
-								imageData[colDataStart + col * 4 + 2] = color.b;
-								imageData[colDataStart + col * 4 + 3] = 255;
-								col++;
-							}
-						}
-						else
-						{
-							uint8_t repeatedByte = compressedData[rleDataOffset++];
-							uint8_t numRepeats = rleCode;
-							const RGBColor& color = g_macStandardPalette[repeatedByte];
-							for (size_t rep = 0; rep < numRepeats; rep++)
-							{
-								imageData[colDataStart + col * 4 + 0] = color.r;
-								imageData[colDataStart + col * 4 + 1] = color.g;
-								imageData[colDataStart + col * 4 + 2] = color.b;
-								imageData[colDataStart + col * 4 + 3] = 255;
-								col++;
-							}
-						}
-					}
-				}
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("LengthOfName", obj.m_lengthOfName, w);
+	WriteField("EnableWhen", obj.m_enableWhen, w);
+	WriteField("Unknown6", obj.m_unknown6, w);
+	WriteField("Unknown7", obj.m_unknown7, w);
+	WriteStrField("Name", obj.m_name, w);
 
-				std::string outPath = basePath + "/asset_" + std::to_string(asset.m_assetID) + "_frame_" + std::to_string(i) + ".png";
-				stbi_write_png(outPath.c_str(), rleCols, rleRows, 4, &imageData[0], rleCols * 4);
-			}
-			else if (rleHeaderInts[1] == 0x01000002 && asset.m_bitsPerPixel == 16)
-			{
-				size_t rleCols = rleHeaderInts[2];
-				size_t rleRows = rleHeaderInts[3];
-				size_t rleSize = rleHeaderInts[4];
+	w.BeginObject("Program");
+	SerializeObject(obj.m_program, w, false);
+	w.EndObject();
+}
 
-				// In this version rleSize appears to NOT include the header
+void SerializeObject(const mtdisasm::DONotYetImplemented& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kNotYetImplemented);
 
-				//rleSize -= 20;
-				rleSize = frameDef.m_compressedSize - 20;
+	w.WriteString("Unimplemented", obj.m_name);
+	WriteField("DataSize", obj.m_sizeIncludingTag - 14, w);
+}
 
-				std::vector<uint8_t> imageData;
-				imageData.resize(rleCols * rleRows * 4);
+void SerializeObject(const mtdisasm::POUnknown& obj, mtdisasm::StructuredWriter& w)
+{
+	WriteBytesField("Data", obj.m_data, w);
+}
 
-				std::vector<uint8_t> compressedDataBytes;
-				compressedDataBytes.resize(rleSize);
+void SerializeObject(const mtdisasm::POCursorMod& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::PlugInObjectType::kCursorMod);
 
-				for (size_t j = 0; j < rleSize; j++)
-					compressedDataBytes[j] = frameData[dataOffset++];
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("ApplyWhen", obj.m_applyWhen, w);
 
-				std::vector<uint16_t> compressedData;
-				compressedData.resize(rleSize / 2);
+	if (obj.m_haveRev0Fields)
+	{
+		WriteField("Unknown5", obj.m_rev0Fields.m_unknown5, w);
+	}
 
-				if (sp.m_systemType == mtdisasm::SystemType::kWindows) {
-					for (size_t j = 0; j < rleSize / 2; j++)
-						compressedData[j] = (compressedDataBytes[j * 2 + 1] << 8) + compressedDataBytes[j * 2];
-				}
-				if (sp.m_systemType == mtdisasm::SystemType::kMac) {
-					for (size_t j = 0; j < rleSize / 2; j++)
-						compressedData[j] = (compressedDataBytes[j * 2 + 0] << 8) + compressedDataBytes[j * 2 + 1];
-				}
+	if (obj.m_haveRev1Fields)
+	{
+		WriteField("Unknown3", obj.m_rev1Fields.m_unknown3, w);
+		WriteField("Unknown4", obj.m_rev1Fields.m_unknown4, w);
+		WriteField("RemoveWhen", obj.m_rev1Fields.m_removeWhen, w);
+		WriteField("CursorID", obj.m_rev1Fields.m_cursorID, w);
+	}
+}
 
-				compressedDataBytes.clear();
+void SerializeObject(const mtdisasm::POMediaCueModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::PlugInObjectType::kMediaCue);
 
-				size_t rleDataOffset = 0;
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("NonStandardMessageFlags", obj.m_nonStandardMessageFlags, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("With", obj.m_with, w);
+	WriteField("Range", obj.m_range, w);
+	WriteField("Unknown10", obj.m_unknown10, w);
+	WriteField("TriggerTiming", obj.m_triggerTiming, w);
+	WriteField("Destination", obj.m_destination, w);
+	WriteField("ApplyWhen", obj.m_enableWhen, w);
+	WriteField("RemoveWhen", obj.m_disableWhen, w);
+	WriteField("SendEvent", obj.m_sendEvent, w);
+}
 
-				for (size_t row = 0; row < rleRows; row++)
-				{
-					size_t colDataStart = row * rleCols * 4;
-					for (size_t col = 0; col < rleCols; )
-					{
-						size_t numDecompressed = 0;
-						if (rleDataOffset == compressedData.size())
-							break;
+void SerializeObject(const mtdisasm::POMidiModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::PlugInObjectType::kMIDIModf);
 
-						uint16_t rleCode = compressedData[rleDataOffset++];
-						if (rleCode == 0)
-						{
-							uint16_t numTransparent = compressedData[rleDataOffset++];
-							if (numTransparent & 0x8000)
-							{
-								// Appears to be vertical displacement...?
-								row += (numTransparent & 0x7fff) - 1;
-								break;
-							}
-							else
-							{
-								for (size_t tr = 0; tr < numTransparent; tr++)
-								{
-									if (col == rleCols)
-										break;	// Last row transparent run sometimes overruns the end of the buffer...
-
-									imageData[colDataStart + col * 4 + 0] = 0;
-									imageData[colDataStart + col * 4 + 1] = 0;
-									imageData[colDataStart + col * 4 + 2] = 0;
-									imageData[colDataStart + col * 4 + 3] = 0;
-									col++;
-								}
-							}
-						}
-						else if (rleCode & 0x8000)
-						{
-							uint8_t numLiterals = rleCode & 0x7fff;
-							for (size_t lit = 0; lit < numLiterals; lit++)
-							{
-								uint16_t litWord = compressedData[rleDataOffset++];
-								RGBColor color;
-								DecodeRGB15(litWord, color);
-								imageData[colDataStart + col * 4 + 0] = color.r;
-								imageData[colDataStart + col * 4 + 1] = color.g;
-								imageData[colDataStart + col * 4 + 2] = color.b;
-								imageData[colDataStart + col * 4 + 3] = 255;
-								col++;
-							}
-						}
-						else
-						{
-							if (rleDataOffset == compressedData.size())
-							{
-								while (col < rleCols)
-								{
-									imageData[colDataStart + col * 4 + 0] = 255;
-									imageData[colDataStart + col * 4 + 1] = 0;
-									imageData[colDataStart + col * 4 + 2] = 255;
-									imageData[colDataStart + col * 4 + 3] = 255;
-									col++;
-								}
-								break;
-							}
-
-							uint16_t repeatedWord = compressedData[rleDataOffset++];
-							uint16_t numRepeats = rleCode;
-							RGBColor color;
-							DecodeRGB15(repeatedWord, color);
-							for (size_t rep = 0; rep < numRepeats; rep++)
-							{
-								if (col == rleCols)
-									break;
-								imageData[colDataStart + col * 4 + 0] = color.r;
-								imageData[colDataStart + col * 4 + 1] = color.g;
-								imageData[colDataStart + col * 4 + 2] = color.b;
-								imageData[colDataStart + col * 4 + 3] = 255;
-								col++;
-							}
-						}
-					}
-				}
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("ExecuteWhen", obj.m_executeWhen, w);
+	WriteField("TerminateWhen", obj.m_terminateWhen, w);
+	WriteField("IsEmbeddedMode", obj.m_embeddedFlag, w);
 
-				std::string outPath = basePath + "/asset_" + std::to_string(asset.m_assetID) + "_frame_" + std::to_string(i) + ".png";
-				stbi_write_png(outPath.c_str(), rleCols, rleRows, 4, &imageData[0], rleCols * 4);
-			}
-		}
-		else if (isUncompressed)
-		{
-			std::vector<uint8_t> imageData;
-			size_t numPixels = numCols * numRows;
-			imageData.resize(numPixels * 4);
+	if (obj.m_embeddedFlag)
+	{
+		const mtdisasm::POMidiModifier::EmbeddedPart& emb = obj.m_typeDependent.m_embedded;
+		WriteField("HasFile", emb.m_hasFile, w);
+		if (emb.m_hasFile)
+			WriteField("BigEndianLength", emb.m_bigEndianLength, w);
+
+		WriteField("Loop", emb.m_loop, w);
+		WriteField("OverrideTempo", emb.m_overrideTempo, w);
+		WriteField("Volume", emb.m_volume, w);
+		WriteField("Tempo", emb.m_tempo, w);
+		WriteField("FadeIn", emb.m_fadeIn, w);
+		WriteField("FadeOut", emb.m_fadeOut, w);
+	}
+	else
+	{
+		const mtdisasm::POMidiModifier::SingleNotePart& sn = obj.m_typeDependent.m_singleNote;
 
-			size_t bytesPerRow = frameDef.m_decompressedBytesPerRow;
+		WriteField("Channel", sn.m_channel, w);
+		WriteField("Note", sn.m_note, w);
+		WriteField("Velocity", sn.m_velocity, w);
+		WriteField("Program", sn.m_program, w);
+		WriteField("Duration", sn.m_duration, w);
+	}
+}
 
-			if (asset.m_bitsPerPixel == 8)
-			{
-				for (size_t row = 0; row < numRows; row++)
-				{
-					size_t rowOffset = dataOffset + row * bytesPerRow;
-					if (isBottomUp)
-						rowOffset = dataOffset + (numRows - 1 - row) * bytesPerRow;
+void SerializeObject(const mtdisasm::DOPlugInModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kPlugInModifier);
 
-					for (size_t col = 0; col < numCols; col++)
-					{
-						uint8_t pixel8 = frameData[rowOffset + col];
-						const RGBColor& color = g_macStandardPalette[pixel8];
-
-						const size_t px = col + row * numCols;
-						imageData[px * 4 + 0] = color.r;
-						imageData[px * 4 + 1] = color.g;
-						imageData[px * 4 + 2] = color.b;
-						imageData[px * 4 + 3] = 255;
-					}
-				}
-			}
-			else if (asset.m_bitsPerPixel == 16)
-			{
-				for (size_t row = 0; row < numRows; row++)
-				{
-					size_t rowOffset = dataOffset + row * bytesPerRow;
-					if (isBottomUp)
-						rowOffset = dataOffset + (numRows - 1 - row) * bytesPerRow;
+	w.WriteString("PlugIn", obj.m_plugin);
+	WriteField("PrivateDataSize", obj.m_privateDataSize, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("PlugInRevision", obj.m_plugInRevision, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("WeirdSize", obj.m_weirdSize, w);
 
-					for (size_t col = 0; col < numCols; col++)
-					{
-						const size_t px = col + row * numCols;
-
-						uint16_t pixel16 = frameData[rowOffset + col * 2 + 0] + (frameData[rowOffset + col * 2 + 1] << 8);
-						RGBColor color;
-						DecodeRGB15(pixel16, color);
-						imageData[px * 4 + 0] = color.r;
-						imageData[px * 4 + 1] = color.g;
-						imageData[px * 4 + 2] = color.b;
-						imageData[px * 4 + 3] = 255;
+	WriteStrField("Name", obj.m_name, w);
+
+	switch (obj.m_plugInData->GetType())
+	{
+	case mtdisasm::PlugInObjectType::kUnknown:
+		SerializeObject(static_cast<const mtdisasm::POUnknown&>(*obj.m_plugInData), w);
+		break;
+	case mtdisasm::PlugInObjectType::kCursorMod:
+		SerializeObject(static_cast<const mtdisasm::POCursorMod&>(*obj.m_plugInData), w);
+		break;
+	case mtdisasm::PlugInObjectType::kMIDIModf:
+		SerializeObject(static_cast<const mtdisasm::POMidiModifier&>(*obj.m_plugInData), w);
+		break;
+	case mtdisasm::PlugInObjectType::kMediaCue:
+		SerializeObject(static_cast<const mtdisasm::POMediaCueModifier&>(*obj.m_plugInData), w);
+		break;
+	default:
+		break;
+	}
+}
+
+void SerializeObject(const mtdisasm::DOAudioAsset& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kAudioAsset);
+
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("AssetAndDataCombinedSize", obj.m_assetAndDataCombinedSize, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("AssetID", obj.m_assetID, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("SampleRate1", obj.m_sampleRate1, w);
+	WriteField("BitsPerSample", obj.m_bitsPerSample, w);
+	WriteField("Encoding1", obj.m_encoding1, w);
+	WriteField("Channels", obj.m_channels, w);
+	WriteField("CodedDuration", obj.m_codedDuration, w);
+	WriteField("SampleRate2", obj.m_sampleRate2, w);
+	WriteField("CuePointDataSize", obj.m_cuePointDataSize, w);
+	WriteField("NumCuePoints", obj.m_numCuePoints, w);
+	WriteField("Unknown14", obj.m_unknown14, w);
+	WriteField("FilePosition", obj.m_filePosition, w);
+	WriteField("Size", obj.m_size, w);
+
+	if (obj.m_haveMacPart)
+	{
+		WriteField("Unknown4", obj.m_macPart.m_unknown4, w);
+		WriteField("Unknown5", obj.m_macPart.m_unknown5, w);
+		WriteField("Unknown6", obj.m_macPart.m_unknown6, w);
+		WriteField("Unknown8", obj.m_macPart.m_unknown8, w);
+	}
+
+	if (obj.m_haveWinPart)
+	{
+		WriteField("Unknown9", obj.m_winPart.m_unknown9, w);
+		WriteField("Unknown10", obj.m_winPart.m_unknown10, w);
+		WriteField("Unknown11", obj.m_winPart.m_unknown11, w);
+		WriteField("Unknown12_1", obj.m_winPart.m_unknown12_1, w);
+	}
+
+	w.BeginArray("CuePoints");
+	for (size_t i = 0; i < obj.m_numCuePoints; i++)
+	{
+		const mtdisasm::DOAudioAsset::CuePoint& cuePoint = obj.m_cuePoints[i];
+
+		w.BeginObject(nullptr);
+		WriteField("Unknown13", cuePoint.m_unknown13, w);
+		WriteField("Unknown14", cuePoint.m_unknown14, w);
+		WriteField("Position", cuePoint.m_position, w);
+		WriteField("CuePointID", cuePoint.m_cuePointID, w);
+		w.EndObject();
+	}
+	w.EndArray();
+}
+
+void SerializeObject(const mtdisasm::DOImageAsset& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kImageAsset);
+
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("AssetID", obj.m_assetID, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("Rect1", obj.m_rect1, w);
+	WriteField("HDPI", obj.m_hdpiFixed, w);
+	WriteField("VDPI", obj.m_vdpiFixed, w);
+	WriteField("BitsPerPixel", obj.m_bitsPerPixel, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteField("Unknown6", obj.m_unknown6, w);
+	WriteField("Rect2", obj.m_rect2, w);
+	WriteField("FilePosition", obj.m_filePosition, w);
+	WriteField("Size", obj.m_size, w);
+
+	if (obj.m_haveMacPart)
+		WriteField("Unknown7", obj.m_platform.m_mac.m_unknown7, w);
+	if (obj.m_haveWinPart)
+		WriteField("Unknown8", obj.m_platform.m_win.m_unknown8, w);
+}
+
+void SerializeObject(const mtdisasm::DOMovieAsset& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kMovieAsset);
+
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("AssetAndDataCombinedSize", obj.m_assetAndDataCombinedSize, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("AssetID", obj.m_assetID, w);
+	WriteField("Unknown1_1", obj.m_unknown1_1, w);
+	WriteField("ExtFileNameLength", obj.m_extFileNameLength, w);
+	WriteField("MovieDataPos", obj.m_movieDataPos, w);
+	WriteField("MovieDataSize", obj.m_movieDataSize, w);
+	WriteField("MoovAtomPos", obj.m_moovAtomPos, w);
+
+	if (obj.m_haveMacPart)
+	{
+		WriteField("Unknown5_1", obj.m_macPart.m_unknown5_1, w);
+		WriteField("Unknown6", obj.m_macPart.m_unknown6, w);
+	}
+
+	if (obj.m_haveWinPart)
+	{
+		WriteField("Unknown3_1", obj.m_winPart.m_unknown3_1, w);
+		WriteField("Unknown4", obj.m_winPart.m_unknown4, w);
+		WriteField("Unknown7", obj.m_winPart.m_unknown7, w);
+	}
+
+	if (obj.m_extFileNameLength > 1)
+		WriteStrField("ExternalFileName", obj.m_extFileName, obj.m_extFileNameLength - 1, w);
+}
+
+void SerializeObject(const mtdisasm::DOMToonAsset& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kMToonAsset);
+
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("AssetID", obj.m_assetID, w);
+	WriteField("FrameDataPosition", obj.m_frameDataPosition, w);
+	WriteField("SizeOfFrameData", obj.m_sizeOfFrameData, w);
+
+	WriteField("MToonHeader", obj.m_mtoonHeader, w);
+	WriteField("Version", obj.m_version, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("EncodingFlags", obj.m_encodingFlags, w);
+	WriteField("Rect", obj.m_rect, w);
+
+	WriteField("NumFrames", obj.m_numFrames, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("BitsPerPixel", obj.m_bitsPerPixel, w);
+	WriteField("CodecID", obj.m_codecID, w);
+	WriteField("Unknown4_1", obj.m_unknown4_1, w);
+	WriteField("CodecDataSize", obj.m_codecDataSize, w);
+	WriteField("Unknown4_2", obj.m_unknown4_2, w);
+
+	if (obj.m_haveMacPart)
+		WriteField("Unknown10", obj.m_platform.m_mac.m_unknown10, w);
+	if (obj.m_haveWinPart)
+		WriteField("Unknown11", obj.m_platform.m_win.m_unknown11, w);
+
+	w.BeginArray("Frames");
+	for (size_t i = 0; i < obj.m_numFrames; i++)
+	{
+		const mtdisasm::DOMToonAsset::FrameDef& frame = obj.m_frames[i];
+
+		w.BeginObject(nullptr);
+		WriteField("Unknown12", frame.m_unknown12, w);
+		WriteField("Rect1", frame.m_rect1, w);
+		WriteField("DataOffset", frame.m_dataOffset, w);
+		WriteField("AbsPos", frame.m_absPos, w);
+		WriteField("Unknown13", frame.m_unknown13, w);
+		WriteField("CompressedSize", frame.m_compressedSize, w);
+		WriteField("Unknown14", frame.m_unknown14, w);
+		WriteField("KeyframeFlag", frame.m_keyframeFlag, w);
+		WriteField("PlatformBit", frame.m_platformBit, w);
+		WriteField("Unknown15", frame.m_unknown15, w);
+		WriteField("Rect2", frame.m_rect2, w);
+		WriteField("HdpiFixed", frame.m_hdpiFixed, w);
+		WriteField("VdpiFixed", frame.m_vdpiFixed, w);
+		WriteField("BitsPerPixel", frame.m_bitsPerPixel, w);
+		WriteField("Unknown16", frame.m_unknown16, w);
+		WriteField("DecompressedBytesPerRow", frame.m_decompressedBytesPerRow, w);
+		WriteField("DecompressedSize", frame.m_decompressedSize, w);
+
+		if (obj.m_haveMacPart)
+			WriteField("Unknown17", frame.m_platform.m_mac.m_unknown17, w);
+		if (obj.m_haveWinPart)
+			WriteField("Unknown18", frame.m_platform.m_win.m_unknown18, w);
+		w.EndObject();
+	}
+	w.EndArray();
+
+	WriteBytesField("CodecData", obj.m_codecData, w);
+
+	if (obj.m_encodingFlags & mtdisasm::DOMToonAsset::kEncodingFlag_HasRanges)
+	{
+		WriteField("FrameRangesTag", obj.m_frameRangesPart.m_tag, w);
+		WriteField("FrameRangesSizeIncludingTag", obj.m_frameRangesPart.m_sizeIncludingTag, w);
+		WriteField("NumFrameRanges", obj.m_frameRangesPart.m_numFrameRanges, w);
+
+		w.BeginArray("FrameRanges");
+		for (size_t i = 0; i < obj.m_frameRangesPart.m_numFrameRanges; i++)
+		{
+			const mtdisasm::DOMToonAsset::FrameRangeDef& frameRange = obj.m_frameRangesPart.m_frameRanges[i];
+
+			w.BeginObject(nullptr);
+			WriteField("StartFrame", frameRange.m_startFrame, w);
+			WriteField("EndFrame", frameRange.m_endFrame, w);
+			WriteStrField("Name", frameRange.m_name, w);
+			WriteField("Unknown14", frameRange.m_unknown14, w);
+			w.EndObject();
+		}
+		w.EndArray();
+	}
+}
+
+
+void SerializeObject(const mtdisasm::DOTextAsset& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kTextAsset);
+
+	WriteField("Marker", obj.m_marker, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("AssetID", obj.m_assetID, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("BitmapRect", obj.m_bitmapRect, w);
+	WriteField("HDPI", obj.m_hdpi, w);
+	WriteField("VDPI", obj.m_vdpi, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteField("PitchBigEndian", obj.m_pitchBigEndian, w);
+	WriteField("Unknown6", obj.m_unknown6, w);
+	WriteField("BitmapSize", obj.m_bitmapSize, w);
+	WriteField("Unknown7", obj.m_unknown7, w);
+	WriteField("TextSize", obj.m_textSize, w);
+	WriteField("Unknown8", obj.m_unknown8, w);
+	WriteField("Alignment", obj.m_alignment, w);
+	WriteField("IsBitmap", obj.m_isBitmap, w);
+
+	if (obj.m_haveMacPart)
+		WriteField("Unknown3", obj.m_platform.m_mac.m_unknown3, w);
+	if (obj.m_haveWinPart)
+		WriteField("Unknown4", obj.m_platform.m_win.m_unknown4, w);
+
+	if ((obj.m_isBitmap & 1) == 0)
+		WriteStrField("Text", obj.m_text, w);
+
+	w.BeginArray("MacFormattingSpans");
+	for (size_t i = 0; i < obj.m_macFormattingSpans.size(); i++)
+	{
+		const mtdisasm::DOTextAsset::MacFormattingSpan& fmtSpan = obj.m_macFormattingSpans[i];
+
+		w.BeginObject(nullptr);
+		WriteField("Unknown9", fmtSpan.m_unknown9, w);
+		WriteField("SpanStart", fmtSpan.m_spanStart, w);
+		WriteField("Unknown10", fmtSpan.m_unknown10, w);
+		WriteField("FontID", fmtSpan.m_fontID, w);
+		WriteField("Unknown11", fmtSpan.m_unknown11, w);
+		WriteField("Size", fmtSpan.m_size, w);
+		WriteField("Unknown12", fmtSpan.m_unknown12, w);
+		w.EndObject();
+	}
+	w.EndArray();
+}
+
+void SerializeObject(const mtdisasm::DOAssetDataSection& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kAssetDataSection);
+
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+}
+
+void SerializeObject(const mtdisasm::DOBehaviorModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kBehaviorModifier);
+
+	WriteField("Unknown1", obj.m_modifierFlags, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteField("Unknown6", obj.m_unknown6, w);
+	WriteField("EditorLayoutPosition", obj.m_editorLayoutPosition, w);
+	WriteField("LengthOfName", obj.m_lengthOfName, w);
+	WriteField("NumChildren", obj.m_numChildren, w);
+	WriteField("Flags", obj.m_flags, w);
+	WriteField("EnableWhen", obj.m_enableWhen, w);
+	WriteField("DisableWhen", obj.m_disableWhen, w);
+	WriteField("Unknown7", obj.m_unknown7, w);
+
+	WriteStrField("Name", obj.m_name, w);
+}
+
+void SerializeObject(const mtdisasm::DOMessageDataSpec& obj, mtdisasm::StructuredWriter& w)
+{
+	WriteField("Type", obj.m_typeCode, w);
+	w.WriteBytes("Value", obj.m_value.m_unknown, sizeof(obj.m_value.m_unknown));
+}
+
+void SerializeObject(const mtdisasm::DOMessengerModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kMessengerModifier);
+
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteField("MessageFlags", obj.m_messageFlags, w);
+	WriteField("Unknown11", obj.m_unknown11, w);
+	WriteField("Unknown14", obj.m_unknown14, w);
+	WriteField("Send", obj.m_send, w);
+	WriteField("When", obj.m_when, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("LengthOfName", obj.m_lengthOfName, w);
+	WriteField("Destination", obj.m_destination, w);
+	w.BeginObject("With");
+	SerializeObject(obj.m_with, w);
+	w.EndObject();
+
+	WriteStrField("WithSource", obj.m_withSource, w);
+
+	WriteStrField("WithString", obj.m_withString, w);
+
+	WriteStrField("Name", obj.m_name, w);
+}
+void SerializeObject(const mtdisasm::DOTypicalModifierHeader& obj, mtdisasm::StructuredWriter& w)
+{
+	WriteField("ModifierFlags", obj.m_modifierFlags, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("LengthOfName", obj.m_lengthOfName, w);
+
+	WriteStrField("Name", obj.m_name, w);
+}
+
+void SerializeObject(const mtdisasm::DOIfMessengerModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kIfMessengerModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+	WriteField("Unknown6", obj.m_unknown6, w);
+	WriteField("Unknown7", obj.m_unknown7, w);
+	WriteField("Unknown8", obj.m_unknown8, w);
+	WriteField("Unknown9", obj.m_unknown9, w);
+	WriteField("Unknown10", obj.m_unknown10, w);
+	WriteField("MessageFlags", obj.m_messageFlags, w);
+	WriteField("Send", obj.m_send, w);
+	WriteField("When", obj.m_when, w);
+	WriteField("Destination", obj.m_destination, w);
+	WriteField("With", obj.m_with, w);
+	WriteField("WithSourceGUID", obj.m_withSourceGUID, w);
+
+	WriteStrField("WithSource", obj.m_withSource, w);
+
+	w.BeginObject("Program");
+	SerializeObject(obj.m_program, w, true);
+	w.EndObject();
+}
+
+void SerializeObject(const mtdisasm::DOTimerMessengerModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kTimerMessengerModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Unknown2", obj.m_unknown2, w);
+
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteField("Unknown6", obj.m_unknown6, w);
+	WriteField("Unknown7", obj.m_unknown7, w);
+	WriteField("Unknown8", obj.m_unknown8, w);
+	WriteField("Unknown9", obj.m_unknown9, w);
+	WriteField("MessageAndTimerFlags", obj.m_messageAndTimerFlags, w);
+	WriteField("ExecuteWhen", obj.m_executeWhen, w);
+	WriteField("Send", obj.m_send, w);
+	WriteField("TerminateWhen", obj.m_terminateWhen, w);
+	WriteField("Destination", obj.m_destination, w);
+	w.BeginObject("With");
+	SerializeObject(obj.m_with, w);
+	w.EndObject();
+	WriteField("Minutes", obj.m_minutes, w);
+	WriteField("Seconds", obj.m_seconds, w);
+	WriteField("HundredthsOfSeconds", obj.m_hundredthsOfSeconds, w);
+
+	WriteStrField("WithSource", obj.m_withSource, w);
+}
+
+void SerializeObject(const mtdisasm::DOBoundaryDetectionMessengerModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kBoundaryDetectionMessengerModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("MessageFlagsHigh", obj.m_messageFlagsHigh, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("Destination", obj.m_destination, w);
+	WriteField("EnableWhen", obj.m_enableWhen, w);
+	WriteField("DisableWhen", obj.m_disableWhen, w);
+	WriteField("Send", obj.m_send, w);
+
+	w.BeginObject("With");
+	SerializeObject(obj.m_with, w);
+	w.EndObject();
+
+	WriteStrField("WithSource", obj.m_withSource, w);
+}
+
+void SerializeObject(const mtdisasm::DOCollisionDetectionMessengerModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kCollisionDetectionMessengerModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("MessageAndModifierFlags", obj.m_messageAndModifierFlags, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("Destination", obj.m_destination, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+
+	WriteField("EnableWhen", obj.m_enableWhen, w);
+	WriteField("DisableWhen", obj.m_disableWhen, w);
+	WriteField("Send", obj.m_send, w);
+
+	w.BeginObject("With");
+	SerializeObject(obj.m_with, w);
+	w.EndObject();
+
+	WriteStrField("WithSource", obj.m_withSource, w);
+}
+
+void SerializeObject(const mtdisasm::DOSharedSceneModifier &obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kSharedSceneModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("ExecuteWhen", obj.m_executeWhen, w);
+	WriteField("SectionGUID", obj.m_sectionGUID, w);
+	WriteField("SubsectionGUID", obj.m_subsectionGUID, w);
+	WriteField("SceneGUID", obj.m_sceneGUID, w);
+}
+
+void SerializeObject(const mtdisasm::DOSetModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kSetModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("When", obj.m_when, w);
+	w.BeginObject("Source");
+	SerializeObject(obj.m_source, w);
+	w.EndObject();
+	w.BeginObject("Target");
+	SerializeObject(obj.m_target, w);
+	w.EndObject();
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("SourceNameLength", obj.m_sourceNameLength, w);
+	WriteField("TargetNameLength", obj.m_targetNameLength, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+
+	WriteStrField("SourceName", obj.m_sourceName, w);
+
+	WriteStrField("TargetName", obj.m_targetName, w);
+}
+
+void SerializeObject(const mtdisasm::DOSaveAndRestoreModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kSaveAndRestoreModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("SaveWhen", obj.m_saveWhen, w);
+	WriteField("RestoreWhen", obj.m_restoreWhen, w);
+	w.BeginObject("DataSpec");
+	SerializeObject(obj.m_dataSpec, w);
+	w.EndObject();
+	WriteField("Unknown5_1", obj.m_unknown5_1, w);
+	WriteField("Unknown5_2", obj.m_unknown5_2, w);
+	WriteField("Unknown6", obj.m_unknown6, w);
+	WriteField("Unknown7", obj.m_unknown7, w);
+	WriteField("LengthOfFilePath", obj.m_lengthOfFilePath, w);
+	WriteField("LengthOfFileName", obj.m_lengthOfFileName, w);
+	WriteField("LengthOfVariableName", obj.m_lengthOfVariableName, w);
+	WriteField("LengthOfVariableString", obj.m_lengthOfVariableString, w);
+	WriteStrField("VariableName", obj.m_varName, w);
+	WriteStrField("VariableString", obj.m_varString, w);
+	WriteStrField("FilePath", obj.m_filePath, w);
+	WriteStrField("FileName", obj.m_fileName, w);
+}
+
+void SerializeObject(const mtdisasm::DOKeyboardMessengerModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kKeyboardMessengerModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+	WriteField("MessageFlagsAndKeyStates", obj.m_messageFlagsAndKeyStates, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("KeyModifiers", obj.m_keyModifiers, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("Message", obj.m_message, w);
+	WriteField("Unknown7", obj.m_unknown7, w);
+	WriteField("Destination", obj.m_destination, w);
+	WriteField("Unknown9", obj.m_unknown9, w);
+	w.BeginObject("With");
+	SerializeObject(obj.m_with, w);
+	w.EndObject();
+
+	WriteField("KeyCode", obj.m_keycode, w);
+	WriteField("WithSourceLength", obj.m_withSourceLength, w);
+
+	WriteStrField("WithSource", obj.m_withSource, w);
+
+	WriteField("WithStringLength", obj.m_withStringLength, w);
+	WriteStrField("WithString", obj.m_withString, w);
+}
+
+void SerializeObject(const mtdisasm::DOBooleanVariableModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kBooleanVariableModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+	WriteField("Unknown5", obj.m_unknown5, w);
+
+	WriteField("Value", obj.m_value, w);
+}
+
+void SerializeObject(const mtdisasm::DOIntegerVariableModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kIntegerVariableModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Value", obj.m_value, w);
+}
+
+void SerializeObject(const mtdisasm::DOIntegerRangeVariableModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kIntegerRangeVariableModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Min", obj.m_min, w);
+	WriteField("Max", obj.m_max, w);
+}
+
+void SerializeObject(const mtdisasm::DOFloatVariableModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kFloatVariableModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Value", obj.m_value, w);
+}
+
+void SerializeObject(const mtdisasm::DOCompoundVariableModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kCompoundVariableModifier);
+
+	WriteField("ModifierFlags", obj.m_modifierFlags, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("GUID", obj.m_guid, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteField("NumChildren", obj.m_numChildren, w);
+	WriteStrField("Name", obj.m_name, w);
+	WriteField("Unknown7", obj.m_unknown7, w);
+	WriteField("EditorLayoutPosition", obj.m_editorLayoutPosition, w);
+}
+
+void SerializeObject(const mtdisasm::DOVectorVariableModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kVectorVariableModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Angle", obj.m_value, w);
+}
+
+void SerializeObject(const mtdisasm::DOStringVariableModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kStringVariableModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteStrField("Value", obj.m_string, w);
+}
+
+void SerializeObject(const mtdisasm::DOPointVariableModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kPointVariableModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+	WriteField("Unknown5", obj.m_unknown5, w);
+
+	WriteField("Value", obj.m_value, w);
+}
+
+void SerializeObject(const mtdisasm::DOGraphicModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kGraphicModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("ApplyWhen", obj.m_applyWhen, w);
+	WriteField("RemoveWhen", obj.m_removeWhen, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("InkMode", obj.m_inkMode, w);
+	WriteField("Shape", obj.m_shape, w);
+
+	if (obj.m_haveMacPart)
+	{
+		WriteField("Unknown4_1", obj.m_platform.m_mac.m_unknown4_1, w);
+		WriteField("Unknown4_2", obj.m_platform.m_mac.m_unknown4_2, w);
+	}
+	if (obj.m_haveWinPart)
+	{
+		WriteField("Unknown5_1", obj.m_platform.m_win.m_unknown5_1, w);
+		WriteField("Unknown5_2", obj.m_platform.m_win.m_unknown5_2, w);
+	}
+	WriteField("ForeColor", obj.m_foreColor, w);
+	WriteField("BackColor", obj.m_backColor, w);
+
+	WriteField("ShadowSize", obj.m_shadowSize, w);
+	WriteField("ShadowColor", obj.m_shadowColor, w);
+	WriteField("BorderSize", obj.m_borderSize, w);
+	WriteField("BorderColor", obj.m_borderColor, w);
+
+	w.BeginArray("PolyPoints");
+	for (const mtdisasm::DOPoint &pt : obj.m_polyPoints)
+		WriteField(nullptr, pt, w);
+	w.EndArray();
+}
+
+void SerializeObject(const mtdisasm::DOTextStyleModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kTextStyleModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("Flags", obj.m_flags, w);
+	WriteField("MacFontID", obj.m_macFontID, w);
+	WriteField("Size", obj.m_size, w);
+	WriteField("TextColor", obj.m_textColor, w);
+	WriteField("BackgroundColor", obj.m_backgroundColor, w);
+	WriteField("Alignment", obj.m_alignment, w);
+	WriteField("ApplyWhen", obj.m_applyWhen, w);
+	WriteField("RemoveWhen", obj.m_removeWhen, w);
+
+	if (obj.m_lengthOfFontName > 0)
+	{
+		WriteStrField("FontFamilyName", obj.m_fontName, obj.m_lengthOfFontName, w);
+	}
+}
+
+void SerializeObject(const mtdisasm::DOSceneTransitionModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kSceneTransitionModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("EnableWhen", obj.m_enableWhen, w);
+	WriteField("DisableWhen", obj.m_disableWhen, w);
+	WriteField("TransitionType", obj.m_transitionType, w);
+	WriteField("Direction", obj.m_direction, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("Duration", obj.m_duration, w);
+	WriteField("Steps", obj.m_steps, w);
+}
+
+void SerializeObject(const mtdisasm::DOSimpleMotionModifier &obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kSimpleMotionModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+	WriteField("ExecuteWhen", obj.m_executeWhen, w);
+	WriteField("TerminateWhen", obj.m_terminateWhen, w);
+	WriteField("MotionType", obj.m_motionType, w);
+	WriteField("DirectionFlags", obj.m_directionFlags, w);
+	WriteField("Steps", obj.m_steps, w);
+	WriteField("DelayMSecTimes4800", obj.m_delayMSecTimes4800, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+}
+
+void SerializeObject(const mtdisasm::DOElementTransitionModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kElementTransitionModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("EnableWhen", obj.m_enableWhen, w);
+	WriteField("DisableWhen", obj.m_disableWhen, w);
+	WriteField("RevealType", obj.m_revealType, w);
+	WriteField("TransitionType", obj.m_transitionType, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("Unknown4", obj.m_unknown4, w);
+	WriteField("Steps", obj.m_steps, w);
+	WriteField("Rate", obj.m_rate, w);
+}
+
+void SerializeObject(const mtdisasm::DOPathMotionModifierV2& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kPathMotionModifierV2);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+	WriteField("Flags", obj.m_flags, w);
+	WriteField("ExecuteWhen", obj.m_executeWhen, w);
+	WriteField("TerminateWhen", obj.m_terminateWhen, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("NumPoints", obj.m_numPoints, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("FrameDurationTimes10Million", obj.m_frameDurationTimes10Million, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteField("Unknown6", obj.m_unknown6, w);
+
+	w.BeginArray("Points");
+	for (size_t i = 0; i < obj.m_numPoints; i++)
+	{
+		const mtdisasm::DOPathMotionModifierV2::PointDef& point = obj.m_pointDefs[i];
+
+		w.BeginObject(nullptr);
+		WriteField("Point", point.m_point, w);
+		WriteField("Frame", point.m_frame, w);
+		WriteField("FrameFlags", point.m_frameFlags, w);
+		WriteField("MessageFlags", point.m_messageFlags, w);
+		WriteField("Send", point.m_send, w);
+		WriteField("Unknown11", point.m_unknown11, w);
+		WriteField("Destination", point.m_destination, w);
+		WriteField("Unknown13", point.m_unknown13, w);
+		w.BeginObject("With");
+		SerializeObject(point.m_with, w);
+		w.EndObject();
+		WriteField("WithSourceLength", point.m_withSourceLength, w);
+		WriteField("WithStringLength", point.m_withStringLength, w);
+		WriteStrField("WithSource", point.m_withSource, w);
+		WriteStrField("WithString", point.m_withString, w);
+		w.EndObject();
+	}
+	w.EndArray();
+}
+
+void SerializeObject(const mtdisasm::DOPathMotionModifierV1 &obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kPathMotionModifierV1);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+	WriteField("Flags", obj.m_flags, w);
+	WriteField("ExecuteWhen", obj.m_executeWhen, w);
+	WriteField("TerminateWhen", obj.m_terminateWhen, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("NumPoints", obj.m_numPoints, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("FrameDurationTimes10Million", obj.m_frameDurationTimes10Million, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+	WriteField("Unknown6", obj.m_unknown6, w);
+
+	w.BeginArray("Points");
+	for (size_t i = 0; i < obj.m_numPoints; i++)
+	{
+		const mtdisasm::DOPathMotionModifierV1::PointDef &point = obj.m_pointDefs[i];
+
+		w.BeginObject(nullptr);
+		WriteField("Point", point.m_point, w);
+		WriteField("Frame", point.m_frame, w);
+		WriteField("FrameFlags", point.m_frameFlags, w);
+		w.EndObject();
+	}
+	w.EndArray();
+}
+
+void SerializeObject(const mtdisasm::DODragMotionModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kDragMotionModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("EnableWhen", obj.m_enableWhen, w);
+	WriteField("DisableWhen", obj.m_disableWhen, w);
+	WriteField("Constraints", obj.m_constraintMargin, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+
+	if (obj.m_haveMacPart)
+	{
+		WriteField("MacFlags", obj.m_platform.m_mac.m_flags, w);
+		WriteField("Unknown3", obj.m_platform.m_mac.m_unknown3, w);
+	}
+	if (obj.m_haveWinPart)
+	{
+		WriteField("Unknown2", obj.m_platform.m_win.m_unknown2, w);
+		WriteField("ConstrainToParent", obj.m_platform.m_win.m_constrainToParent, w);
+		WriteField("ConstrainHorizontal", obj.m_platform.m_win.m_constrainHorizontal, w);
+		WriteField("ConstrainVertical", obj.m_platform.m_win.m_constrainVertical, w);
+	}
+}
+
+void SerializeObject(const mtdisasm::DOVectorMotionModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kVectorMotionModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("EnableWhen", obj.m_enableWhen, w);
+	WriteField("DisableWhen", obj.m_disableWhen, w);
+	w.BeginObject("VarSource");
+	SerializeObject(obj.m_varSource, w);
+	w.EndObject();
+
+	WriteField("VarStringLength", obj.m_varStringLength, w);
+	WriteStrField("VarSourceName", obj.m_varSourceName, w);
+	WriteStrField("VarString", obj.m_varString, w);
+}
+
+void SerializeObject(const mtdisasm::DOChangeSceneModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kChangeSceneModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("SceneChangeFlags", obj.m_sceneChangeFlags, w);
+	WriteField("TargetSectionGUID", obj.m_targetSectionGUID, w);
+	WriteField("TargetSubsectionGUID", obj.m_targetSubsectionGUID, w);
+	WriteField("TargetSceneGUID", obj.m_targetSceneGUID, w);
+	WriteField("EnableWhen", obj.m_executeWhen, w);
+}
+
+void SerializeObject(const mtdisasm::DOImageEffectModifier &obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kImageEffectModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Flags", obj.m_flags, w);
+	WriteField("Type", obj.m_type, w);
+	WriteField("ApplyWhen", obj.m_applyWhen, w);
+	WriteField("RemoveWhen", obj.m_removeWhen, w);
+	WriteField("BevelWidth", obj.m_bevelWidth, w);
+	WriteField("ToneAmount", obj.m_toneAmount, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+}
+
+
+void SerializeObject(const mtdisasm::DOSoundFadeModifier &obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kSoundFadeModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("EnableWhen", obj.m_enableWhen, w);
+	WriteField("DisableWhen", obj.m_disableWhen, w);
+
+	WriteField("FadeToVolume", obj.m_fadeToVolume, w);
+	WriteField("CodedDuration", obj.m_codedDuration, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+}
+
+void SerializeObject(const mtdisasm::DOAliasModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kAliasModifier);
+
+	WriteField("ModifierFlags", obj.m_modifierFlags, w);
+	WriteField("SizeIncludingTag", obj.m_sizeIncludingTag, w);
+	WriteField("AliasIndexPlusOne", obj.m_aliasIndexPlusOne, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("EditorLayoutPosition", obj.m_editorLayoutPosition, w);
+	if (obj.m_haveGUID)
+		WriteField("GUID", obj.m_guid, w);
+	WriteStrField("Name", obj.m_name, w);
+}
+
+void SerializeObject(const mtdisasm::DOSoundEffectModifier& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kSoundEffectModifier);
+
+	w.BeginObject("ModHeader");
+	SerializeObject(obj.m_modHeader, w);
+	w.EndObject();
+	WriteField("EnableWhen", obj.m_executeWhen, w);
+	WriteField("DisableWhen", obj.m_terminateWhen, w);
+	WriteField("Unknown1", obj.m_unknown1, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteField("Unknown3", obj.m_unknown3, w);
+	WriteField("AssetID", obj.m_assetID, w);
+	WriteField("Unknown5", obj.m_unknown5, w);
+}
+
+void SerializeObject(const mtdisasm::DOExtVideoAsset& obj, mtdisasm::StructuredWriter& w)
+{
+	assert(obj.GetType() == mtdisasm::DataObjectType::kExtVideoAsset);
+
+	WriteField("Unknown1_0", obj.m_unknown1_0, w);
+	WriteField("AssetID", obj.m_assetID, w);
+	WriteField("Unknown1_1", obj.m_unknown1_1, w);
+	WriteField("LengthOfName", obj.m_lengthOfName, w);
+	WriteField("Unknown2", obj.m_unknown2, w);
+	WriteStrField("ExtFilename", obj.m_extFilename, w);
+}
+
+void SerializeObject(const mtdisasm::DOMacOnlyCursorModifier& obj, mtdisasm::StructuredWriter& w)
+{
+}
+
+template<class T>
+void SerializeObjectOfType(const mtdisasm::DataObject& obj, mtdisasm::StructuredWriter& w)
+{
+	SerializeObject(static_cast<const T&>(obj), w);
+}
+
+#define ATOM(a,b,c,d) static_cast<uint32_t>((a << 24) + (b << 16) + (c << 8) + d)
+
+bool PullData(void* dest, const std::vector<uint8_t>& data, size_t pos, size_t size)
+{
+	if (size == 0)
+		return true;
+
+	if (size > data.size())
+		return false;
+
+	if (data.size() - size < pos)
+		return false;
+
+	memcpy(dest, &data[pos], size);
+	return true;
+}
+
+bool RecursiveFixupSTCOChunkFromAtomStart(std::vector<uint8_t>& data, uint32_t atomStartPos, uint32_t& outAtomEndPos, uint32_t basePosition, uint32_t atomSize)
+{
+	static const uint32_t descendableAtoms[] = {
+		ATOM('m', 'o', 'o', 'v'),
+		ATOM('t', 'r', 'a', 'k'),
+		ATOM('m', 'd', 'i', 'a'),
+		ATOM('m', 'i', 'n', 'f'),
+		ATOM('s', 't', 'b', 'l')
+	};
+
+	uint8_t atomHeader[8];
+	if (!PullData(atomHeader, data, atomStartPos, 8))
+		return false;
+
+	uint32_t atomCodedSize = (atomHeader[0] << 24) + (atomHeader[1] << 16) + (atomHeader[2] << 8) + atomHeader[3];
+	uint32_t atomID = (atomHeader[4] << 24) + (atomHeader[5] << 16) + (atomHeader[6] << 8) + atomHeader[7];
+
+	if (atomCodedSize == 0)
+		atomCodedSize = atomSize;
+
+	if (atomCodedSize < 8)
+		return false;
+
+	uint32_t atomEndPos = atomCodedSize + atomStartPos;
+
+	bool isDescendable = false;
+	for (uint32_t descendable : descendableAtoms)
+	{
+		if (descendable == atomID)
+		{
+			isDescendable = true;
+			break;
+		}
+	}
+
+	if (isDescendable)
+	{
+		// Descendable atom
+		uint32_t remainingSize = atomCodedSize - 8;
+		uint32_t childStartPos = atomStartPos + 8;
+		while (remainingSize > 0)
+		{
+			uint32_t childEndPos = 0;
+			if (!RecursiveFixupSTCOChunkFromAtomStart(data, childStartPos, childEndPos, basePosition, remainingSize))
+				return false;
+
+			remainingSize = atomEndPos - childEndPos;
+			childStartPos = childEndPos;
+		}
+	}
+	else if (atomID == ATOM('s', 't', 'c', 'o'))
+	{
+		uint8_t stcoData[8];
+		if (!PullData(stcoData, data, atomStartPos + 8, 8))
+			return false;
+
+		uint8_t version = stcoData[0];
+		uint32_t flags = (stcoData[1] << 16) + (stcoData[2] << 8) + stcoData[3];
+		uint32_t numEntries = (stcoData[4] << 24) + (stcoData[5] << 16) + (stcoData[6] << 8) + stcoData[7];
+
+		for (uint32_t i = 0; i < numEntries; i++)
+		{
+			uint8_t chunkOffsetData[4];
+
+			uint32_t fileOffsetPos = atomStartPos + 16 + i * 4;
+			if (!PullData(chunkOffsetData, data, fileOffsetPos, 4))
+				return false;
+
+			uint32_t offset = (chunkOffsetData[0] << 24) + (chunkOffsetData[1] << 16) + (chunkOffsetData[2] << 8) + chunkOffsetData[3];
+			offset -= basePosition;
+			data[fileOffsetPos + 0] = (offset >> 24) & 0xff;
+			data[fileOffsetPos + 1] = (offset >> 16) & 0xff;
+			data[fileOffsetPos + 2] = (offset >> 8) & 0xff;
+			data[fileOffsetPos + 3] = offset & 0xff;
+		}
+	}
+
+	outAtomEndPos = atomEndPos;
+
+	return true;
+}
+
+void FixupQuickTimeFileOffsets(std::vector<uint8_t>& data, uint32_t basePosition, uint32_t moovAtomPositionAbsolute, uint32_t moovDataSize)
+{
+	uint32_t scratch = 0;
+	RecursiveFixupSTCOChunkFromAtomStart(data, moovAtomPositionAbsolute - basePosition, scratch, basePosition, moovDataSize);
+}
+
+enum class MToonFrameMode : uint8_t
+{
+	kFrames,		// Each frame decoded by itself
+	kComposite,		// Temporally compressed frames drawn over the frames before them
+	kAtlas,			// Every frame packed into atlas pages
+};
+
+// Atlas pages are limited to this many pixels on each side, unless a frame is bigger
+static const size_t kMaxAtlasPageSize = 4096;
+
+struct AssetExtractionOptions
+{
+	MToonFrameMode m_mtoonFrameMode;
+	mtdisasm::ImageEncoderOptions m_imageEncoderOptions;
+};
+
+// The extractors return false if they couldn't write all of an asset's output
+
+bool ExtractMovieAsset(const mtdisasm::DOMovieAsset& asset, const mtdisasm::IOStream& stream, const mtdisasm::SerializationProperties& sp, const std::string& basePath, const AssetExtractionOptions& options)
+{
+	std::vector<uint8_t> movieData;
+	movieData.resize(asset.m_movieDataSize);
+
+	if (asset.m_movieDataSize == 0)
+		return true;
+
+	if (!stream.ReadAt(asset.m_movieDataPos, &movieData[0], asset.m_movieDataSize))
+	{
+		fprintf(stderr, "Asset %u: Failed to read movie data\n", static_cast<unsigned int>(asset.m_assetID));
+		return false;
+	}
+
+	FixupQuickTimeFileOffsets(movieData, asset.m_movieDataPos, asset.m_moovAtomPos, asset.m_movieDataSize);
+
+	std::string outPath = basePath + "/asset_" + std::to_string(asset.m_assetID) + ".mov";
+
+	FILE* outF = fopen(outPath.c_str(), "w+b");
+
+	if (!outF)
+		return false;
+
+	bool succeeded = (fwrite(&movieData[0], 1, asset.m_movieDataSize, outF) == asset.m_movieDataSize);
+
+	return (fclose(outF) == 0) && succeeded;
+}
+
+bool ExtractImageAsset(const mtdisasm::DOImageAsset& asset, const mtdisasm::IOStream& stream, const mtdisasm::SerializationProperties& sp, const std::string& basePath, const AssetExtractionOptions& options)
+{
+	std::string outPath = basePath + "/asset_" + std::to_string(asset.m_assetID) + mtdisasm::GetImageFileExtension(options.m_imageEncoderOptions.m_backend, 3);
+
+	size_t width = asset.m_rect1.m_right - asset.m_rect1.m_left;
+	size_t height = asset.m_rect1.m_bottom - asset.m_rect1.m_top;
+	size_t bytesPerRow = (width * asset.m_bitsPerPixel + 7) / 8;
+	bytesPerRow = (bytesPerRow + 3) / 4 * 4;
+
+	if (width < 0)
+		return false;
+
+	size_t expectedSize = bytesPerRow * height;
+
+	if (expectedSize != asset.m_size)
+	{
+		fprintf(stderr, "Asset %u unexpected data size: Expected %u but was %u\n", static_cast<unsigned int>(asset.m_assetID), static_cast<unsigned int>(expectedSize), static_cast<unsigned int>(asset.m_size));
+		return false;
+	}
+	if (asset.m_bitsPerPixel != 1 && asset.m_bitsPerPixel != 2 && asset.m_bitsPerPixel != 4 && asset.m_bitsPerPixel != 8 && asset.m_bitsPerPixel != 16 && asset.m_bitsPerPixel != 32)
+	{
+		fprintf(stderr, "Asset %u unsupported bit depth: %u\n", static_cast<unsigned int>(asset.m_assetID), static_cast<unsigned int>(asset.m_bitsPerPixel));
+		return false;
+	}
+
+	if (sp.m_systemType != mtdisasm::SystemType::kWindows && sp.m_systemType != mtdisasm::SystemType::kMac)
+		return false;
+
+	const mtdisasm::PixelRowConverters& converters = *mtdisasm::GetPixelRowConverters(mtdisasm::PixelConvertISA::kAuto);
+	const bool isWindows = (sp.m_systemType == mtdisasm::SystemType::kWindows);
+
+	void (*convertRow)(const uint8_t* src, uint8_t* dest, size_t width) = nullptr;
+	switch (asset.m_bitsPerPixel)
+	{
+	case 32:
+		convertRow = isWindows ? converters.m_convertWin32ToRGB24 : converters.m_convertMac32ToRGB24;
+		break;
+	case 16:
+		convertRow = isWindows ? converters.m_convertRGB555LEToRGB24 : converters.m_convertRGB555BEToRGB24;
+		break;
+	case 8:
+		convertRow = converters.m_convertGray8ToRGB24;
+		break;
+	case 4:
+		convertRow = converters.m_convertGray4ToRGB24;
+		break;
+	case 2:
+		convertRow = converters.m_convertGray2ToRGB24;
+		break;
+	case 1:
+		convertRow = converters.m_convertGray1ToRGB24;
+		break;
+	}
+
+	// The whole image is read at once since the rows are contiguous
+	std::vector<uint8_t> imageData;
+	imageData.resize(expectedSize);
+
+	if (expectedSize > 0 && !stream.ReadAt(asset.m_filePosition, &imageData[0], expectedSize))
+	{
+		fprintf(stderr, "Asset %u: Failed to read image data\n", static_cast<unsigned int>(asset.m_assetID));
+		return false;
+	}
+
+	size_t outBytesPerRow = width * 3;
+
+	std::vector<uint8_t> decoded;
+	decoded.resize(height * outBytesPerRow);
+
+	for (size_t row = 0; row < height; row++)
+	{
+		const uint8_t* rowBytes = imageData.data() + row * bytesPerRow;
+		uint8_t* outRowBytes = nullptr;
+
+		if (isWindows)
+			outRowBytes = decoded.data() + (height - 1 - row) * outBytesPerRow;
+		else
+			outRowBytes = decoded.data() + row * outBytesPerRow;
+
+		convertRow(rowBytes, outRowBytes, width);
+	}
+
+	return mtdisasm::WriteImageFile(options.m_imageEncoderOptions, outPath, decoded.data(), width, height, 3, outBytesPerRow);
+}
+
+bool ExtractAudioAsset(const mtdisasm::DOAudioAsset &asset, const mtdisasm::IOStream &stream, const mtdisasm::SerializationProperties &sp, const std::string &basePath, const AssetExtractionOptions &options)
+{
+	std::string outPath = basePath + "/asset_" + std::to_string(asset.m_assetID) + ".wav";
+
+	uint8_t encoding = asset.m_encoding1;
+	if (encoding != 0)
+	{
+		fprintf(stderr, "Sound asset %u uses unsupported encoding %i", asset.m_assetID, static_cast<int>(encoding));
+		return false;
+	}
+
+	if (asset.m_bitsPerSample != 8 && asset.m_bitsPerSample != 16)
+	{
+		fprintf(stderr, "Sound asset %u has unsupported bits per sample %i", asset.m_assetID, static_cast<int>(asset.m_bitsPerSample));
+		return false;
+	}
+
+	uint32_t sizePlus36 = asset.m_size + 36;
+	uint16_t blockSize = asset.m_bitsPerSample * asset.m_channels / 8;
+	uint32_t bytesPerSecond = blockSize * asset.m_sampleRate1;
+
+	uint16_t wavFormatCode = 1;	// PCM
+	uint16_t sampleRate = asset.m_sampleRate1;
+
+	uint8_t wavHeader[] =
+	{
+		'R', 'I', 'F', 'F',
+		((sizePlus36 >> 0) & 0xff), ((sizePlus36 >> 8) & 0xff), ((sizePlus36 >> 16) & 0xff), ((sizePlus36 >> 24) & 0xff),
+		'W', 'A', 'V', 'E', 'f', 'm', 't', ' ',
+		16, 0, 0, 0,	// fmt chunk size
+		((wavFormatCode >> 0) & 0xff), ((wavFormatCode >> 8) & 0xff),
+		asset.m_channels, 0,
+		((sampleRate >> 0) & 0xff), ((sampleRate >> 8) & 0xff), 0, 0,
+		((bytesPerSecond >> 0) & 0xff), ((bytesPerSecond >> 8) & 0xff), ((bytesPerSecond >> 16) & 0xff), ((bytesPerSecond >> 24) & 0xff),
+		((blockSize >> 0) & 0xff), ((blockSize >> 8) & 0xff),
+		((asset.m_bitsPerSample >> 0) & 0xff), 0,
+		'd', 'a', 't', 'a',
+		((asset.m_size >> 0) & 0xff), ((asset.m_size >> 8) & 0xff), ((asset.m_size >> 16) & 0xff), ((asset.m_size >> 24) & 0xff),
+	};
+
+	std::vector<uint8_t> soundData;
+	soundData.resize(asset.m_size);
+
+	if (asset.m_bitsPerSample == 16 && asset.m_isBigEndian)
+	{
+		for (size_t i = 0; i < soundData.size(); i += 2)
+			std::swap(soundData[i], soundData[i + 1]);
+	}
+
+	if (asset.m_size > 0)
+	{
+		if (!stream.ReadAt(asset.m_filePosition, &soundData[0], asset.m_size))
+		{
+			fprintf(stderr, "Sound asset %u: Failed to read sample data\n", asset.m_assetID);
+			return false;
+		}
+
+		FILE *f = fopen(outPath.c_str(), "wb");
+		if (!f)
+			return false;
+
+		bool succeeded = (fwrite(wavHeader, 1, sizeof(wavHeader), f) == sizeof(wavHeader));
+		succeeded = (fwrite(&soundData[0], 1, soundData.size(), f) == soundData.size()) && succeeded;
+		return (fclose(f) == 0) && succeeded;
+	}
+
+	return true;
+}
+
+// Reads an RLE frame's header and finds its RLE data, or returns false if it's out of bounds
+bool FindMToonRLEFrame(const mtdisasm::DOMToonAsset::FrameDef& frameDef, const std::vector<uint8_t>& frameData, mtdisasm::MToonRLEFrameHeader& outHeader, const uint8_t*& outRLEData, size_t& outRLESize)
+{
+	const size_t dataOffset = frameDef.m_dataOffset;
+	if (dataOffset > frameData.size() || frameDef.m_compressedSize < mtdisasm::MToonRLEDecoder::kFrameHeaderSize || frameDef.m_compressedSize > frameData.size() - dataOffset)
+		return false;
+
+	if (!mtdisasm::MToonRLEDecoder::ReadFrameHeader(&frameData[dataOffset], frameDef.m_compressedSize, outHeader))
+		return false;
+
+	outRLEData = &frameData[dataOffset + mtdisasm::MToonRLEDecoder::kFrameHeaderSize];
+	outRLESize = frameDef.m_compressedSize - mtdisasm::MToonRLEDecoder::kFrameHeaderSize;
+	return true;
+}
+
+bool IsSupportedMToonRLEFormat(const mtdisasm::DOMToonAsset& asset, const mtdisasm::MToonRLEFrameHeader& rleHeader)
+{
+	return (rleHeader.m_format == mtdisasm::MToonRLEDecoder::k8BitFormat && asset.m_bitsPerPixel == 8)
+		|| (rleHeader.m_format == mtdisasm::MToonRLEDecoder::k16BitFormat && asset.m_bitsPerPixel == 16);
+}
+
+// Sizes the atlas slot of each frame, leaving frames that can't be decoded empty
+void GetMToonAtlasSlots(const mtdisasm::DOMToonAsset& asset, const std::vector<uint8_t>& frameData, bool isMToonRLE, std::vector<mtdisasm::AtlasSlot>& outSlots)
+{
+	outSlots.resize(asset.m_numFrames);
+
+	for (size_t i = 0; i < asset.m_numFrames; i++)
+	{
+		const mtdisasm::DOMToonAsset::FrameDef& frameDef = asset.m_frames[i];
+		mtdisasm::AtlasSlot& slot = outSlots[i];
+
+		slot.m_width = 0;
+		slot.m_height = 0;
+
+		if (isMToonRLE)
+		{
+			mtdisasm::MToonRLEFrameHeader rleHeader;
+			const uint8_t* rleData = nullptr;
+			size_t rleSize = 0;
+			if (FindMToonRLEFrame(frameDef, frameData, rleHeader, rleData, rleSize) && IsSupportedMToonRLEFormat(asset, rleHeader))
+			{
+				slot.m_width = rleHeader.m_width;
+				slot.m_height = rleHeader.m_height;
+			}
+		}
+		else if (frameDef.m_rect1.m_right > frameDef.m_rect1.m_left && frameDef.m_rect1.m_bottom > frameDef.m_rect1.m_top)
+		{
+			slot.m_width = frameDef.m_rect1.m_right - frameDef.m_rect1.m_left;
+			slot.m_height = frameDef.m_rect1.m_bottom - frameDef.m_rect1.m_top;
+		}
+	}
+}
+
+bool WriteMToonAtlasPage(const mtdisasm::DOMToonAsset& asset, size_t pageIndex, const mtdisasm::AtlasPage& page, const std::vector<uint8_t>& pixels, const std::string& basePath, const AssetExtractionOptions& options)
+{
+	if (page.m_width == 0 || page.m_height == 0)
+		return true;
+
+	std::string outPath = basePath + "/asset_" + std::to_string(asset.m_assetID) + "_atlas_" + std::to_string(pageIndex) + mtdisasm::GetImageFileExtension(options.m_imageEncoderOptions.m_backend, 4);
+	return mtdisasm::WriteImageFile(options.m_imageEncoderOptions, outPath, pixels.data(), page.m_width, page.m_height, 4, page.m_width * 4);
+}
+
+// Lists the atlas pages, where each decoded frame is in them, and the frame ranges
+bool WriteMToonAtlasTable(const mtdisasm::DOMToonAsset& asset, const std::vector<mtdisasm::AtlasPage>& pages, const std::vector<mtdisasm::AtlasSlot>& slots, const std::vector<bool>& isFrameDecoded, const std::string& basePath)
+{
+	std::string tablePath = basePath + "/asset_" + std::to_string(asset.m_assetID) + "_atlas.txt";
+	FILE* tableF = fopen(tablePath.c_str(), "wb");
+	if (!tableF)
+	{
+		fprintf(stderr, "Failed to open atlas table output path '%s'\n", tablePath.c_str());
+		return false;
+	}
+
+	mtdisasm::TextWriter f(tableF);
+
+	f.Printf("Page Width Height\n");
+	for (size_t i = 0; i < pages.size(); i++)
+		f.Printf("%u %u %u\n", static_cast<unsigned int>(i), static_cast<unsigned int>(pages[i].m_width), static_cast<unsigned int>(pages[i].m_height));
+
+	// Offsets are from the corner of the mToon's rect
+	f.Printf("Frame Page Left Top Width Height OffsetX OffsetY Keyframe\n");
+	for (size_t i = 0; i < slots.size(); i++)
+	{
+		if (!isFrameDecoded[i])
+			continue;
+
+		const mtdisasm::AtlasSlot& slot = slots[i];
+		const mtdisasm::DOMToonAsset::FrameDef& frameDef = asset.m_frames[i];
+		f.Printf("%u %u %u %u %u %u %i %i %i\n", static_cast<unsigned int>(i), static_cast<unsigned int>(slot.m_page), static_cast<unsigned int>(slot.m_left), static_cast<unsigned int>(slot.m_top),
+			static_cast<unsigned int>(slot.m_width), static_cast<unsigned int>(slot.m_height), frameDef.m_rect1.m_left - asset.m_rect.m_left, frameDef.m_rect1.m_top - asset.m_rect.m_top, (frameDef.m_keyframeFlag != 0) ? 1 : 0);
+	}
+
+	if (asset.m_encodingFlags & mtdisasm::DOMToonAsset::kEncodingFlag_HasRanges)
+	{
+		f.Printf("Range Start End Name\n");
+		for (size_t i = 0; i < asset.m_frameRangesPart.m_frameRanges.size(); i++)
+		{
+			const mtdisasm::DOMToonAsset::FrameRangeDef& frameRange = asset.m_frameRangesPart.m_frameRanges[i];
+			f.Printf("%u %u %u ", static_cast<unsigned int>(i), frameRange.m_startFrame, frameRange.m_endFrame);
+			if (frameRange.m_name.size() > 1)
+				f.Write(&frameRange.m_name[0], frameRange.m_name.size() - 1);
+			f.Put('\n');
+		}
+	}
+
+	f.Flush();
+	fclose(tableF);
+	return true;
+}
+
+bool ExtractMToonAsset(const mtdisasm::DOMToonAsset& asset, const mtdisasm::IOStream& stream, const mtdisasm::SerializationProperties& sp, const std::string& basePath, const AssetExtractionOptions& options)
+{
+	bool isMToonRLE = (asset.m_codecID == 0x2e524c45);
+	bool isUncompressed = (asset.m_codecID == 0);
+
+	if (!isMToonRLE && !isUncompressed)
+	{
+		char codecID[5] = { static_cast<char>((asset.m_codecID >> 24) & 0xff), static_cast<char>((asset.m_codecID >> 16) & 0xff), static_cast<char>((asset.m_codecID >> 8) & 0xff), static_cast<char>(asset.m_codecID & 0xff), 0 };
+		fprintf(stderr, "Not yet supported mToon compression type '%s' in asset %i\n", codecID, static_cast<int>(asset.m_assetID));
+		return false;
+	}
+
+	std::vector<uint8_t> frameData;
+	frameData.resize(asset.m_sizeOfFrameData);
+
+	if (asset.m_sizeOfFrameData == 0)
+		return true;
+
+	if (!stream.ReadAt(asset.m_frameDataPosition, &frameData[0], asset.m_sizeOfFrameData))
+	{
+		fprintf(stderr, "mToon asset %u: Failed to read frame data\n", asset.m_assetID);
+		return false;
+	}
+
+	mtdisasm::MToonRLEDecoder rleDecoder;
+	rleDecoder.SetPalette(g_macStandardPaletteRGBA);
+
+	const mtdisasm::PixelRowConverters& converters = *mtdisasm::GetPixelRowConverters(mtdisasm::PixelConvertISA::kAuto);
+
+	// Composited frames are drawn on a canvas covering the mToon's rect, and each frame is
+	// written as the part of the canvas that changed
+	std::unique_ptr<mtdisasm::MToonCompositor> compositor;
+	FILE* frameTableF = nullptr;
+	std::unique_ptr<mtdisasm::TextWriter> frameTable;
+
+	const bool isTemporallyCompressed = ((asset.m_encodingFlags & mtdisasm::DOMToonAsset::kEncodingFlag_TemporalCompression) != 0);
+	if (options.m_mtoonFrameMode == MToonFrameMode::kComposite && isMToonRLE && isTemporallyCompressed)
+	{
+		if (asset.m_rect.m_right <= asset.m_rect.m_left || asset.m_rect.m_bottom <= asset.m_rect.m_top)
+			fprintf(stderr, "mToon asset %u has an empty rect, so its frames can't be composited\n", asset.m_assetID);
+		else
+		{
+			std::string frameTablePath = basePath + "/asset_" + std::to_string(asset.m_assetID) + "_frames.txt";
+			frameTableF = fopen(frameTablePath.c_str(), "wb");
+			if (!frameTableF)
+			{
+				fprintf(stderr, "Failed to open frame table output path '%s'\n", frameTablePath.c_str());
+				return false;
+			}
+
+			compositor.reset(new mtdisasm::MToonCompositor());
+			compositor->Reset(asset.m_rect.m_right - asset.m_rect.m_left, asset.m_rect.m_bottom - asset.m_rect.m_top);
+
+			frameTable.reset(new mtdisasm::TextWriter(frameTableF));
+			frameTable->Printf("Canvas %u %u\n", static_cast<unsigned int>(compositor->GetWidth()), static_cast<unsigned int>(compositor->GetHeight()));
+			frameTable->Printf("Frame Left Top Right Bottom\n");
+		}
+	}
+
+	// Atlas frames are decoded straight into their slots.  Slots are packed in frame order,
+	// so each page is written as soon as the frames on it are done.
+	const bool isAtlas = (options.m_mtoonFrameMode == MToonFrameMode::kAtlas);
+	std::vector<mtdisasm::AtlasSlot> atlasSlots;
+	std::vector<mtdisasm::AtlasPage> atlasPages;
+	std::vector<bool> isFrameDecoded;
+	std::vector<uint8_t> atlasPixels;
+	size_t atlasPageIndex = 0;
+
+	bool succeeded = true;
+
+	if (isAtlas)
+	{
+		GetMToonAtlasSlots(asset, frameData, isMToonRLE, atlasSlots);
+		mtdisasm::PackAtlas(atlasSlots, kMaxAtlasPageSize, atlasPages);
+		isFrameDecoded.resize(asset.m_numFrames, false);
+
+		if (!atlasPages.empty())
+			atlasPixels.assign(atlasPages[0].m_width * atlasPages[0].m_height * 4, 0);
+	}
+
+	for (size_t i = 0; i < asset.m_numFrames; i++)
+	{
+		const mtdisasm::DOMToonAsset::FrameDef& frameDef = asset.m_frames[i];
+
+		size_t numRows = frameDef.m_rect1.m_bottom - frameDef.m_rect1.m_top;
+		size_t numCols = frameDef.m_rect1.m_right - frameDef.m_rect1.m_left;
+		size_t dataOffset = frameDef.m_dataOffset;
+		bool isKeyframe = (frameDef.m_keyframeFlag != 0);
+
+		bool isBottomUp = (sp.m_systemType == mtdisasm::SystemType::kWindows);
+
+		mtdisasm::MToonRLEFrameHeader rleHeader;
+		const uint8_t* rleData = nullptr;
+		size_t rleSize = 0;
+
+		if (isMToonRLE)
+		{
+			if (!FindMToonRLEFrame(frameDef, frameData, rleHeader, rleData, rleSize))
+			{
+				fprintf(stderr, "Frame %zu of mToon asset %u is out of bounds\n", i, asset.m_assetID);
+				succeeded = false;
+				break;
+			}
+
+			if (isKeyframe && rleHeader.m_signature == mtdisasm::MToonRLEDecoder::kKeyframeSignature)
+			{
+				fprintf(stderr, "Keyframe header in non-keyframe mToon frame for some reason?\n");
+			}
+
+			if (!IsSupportedMToonRLEFormat(asset, rleHeader))
+				continue;
+
+			if (rleHeader.m_format == mtdisasm::MToonRLEDecoder::k8BitFormat && rleHeader.m_size < mtdisasm::MToonRLEDecoder::kFrameHeaderSize)
+			{
+				fprintf(stderr, "RLE data size for asset %u frame %zu is too small (was %u but needs to be >20)\n", asset.m_assetID, i, rleHeader.m_size);
+				succeeded = false;
+				break;
+			}
+
+			numCols = rleHeader.m_width;
+			numRows = rleHeader.m_height;
+		}
+		else if (isUncompressed)
+		{
+			size_t bytesPerRow = frameDef.m_decompressedBytesPerRow;
+			size_t bytesPerPixel = asset.m_bitsPerPixel / 8;
+
+			if (asset.m_bitsPerPixel != 8 && asset.m_bitsPerPixel != 16 && asset.m_bitsPerPixel != 32)
+			{
+				fprintf(stderr, "Unsupported uncompressed bit count\n");
+				succeeded = false;
+				break;
+			}
+
+			if (numRows > 0 && (dataOffset > frameData.size() || (numRows - 1) * bytesPerRow + numCols * bytesPerPixel > frameData.size() - dataOffset))
+			{
+				fprintf(stderr, "Frame %zu of mToon asset %u is out of bounds\n", i, asset.m_assetID);
+				succeeded = false;
+				break;
+			}
+		}
+
+		// Where the frame is decoded to
+		std::vector<uint8_t> imageData;
+		uint8_t* pixels = nullptr;
+		size_t pixelsBytesPerRow = numCols * 4;
+
+		if (isAtlas)
+		{
+			const mtdisasm::AtlasSlot& slot = atlasSlots[i];
+			if (slot.m_width != numCols || slot.m_height != numRows)
+				continue;
+
+			if (slot.m_page != atlasPageIndex)
+			{
+				if (!WriteMToonAtlasPage(asset, atlasPageIndex, atlasPages[atlasPageIndex], atlasPixels, basePath, options))
+					succeeded = false;
+
+				atlasPageIndex = slot.m_page;
+				atlasPixels.assign(atlasPages[atlasPageIndex].m_width * atlasPages[atlasPageIndex].m_height * 4, 0);
+			}
+
+			pixelsBytesPerRow = atlasPages[atlasPageIndex].m_width * 4;
+			pixels = atlasPixels.data() + slot.m_top * pixelsBytesPerRow + slot.m_left * 4;
+			isFrameDecoded[i] = true;
+		}
+		else if (!compositor)
+		{
+			imageData.resize(numCols * numRows * 4);
+			pixels = imageData.data();
+		}
+
+		if (isMToonRLE)
+		{
+			const bool is8Bit = (rleHeader.m_format == mtdisasm::MToonRLEDecoder::k8BitFormat);
+
+			// 16-bit frames are top-down on both platforms
+			const bool isFrameBottomUp = (is8Bit && isBottomUp);
+
+			mtdisasm::MToonRLESurface surface;
+			if (compositor)
+				surface = compositor->BeginFrame(numCols, numRows, isFrameBottomUp);
+			else
+				surface = mtdisasm::MakeMToonRLESurface(pixels, numCols, numRows, pixelsBytesPerRow, mtdisasm::MToonRLEPixelFormat::kRGBA32, isFrameBottomUp);
+
+			bool decoded = false;
+			if (is8Bit)
+				decoded = rleDecoder.DecodeFrame8(rleData, rleSize, isKeyframe, surface);
+			else
+			{
+				// In this version rleSize appears to NOT include the header
+				decoded = rleDecoder.DecodeFrame16(rleData, rleSize, sp.m_systemType == mtdisasm::SystemType::kMac, surface);
+			}
+
+			if (!decoded)
+			{
+				fprintf(stderr, "RLE data for asset %u frame %zu is truncated\n", asset.m_assetID, i);
+				succeeded = false;
+			}
+		}
+		else if (isUncompressed)
+		{
+			size_t bytesPerRow = frameDef.m_decompressedBytesPerRow;
+
+			for (size_t row = 0; row < numRows; row++)
+			{
+				size_t rowOffset = dataOffset + row * bytesPerRow;
+				if (isBottomUp)
+					rowOffset = dataOffset + (numRows - 1 - row) * bytesPerRow;
+
+				const uint8_t* src = frameData.data() + rowOffset;
+				uint8_t* dest = pixels + row * pixelsBytesPerRow;
+
+				if (asset.m_bitsPerPixel == 8)
+					converters.m_convertIndexed8ToRGBA32(src, dest, numCols, g_macStandardPaletteRGBA);
+				else if (asset.m_bitsPerPixel == 16)
+					converters.m_convertRGB555LEToRGBA32(src, dest, numCols);
+				else
+					converters.m_convertRGBX32ToRGBA32(src, dest, numCols);
+			}
+		}
+
+		if (isAtlas)
+			continue;
+
+		std::string outPath = basePath + "/asset_" + std::to_string(asset.m_assetID) + "_frame_" + std::to_string(i) + mtdisasm::GetImageFileExtension(options.m_imageEncoderOptions.m_backend, 4);
+
+		if (compositor)
+		{
+			const ptrdiff_t frameLeft = frameDef.m_rect1.m_left - asset.m_rect.m_left;
+			const ptrdiff_t frameTop = frameDef.m_rect1.m_top - asset.m_rect.m_top;
+			const mtdisasm::MToonCanvasRect dirtyRect = compositor->EndFrame(frameLeft, frameTop, isKeyframe);
+
+			frameTable->Printf("%u %u %u %u %u\n", static_cast<unsigned int>(i), static_cast<unsigned int>(dirtyRect.m_left), static_cast<unsigned int>(dirtyRect.m_top), static_cast<unsigned int>(dirtyRect.m_right), static_cast<unsigned int>(dirtyRect.m_bottom));
+
+			if (!dirtyRect.IsEmpty())
+			{
+				const size_t canvasPitch = compositor->GetWidth() * 4;
+				const uint8_t* dirtyPixels = compositor->GetPixels() + dirtyRect.m_top * canvasPitch + dirtyRect.m_left * 4;
+				if (!mtdisasm::WriteImageFile(options.m_imageEncoderOptions, outPath, dirtyPixels, dirtyRect.m_right - dirtyRect.m_left, dirtyRect.m_bottom - dirtyRect.m_top, 4, canvasPitch))
+					succeeded = false;
+			}
+		}
+		else if (!mtdisasm::WriteImageFile(options.m_imageEncoderOptions, outPath, pixels, numCols, numRows, 4, pixelsBytesPerRow))
+			succeeded = false;
+	}
+
+	if (frameTable && !frameTable->Flush())
+		succeeded = false;
+
+	frameTable.reset();
+
+	if (frameTableF && fclose(frameTableF) != 0)
+		succeeded = false;
+
+	if (isAtlas && !atlasPages.empty())
+	{
+		if (!WriteMToonAtlasPage(asset, atlasPageIndex, atlasPages[atlasPageIndex], atlasPixels, basePath, options))
+			succeeded = false;
+		if (!WriteMToonAtlasTable(asset, atlasPages, atlasSlots, isFrameDecoded, basePath))
+			succeeded = false;
+	}
+
+	return succeeded;
+}
+
+
+// Objects whose assets are extracted to their own files, named by their asset IDs
+template<class T>
+struct ObjectAssetExtractor
+{
+	static const bool kIsExtractable = false;
+
+	static bool GetAssetID(const mtdisasm::DataObject& dataObject, uint32_t& outAssetID);
+	static uint32_t GetPayloadPosition(const mtdisasm::DataObject& dataObject);
+	static uint32_t GetPayloadSize(const mtdisasm::DataObject& dataObject);
+	static bool Extract(const mtdisasm::DataObject& dataObject, const mtdisasm::IOStream& stream, const mtdisasm::SerializationProperties& sp, const std::string& basePath, const AssetExtractionOptions& options);
+};
+
+template<class T>
+bool ObjectAssetExtractor<T>::GetAssetID(const mtdisasm::DataObject& dataObject, uint32_t& outAssetID)
+{
+	return false;
+}
+
+template<class T>
+uint32_t ObjectAssetExtractor<T>::GetPayloadPosition(const mtdisasm::DataObject& dataObject)
+{
+	return 0;
+}
+
+template<class T>
+uint32_t ObjectAssetExtractor<T>::GetPayloadSize(const mtdisasm::DataObject& dataObject)
+{
+	return 0;
+}
+
+template<class T>
+bool ObjectAssetExtractor<T>::Extract(const mtdisasm::DataObject& dataObject, const mtdisasm::IOStream& stream, const mtdisasm::SerializationProperties& sp, const std::string& basePath, const AssetExtractionOptions& options)
+{
+	return true;
+}
+
+template<class T, bool (*TExtractFunc)(const T&, const mtdisasm::IOStream&, const mtdisasm::SerializationProperties&, const std::string&, const AssetExtractionOptions&), uint32_t T::*TPayloadPosition, uint32_t T::*TPayloadSize>
+struct ExtractableAssetExtractor
+{
+	static const bool kIsExtractable = true;
+
+	static bool GetAssetID(const mtdisasm::DataObject& dataObject, uint32_t& outAssetID)
+	{
+		outAssetID = static_cast<const T&>(dataObject).m_assetID;
+		return true;
+	}
+
+	static uint32_t GetPayloadPosition(const mtdisasm::DataObject& dataObject)
+	{
+		return static_cast<const T&>(dataObject).*TPayloadPosition;
+	}
+
+	static uint32_t GetPayloadSize(const mtdisasm::DataObject& dataObject)
+	{
+		return static_cast<const T&>(dataObject).*TPayloadSize;
+	}
+
+	static bool Extract(const mtdisasm::DataObject& dataObject, const mtdisasm::IOStream& stream, const mtdisasm::SerializationProperties& sp, const std::string& basePath, const AssetExtractionOptions& options)
+	{
+		return TExtractFunc(static_cast<const T&>(dataObject), stream, sp, basePath, options);
+	}
+};
+
+template<>
+struct ObjectAssetExtractor<mtdisasm::DOImageAsset> : public ExtractableAssetExtractor<mtdisasm::DOImageAsset, ExtractImageAsset, &mtdisasm::DOImageAsset::m_filePosition, &mtdisasm::DOImageAsset::m_size>
+{
+};
+
+template<>
+struct ObjectAssetExtractor<mtdisasm::DOMovieAsset> : public ExtractableAssetExtractor<mtdisasm::DOMovieAsset, ExtractMovieAsset, &mtdisasm::DOMovieAsset::m_movieDataPos, &mtdisasm::DOMovieAsset::m_movieDataSize>
+{
+};
+
+template<>
+struct ObjectAssetExtractor<mtdisasm::DOMToonAsset> : public ExtractableAssetExtractor<mtdisasm::DOMToonAsset, ExtractMToonAsset, &mtdisasm::DOMToonAsset::m_frameDataPosition, &mtdisasm::DOMToonAsset::m_sizeOfFrameData>
+{
+};
+
+template<>
+struct ObjectAssetExtractor<mtdisasm::DOAudioAsset> : public ExtractableAssetExtractor<mtdisasm::DOAudioAsset, ExtractAudioAsset, &mtdisasm::DOAudioAsset::m_filePosition, &mtdisasm::DOAudioAsset::m_size>
+{
+};
+
+// Per-type handlers, indexed by the registry's type index
+struct ObjectTypeHandlers
+{
+	void (*m_print)(const mtdisasm::DataObject& dataObject, mtdisasm::TextWriter& f);
+	void (*m_serialize)(const mtdisasm::DataObject& dataObject, mtdisasm::StructuredWriter& w);
+	bool (*m_getAssetID)(const mtdisasm::DataObject& dataObject, uint32_t& outAssetID);
+	uint32_t (*m_getPayloadPosition)(const mtdisasm::DataObject& dataObject);
+	uint32_t (*m_getPayloadSize)(const mtdisasm::DataObject& dataObject);
+	bool (*m_extractAsset)(const mtdisasm::DataObject& dataObject, const mtdisasm::IOStream& stream, const mtdisasm::SerializationProperties& sp, const std::string& basePath, const AssetExtractionOptions& options);
+	bool m_isExtractableAsset;
+};
+
+const ObjectTypeHandlers g_objectTypeHandlers[] =
+{
+#define OBJECT_TYPE_HANDLERS(typeCode, className, constructorArgs, name) \
+	{ PrintObjectOfType<mtdisasm::className>, SerializeObjectOfType<mtdisasm::className>, ObjectAssetExtractor<mtdisasm::className>::GetAssetID, ObjectAssetExtractor<mtdisasm::className>::GetPayloadPosition, ObjectAssetExtractor<mtdisasm::className>::GetPayloadSize, ObjectAssetExtractor<mtdisasm::className>::Extract, ObjectAssetExtractor<mtdisasm::className>::kIsExtractable },
+	MTDISASM_FOR_EACH_OBJECT_TYPE(OBJECT_TYPE_HANDLERS)
+#undef OBJECT_TYPE_HANDLERS
+};
+
+static_assert(sizeof(g_objectTypeHandlers) / sizeof(g_objectTypeHandlers[0]) == mtdisasm::kNumObjectTypes, "Object type handler table size mismatch");
+
+void ExtractMIDIModifier(const mtdisasm::DOPlugInModifier& plugin, const std::string& basePath, int segmentNum, uint32_t objectEndGlobalPos)
+{
+	if (!strcmp(plugin.m_plugin, "MIDIModf"))
+	{
+		const mtdisasm::POMidiModifier* midiModifier = static_cast<const mtdisasm::POMidiModifier*>(plugin.m_plugInData);
+		if (midiModifier->m_data.size() > 0)
+		{
+			char midiName[64];
+			sprintf(midiName, "/midi-%i-%x.mid", segmentNum, static_cast<int>(objectEndGlobalPos));
+
+			std::string outPath = basePath + midiName;
+			FILE* fOut = fopen(outPath.c_str(), "wb");
+			if (fOut)
+			{
+				fwrite(&midiModifier->m_data[0], 1, midiModifier->m_data.size(), fOut);
+				fclose(fOut);
+			}
+		}
+	}
+}
+
+// Collects the assets defined in the streams and extracts them once every stream has been
+// walked.  Deferring them lets payloads be read in the order they're stored in each segment,
+// and lets the first definition of each asset in catalog order win regardless of the order
+// the streams were walked in.  With an async reader, payloads that aren't already in memory
+// are read ahead of the decoders, which then decode from the buffers.
+//
+// Only the location of each definition is kept while the streams are walked, so that each
+// stream's objects can be released with it.  The winning definitions are loaded again from
+// their segments when they're extracted, on the pool's workers if there is a pool.
+class AssetExtractor
+{
+public:
+	AssetExtractor(const mtdisasm::SerializationProperties& sp, const std::string& basePath, const AssetExtractionOptions& options);
+	AssetExtractor(const mtdisasm::SerializationProperties& sp, const std::string& basePath, const AssetExtractionOptions& options, mtdisasm::ThreadPool& pool);
+	~AssetExtractor();
+
+	// Takes ownership of the object, which was loaded from the segment range starting at
+	// objectGlobalPos and ending at objectEndGlobalPos
+	void ExtractAsset(mtdisasm::DataObject* dataObject, size_t typeIndex, const mtdisasm::IOStream& segmentStream, int segmentNum, int streamNum, uint32_t objectGlobalPos, uint32_t objectEndGlobalPos);
+
+	void SetAsyncReader(mtdisasm::AsyncReader* asyncReader);
+
+	// Assets whose existing outputs are kept, by the first stream that defines them.
+	// Definitions of them in that stream or later streams are skipped.
+	void SetRetainedAssets(const std::unordered_map<uint32_t, int>* retainedAssets);
+
+	// Lists the definitions collected so far by stream, in the order they were found.
+	// Payload hashes are left at zero.
+	void ListPendingAssets(size_t numStreams, std::vector<std::vector<mtdisasm::ExtractionManifestAsset>>& outAssetsByStream);
+
+	// Extracts the collected assets, on the pool if there is one
+	void Flush();
+
+	// Assets that failed to extract.  Only complete once the extractions have finished.
+	void GetFailedAssets(std::unordered_set<uint32_t>& outAssetIDs);
+
+private:
+	struct PendingAsset
+	{
+		uint32_t m_assetID;
+		int m_streamNum;
+		uint64_t m_sequenceNumber;	// Order the asset was found within its stream
+		int m_segmentNum;
+		uint32_t m_payloadPosition;
+		uint32_t m_payloadSize;
+
+		size_t m_typeIndex;
+		uint32_t m_objectPosition;	// Segment position of the defining object
+		uint32_t m_objectSize;
+		const mtdisasm::IOStream* m_segmentStream;
+	};
+
+	struct PayloadBuffer
+	{
+		std::vector<uint8_t> m_data;
+		uint32_t m_pos;
+	};
+
+	bool IsRetained(const PendingAsset& pendingAsset) const;
+	void ExtractWithAsyncReads(std::vector<PendingAsset>& claimedAssets);
+	void DispatchExtraction(const PendingAsset& pendingAsset, const std::shared_ptr<PayloadBuffer>& payload);
+	void ExtractPendingAsset(const PendingAsset& pendingAsset, const std::shared_ptr<PayloadBuffer>& payload);
+	mtdisasm::DataObject* LoadPendingObject(const PendingAsset& pendingAsset) const;
+	bool ReservePayloadBytes(size_t size, bool wait);
+	void ReleasePayloadBytes(size_t size);
+
+	// Payloads read ahead but not yet decoded are limited to this many bytes, except that
+	// one payload can always be read
+	static const size_t kMaxOutstandingPayloadBytes = 64 * 1024 * 1024;
+
+	const mtdisasm::SerializationProperties& m_sp;
+	std::string m_basePath;
+	AssetExtractionOptions m_options;
+
+	mtdisasm::ThreadPool* m_pool;
+	mtdisasm::AsyncReader* m_asyncReader;
+	const std::unordered_map<uint32_t, int>* m_retainedAssets;
+
+	std::mutex m_pendingMutex;
+	std::vector<PendingAsset> m_pendingAssets;
+	uint64_t m_nextSequenceNumber;
+
+	std::mutex m_payloadBytesMutex;
+	std::condition_variable m_payloadBytesCondition;
+	size_t m_outstandingPayloadBytes;
+
+	std::mutex m_failedMutex;
+	std::unordered_set<uint32_t> m_failedAssetIDs;
+};
+
+AssetExtractor::AssetExtractor(const mtdisasm::SerializationProperties& sp, const std::string& basePath, const AssetExtractionOptions& options)
+	: m_sp(sp)
+	, m_basePath(basePath)
+	, m_options(options)
+	, m_pool(nullptr)
+	, m_asyncReader(nullptr)
+	, m_retainedAssets(nullptr)
+	, m_nextSequenceNumber(0)
+	, m_outstandingPayloadBytes(0)
+{
+}
+
+AssetExtractor::AssetExtractor(const mtdisasm::SerializationProperties& sp, const std::string& basePath, const AssetExtractionOptions& options, mtdisasm::ThreadPool& pool)
+	: m_sp(sp)
+	, m_basePath(basePath)
+	, m_options(options)
+	, m_pool(&pool)
+	, m_asyncReader(nullptr)
+	, m_retainedAssets(nullptr)
+	, m_nextSequenceNumber(0)
+	, m_outstandingPayloadBytes(0)
+{
+}
+
+AssetExtractor::~AssetExtractor()
+{
+}
+
+void AssetExtractor::ExtractAsset(mtdisasm::DataObject* dataObject, size_t typeIndex, const mtdisasm::IOStream& segmentStream, int segmentNum, int streamNum, uint32_t objectGlobalPos, uint32_t objectEndGlobalPos)
+{
+	const ObjectTypeHandlers& handlers = g_objectTypeHandlers[typeIndex];
+
+	uint32_t assetID = 0;
+	if (handlers.m_getAssetID(*dataObject, assetID))
+	{
+		PendingAsset pendingAsset;
+		pendingAsset.m_assetID = assetID;
+		pendingAsset.m_streamNum = streamNum;
+		pendingAsset.m_segmentNum = segmentNum;
+		pendingAsset.m_payloadPosition = handlers.m_getPayloadPosition(*dataObject);
+		pendingAsset.m_payloadSize = handlers.m_getPayloadSize(*dataObject);
+		pendingAsset.m_typeIndex = typeIndex;
+		pendingAsset.m_objectPosition = objectGlobalPos;
+		pendingAsset.m_objectSize = objectEndGlobalPos - objectGlobalPos;
+		pendingAsset.m_segmentStream = &segmentStream;
+
+		dataObject->Delete();
+
+		std::unique_lock<std::mutex> lock(m_pendingMutex);
+		pendingAsset.m_sequenceNumber = m_nextSequenceNumber++;
+		m_pendingAssets.push_back(pendingAsset);
+		return;
+	}
+
+	if (dataObject->GetType() == mtdisasm::DataObjectType::kPlugInModifier)
+		ExtractMIDIModifier(static_cast<const mtdisasm::DOPlugInModifier&>(*dataObject), m_basePath, segmentNum, objectEndGlobalPos);
+
+	dataObject->Delete();
+}
+
+void AssetExtractor::SetAsyncReader(mtdisasm::AsyncReader* asyncReader)
+{
+	m_asyncReader = asyncReader;
+}
+
+void AssetExtractor::SetRetainedAssets(const std::unordered_map<uint32_t, int>* retainedAssets)
+{
+	m_retainedAssets = retainedAssets;
+}
+
+void AssetExtractor::ListPendingAssets(size_t numStreams, std::vector<std::vector<mtdisasm::ExtractionManifestAsset>>& outAssetsByStream)
+{
+	std::vector<const PendingAsset*> pendingAssets;
+
+	std::unique_lock<std::mutex> lock(m_pendingMutex);
+	for (const PendingAsset& pendingAsset : m_pendingAssets)
+		pendingAssets.push_back(&pendingAsset);
+
+	std::sort(pendingAssets.begin(), pendingAssets.end(), [](const PendingAsset* a, const PendingAsset* b)
+	{
+		if (a->m_streamNum != b->m_streamNum)
+			return a->m_streamNum < b->m_streamNum;
+		return a->m_sequenceNumber < b->m_sequenceNumber;
+	});
+
+	outAssetsByStream.clear();
+	outAssetsByStream.resize(numStreams);
+	for (const PendingAsset* pendingAsset : pendingAssets)
+	{
+		mtdisasm::ExtractionManifestAsset asset;
+		asset.m_assetID = pendingAsset->m_assetID;
+		asset.m_payloadPosition = pendingAsset->m_payloadPosition;
+		asset.m_payloadSize = pendingAsset->m_payloadSize;
+		asset.m_numOutputFiles = 0;
+		asset.m_payloadHash = 0;
+
+		outAssetsByStream[static_cast<size_t>(pendingAsset->m_streamNum)].push_back(asset);
+	}
+}
+
+void AssetExtractor::Flush()
+{
+	std::vector<PendingAsset> pendingAssets;
+	{
+		std::unique_lock<std::mutex> lock(m_pendingMutex);
+		pendingAssets.swap(m_pendingAssets);
+	}
+
+	// Keep only the first definition of each asset in catalog order
+	std::sort(pendingAssets.begin(), pendingAssets.end(), [](const PendingAsset& a, const PendingAsset& b)
+	{
+		if (a.m_assetID != b.m_assetID)
+			return a.m_assetID < b.m_assetID;
+		if (a.m_streamNum != b.m_streamNum)
+			return a.m_streamNum < b.m_streamNum;
+		return a.m_sequenceNumber < b.m_sequenceNumber;
+	});
+
+	std::vector<PendingAsset> claimedAssets;
+	for (size_t i = 0; i < pendingAssets.size(); i++)
+	{
+		if (i > 0 && pendingAssets[i].m_assetID == pendingAssets[i - 1].m_assetID)
+			continue;
+
+		if (!IsRetained(pendingAssets[i]))
+			claimedAssets.push_back(pendingAssets[i]);
+	}
+
+	std::sort(claimedAssets.begin(), claimedAssets.end(), [](const PendingAsset& a, const PendingAsset& b)
+	{
+		if (a.m_segmentNum != b.m_segmentNum)
+			return a.m_segmentNum < b.m_segmentNum;
+		return a.m_payloadPosition < b.m_payloadPosition;
+	});
+
+	if (m_asyncReader)
+		ExtractWithAsyncReads(claimedAssets);
+	else
+	{
+		for (const PendingAsset& pendingAsset : claimedAssets)
+			DispatchExtraction(pendingAsset, nullptr);
+	}
+}
+
+void AssetExtractor::GetFailedAssets(std::unordered_set<uint32_t>& outAssetIDs)
+{
+	std::unique_lock<std::mutex> lock(m_failedMutex);
+	outAssetIDs = m_failedAssetIDs;
+}
+
+bool AssetExtractor::IsRetained(const PendingAsset& pendingAsset) const
+{
+	if (!m_retainedAssets)
+		return false;
+
+	std::unordered_map<uint32_t, int>::const_iterator it = m_retainedAssets->find(pendingAsset.m_assetID);
+	return it != m_retainedAssets->end() && it->second <= pendingAsset.m_streamNum;
+}
+
+// Keeps the reader full while decoding finished reads.  Completions are handled on this
+// thread, so without a pool, decoding overlaps with the reads still in flight.
+void AssetExtractor::ExtractWithAsyncReads(std::vector<PendingAsset>& claimedAssets)
+{
+	std::vector<std::shared_ptr<PayloadBuffer>> payloads(claimedAssets.size());
+	size_t nextAssetIndex = 0;
+
+	for (;;)
+	{
+		while (nextAssetIndex < claimedAssets.size() && m_asyncReader->NumInFlight() < m_asyncReader->MaxInFlight())
+		{
+			const PendingAsset& pendingAsset = claimedAssets[nextAssetIndex];
+
+			// Payloads in mapped segments are decoded in place
+			const void* spanData = nullptr;
+			size_t spanSize = 0;
+			uint32_t spanGlobalBase = 0;
+			if (pendingAsset.m_segmentStream->GetContiguousSpan(spanData, spanSize, spanGlobalBase))
+			{
+				DispatchExtraction(pendingAsset, nullptr);
+				nextAssetIndex++;
+				continue;
+			}
+
+			// Only waits for decoders to free buffers if there are no reads to wait for instead
+			if (!ReservePayloadBytes(pendingAsset.m_payloadSize, m_asyncReader->NumInFlight() == 0))
+				break;
+
+			std::shared_ptr<PayloadBuffer> payload = std::make_shared<PayloadBuffer>();
+			payload->m_data.resize(pendingAsset.m_payloadSize);
+			payload->m_pos = pendingAsset.m_payloadPosition;
+
+			void* dest = payload->m_data.empty() ? nullptr : &payload->m_data[0];
+			if (!m_asyncReader->Submit(*pendingAsset.m_segmentStream, payload->m_pos, dest, payload->m_data.size(), nextAssetIndex))
+			{
+				ReleasePayloadBytes(pendingAsset.m_payloadSize);
+				break;
+			}
+
+			payloads[nextAssetIndex] = payload;
+			nextAssetIndex++;
+		}
+
+		uintptr_t tag = 0;
+		bool succeeded = false;
+		if (!m_asyncReader->WaitForCompletion(tag, succeeded))
+		{
+			if (m_asyncReader->NumInFlight() > 0)
+			{
+				fprintf(stderr, "Asynchronous payload reads failed, reading the remaining payloads synchronously\n");
+
+				// The buffers of unfinished reads can only be released once nothing can land in them
+				m_asyncReader->CancelAll();
+
+				for (size_t i = 0; i < claimedAssets.size(); i++)
+				{
+					if (i < nextAssetIndex && !payloads[i])
+						continue;
+
+					if (payloads[i])
+					{
+						payloads[i].reset();
+						ReleasePayloadBytes(claimedAssets[i].m_payloadSize);
 					}
+
+					DispatchExtraction(claimedAssets[i], nullptr);
 				}
+				break;
+			}
+
+			if (nextAssetIndex == claimedAssets.size())
+				break;
+			continue;
+		}
+
+		const PendingAsset& pendingAsset = claimedAssets[tag];
+		std::shared_ptr<PayloadBuffer> payload;
+		payload.swap(payloads[tag]);
+
+		// A payload that couldn't be read in full is decoded from the segment, the same
+		// as without read-ahead, so damaged assets come out the same either way
+		if (!succeeded)
+		{
+			payload.reset();
+			ReleasePayloadBytes(pendingAsset.m_payloadSize);
+		}
+
+		DispatchExtraction(pendingAsset, payload);
+	}
+}
+
+// Extracts an asset on the pool if there is one, otherwise on this thread
+void AssetExtractor::DispatchExtraction(const PendingAsset& pendingAsset, const std::shared_ptr<PayloadBuffer>& payload)
+{
+	if (m_pool)
+	{
+		m_pool->Submit([this, pendingAsset, payload](size_t /*workerIndex*/)
+		{
+			ExtractPendingAsset(pendingAsset, payload);
+		});
+	}
+	else
+		ExtractPendingAsset(pendingAsset, payload);
+}
+
+// Decodes an asset from its payload buffer if it has one, otherwise from its segment
+void AssetExtractor::ExtractPendingAsset(const PendingAsset& pendingAsset, const std::shared_ptr<PayloadBuffer>& payload)
+{
+	mtdisasm::ThreadBudget* threadBudget = m_options.m_imageEncoderOptions.m_threadBudget;
+	if (threadBudget)
+		threadBudget->Claim();
+
+	mtdisasm::ObjectArena arena;
+	mtdisasm::ObjectArena::Scope arenaScope(arena);
+
+	bool succeeded = false;
+
+	mtdisasm::DataObject* dataObject = LoadPendingObject(pendingAsset);
+	if (dataObject)
+	{
+		const ObjectTypeHandlers& handlers = g_objectTypeHandlers[pendingAsset.m_typeIndex];
+
+		if (payload)
+		{
+			const void* payloadData = payload->m_data.empty() ? nullptr : &payload->m_data[0];
+			mtdisasm::PayloadIOStream payloadStream(payloadData, payload->m_data.size(), payload->m_pos);
+			succeeded = handlers.m_extractAsset(*dataObject, payloadStream, m_sp, m_basePath, m_options);
+		}
+		else
+			succeeded = handlers.m_extractAsset(*dataObject, *pendingAsset.m_segmentStream, m_sp, m_basePath, m_options);
+
+		dataObject->Delete();
+	}
+	else
+		fprintf(stderr, "Asset %u: Couldn't load its definition again from segment %i position %x\n", static_cast<unsigned int>(pendingAsset.m_assetID), pendingAsset.m_segmentNum, static_cast<int>(pendingAsset.m_objectPosition));
+
+	if (payload)
+		ReleasePayloadBytes(payload->m_data.size());
+
+	if (!succeeded)
+	{
+		std::unique_lock<std::mutex> lock(m_failedMutex);
+		m_failedAssetIDs.insert(pendingAsset.m_assetID);
+	}
+
+	if (threadBudget)
+		threadBudget->Release(1);
+}
+
+template<class TReader>
+mtdisasm::DataObject* LoadObjectOfTypeWithReader(TReader& reader, size_t typeIndex, const mtdisasm::SerializationProperties& sp)
+{
+	const mtdisasm::ObjectTypeInfo& typeInfo = mtdisasm::GetObjectTypeInfo(typeIndex);
+
+	uint32_t typeCode = 0;
+	uint16_t revision = 0;
+	if (!reader.ReadU32(typeCode) || !reader.ReadU16(revision) || typeCode != typeInfo.m_typeCode)
+		return nullptr;
+
+	mtdisasm::DataObject* dataObject = typeInfo.m_create();
+	if (!dataObject->Load(reader, revision, sp))
+	{
+		dataObject->Delete();
+		return nullptr;
+	}
+
+	return dataObject;
+}
+
+// Loads the object that defined an asset into the current arena.  It's read from a copy
+// that keeps its segment positions, since some objects record where their data starts.
+mtdisasm::DataObject* AssetExtractor::LoadPendingObject(const PendingAsset& pendingAsset) const
+{
+	std::vector<uint8_t> objectData(pendingAsset.m_objectSize);
+	if (objectData.empty() || !pendingAsset.m_segmentStream->ReadAt(pendingAsset.m_objectPosition, &objectData[0], objectData.size()))
+		return nullptr;
+
+	mtdisasm::PayloadIOStream objectStream(&objectData[0], objectData.size(), pendingAsset.m_objectPosition);
+
+	if (m_sp.m_isByteSwapped)
+	{
+		mtdisasm::SwappedOrderDataReader reader(objectStream);
+		return LoadObjectOfTypeWithReader(reader, pendingAsset.m_typeIndex, m_sp);
+	}
+	else
+	{
+		mtdisasm::NativeOrderDataReader reader(objectStream);
+		return LoadObjectOfTypeWithReader(reader, pendingAsset.m_typeIndex, m_sp);
+	}
+}
+
+bool AssetExtractor::ReservePayloadBytes(size_t size, bool wait)
+{
+	std::unique_lock<std::mutex> lock(m_payloadBytesMutex);
+
+	for (;;)
+	{
+		if (m_outstandingPayloadBytes == 0 || m_outstandingPayloadBytes + size <= kMaxOutstandingPayloadBytes)
+		{
+			m_outstandingPayloadBytes += size;
+			return true;
+		}
+
+		if (!wait)
+			return false;
+
+		m_payloadBytesCondition.wait(lock);
+	}
+}
+
+void AssetExtractor::ReleasePayloadBytes(size_t size)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_payloadBytesMutex);
+		m_outstandingPayloadBytes -= size;
+	}
+
+	m_payloadBytesCondition.notify_all();
+}
+
+// Reports why a stream walk stopped, if it didn't reach the end of the stream
+template<class TReader>
+void PrintStreamCursorError(const mtdisasm::ObjectStreamCursor<TReader>& cursor, int streamIndex, uint32_t streamPos)
+{
+	const uint32_t pos = cursor.GetPosition();
+
+	switch (cursor.GetStatus())
+	{
+	case mtdisasm::ObjectStreamStatus::kTruncatedHeader:
+		fprintf(stderr, "Stream %i: Couldn't read type at stream position %x (global position %x)\n", streamIndex, static_cast<int>(pos), static_cast<int>(pos + streamPos));
+		break;
+	case mtdisasm::ObjectStreamStatus::kUnknownType:
+		fprintf(stderr, "Stream %i: Unknown object type %x revision %i at position %x (global position %x)\n", streamIndex, static_cast<int>(cursor.GetTypeCode()), static_cast<int>(cursor.GetRevision()), static_cast<int>(pos), static_cast<int>(pos + streamPos));
+		break;
+	case mtdisasm::ObjectStreamStatus::kLoadFailed:
+		fprintf(stderr, "Stream %i: Object type %s revision %i at position %x (global position %x) failed to load\n", streamIndex, cursor.GetTypeInfo().m_name, static_cast<int>(cursor.GetRevision()), static_cast<int>(pos), static_cast<int>(pos + streamPos));
+		break;
+	default:
+		break;
+	}
+}
+
+template<class TReader>
+void ExtractAssetsFromStreamWithReader(TReader& reader, AssetExtractor& extractor, const mtdisasm::IOStream& globalStream, size_t streamSize, int segmentIndex, int streamIndex, uint32_t streamPos, const mtdisasm::SerializationProperties& sp, const mtdisasm::ObjectTypeFilter* typeFilter)
+{
+	mtdisasm::ObjectStreamCursor<TReader> cursor(reader, streamSize, sp);
+	cursor.SetTypeFilter(typeFilter);
+
+	while (cursor.Next())
+	{
+		mtdisasm::DataObject* dataObject = cursor.Load();
+		if (!dataObject)
+			break;
+
+		extractor.ExtractAsset(dataObject, cursor.GetTypeIndex(), globalStream, segmentIndex, streamIndex, streamPos + cursor.GetPosition(), reader.TellGlobal());
+	}
+
+	PrintStreamCursorError(cursor, streamIndex, streamPos);
+}
+
+template<class TReader>
+void DisassembleStreamWithReader(TReader& reader, size_t streamSize, int streamIndex, uint32_t streamPos, const mtdisasm::SerializationProperties& sp, const mtdisasm::ObjectTypeFilter* typeFilter, mtdisasm::TextWriter& f)
+{
+	mtdisasm::ObjectStreamCursor<TReader> cursor(reader, streamSize, sp);
+	cursor.SetTypeFilter(typeFilter);
+
+	while (cursor.Next())
+	{
+		const uint32_t pos = cursor.GetPosition();
+
+		f.Write("Pos=");
+		f.WriteHex(pos, 1);
+		f.Write(" AbsPos=");
+		f.WriteHex(pos + streamPos, 1);
+		f.Write("  ");
+		f.Write(cursor.GetTypeInfo().m_name);
+		f.Write(" (");
+		f.WriteHex(cursor.GetTypeCode(), 1);
+		f.Write(") rev ");
+		f.WriteDec(static_cast<int32_t>(cursor.GetRevision()));
+		f.Write(":\n");
+
+		mtdisasm::DataObject* dataObject = cursor.Load();
+		if (!dataObject)
+		{
+			f.Write("FAILED\n\n");
+			break;
+		}
+
+		g_objectTypeHandlers[cursor.GetTypeIndex()].m_print(*dataObject, f);
+		dataObject->Delete();
+
+		f.Write("\n");
+	}
+
+	PrintStreamCursorError(cursor, streamIndex, streamPos);
+}
+
+// Byte order is resolved once per stream so that every field read in the object loaders
+// is decoded by a reader specialized for it.  Streams that aren't in memory are read through
+// a read-ahead buffer of readAheadSize bytes, since objects are loaded with many small reads.
+// Objects are loaded into an arena that is released in one shot once the stream is done.
+void ExtractAssetsFromStream(AssetExtractor& extractor, const mtdisasm::IOStream& globalStream, mtdisasm::IOStream& stream, size_t streamSize, int segmentIndex, int streamIndex, uint32_t streamPos, const mtdisasm::SerializationProperties& sp, size_t readAheadSize, const mtdisasm::ObjectTypeFilter* typeFilter)
+{
+	mtdisasm::ReadAheadIOStream readAheadStream(stream, streamSize, readAheadSize);
+
+	mtdisasm::ObjectArena arena;
+	mtdisasm::ObjectArena::Scope arenaScope(arena);
+
+	if (sp.m_isByteSwapped)
+	{
+		mtdisasm::SwappedOrderDataReader reader(readAheadStream);
+		ExtractAssetsFromStreamWithReader(reader, extractor, globalStream, streamSize, segmentIndex, streamIndex, streamPos, sp, typeFilter);
+	}
+	else
+	{
+		mtdisasm::NativeOrderDataReader reader(readAheadStream);
+		ExtractAssetsFromStreamWithReader(reader, extractor, globalStream, streamSize, segmentIndex, streamIndex, streamPos, sp, typeFilter);
+	}
+}
+
+void DisassembleStream(mtdisasm::IOStream& stream, size_t streamSize, int streamIndex, uint32_t streamPos, const mtdisasm::SerializationProperties& sp, size_t readAheadSize, const mtdisasm::ObjectTypeFilter* typeFilter, mtdisasm::TextWriter& f)
+{
+	mtdisasm::ReadAheadIOStream readAheadStream(stream, streamSize, readAheadSize);
+
+	mtdisasm::ObjectArena arena;
+	mtdisasm::ObjectArena::Scope arenaScope(arena);
+
+	if (sp.m_isByteSwapped)
+	{
+		mtdisasm::SwappedOrderDataReader reader(readAheadStream);
+		DisassembleStreamWithReader(reader, streamSize, streamIndex, streamPos, sp, typeFilter, f);
+	}
+	else
+	{
+		mtdisasm::NativeOrderDataReader reader(readAheadStream);
+		DisassembleStreamWithReader(reader, streamSize, streamIndex, streamPos, sp, typeFilter, f);
+	}
+}
+
+// Writes one record per object, each holding the object's location, type and loaded fields
+template<class TReader>
+void SerializeStreamWithReader(TReader& reader, size_t streamSize, int streamIndex, uint32_t streamPos, const mtdisasm::SerializationProperties& sp, const mtdisasm::ObjectTypeFilter* typeFilter, mtdisasm::StructuredWriter& w)
+{
+	mtdisasm::ObjectStreamCursor<TReader> cursor(reader, streamSize, sp);
+	cursor.SetTypeFilter(typeFilter);
+
+	while (cursor.Next())
+	{
+		const uint32_t pos = cursor.GetPosition();
+
+		w.BeginRecord();
+		w.WriteString("Record", "object");
+		w.WriteUInt("Stream", static_cast<uint32_t>(streamIndex));
+		w.WriteUInt("Pos", pos);
+		w.WriteUInt("AbsPos", pos + streamPos);
+		w.WriteString("Type", cursor.GetTypeInfo().m_name);
+		w.WriteUInt("TypeCode", cursor.GetTypeCode());
+		w.WriteUInt("Revision", cursor.GetRevision());
+
+		mtdisasm::DataObject* dataObject = cursor.Load();
+		w.WriteBool("Loaded", dataObject != nullptr);
+
+		if (!dataObject)
+		{
+			w.EndRecord();
+			break;
+		}
+
+		w.BeginObject("Fields");
+		g_objectTypeHandlers[cursor.GetTypeIndex()].m_serialize(*dataObject, w);
+		w.EndObject();
+		w.EndRecord();
+
+		dataObject->Delete();
+	}
+
+	PrintStreamCursorError(cursor, streamIndex, streamPos);
+}
+
+void SerializeStream(mtdisasm::IOStream& stream, size_t streamSize, int streamIndex, uint32_t streamPos, const mtdisasm::SerializationProperties& sp, size_t readAheadSize, const mtdisasm::ObjectTypeFilter* typeFilter, mtdisasm::StructuredWriter& w)
+{
+	mtdisasm::ReadAheadIOStream readAheadStream(stream, streamSize, readAheadSize);
+
+	mtdisasm::ObjectArena arena;
+	mtdisasm::ObjectArena::Scope arenaScope(arena);
+
+	if (sp.m_isByteSwapped)
+	{
+		mtdisasm::SwappedOrderDataReader reader(readAheadStream);
+		SerializeStreamWithReader(reader, streamSize, streamIndex, streamPos, sp, typeFilter, w);
+	}
+	else
+	{
+		mtdisasm::NativeOrderDataReader reader(readAheadStream);
+		SerializeStreamWithReader(reader, streamSize, streamIndex, streamPos, sp, typeFilter, w);
+	}
+}
+
+void PrintCatalogDisassembly(const mtdisasm::Catalog& cat, mtdisasm::TextWriter& f)
+{
+	f.Printf("System desc: %i\n", static_cast<int>(cat.GetSystem()));
+
+	const mtdisasm::CatalogHeader& catHeader = cat.GetCatalogHeader();
+	PrintHex("Platform", catHeader.m_platform, f);
+	PrintHex("Unknown34", catHeader.m_unknown34, f);
+
+	f.Write("Streams:\n");
+
+	size_t numStreams = cat.NumStreams();
+	for (size_t i = 0; i < numStreams; i++)
+	{
+		const mtdisasm::StreamDesc& stream = cat.GetStream(i);
+		f.Printf("    Stream % 4i   Pos: %i  Size: %i  Segment: %i  Type: '%s'\n", static_cast<int>(i + 1), static_cast<int>(stream.m_pos), static_cast<int>(stream.m_size), static_cast<int>(stream.m_segmentNumber), stream.m_streamType);
+	}
+
+	size_t numSegments = cat.NumSegments();
+
+	f.Write("\nSegments:\n");
+	for (size_t i = 0; i < numSegments; i++)
+	{
+		const mtdisasm::SegmentDesc& seg = cat.GetSegment(i);
+		f.Printf("    Path: '%s'  Label: '%s'  SegmentID: %i\n", seg.m_exportedPath.c_str(), seg.m_label.c_str(), seg.m_segmentID);
+	}
+}
+
+void SerializeCatalog(const mtdisasm::Catalog& cat, mtdisasm::StructuredWriter& w)
+{
+	const mtdisasm::CatalogHeader& catHeader = cat.GetCatalogHeader();
+
+	w.BeginRecord();
+	w.WriteString("Record", "catalog");
+	w.WriteUInt("System", static_cast<uint32_t>(cat.GetSystem()));
+	w.WriteUInt("Platform", catHeader.m_platform);
+	w.WriteUInt("Unknown34", catHeader.m_unknown34);
+
+	w.BeginArray("Streams");
+	for (size_t i = 0; i < cat.NumStreams(); i++)
+	{
+		const mtdisasm::StreamDesc& stream = cat.GetStream(i);
+
+		w.BeginObject(nullptr);
+		w.WriteUInt("Stream", static_cast<uint32_t>(i));
+		w.WriteString("Type", stream.m_streamType);
+		w.WriteUInt("Segment", stream.m_segmentNumber);
+		w.WriteUInt("Pos", stream.m_pos);
+		w.WriteUInt("Size", stream.m_size);
+		w.EndObject();
+	}
+	w.EndArray();
+
+	w.BeginArray("Segments");
+	for (size_t i = 0; i < cat.NumSegments(); i++)
+	{
+		const mtdisasm::SegmentDesc& seg = cat.GetSegment(i);
+
+		w.BeginObject(nullptr);
+		w.WriteString("Path", seg.m_exportedPath.c_str(), seg.m_exportedPath.size());
+		w.WriteString("Label", seg.m_label.c_str(), seg.m_label.size());
+		w.WriteUInt("SegmentID", seg.m_segmentID);
+		w.EndObject();
+	}
+	w.EndArray();
+
+	w.EndRecord();
+}
+
+enum class IOBackend
+{
+	kStdio,
+	kMMap,
+	kAuto,		// mmap, except for segments that can't be mapped
+};
+
+#ifdef __linux__
+const IOBackend kDefaultIOBackend = IOBackend::kAuto;
+const char* const kDefaultIOBackendName = "auto";
+#else
+const IOBackend kDefaultIOBackend = IOBackend::kStdio;
+const char* const kDefaultIOBackendName = "stdio";
+#endif
+
+// Returns null if the mmap backend was picked and the segment can't be mapped
+mtdisasm::IOStream* CreateSegmentStream(FILE* f, IOBackend ioBackend, const std::string& path)
+{
+	if (ioBackend == IOBackend::kMMap || ioBackend == IOBackend::kAuto)
+	{
+		mtdisasm::MMapIOStream* stream = new mtdisasm::MMapIOStream(f);
+		if (stream->IsValid())
+			return stream;
+
+		delete stream;
+
+		if (ioBackend == IOBackend::kMMap)
+			return nullptr;
+
+		// Pipes, files over 2GB, and file systems without mmap support are read instead
+		fprintf(stderr, "Warning: Couldn't map %s, reading it with stdio instead\n", path.c_str());
+	}
+
+#ifdef POSIX_FADV_SEQUENTIAL
+	// Streams are mostly read front to back, so ask for more aggressive read-ahead
+	posix_fadvise(fileno(f), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+	return new mtdisasm::CFileIOStream(f);
+}
+
+const size_t kMaxPayloadReadsInFlight = 32;
+
+// Creates a reader for asset payloads if any segment has to be read rather than mapped
+bool CreatePayloadReader(mtdisasm::AsyncReadEngine engine, const std::vector<mtdisasm::IOStream*>& segmentStreams, std::unique_ptr<mtdisasm::AsyncReader>& outReader)
+{
+	bool needsReader = false;
+	for (const mtdisasm::IOStream* segmentStream : segmentStreams)
+	{
+		const void* spanData = nullptr;
+		size_t spanSize = 0;
+		uint32_t spanGlobalBase = 0;
+		if (!segmentStream->GetContiguousSpan(spanData, spanSize, spanGlobalBase))
+			needsReader = true;
+	}
+
+	if (!needsReader)
+		return true;
+
+	outReader.reset(mtdisasm::AsyncReader::Create(engine, kMaxPayloadReadsInFlight));
+	if (!outReader)
+	{
+		fprintf(stderr, "Requested asynchronous read engine isn't available\n");
+		return false;
+	}
+
+	return true;
+}
+
+const size_t kDefaultReadAheadSize = 4 * 1024 * 1024;
+const size_t kMaxReadAheadMiB = 64;
+const size_t kBinCopyBufferSize = 1024 * 1024;
+
+#ifdef __linux__
+// Copies file data in the kernel, trying copy_file_range first and then sendfile.
+// Returns the number of bytes copied, which is less than size if neither is usable.
+size_t KernelCopyFileRange(int inFD, uint32_t pos, size_t size, int outFD)
+{
+	off_t inOffset = static_cast<off_t>(pos);
+	size_t bytesCopied = 0;
+	bool useCopyFileRange = true;
+
+	while (bytesCopied < size)
+	{
+		ssize_t result;
+		if (useCopyFileRange)
+			result = copy_file_range(inFD, &inOffset, outFD, nullptr, size - bytesCopied, 0);
+		else
+			result = sendfile(outFD, inFD, &inOffset, size - bytesCopied);
+
+		if (result < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			if (useCopyFileRange && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP))
+			{
+				useCopyFileRange = false;
+				continue;
+			}
+
+			break;
+		}
+
+		if (result == 0)
+			break;
+
+		bytesCopied += static_cast<size_t>(result);
+	}
+
+	return bytesCopied;
+}
+#endif
+
+// Copies a range of a segment to an output file.  Mapped segments are written straight from
+// memory, otherwise the copy is done in the kernel where possible and falls back to large
+// buffered reads.
+bool CopySegmentRange(const mtdisasm::IOStream& segmentStream, FILE* segmentFile, uint32_t pos, size_t size, FILE* outF)
+{
+	const void* spanData = nullptr;
+	size_t spanSize = 0;
+	uint32_t spanGlobalBase = 0;
+	if (segmentStream.GetContiguousSpan(spanData, spanSize, spanGlobalBase))
+	{
+		if (pos > spanSize || spanSize - pos < size)
+			return false;
+
+		return size == 0 || fwrite(static_cast<const uint8_t*>(spanData) + pos, 1, size, outF) == size;
+	}
+
+	size_t bytesCopied = 0;
+
+#ifdef __linux__
+	if (fflush(outF) == 0)
+		bytesCopied = KernelCopyFileRange(fileno(segmentFile), pos, size, fileno(outF));
+#endif
+
+	if (bytesCopied == size)
+		return true;
+
+	std::vector<uint8_t> copyBuffer;
+	copyBuffer.resize(std::min(size - bytesCopied, kBinCopyBufferSize));
+
+	while (bytesCopied < size)
+	{
+		size_t chunkSize = std::min(size - bytesCopied, copyBuffer.size());
+
+		if (!segmentStream.ReadAt(pos + static_cast<uint32_t>(bytesCopied), &copyBuffer[0], chunkSize) || fwrite(&copyBuffer[0], 1, chunkSize, outF) != chunkSize)
+			return false;
+
+		bytesCopied += chunkSize;
+	}
+
+	return true;
+}
+
+bool GetStreamOutputPath(const std::string& outputDir, const mtdisasm::StreamDesc& streamDesc, size_t streamIndex, std::string& outPath)
+{
+	std::string streamPath = outputDir + "/stream-" + std::to_string(streamIndex) + "-" + std::to_string(streamDesc.m_segmentNumber) + ".";
+
+	if (!strcmp(streamDesc.m_streamType, "assetStream"))
+		streamPath += "asset";
+	else if (!strcmp(streamDesc.m_streamType, "bootStream"))
+		streamPath += "boot";
+	else if (!strcmp(streamDesc.m_streamType, "sceneStream"))
+		streamPath += "scene";
+	else
+	{
+		fprintf(stderr, "Unknown stream type '%s'\n", streamDesc.m_streamType);
+		return false;
+	}
+
+	outPath = streamPath;
+	return true;
+}
+
+void DisassembleStreamWithHeader(mtdisasm::IOStream& segmentStream, const mtdisasm::StreamDesc& streamDesc, size_t streamIndex, const mtdisasm::SerializationProperties& sp, size_t readAheadSize, const mtdisasm::ObjectTypeFilter* typeFilter, mtdisasm::TextWriter& f)
+{
+	f.Printf("Stream %i   Segment: %i   Position in file: %x\n\n", static_cast<int>(streamIndex), static_cast<int>(streamDesc.m_segmentNumber), static_cast<int>(streamDesc.m_pos));
+
+	mtdisasm::SliceIOStream slice(segmentStream, streamDesc.m_pos, streamDesc.m_size);
+	DisassembleStream(slice, streamDesc.m_size, static_cast<int>(streamIndex), streamDesc.m_pos, sp, readAheadSize, typeFilter, f);
+}
+
+// Returns stream indexes ordered by segment and then position in the segment, so that each
+// segment file is read front to back instead of seeking back and forth between streams
+std::vector<size_t> GetPhysicalStreamOrder(const mtdisasm::Catalog& catalog)
+{
+	std::vector<size_t> streamOrder;
+	streamOrder.resize(catalog.NumStreams());
+	for (size_t i = 0; i < streamOrder.size(); i++)
+		streamOrder[i] = i;
+
+	std::stable_sort(streamOrder.begin(), streamOrder.end(), [&catalog](size_t a, size_t b)
+	{
+		const mtdisasm::StreamDesc& streamA = catalog.GetStream(a);
+		const mtdisasm::StreamDesc& streamB = catalog.GetStream(b);
+		if (streamA.m_segmentNumber != streamB.m_segmentNumber)
+			return streamA.m_segmentNumber < streamB.m_segmentNumber;
+		return streamA.m_pos < streamB.m_pos;
+	});
+
+	return streamOrder;
+}
+
+// Disassembles every stream on a pool of numJobs workers, starting them in streamOrder.  Each
+// stream is written to its own file, so the output is the same as disassembling serially.
+bool DisassembleStreamsParallel(const mtdisasm::Catalog& catalog, const std::vector<mtdisasm::IOStream*>& segmentStreams, const std::vector<size_t>& streamOrder, const mtdisasm::SerializationProperties& sp, const std::string& outputDir, size_t numJobs, size_t readAheadSize, const mtdisasm::ObjectTypeFilter* typeFilter)
+{
+	const size_t numStreams = catalog.NumStreams();
+
+	std::vector<std::string> streamPaths;
+	streamPaths.resize(numStreams);
+	for (size_t i = 0; i < numStreams; i++)
+	{
+		if (!GetStreamOutputPath(outputDir, catalog.GetStream(i), i, streamPaths[i]))
+			return false;
+	}
+
+	std::atomic<bool> failed(false);
+
+	mtdisasm::ThreadPool pool(numJobs);
+
+	for (size_t i : streamOrder)
+	{
+		pool.Submit([&, i](size_t /*workerIndex*/)
+		{
+			const mtdisasm::StreamDesc& streamDesc = catalog.GetStream(i);
+			mtdisasm::IOStream& stream = *segmentStreams[streamDesc.m_segmentNumber - 1];
+
+			FILE* dumpF = fopen(streamPaths[i].c_str(), "wb");
+			if (!dumpF)
+			{
+				fprintf(stderr, "Failed to open output path '%s'", streamPaths[i].c_str());
+				failed = true;
+				return;
+			}
+
+			mtdisasm::TextWriter dumpWriter(dumpF);
+			DisassembleStreamWithHeader(stream, streamDesc, i, sp, readAheadSize, typeFilter, dumpWriter);
+			dumpWriter.Flush();
+
+			fclose(dumpF);
+		});
+	}
+
+	pool.WaitForIdle();
+
+	return !failed;
+}
+
+// Writes the catalog and then the objects of each stream, starting them in streamOrder, to
+// one file of structured records.  Objects are written as they're loaded and each stream's
+// arena is released once it's done, so memory use doesn't grow with the project.
+bool SerializeStreams(const mtdisasm::Catalog& catalog, const std::vector<mtdisasm::IOStream*>& segmentStreams, const std::vector<size_t>& streamOrder, const mtdisasm::SerializationProperties& sp, const std::string& outputPath, bool useBinaryRecords, size_t readAheadSize, const mtdisasm::ObjectTypeFilter* typeFilter)
+{
+	FILE* outF = fopen(outputPath.c_str(), "wb");
+	if (!outF)
+	{
+		fprintf(stderr, "Failed to open output path '%s'\n", outputPath.c_str());
+		return false;
+	}
+
+	bool succeeded = true;
+	{
+		mtdisasm::TextWriter outWriter(outF);
+
+		std::unique_ptr<mtdisasm::StructuredWriter> writer;
+		if (useBinaryRecords)
+			writer.reset(new mtdisasm::BinaryRecordWriter(outWriter));
+		else
+			writer.reset(new mtdisasm::JSONLinesWriter(outWriter));
+
+		SerializeCatalog(catalog, *writer);
+
+		for (size_t i : streamOrder)
+		{
+			const mtdisasm::StreamDesc& streamDesc = catalog.GetStream(i);
+			mtdisasm::IOStream& stream = *segmentStreams[streamDesc.m_segmentNumber - 1];
+
+			mtdisasm::SliceIOStream slice(stream, streamDesc.m_pos, streamDesc.m_size);
+			SerializeStream(slice, streamDesc.m_size, static_cast<int>(i), streamDesc.m_pos, sp, readAheadSize, typeFilter, *writer);
+		}
+
+		if (!outWriter.Flush())
+		{
+			fprintf(stderr, "Failed to write '%s'\n", outputPath.c_str());
+			succeeded = false;
+		}
+	}
+
+	fclose(outF);
+
+	return succeeded;
+}
+
+// Prints how many objects of each type were loaded, most common first
+void PrintObjectTypeCounts()
+{
+	std::vector<size_t> typeIndexes;
+	for (size_t i = 0; i < mtdisasm::kNumObjectTypes; i++)
+	{
+		if (mtdisasm::GetObjectCountOfType(i) > 0)
+			typeIndexes.push_back(i);
+	}
+
+	std::stable_sort(typeIndexes.begin(), typeIndexes.end(), [](size_t a, size_t b)
+	{
+		return mtdisasm::GetObjectCountOfType(a) > mtdisasm::GetObjectCountOfType(b);
+	});
+
+	printf("Object counts:\n");
+	for (size_t typeIndex : typeIndexes)
+	{
+		const mtdisasm::ObjectTypeInfo& typeInfo = mtdisasm::GetObjectTypeInfo(typeIndex);
+		uint64_t count = mtdisasm::GetObjectCountOfType(typeIndex);
+		printf("    %10llu  %-36s (%x)  ~%llu bytes\n", static_cast<unsigned long long>(count), typeInfo.m_name, static_cast<unsigned int>(typeInfo.m_typeCode), static_cast<unsigned long long>(count * typeInfo.m_sizeHint));
+	}
+}
+
+bool ComputeSegmentKeys(const std::vector<FILE*>& segments, const std::vector<mtdisasm::IOStream*>& segmentStreams, std::vector<mtdisasm::ObjectIndexSegmentKey>& outKeys)
+{
+	outKeys.resize(segments.size());
+	for (size_t i = 0; i < segments.size(); i++)
+	{
+		if (!mtdisasm::ObjectIndex::ComputeSegmentKey(segments[i], *segmentStreams[i], outKeys[i]))
+		{
+			fprintf(stderr, "Failed to identify segment %i\n", static_cast<int>(i + 1));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Loads the index at indexPath, or rebuilds and saves it if it wasn't built from the same segments
+bool OpenObjectIndex(const std::string& indexPath, const mtdisasm::Catalog& catalog, const std::vector<FILE*>& segments, const std::vector<mtdisasm::IOStream*>& segmentStreams, const mtdisasm::SerializationProperties& sp, size_t readAheadSize, bool printProgress, mtdisasm::ObjectIndex& index, bool& outWasCurrent)
+{
+	outWasCurrent = false;
+
+	std::vector<mtdisasm::ObjectIndexSegmentKey> segmentKeys;
+	if (!ComputeSegmentKeys(segments, segmentStreams, segmentKeys))
+		return false;
+
+	FILE* existingF = fopen(indexPath.c_str(), "rb");
+	if (existingF)
+	{
+		bool isCurrent = index.Load(existingF) && index.IsCurrent(catalog, segmentKeys, sp);
+		fclose(existingF);
+
+		if (isCurrent)
+		{
+			outWasCurrent = true;
+			return true;
+		}
+	}
+
+	if (printProgress)
+		printf("Indexing %i streams...\n", static_cast<int>(catalog.NumStreams()));
+
+	if (!index.Build(catalog, segmentStreams, segmentKeys, sp, readAheadSize))
+	{
+		fprintf(stderr, "Failed to build index\n");
+		return false;
+	}
+
+	size_t numIncompleteStreams = 0;
+	for (size_t i = 0; i < index.NumStreams(); i++)
+	{
+		if (index.GetStream(i).m_status != mtdisasm::ObjectIndexStreamStatus::kComplete)
+			numIncompleteStreams++;
+	}
+
+	// Written to a temporary file first so that a reader never maps a partly written index
+	std::string tempPath = indexPath + ".tmp";
+	FILE* indexF = fopen(tempPath.c_str(), "wb");
+	if (!indexF)
+	{
+		fprintf(stderr, "Failed to open index path '%s'\n", tempPath.c_str());
+		return false;
+	}
+
+	bool saved = index.Save(indexF);
+	if (fclose(indexF) != 0)
+		saved = false;
+
+	if (!saved)
+	{
+		fprintf(stderr, "Failed to write index\n");
+		remove(tempPath.c_str());
+		return false;
+	}
+
+#ifdef _WIN32
+	remove(indexPath.c_str());
+#endif
+
+	if (rename(tempPath.c_str(), indexPath.c_str()) != 0)
+	{
+		fprintf(stderr, "Failed to replace index '%s'\n", indexPath.c_str());
+		remove(tempPath.c_str());
+		return false;
+	}
+
+	if (printProgress)
+	{
+		printf("Indexed %i objects in %i streams", static_cast<int>(index.NumEntries()), static_cast<int>(index.NumStreams()));
+		if (numIncompleteStreams > 0)
+			printf(", %i streams incomplete", static_cast<int>(numIncompleteStreams));
+		printf("\n");
+	}
+
+	return true;
+}
+
+const uint32_t kAssetCatalogTypeCode = 0x00d;
+
+template<class TReader>
+mtdisasm::DataObject* LoadIndexedObjectWithReader(TReader& reader, const mtdisasm::ObjectIndexEntry& entry, const mtdisasm::ObjectIndexStream& indexStream, size_t streamIndex, const mtdisasm::SerializationProperties& sp, size_t& outTypeIndex)
+{
+	if (!reader.Seek(entry.m_position))
+	{
+		fprintf(stderr, "Stream %i: Couldn't seek to indexed object at position %x\n", static_cast<int>(streamIndex), static_cast<int>(entry.m_position));
+		return nullptr;
+	}
+
+	mtdisasm::ObjectStreamCursor<TReader> cursor(reader, indexStream.m_size, sp);
+	if (!cursor.Next() || cursor.GetTypeCode() != entry.m_typeCode)
+	{
+		fprintf(stderr, "Stream %i: Object at position %x doesn't match the index\n", static_cast<int>(streamIndex), static_cast<int>(entry.m_position));
+		return nullptr;
+	}
+
+	mtdisasm::DataObject* dataObject = cursor.Load();
+	if (!dataObject)
+	{
+		PrintStreamCursorError(cursor, static_cast<int>(streamIndex), indexStream.m_pos);
+		return nullptr;
+	}
+
+	outTypeIndex = cursor.GetTypeIndex();
+	return dataObject;
+}
+
+// Loads one indexed object into the current arena.  The caller takes ownership.
+mtdisasm::DataObject* LoadIndexedObject(const mtdisasm::ObjectIndex& index, const std::vector<mtdisasm::IOStream*>& segmentStreams, size_t streamIndex, size_t entryIndex, const mtdisasm::SerializationProperties& sp, size_t& outTypeIndex)
+{
+	const mtdisasm::ObjectIndexStream& indexStream = index.GetStream(streamIndex);
+	const mtdisasm::ObjectIndexEntry& entry = index.GetEntry(entryIndex);
+
+	mtdisasm::SliceIOStream slice(*segmentStreams[indexStream.m_segmentNumber - 1], indexStream.m_pos, indexStream.m_size);
+
+	if (sp.m_isByteSwapped)
+	{
+		mtdisasm::SwappedOrderDataReader reader(slice);
+		return LoadIndexedObjectWithReader(reader, entry, indexStream, streamIndex, sp, outTypeIndex);
+	}
+	else
+	{
+		mtdisasm::NativeOrderDataReader reader(slice);
+		return LoadIndexedObjectWithReader(reader, entry, indexStream, streamIndex, sp, outTypeIndex);
+	}
+}
+
+// Extracts the assets with the given IDs, loading only the asset catalog and the objects that
+// define them.  Like assets mode, an asset is extracted from the first object in stream order
+// that defines it.
+bool ExtractIndexedAssets(const mtdisasm::ObjectIndex& index, const std::vector<mtdisasm::IOStream*>& segmentStreams, const std::vector<uint32_t>& assetIDs, const mtdisasm::SerializationProperties& sp, const AssetExtractionOptions& assetOptions, mtdisasm::AsyncReader* payloadReader, const std::string& outputDir)
+{
+	struct IndexLocation
+	{
+		size_t m_streamIndex;
+		size_t m_entryIndex;
+	};
+
+	const IndexLocation kNotFound = { SIZE_MAX, 0 };
+
+	IndexLocation assetCatalogLocation = kNotFound;
+
+	std::unordered_map<uint32_t, IndexLocation> assetLocations;
+	for (uint32_t assetID : assetIDs)
+		assetLocations[assetID] = kNotFound;
+
+	for (size_t i = 0; i < index.NumStreams(); i++)
+	{
+		const mtdisasm::ObjectIndexStream& indexStream = index.GetStream(i);
+		for (size_t entryIndex = indexStream.m_firstEntry; entryIndex < indexStream.m_firstEntry + indexStream.m_numEntries; entryIndex++)
+		{
+			const mtdisasm::ObjectIndexEntry& entry = index.GetEntry(entryIndex);
+
+			if (entry.m_typeCode == kAssetCatalogTypeCode)
+			{
+				if (assetCatalogLocation.m_streamIndex == SIZE_MAX)
+					assetCatalogLocation = IndexLocation { i, entryIndex };
+				continue;
 			}
-			else if (asset.m_bitsPerPixel == 32)
+
+			if (entry.m_idKind != static_cast<uint8_t>(mtdisasm::ObjectIDKind::kAssetID))
+				continue;
+
+			std::unordered_map<uint32_t, IndexLocation>::iterator it = assetLocations.find(entry.m_id);
+			if (it == assetLocations.end() || it->second.m_streamIndex != SIZE_MAX)
+				continue;
+
+			size_t typeIndex = 0;
+			if (mtdisasm::FindObjectType(entry.m_typeCode, typeIndex) && g_objectTypeHandlers[typeIndex].m_isExtractableAsset)
+				it->second = IndexLocation { i, entryIndex };
+		}
+	}
+
+	mtdisasm::ObjectArena catalogArena;
+	mtdisasm::ObjectArena::Scope catalogArenaScope(catalogArena);
+
+	// The catalog is only used for names, since assets mode doesn't require assets to be in it
+	mtdisasm::DataObject* assetCatalogObject = nullptr;
+	if (assetCatalogLocation.m_streamIndex != SIZE_MAX)
+	{
+		size_t typeIndex = 0;
+		assetCatalogObject = LoadIndexedObject(index, segmentStreams, assetCatalogLocation.m_streamIndex, assetCatalogLocation.m_entryIndex, sp, typeIndex);
+	}
+
+	const mtdisasm::DOAssetCatalog* assetCatalog = static_cast<const mtdisasm::DOAssetCatalog*>(assetCatalogObject);
+
+	bool allExtracted = true;
+	AssetExtractor extractor(sp, outputDir, assetOptions);
+	extractor.SetAsyncReader(payloadReader);
+
+	for (uint32_t assetID : assetIDs)
+	{
+		// Asset IDs are 1-based positions in the catalog
+		const mtdisasm::DOAssetCatalog::AssetInfo* assetInfo = nullptr;
+		if (assetCatalog && assetID >= 1 && assetID <= assetCatalog->m_assets.size())
+			assetInfo = &assetCatalog->m_assets[assetID - 1];
+
+		std::string assetName;
+		if (assetInfo && assetInfo->m_nameLength > 1)
+			assetName.assign(&assetInfo->m_name[0], assetInfo->m_nameLength - 1);
+
+		const IndexLocation& location = assetLocations[assetID];
+		if (location.m_streamIndex == SIZE_MAX)
+		{
+			if (assetInfo)
+				fprintf(stderr, "Asset %u '%s' isn't defined by any extractable object\n", static_cast<unsigned int>(assetID), assetName.c_str());
+			else
+				fprintf(stderr, "Asset %u isn't in the asset catalog or defined by any extractable object\n", static_cast<unsigned int>(assetID));
+			allExtracted = false;
+			continue;
+		}
+
+		if (assetInfo)
+			printf("Extracting asset %u '%s'\n", static_cast<unsigned int>(assetID), assetName.c_str());
+		else
+			printf("Extracting asset %u\n", static_cast<unsigned int>(assetID));
+
+		mtdisasm::ObjectArena arena;
+		mtdisasm::ObjectArena::Scope arenaScope(arena);
+
+		size_t typeIndex = 0;
+		mtdisasm::DataObject* dataObject = LoadIndexedObject(index, segmentStreams, location.m_streamIndex, location.m_entryIndex, sp, typeIndex);
+		if (!dataObject)
+		{
+			allExtracted = false;
+			continue;
+		}
+
+		const mtdisasm::ObjectIndexStream& indexStream = index.GetStream(location.m_streamIndex);
+		const mtdisasm::ObjectIndexEntry& entry = index.GetEntry(location.m_entryIndex);
+		const uint32_t objectGlobalPos = indexStream.m_pos + entry.m_position;
+
+		extractor.ExtractAsset(dataObject, typeIndex, *segmentStreams[indexStream.m_segmentNumber - 1], static_cast<int>(indexStream.m_segmentNumber), static_cast<int>(location.m_streamIndex), objectGlobalPos, objectGlobalPos + entry.m_size);
+	}
+
+	extractor.Flush();
+
+	if (assetCatalogObject)
+		assetCatalogObject->Delete();
+
+	return allExtracted;
+}
+
+bool OutputFileExists(const std::string& path)
+{
+	FILE* f = fopen(path.c_str(), "rb");
+	if (!f)
+		return false;
+
+	fclose(f);
+	return true;
+}
+
+// Counts the files in the output directory that are named after each asset, which are
+// "asset_" and the asset ID followed by an extension or a suffix
+bool CountAssetOutputFiles(const std::string& outputDir, std::unordered_map<uint32_t, uint32_t>& outCounts)
+{
+	outCounts.clear();
+
+	std::vector<std::string> names;
+	if (!mtdisasm::ListFiles(outputDir, names))
+		return false;
+
+	for (const std::string& name : names)
+	{
+		if (name.compare(0, 6, "asset_") != 0)
+			continue;
+
+		size_t endOfID = 6;
+		uint64_t assetID = 0;
+		while (endOfID < name.size() && name[endOfID] >= '0' && name[endOfID] <= '9' && assetID <= 0xffffffffu)
+			assetID = assetID * 10 + static_cast<uint64_t>(name[endOfID++] - '0');
+
+		if (endOfID == 6 || endOfID == name.size() || assetID > 0xffffffffu || (name[endOfID] != '.' && name[endOfID] != '_'))
+			continue;
+
+		outCounts[static_cast<uint32_t>(assetID)]++;
+	}
+
+	return true;
+}
+
+uint64_t HashTypeFilter(const mtdisasm::ObjectTypeFilter* typeFilter)
+{
+	if (!typeFilter)
+		return 0;
+
+	uint8_t isIncluded[mtdisasm::kNumObjectTypes];
+	for (size_t i = 0; i < mtdisasm::kNumObjectTypes; i++)
+		isIncluded[i] = typeFilter->Contains(i) ? 1 : 0;
+
+	return mtdisasm::ExtractionManifest::HashMemory(isIncluded, sizeof(isIncluded), 1);
+}
+
+uint32_t HashStreamType(const mtdisasm::StreamDesc& streamDesc)
+{
+	return static_cast<uint32_t>(mtdisasm::ExtractionManifest::HashMemory(streamDesc.m_streamType, strlen(streamDesc.m_streamType), 0));
+}
+
+// Works out which outputs an incremental run redoes, from the manifest that the last run
+// left in the output directory.  A stream is redone if its contents or type changed or its
+// output is missing.  Streams are only read to hash them if their segment changed.
+//
+// Asset payloads are mostly stored outside of the streams that define them, so each asset
+// is redone if its payload changed, the first stream that defines it changed, or some of
+// its output files are missing.  Unchanged streams that own such assets, or that had assets
+// fail to extract last time, are walked again for their asset definitions only.
+struct IncrementalUpdate
+{
+	IncrementalUpdate();
+
+	std::string m_outputDir;
+	std::string m_manifestPath;
+	mtdisasm::ExtractionSettings m_settings;
+	uint64_t m_catalogHash;
+	bool m_isCatalogChanged;
+
+	std::vector<mtdisasm::ObjectIndexSegmentKey> m_segmentKeys;
+	std::vector<uint64_t> m_streamHashes;
+	std::vector<bool> m_isStreamChanged;
+	std::vector<bool> m_isStreamRescanned;
+
+	// Asset definitions of the unchanged streams, with current payload hashes
+	std::vector<std::vector<mtdisasm::ExtractionManifestAsset>> m_streamAssets;
+
+	// Assets whose outputs are kept, by the first stream that defines them
+	std::unordered_map<uint32_t, int> m_retainedAssets;
+};
+
+IncrementalUpdate::IncrementalUpdate()
+	: m_catalogHash(0)
+	, m_isCatalogChanged(true)
+{
+	memset(&m_settings, 0, sizeof(m_settings));
+}
+
+bool BeginIncrementalUpdate(const std::string& outputDir, const mtdisasm::Catalog& catalog, const std::vector<FILE*>& segments, const std::vector<mtdisasm::IOStream*>& segmentStreams, const mtdisasm::ExtractionSettings& settings, uint64_t catalogHash, IncrementalUpdate& update)
+{
+	update.m_outputDir = outputDir;
+	update.m_manifestPath = outputDir + "/manifest.mtinc";
+	update.m_settings = settings;
+	update.m_catalogHash = catalogHash;
+
+	if (!ComputeSegmentKeys(segments, segmentStreams, update.m_segmentKeys))
+		return false;
+
+	mtdisasm::ExtractionManifest previous;
+	bool hasPrevious = false;
+
+	FILE* manifestF = fopen(update.m_manifestPath.c_str(), "rb");
+	if (manifestF)
+	{
+		hasPrevious = previous.Load(manifestF) && previous.HasSettings(settings);
+		fclose(manifestF);
+	}
+
+	const size_t numSegments = update.m_segmentKeys.size();
+	std::vector<bool> isSegmentUnchanged(numSegments, false);
+	for (size_t i = 0; hasPrevious && i < numSegments && i < previous.NumSegments(); i++)
+	{
+		const mtdisasm::ObjectIndexSegmentKey& previousKey = previous.GetSegmentKey(i);
+		const mtdisasm::ObjectIndexSegmentKey& key = update.m_segmentKeys[i];
+		isSegmentUnchanged[i] = (previousKey.m_size == key.m_size && previousKey.m_modifiedTime == key.m_modifiedTime && previousKey.m_contentHash == key.m_contentHash);
+	}
+
+	update.m_isCatalogChanged = (!hasPrevious || previous.GetCatalogHash() != catalogHash);
+
+	std::unordered_map<uint32_t, uint32_t> outputFileCounts;
+	if (hasPrevious && !CountAssetOutputFiles(outputDir, outputFileCounts))
+		outputFileCounts.clear();
+
+	const size_t numStreams = catalog.NumStreams();
+	update.m_streamHashes.resize(numStreams);
+	update.m_isStreamChanged.assign(numStreams, true);
+	update.m_isStreamRescanned.assign(numStreams, false);
+	update.m_streamAssets.clear();
+	update.m_streamAssets.resize(numStreams);
+	update.m_retainedAssets.clear();
+
+	struct AssetOwner
+	{
+		int m_streamIndex;
+		bool m_isPayloadChanged;
+	};
+
+	// First definition of each asset among the unchanged streams
+	std::unordered_map<uint32_t, AssetOwner> owners;
+
+	for (size_t i = 0; i < numStreams; i++)
+	{
+		const mtdisasm::StreamDesc& streamDesc = catalog.GetStream(i);
+		if (streamDesc.m_segmentNumber < 1 || streamDesc.m_segmentNumber > numSegments)
+		{
+			fprintf(stderr, "Stream %i is in segment %i, which doesn't exist\n", static_cast<int>(i), static_cast<int>(streamDesc.m_segmentNumber));
+			return false;
+		}
+
+		const size_t segmentIndex = streamDesc.m_segmentNumber - 1;
+		const mtdisasm::IOStream& segmentStream = *segmentStreams[segmentIndex];
+
+		const mtdisasm::ExtractionManifestStream* previousStream = nullptr;
+		if (hasPrevious && i < previous.NumStreams())
+		{
+			const mtdisasm::ExtractionManifestStream& candidate = previous.GetStream(i);
+			if (candidate.m_segmentNumber == streamDesc.m_segmentNumber && candidate.m_pos == streamDesc.m_pos && candidate.m_size == streamDesc.m_size && candidate.m_streamTypeHash == HashStreamType(streamDesc))
+				previousStream = &candidate;
+		}
+
+		if (previousStream && isSegmentUnchanged[segmentIndex])
+			update.m_streamHashes[i] = previousStream->m_contentHash;
+		else if (!mtdisasm::ExtractionManifest::HashStreamRange(segmentStream, streamDesc.m_pos, streamDesc.m_size, 0, update.m_streamHashes[i]))
+		{
+			fprintf(stderr, "Failed to read stream %i\n", static_cast<int>(i));
+			return false;
+		}
+
+		if (!previousStream || previousStream->m_contentHash != update.m_streamHashes[i])
+			continue;
+
+		std::string streamPath;
+		if (!GetStreamOutputPath(outputDir, streamDesc, i, streamPath))
+			return false;
+
+		if (!OutputFileExists(streamPath))
+			continue;
+
+		update.m_isStreamChanged[i] = false;
+
+		// Failed assets weren't listed, so they're only found again by walking the stream
+		if (previousStream->m_numFailedAssets > 0)
+			update.m_isStreamRescanned[i] = true;
+
+		std::vector<mtdisasm::ExtractionManifestAsset>& assets = update.m_streamAssets[i];
+		for (size_t j = 0; j < previousStream->m_numAssets; j++)
+		{
+			mtdisasm::ExtractionManifestAsset asset = previous.GetAsset(previousStream->m_firstAsset + j);
+
+			bool isPayloadChanged = false;
+			if (!isSegmentUnchanged[segmentIndex])
 			{
-				for (size_t row = 0; row < numRows; row++)
+				uint64_t payloadHash = 0;
+				if (!mtdisasm::ExtractionManifest::HashStreamRange(segmentStream, asset.m_payloadPosition, asset.m_payloadSize, 0, payloadHash))
+					isPayloadChanged = true;
+				else if (payloadHash != asset.m_payloadHash)
 				{
-					size_t rowOffset = dataOffset + row * bytesPerRow;
-					if (isBottomUp)
-						rowOffset = dataOffset + (numRows - 1 - row) * bytesPerRow;
+					asset.m_payloadHash = payloadHash;
+					isPayloadChanged = true;
+				}
+			}
+
+			// Missing outputs are redone the same way as a changed payload
+			std::unordered_map<uint32_t, uint32_t>::const_iterator outputFileCountIt = outputFileCounts.find(asset.m_assetID);
+			const uint32_t numOutputFiles = (outputFileCountIt == outputFileCounts.end()) ? 0 : outputFileCountIt->second;
+			if (numOutputFiles < asset.m_numOutputFiles)
+				isPayloadChanged = true;
+
+			AssetOwner owner;
+			owner.m_streamIndex = static_cast<int>(i);
+			owner.m_isPayloadChanged = isPayloadChanged;
+			owners.insert(std::make_pair(asset.m_assetID, owner));
+
+			assets.push_back(asset);
+		}
+	}
+
+	std::unordered_map<uint32_t, int> previousOwners;
+	for (size_t i = 0; hasPrevious && i < previous.NumStreams(); i++)
+	{
+		const mtdisasm::ExtractionManifestStream& previousStream = previous.GetStream(i);
+		for (size_t j = 0; j < previousStream.m_numAssets; j++)
+			previousOwners.insert(std::make_pair(previous.GetAsset(previousStream.m_firstAsset + j).m_assetID, static_cast<int>(i)));
+	}
+
+	for (const std::pair<const uint32_t, AssetOwner>& owner : owners)
+	{
+		std::unordered_map<uint32_t, int>::const_iterator previousOwnerIt = previousOwners.find(owner.first);
+		bool isOwnerUnchanged = (previousOwnerIt != previousOwners.end() && previousOwnerIt->second == owner.second.m_streamIndex);
+
+		if (owner.second.m_isPayloadChanged || !isOwnerUnchanged)
+			update.m_isStreamRescanned[static_cast<size_t>(owner.second.m_streamIndex)] = true;
+		else
+			update.m_retainedAssets[owner.first] = owner.second.m_streamIndex;
+	}
+
+	return true;
+}
+
+// Writes the manifest for the outputs of this run.  foundAssets holds the asset definitions
+// found in the streams that were walked, and failedAssets the assets that failed to extract,
+// which are left out so that the next run tries them again.
+bool FinishIncrementalUpdate(const IncrementalUpdate& update, const mtdisasm::Catalog& catalog, const std::vector<mtdisasm::IOStream*>& segmentStreams, const std::vector<std::vector<mtdisasm::ExtractionManifestAsset>>& foundAssets, const std::unordered_set<uint32_t>& failedAssets)
+{
+	mtdisasm::ExtractionManifest manifest;
+	manifest.SetSettings(update.m_settings);
+	manifest.SetCatalogHash(update.m_catalogHash);
+	manifest.SetSegmentKeys(update.m_segmentKeys);
+
+	std::unordered_map<uint32_t, uint32_t> outputFileCounts;
+	if (!CountAssetOutputFiles(update.m_outputDir, outputFileCounts))
+	{
+		fprintf(stderr, "Failed to list output directory '%s'\n", update.m_outputDir.c_str());
+		return false;
+	}
+
+	for (size_t i = 0; i < catalog.NumStreams(); i++)
+	{
+		const mtdisasm::StreamDesc& streamDesc = catalog.GetStream(i);
+
+		std::vector<mtdisasm::ExtractionManifestAsset> assets;
+		if (!update.m_isStreamChanged[i] && !update.m_isStreamRescanned[i])
+			assets = update.m_streamAssets[i];
+		else if (i < foundAssets.size())
+		{
+			// Payloads of unchanged streams' assets were already hashed
+			std::unordered_map<uint32_t, uint64_t> knownPayloadHashes;
+			if (!update.m_isStreamChanged[i])
+			{
+				for (const mtdisasm::ExtractionManifestAsset& asset : update.m_streamAssets[i])
+					knownPayloadHashes.insert(std::make_pair(asset.m_assetID, asset.m_payloadHash));
+			}
+
+			assets = foundAssets[i];
+
+			// A payload that can't be read keeps a zero hash, which only matches while its
+			// segment is unchanged
+			for (mtdisasm::ExtractionManifestAsset& asset : assets)
+			{
+				std::unordered_map<uint32_t, uint64_t>::const_iterator knownHashIt = knownPayloadHashes.find(asset.m_assetID);
+				if (knownHashIt != knownPayloadHashes.end())
+					asset.m_payloadHash = knownHashIt->second;
+				else if (!mtdisasm::ExtractionManifest::HashStreamRange(*segmentStreams[streamDesc.m_segmentNumber - 1], asset.m_payloadPosition, asset.m_payloadSize, 0, asset.m_payloadHash))
+					asset.m_payloadHash = 0;
+			}
+		}
+
+		uint32_t numFailedAssets = 0;
+		std::vector<mtdisasm::ExtractionManifestAsset>::iterator assetsEnd = assets.begin();
+		for (const mtdisasm::ExtractionManifestAsset& asset : assets)
+		{
+			if (failedAssets.find(asset.m_assetID) != failedAssets.end())
+			{
+				numFailedAssets++;
+				continue;
+			}
+
+			*assetsEnd = asset;
+
+			std::unordered_map<uint32_t, uint32_t>::const_iterator outputFileCountIt = outputFileCounts.find(asset.m_assetID);
+			assetsEnd->m_numOutputFiles = (outputFileCountIt == outputFileCounts.end()) ? 0 : outputFileCountIt->second;
+			++assetsEnd;
+		}
+		assets.erase(assetsEnd, assets.end());
+
+		if (!manifest.AddStream(streamDesc.m_segmentNumber, streamDesc.m_pos, streamDesc.m_size, HashStreamType(streamDesc), update.m_streamHashes[i], assets, numFailedAssets))
+		{
+			fprintf(stderr, "Too many assets for manifest\n");
+			return false;
+		}
+	}
+
+	// Written to a temporary file first so that an interrupted run leaves the last manifest
+	std::string tempPath = update.m_manifestPath + ".tmp";
+	FILE* manifestF = fopen(tempPath.c_str(), "wb");
+	if (!manifestF)
+	{
+		fprintf(stderr, "Failed to open manifest path '%s'\n", tempPath.c_str());
+		return false;
+	}
+
+	bool saved = manifest.Save(manifestF);
+	if (fclose(manifestF) != 0)
+		saved = false;
+
+	if (!saved)
+	{
+		fprintf(stderr, "Failed to write manifest\n");
+		remove(tempPath.c_str());
+		return false;
+	}
+
+#ifdef _WIN32
+	remove(update.m_manifestPath.c_str());
+#endif
+
+	if (rename(tempPath.c_str(), update.m_manifestPath.c_str()) != 0)
+	{
+		fprintf(stderr, "Failed to replace manifest '%s'\n", update.m_manifestPath.c_str());
+		remove(tempPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool ParseAssetIDList(const std::string& assetList, std::vector<uint32_t>& outAssetIDs)
+{
+	size_t tokenStart = 0;
+	while (tokenStart <= assetList.size())
+	{
+		size_t tokenEnd = assetList.find(',', tokenStart);
+		if (tokenEnd == std::string::npos)
+			tokenEnd = assetList.size();
+
+		std::string token = assetList.substr(tokenStart, tokenEnd - tokenStart);
+		tokenStart = tokenEnd + 1;
+
+		char* idEnd = nullptr;
+		unsigned long assetID = strtoul(token.c_str(), &idEnd, 10);
+		if (token.empty() || *idEnd != '\0' || assetID > UINT32_MAX)
+		{
+			fprintf(stderr, "Invalid asset ID '%s'\n", token.c_str());
+			return false;
+		}
+
+		outAssetIDs.push_back(static_cast<uint32_t>(assetID));
+	}
+
+	return true;
+}
+
+// Segment files and their streams, closed together
+struct ProjectSegments
+{
+	~ProjectSegments();
+
+	std::vector<FILE*> m_files;
+	std::vector<mtdisasm::IOStream*> m_streams;
+};
+
+ProjectSegments::~ProjectSegments()
+{
+	for (mtdisasm::IOStream* segmentStream : m_streams)
+	{
+		delete segmentStream;
+	}
+
+	for (FILE* f : m_files)
+	{
+		if (f)
+			fclose(f);
+	}
+}
+
+// Parses a comma-separated list of type names and hex type codes.  A name selects every
+// type registered under it.
+bool ParseObjectTypeFilter(const std::string& typeList, mtdisasm::ObjectTypeFilter& outFilter)
+{
+	size_t tokenStart = 0;
+	while (tokenStart <= typeList.size())
+	{
+		size_t tokenEnd = typeList.find(',', tokenStart);
+		if (tokenEnd == std::string::npos)
+			tokenEnd = typeList.size();
+
+		std::string token = typeList.substr(tokenStart, tokenEnd - tokenStart);
+		tokenStart = tokenEnd + 1;
+
+		bool matched = false;
+		for (size_t i = 0; i < mtdisasm::kNumObjectTypes; i++)
+		{
+			if (token == mtdisasm::GetObjectTypeInfo(i).m_name)
+			{
+				outFilter.Add(i);
+				matched = true;
+			}
+		}
+
+		if (!matched && !token.empty())
+		{
+			char* codeEnd = nullptr;
+			unsigned long typeCode = strtoul(token.c_str(), &codeEnd, 16);
+			size_t typeIndex = 0;
+			if (*codeEnd == '\0' && typeCode <= UINT32_MAX && mtdisasm::FindObjectType(static_cast<uint32_t>(typeCode), typeIndex))
+			{
+				outFilter.Add(typeIndex);
+				matched = true;
+			}
+		}
+
+		if (!matched)
+		{
+			fprintf(stderr, "Unknown object type '%s'\n", token.c_str());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void PrintUsage()
+{
+	fprintf(stderr, "Usage: unbundle [options] <mode> <segment 1 path> <output dir>\n");
+	fprintf(stderr, "       unbundle [options] -batch <mode> <project list or directory> <output root>\n");
+	fprintf(stderr, "Options:\n");
+	fprintf(stderr, "    -aio <engine>    Read-ahead of asset payloads from unmapped segments: auto, uring, threads, off (default: auto)\n");
+	fprintf(stderr, "    -asset <ids>     Comma-separated asset IDs to extract in extract mode\n");
+	fprintf(stderr, "    -batch           Unbundle each project listed in a file, one segment 1 path per line, or each\n");
+	fprintf(stderr, "                     .MPL under a directory, into a subdirectory of the output root\n");
+	fprintf(stderr, "    -image <encoder> How images and mToon frames are written (default: stb):\n");
+	fprintf(stderr, "                     stb: PNG from stb_image_write\n");
+	fprintf(stderr, "                     png: PNG with a faster compressor, at the level from -imagelevel\n");
+	fprintf(stderr, "                     pnm: Uncompressed PPM, or PAM for images with alpha\n");
+	fprintf(stderr, "                     qoi: QOI\n");
+	fprintf(stderr, "    -imagelevel <n>  Level for the png encoder, from 0 (uncompressed) to %i (smallest) (default: 1)\n", mtdisasm::ImageEncoderOptions::kMaxLevel);
+	fprintf(stderr, "    -incremental     In bin, text, and assets modes, only redo outputs whose streams or asset payloads\n");
+	fprintf(stderr, "                     changed since the last incremental run, as recorded in <output dir>/manifest.mtinc\n");
+	fprintf(stderr, "    -index <path>    Object index file for index and extract modes (default: <output dir>/objects.mtidx)\n");
+	fprintf(stderr, "    -io <backend>    Segment I/O backend: stdio, mmap, auto (default: %s)\n", kDefaultIOBackendName);
+	fprintf(stderr, "    -j <jobs>        Number of worker threads for text and assets modes, or projects in batch mode (default: 1)\n");
+	fprintf(stderr, "    -mtoon <mode>    How mToon frames are extracted (default: frames):\n");
+	fprintf(stderr, "                     frames: Each frame by itself\n");
+	fprintf(stderr, "                     composite: Temporally compressed frames drawn over the frames before them\n");
+	fprintf(stderr, "                     on a canvas the size of the mToon.  Keyframes are written whole and other\n");
+	fprintf(stderr, "                     frames as the rect that changed, listed in asset_<id>_frames.txt\n");
+	fprintf(stderr, "                     atlas: Each mToon's frames packed into asset_<id>_atlas_<page>.png, listed with\n");
+	fprintf(stderr, "                     the mToon's frame ranges in asset_<id>_atlas.txt\n");
+	fprintf(stderr, "    -order <order>   Stream processing order: catalog, physical (default: physical)\n");
+	fprintf(stderr, "    -readahead <MiB> Read-ahead block size for unmapped streams, 0 to disable (default: %i)\n", static_cast<int>(kDefaultReadAheadSize / (1024 * 1024)));
+	fprintf(stderr, "    -stats           Print the number of objects loaded of each type\n");
+	fprintf(stderr, "    -types <list>    Only disassemble or extract these object types, as names or hex type codes\n");
+}
+
+struct UnbundleOptions
+{
+	std::string m_mode;
+	bool m_is112Compatible;
+	IOBackend m_ioBackend;
+	size_t m_numJobs;
+	size_t m_readAheadSize;
+	bool m_usePhysicalOrder;
+	bool m_printProgress;
+	std::string m_indexPath;	// Empty for the default in the output directory
+	const mtdisasm::ObjectTypeFilter* m_typeFilter;
+	std::vector<uint32_t> m_assetIDs;
+	bool m_useAsyncReads;
+	mtdisasm::AsyncReadEngine m_asyncReadEngine;
+	bool m_isIncremental;
+	AssetExtractionOptions m_assetOptions;
+};
+
+bool UnbundleProject(const UnbundleOptions& options, const std::string& seg1Path, const std::string& outputDir, size_t& outNumStreams)
+{
+	outNumStreams = 0;
+
+	if (seg1Path.size() < 5)
+	{
+		fprintf(stderr, "Segment 1 path needs to end in .MPL");
+		return false;
+	}
+
+	if (options.m_printProgress)
+		printf("Loading catalog...\n");
+
+	ProjectSegments projectSegments;
+	std::vector<FILE*>& segments = projectSegments.m_files;
+	std::vector<mtdisasm::IOStream*>& segmentStreams = projectSegments.m_streams;
+
+	FILE* catFile = fopen(seg1Path.c_str(), "rb");
+
+	if (!catFile)
+	{
+		fprintf(stderr, "Failed to open catalog file\n");
+		return false;
+	}
 
-					for (size_t col = 0; col < numCols; col++)
-					{
-						const size_t px = col + row * numCols;
+	segments.push_back(catFile);
 
-						const uint8_t* pixel32 = &frameData[rowOffset + col * 4];
+	mtdisasm::IOStream* seg1Stream = CreateSegmentStream(catFile, options.m_ioBackend, seg1Path);
+	if (!seg1Stream)
+	{
+		fprintf(stderr, "Failed to map catalog file\n");
+		return false;
+	}
 
-						imageData[px * 4 + 0] = pixel32[0];
-						imageData[px * 4 + 1] = pixel32[1];
-						imageData[px * 4 + 2] = pixel32[2];
-						imageData[px * 4 + 3] = 255;
-					}
-				}
-			}
-			else
-			{
-				fprintf(stderr, "Unsupported uncompressed bit count\n");
-				return;
-			}
+	segmentStreams.push_back(seg1Stream);
 
-			std::string outPath = basePath + "/asset_" + std::to_string(asset.m_assetID) + "_frame_" + std::to_string(i) + ".png";
-			stbi_write_png(outPath.c_str(), numCols, numRows, 4, &imageData[0], numCols * 4);
-		}
+	uint8_t systemCheck[2];
+	if (!seg1Stream->ReadAll(systemCheck, 2))
+	{
+		fprintf(stderr, "Failed to read system ID\n");
+		return false;
 	}
-}
 
 
-void ExtractAsset(std::unordered_set<uint32_t>& assetIDs, const mtdisasm::DataObject& dataObject, mtdisasm::IOStream& stream, const mtdisasm::SerializationProperties& sp, const std::string& basePath, int segmentNum, int streamNum)
-{
-	switch (dataObject.GetType())
+	mtdisasm::SerializationProperties sp;
+	sp.m_is112Compatible = options.m_is112Compatible;
+
+	bool isBigEndian = false;
+	if (systemCheck[0] == 0 && systemCheck[1] == 0)
 	{
-	case mtdisasm::DataObjectType::kImageAsset:
-		ExtractImageAsset(assetIDs, static_cast<const mtdisasm::DOImageAsset&>(dataObject), stream, sp, basePath);
-		break;
-	case mtdisasm::DataObjectType::kMovieAsset:
-		ExtractMovieAsset(assetIDs, static_cast<const mtdisasm::DOMovieAsset&>(dataObject), stream, sp, basePath);
-		break;
-	case mtdisasm::DataObjectType::kMToonAsset:
-		ExtractMToonAsset(assetIDs, static_cast<const mtdisasm::DOMToonAsset&>(dataObject), stream, sp, basePath);
-		break;
-	case mtdisasm::DataObjectType::kPlugInModifier:
+		if (options.m_printProgress)
+			printf("Detected as Macintosh format\n");
+		isBigEndian = true;
+		sp.m_systemType = mtdisasm::SystemType::kMac;
+	}
+	else if (systemCheck[0] == 1 && systemCheck[1] == 0)
+	{
+		if (options.m_printProgress)
+			printf("Detected as Windows format\n");
+		isBigEndian = false;
+		sp.m_systemType = mtdisasm::SystemType::kWindows;
+	}
+	else
+	{
+		fprintf(stderr, "Unknown system value\n");
+		return false;
+	}
+
+	uint32_t byteOrderCheckInt;
+	uint8_t byteOrderCheckBytes[4] = { 0, 0, 0, 1 };
+
+	memcpy(&byteOrderCheckInt, byteOrderCheckBytes, 4);
+
+	bool isSystemBigEndian = false;
+	if (byteOrderCheckInt == 1)
+		isSystemBigEndian = true;
+	else if (byteOrderCheckInt == 0x01000000)
+		isSystemBigEndian = false;
+	else
+	{
+		fprintf(stderr, "Couldn't detect system endian\n");
+		return false;
+	}
+
+	sp.m_isByteSwapped = (isSystemBigEndian != isBigEndian);
+
+	if (!seg1Stream->SeekSet(0))
+	{
+		fprintf(stderr, "Failed to reposition to start\n");
+		return false;
+	}
+
+	mtdisasm::DataReader dataReader(*seg1Stream, sp.m_isByteSwapped);
+
+	dataReader.Seek(0);
+
+	mtdisasm::Catalog catalog;
+	if (!catalog.Load(dataReader))
+	{
+		fprintf(stderr, "Failed to load catalog\n");
+		return false;
+	}
+
+	size_t numSegments = catalog.NumSegments();
+
+	segments.resize(numSegments);
+	segmentStreams.resize(numSegments);
+
+	bool isWinConvention = false;
+	if (numSegments > 1)
+	{
+		if (seg1Path[seg1Path.size() - 1] != '1')
 		{
-			const mtdisasm::DOPlugInModifier& plugin = static_cast<const mtdisasm::DOPlugInModifier&>(dataObject);
-			if (!strcmp(plugin.m_plugin, "MIDIModf"))
+			isWinConvention = true;
+			if (seg1Path.size() < 5 || seg1Path[seg1Path.size() - 5] != '1' || seg1Path[seg1Path.size() - 4] != '.')
 			{
-				const mtdisasm::POMidiModifier* midiModifier = static_cast<const mtdisasm::POMidiModifier*>(plugin.m_plugInData);
-				if (midiModifier->m_data.size() > 0)
-				{
-					char midiName[64];
-					sprintf(midiName, "/midi-%i-%x.mid", segmentNum, static_cast<int>(stream.TellGlobal()));
-
-					std::string outPath = basePath + midiName;
-					FILE* fOut = fopen(outPath.c_str(), "wb");
-					if (fOut)
-					{
-						fwrite(&midiModifier->m_data[0], 1, midiModifier->m_data.size(), fOut);
-						fclose(fOut);
-					}
-				}
+				fprintf(stderr, "Couldn't figure out segment naming convention");
+				return false;
 			}
 		}
-		break;
-	case mtdisasm::DataObjectType::kAudioAsset:
-		ExtractAudioAsset(assetIDs, static_cast<const mtdisasm::DOAudioAsset &>(dataObject), stream, sp, basePath);
-		break;
-	default:
-		break;
 	}
-}
-
-void ExtractAssetsFromStream(std::unordered_set<uint32_t>& assetIDs, mtdisasm::IOStream& globalStream, mtdisasm::IOStream& stream, size_t streamSize, int segmentIndex, int streamIndex, uint32_t streamPos, const mtdisasm::SerializationProperties& sp, const std::string& basePath)
-{
-	mtdisasm::DataReader reader(stream, sp.m_isByteSwapped);
 
-	for (;;)
+	for (size_t i = 1; i < numSegments; i++)
 	{
-		uint32_t pos = stream.Tell();
-		if (pos == streamSize)
-			break;
+		std::string mpxPath;
+		if (isWinConvention)
+			mpxPath = seg1Path.substr(0, seg1Path.size() - 5) + std::to_string(i + 1) + ".MPX";
+		else
+			mpxPath = seg1Path.substr(0, seg1Path.size() - 1) + std::to_string(i + 1);
 
-		uint32_t objectType = 0;
-		uint16_t revision = 0;
-		if (!reader.ReadU32(objectType) || !reader.ReadU16(revision))
+		segments[i] = fopen(mpxPath.c_str(), "rb");
+		if (!segments[i])
 		{
-			fprintf(stderr, "Stream %i: Couldn't read type at stream position %x (global position %x)\n", streamIndex, static_cast<int>(pos), static_cast<int>(pos + streamPos));
-			return;
+			fprintf(stderr, "Attempted to open %s but couldn't find it\n", mpxPath.c_str());
+			return false;
 		}
 
-		mtdisasm::DataObject* dataObject = mtdisasm::CreateObjectFromType(objectType);
-		if (!dataObject)
+		segmentStreams[i] = CreateSegmentStream(segments[i], options.m_ioBackend, mpxPath);
+		if (!segmentStreams[i])
 		{
-			fprintf(stderr, "Stream %i: Unknown object type %x revision %i at position %x (global position %x)\n", streamIndex, static_cast<int>(objectType), static_cast<int>(revision), static_cast<int>(pos), static_cast<int>(pos + streamPos));
-			return;
+			fprintf(stderr, "Failed to map %s\n", mpxPath.c_str());
+			return false;
 		}
+	}
+
+	const std::string& mode = options.m_mode;
+	const size_t readAheadSize = options.m_readAheadSize;
+	const mtdisasm::ObjectTypeFilter* typeFilter = options.m_typeFilter;
+
+	if (mode == "index" || mode == "extract")
+	{
+		std::string indexPath = options.m_indexPath;
+		if (indexPath.empty())
+			indexPath = outputDir + "/objects.mtidx";
+
+		mtdisasm::ObjectIndex index;
+		bool indexWasCurrent = false;
+		if (!OpenObjectIndex(indexPath, catalog, segments, segmentStreams, sp, readAheadSize, options.m_printProgress, index, indexWasCurrent))
+			return false;
 
-		const bool succeeded = dataObject->Load(reader, revision, sp);
-		if (succeeded)
+		bool succeeded = true;
+		if (mode == "index")
 		{
-			uint32_t prevPos = stream.Tell();
-			ExtractAsset(assetIDs, *dataObject, globalStream, sp, basePath, segmentIndex, streamIndex);
-			if (!stream.SeekSet(prevPos))
-			{
-				fprintf(stderr, "Failed to reset stream position\n");
-				return;
-			}
+			if (indexWasCurrent && options.m_printProgress)
+				printf("Index is up to date\n");
 		}
 		else
-			fprintf(stderr, "Stream %i: Object type %s revision %i at position %x (global position %x) failed to load\n", streamIndex, NameObjectType(dataObject->GetType()), static_cast<int>(revision), static_cast<int>(pos), static_cast<int>(pos + streamPos));
+		{
+			std::unique_ptr<mtdisasm::AsyncReader> payloadReader;
+			if (options.m_useAsyncReads && !CreatePayloadReader(options.m_asyncReadEngine, segmentStreams, payloadReader))
+				return false;
 
-		dataObject->Delete();
+			succeeded = ExtractIndexedAssets(index, segmentStreams, options.m_assetIDs, sp, options.m_assetOptions, payloadReader.get(), outputDir);
+		}
 
-		if (!succeeded)
-			break;
+		return succeeded;
 	}
-}
 
-void DisassembleStream(mtdisasm::IOStream& stream, size_t streamSize, int streamIndex, uint32_t streamPos, const mtdisasm::SerializationProperties& sp, FILE* f)
-{
-	mtdisasm::DataReader reader(stream, sp.m_isByteSwapped);
+	std::string catalogText;
+	if (mode == "text")
+	{
+		mtdisasm::TextWriter catWriter(catalogText);
+		PrintCatalogDisassembly(catalog, catWriter);
+		catWriter.Flush();
+	}
 
-	for (;;)
+	std::unique_ptr<IncrementalUpdate> incrementalUpdate;
+	if (options.m_isIncremental)
 	{
-		uint32_t pos = stream.Tell();
-		if (pos == streamSize)
-			break;
+		mtdisasm::ExtractionSettings settings;
+		memset(&settings, 0, sizeof(settings));
+		settings.m_mode = (mode == "bin") ? mtdisasm::ExtractionMode::kBin : (mode == "text") ? mtdisasm::ExtractionMode::kText : mtdisasm::ExtractionMode::kAssets;
+		settings.m_systemType = static_cast<uint8_t>(sp.m_systemType);
+		settings.m_is112Compatible = sp.m_is112Compatible ? 1 : 0;
+		settings.m_isByteSwapped = sp.m_isByteSwapped ? 1 : 0;
+		settings.m_mtoonFrameMode = static_cast<uint8_t>(options.m_assetOptions.m_mtoonFrameMode);
+
+		// The level only changes the output of the png encoder
+		const mtdisasm::ImageEncoderOptions& imageEncoderOptions = options.m_assetOptions.m_imageEncoderOptions;
+		settings.m_imageEncoder = static_cast<uint8_t>(imageEncoderOptions.m_backend);
+		settings.m_imageLevel = (imageEncoderOptions.m_backend == mtdisasm::ImageEncoderBackend::kPNG) ? static_cast<uint8_t>(imageEncoderOptions.m_level) : 0;
+		settings.m_typeFilterHash = HashTypeFilter(typeFilter);
+
+		const uint64_t catalogHash = mtdisasm::ExtractionManifest::HashMemory(catalogText.data(), catalogText.size(), 0);
+
+		incrementalUpdate.reset(new IncrementalUpdate());
+		if (!BeginIncrementalUpdate(outputDir, catalog, segments, segmentStreams, settings, catalogHash, *incrementalUpdate))
+			return false;
+	}
 
-		uint32_t objectType = 0;
-		uint16_t revision = 0;
-		if (!reader.ReadU32(objectType) || !reader.ReadU16(revision))
-		{
-			fprintf(stderr, "Stream %i: Couldn't read type at stream position %x (global position %x)\n", streamIndex, static_cast<int>(pos), static_cast<int>(pos + streamPos));
-			return;
-		}
+	if (mode == "text")
+	{
+		std::string catPath = outputDir + "/catalog.txt";
 
-		mtdisasm::DataObject* dataObject = mtdisasm::CreateObjectFromType(objectType);
-		if (!dataObject)
+		if (!incrementalUpdate || incrementalUpdate->m_isCatalogChanged || !OutputFileExists(catPath))
 		{
-			fprintf(stderr, "Stream %i: Unknown object type %x revision %i at position %x (global position %x)\n", streamIndex, static_cast<int>(objectType), static_cast<int>(revision), static_cast<int>(pos), static_cast<int>(pos + streamPos));
-			return;
+			FILE* dumpF = fopen(catPath.c_str(), "wb");
+			if (!dumpF)
+			{
+				fprintf(stderr, "Failed to open catalog path '%s'", catPath.c_str());
+				return false;
+			}
+
+			fwrite(catalogText.data(), 1, catalogText.size(), dumpF);
+			fclose(dumpF);
 		}
+	}
+
+	const size_t numStreams = catalog.NumStreams();
+	outNumStreams = numStreams;
 
-		fprintf(f, "Pos=%x AbsPos=%x  %s (%x) rev %i:\n", static_cast<int>(pos), static_cast<int>(pos + streamPos), NameObjectType(dataObject->GetType()), static_cast<int>(objectType), static_cast<int>(revision));
+	if (options.m_printProgress)
+		printf("Unbundling %i streams...\n", static_cast<int>(numStreams));
 
-		const bool succeeded = dataObject->Load(reader, revision, sp);
-		if (succeeded)
+	// Declared so that the pool is shut down before the extractor its jobs use
+	std::unique_ptr<mtdisasm::AsyncReader> payloadReader;
+	std::unique_ptr<AssetExtractor> assetExtractor;
+	std::unique_ptr<mtdisasm::ThreadPool> assetPool;
+
+	if (mode == "assets")
+	{
+		if (options.m_useAsyncReads && !CreatePayloadReader(options.m_asyncReadEngine, segmentStreams, payloadReader))
+			return false;
+
+		if (options.m_numJobs > 1)
 		{
-			PrintObjectDisassembly(*dataObject, f);
+			assetPool.reset(new mtdisasm::ThreadPool(options.m_numJobs));
+			assetExtractor.reset(new AssetExtractor(sp, outputDir, options.m_assetOptions, *assetPool));
 		}
 		else
+			assetExtractor.reset(new AssetExtractor(sp, outputDir, options.m_assetOptions));
+
+		assetExtractor->SetAsyncReader(payloadReader.get());
+	}
+
+	std::vector<size_t> streamOrder;
+	if (options.m_usePhysicalOrder)
+		streamOrder = GetPhysicalStreamOrder(catalog);
+	else
+	{
+		for (size_t i = 0; i < numStreams; i++)
+			streamOrder.push_back(i);
+	}
+
+	if (incrementalUpdate)
+	{
+		std::vector<size_t> changedStreamOrder;
+		size_t numRescannedStreams = 0;
+		for (size_t i : streamOrder)
 		{
-			fprintf(stderr, "Stream %i: Object type %s revision %i at position %x (global position %x) failed to load\n", streamIndex, NameObjectType(dataObject->GetType()), static_cast<int>(revision), static_cast<int>(pos), static_cast<int>(pos + streamPos));
-			fprintf(f, "FAILED\n");
+			if (incrementalUpdate->m_isStreamChanged[i])
+				changedStreamOrder.push_back(i);
+			else if (incrementalUpdate->m_isStreamRescanned[i])
+				numRescannedStreams++;
 		}
 
-		dataObject->Delete();
+		if (options.m_printProgress)
+			printf("%i of %i streams changed since the last run, %i unchanged streams have changed assets\n", static_cast<int>(changedStreamOrder.size()), static_cast<int>(numStreams), static_cast<int>(numRescannedStreams));
 
-		fprintf(f, "\n");
+		if (assetExtractor)
+		{
+			assetExtractor->SetRetainedAssets(&incrementalUpdate->m_retainedAssets);
 
-		if (!succeeded)
-			break;
-	}
-}
+			// Only asset definitions are loaded from the rescanned streams, so their other
+			// outputs are left alone
+			mtdisasm::ObjectTypeFilter assetTypeFilter;
+			for (size_t typeIndex = 0; typeIndex < mtdisasm::kNumObjectTypes; typeIndex++)
+			{
+				if (g_objectTypeHandlers[typeIndex].m_isExtractableAsset && (!typeFilter || typeFilter->Contains(typeIndex)))
+					assetTypeFilter.Add(typeIndex);
+			}
 
-void PrintCatalogDisassembly(const mtdisasm::Catalog& cat, FILE* f)
-{
-	fprintf(f, "System desc: %i\n", static_cast<int>(cat.GetSystem()));
+			for (size_t i : streamOrder)
+			{
+				if (incrementalUpdate->m_isStreamChanged[i] || !incrementalUpdate->m_isStreamRescanned[i])
+					continue;
 
-	const mtdisasm::CatalogHeader& catHeader = cat.GetCatalogHeader();
-	PrintHex("Platform", catHeader.m_platform, f);
-	PrintHex("Unknown34", catHeader.m_unknown34, f);
+				const mtdisasm::StreamDesc& streamDesc = catalog.GetStream(i);
+				mtdisasm::IOStream& stream = *segmentStreams[streamDesc.m_segmentNumber - 1];
 
-	fprintf(f, "Streams:\n");
+				mtdisasm::SliceIOStream slice(stream, streamDesc.m_pos, streamDesc.m_size);
+				ExtractAssetsFromStream(*assetExtractor, stream, slice, streamDesc.m_size, static_cast<int>(streamDesc.m_segmentNumber), static_cast<int>(i), streamDesc.m_pos, sp, readAheadSize, &assetTypeFilter);
+			}
+		}
 
-	size_t numStreams = cat.NumStreams();
-	for (size_t i = 0; i < numStreams; i++)
-	{
-		const mtdisasm::StreamDesc& stream = cat.GetStream(i);
-		fprintf(f, "    Stream % 4i   Pos: %i  Size: %i  Segment: %i  Type: '%s'\n", static_cast<int>(i + 1), static_cast<int>(stream.m_pos), static_cast<int>(stream.m_size), static_cast<int>(stream.m_segmentNumber), stream.m_streamType);
+		streamOrder.swap(changedStreamOrder);
 	}
 
-	size_t numSegments = cat.NumSegments();
-
-	fprintf(f, "\nSegments:\n");
-	for (size_t i = 0; i < numSegments; i++)
+	if (mode == "json" || mode == "records")
 	{
-		const mtdisasm::SegmentDesc& seg = cat.GetSegment(i);
-		fprintf(f, "    Path: '%s'  Label: '%s'  SegmentID: %i\n", seg.m_exportedPath.c_str(), seg.m_label.c_str(), seg.m_segmentID);
+		const bool useBinaryRecords = (mode == "records");
+		const std::string outputPath = outputDir + (useBinaryRecords ? "/objects.mtrec" : "/objects.jsonl");
+
+		return SerializeStreams(catalog, segmentStreams, streamOrder, sp, outputPath, useBinaryRecords, readAheadSize, typeFilter);
 	}
-}
 
-int main(int argc, const char** argv)
-{
-	if (argc != 4)
+	if (mode == "text" && options.m_numJobs > 1)
 	{
-		fprintf(stderr, "Usage: unbundle <mode> <segment 1 path> <output dir>\n");
-		return -1;
+		if (!DisassembleStreamsParallel(catalog, segmentStreams, streamOrder, sp, outputDir, options.m_numJobs, readAheadSize, typeFilter))
+			return false;
 	}
+	else
+	{
+		for (size_t i : streamOrder)
+		{
+			const mtdisasm::StreamDesc& streamDesc = catalog.GetStream(i);
+			mtdisasm::IOStream& stream = *segmentStreams[streamDesc.m_segmentNumber - 1];
 
-	GenerateMacStandardPalette();
+			std::string streamPath;
+			if (!GetStreamOutputPath(outputDir, streamDesc, i, streamPath))
+				return false;
 
-	std::string mode = argv[1];
-	std::string seg1Path = argv[2];
-	std::string outputDir = argv[3];
-	bool is112Compat = false;
+			if (!stream.SeekSet(streamDesc.m_pos))
+			{
+				fprintf(stderr, "Failed to load stream\n");
+				return false;
+			}
 
-	if (mode != "bin" && mode != "text" && mode != "text112" && mode != "assets" && mode != "assets112")
-	{
-		fprintf(stderr, "Supported disassembly modes: bin, text, text112, assets, assets112\n");
-		return -1;
-	}
+			FILE* dumpF = fopen(streamPath.c_str(), "wb");
+			if (!dumpF)
+			{
+				fprintf(stderr, "Failed to open output path '%s'", streamPath.c_str());
+				return false;
+			}
 
-	if (mode == "text112")
-	{
-		mode = "text";
-		is112Compat = true;
+			if (mode == "bin")
+			{
+				if (!CopySegmentRange(stream, segments[streamDesc.m_segmentNumber - 1], streamDesc.m_pos, streamDesc.m_size, dumpF))
+				{
+					fprintf(stderr, "Failed to dump stream data at position %i\n", static_cast<int>(streamDesc.m_pos));
+					fclose(dumpF);
+					return false;
+				}
+			}
+			else if (mode == "text")
+			{
+				mtdisasm::TextWriter dumpWriter(dumpF);
+				DisassembleStreamWithHeader(stream, streamDesc, i, sp, readAheadSize, typeFilter, dumpWriter);
+				dumpWriter.Flush();
+			}
+			else if (mode == "assets")
+			{
+				fprintf(dumpF, "Stream %i   Segment: %i   Position in file: %x\n\n", static_cast<int>(i), static_cast<int>(streamDesc.m_segmentNumber), static_cast<int>(streamDesc.m_pos));
+
+				mtdisasm::SliceIOStream slice(stream, streamDesc.m_pos, streamDesc.m_size);
+				ExtractAssetsFromStream(*assetExtractor, stream, slice, streamDesc.m_size, static_cast<int>(streamDesc.m_segmentNumber), static_cast<int>(i), streamDesc.m_pos, sp, readAheadSize, typeFilter);
+			}
+			else
+			{
+				fprintf(stderr, "Unknown mode %s\n", mode.c_str());
+				fclose(dumpF);
+				return false;
+			}
+
+			fclose(dumpF);
+		}
 	}
 
-	if (mode == "assets112")
+	// Listed before the extractor takes its pending assets
+	std::vector<std::vector<mtdisasm::ExtractionManifestAsset>> foundAssets;
+	if (incrementalUpdate && assetExtractor)
+		assetExtractor->ListPendingAssets(numStreams, foundAssets);
+
+	if (assetExtractor)
+		assetExtractor->Flush();
+
+	if (assetPool)
+		assetPool->WaitForIdle();
+
+	std::unordered_set<uint32_t> failedAssets;
+	if (incrementalUpdate && assetExtractor)
+		assetExtractor->GetFailedAssets(failedAssets);
+
+	if (incrementalUpdate && !FinishIncrementalUpdate(*incrementalUpdate, catalog, segmentStreams, foundAssets, failedAssets))
+		return false;
+
+	return true;
+}
+
+// Reads one project path per line, skipping blank lines and lines starting with '#'
+bool ReadProjectList(const std::string& listPath, std::vector<std::string>& outPaths)
+{
+	FILE* listF = fopen(listPath.c_str(), "rb");
+	if (!listF)
 	{
-		mode = "assets";
-		is112Compat = true;
+		fprintf(stderr, "Failed to open project list '%s'\n", listPath.c_str());
+		return false;
 	}
 
-	if (seg1Path.size() < 5)
+	std::string line;
+	bool isEOF = false;
+	while (!isEOF)
 	{
-		fprintf(stderr, "Segment 1 path needs to end in .MPL");
-		return -1;
-	}
+		int c = fgetc(listF);
+		if (c == EOF)
+			isEOF = true;
+		else if (c != '\n')
+		{
+			line.push_back(static_cast<char>(c));
+			continue;
+		}
 
-	printf("Loading catalog...\n");
-	FILE* catFile = fopen(seg1Path.c_str(), "rb");
+		size_t start = line.find_first_not_of(" \t\r");
+		if (start != std::string::npos && line[start] != '#')
+		{
+			size_t end = line.find_last_not_of(" \t\r");
+			outPaths.push_back(line.substr(start, end - start + 1));
+		}
 
-	if (!catFile)
-	{
-		fprintf(stderr, "Failed to open catalog file\n");
-		return -1;
+		line.clear();
 	}
 
-	mtdisasm::CFileIOStream seg1Stream(catFile);
+	bool succeeded = (ferror(listF) == 0);
+	fclose(listF);
 
-	uint8_t systemCheck[2];
-	if (!seg1Stream.ReadAll(systemCheck, 2))
+	if (!succeeded)
+		fprintf(stderr, "Failed to read project list '%s'\n", listPath.c_str());
+
+	return succeeded;
+}
+
+// Names a project's output directory after its parent directory and file name, since
+// projects in different directories often share a file name
+std::string ProjectOutputDirName(const std::string& seg1Path)
+{
+	size_t nameStart = seg1Path.find_last_of("/\\");
+	std::string name = (nameStart == std::string::npos) ? seg1Path : seg1Path.substr(nameStart + 1);
+	std::string parentName;
+	if (nameStart != std::string::npos && nameStart > 0)
 	{
-		fprintf(stderr, "Failed to read system ID\n");
-		return -1;
+		size_t parentStart = seg1Path.find_last_of("/\\", nameStart - 1);
+		parentName = (parentStart == std::string::npos) ? seg1Path.substr(0, nameStart) : seg1Path.substr(parentStart + 1, nameStart - parentStart - 1);
 	}
 
+	size_t extPos = name.find_last_of('.');
+	if (extPos != std::string::npos && extPos > 0)
+		name = name.substr(0, extPos);
 
-	mtdisasm::SerializationProperties sp;
-	sp.m_is112Compatible = is112Compat;
+	if (parentName.empty() || parentName == "." || parentName == "..")
+		return name;
 
-	bool isBigEndian = false;
-	if (systemCheck[0] == 0 && systemCheck[1] == 0)
+	return parentName + "_" + name;
+}
+
+// Output directory names are compared this way since the output may be on a
+// case-insensitive file system
+std::string FoldDirNameCase(const std::string& dirName)
+{
+	std::string folded = dirName;
+	for (char& c : folded)
 	{
-		printf("Detected as Macintosh format\n");
-		isBigEndian = true;
-		sp.m_systemType = mtdisasm::SystemType::kMac;
+		if (c >= 'A' && c <= 'Z')
+			c = static_cast<char>(c - 'A' + 'a');
 	}
-	else if (systemCheck[0] == 1 && systemCheck[1] == 0)
+
+	return folded;
+}
+
+struct BatchProjectResult
+{
+	BatchProjectResult();
+
+	std::string m_seg1Path;
+	std::string m_outputDir;
+	bool m_succeeded;
+	size_t m_numStreams;
+	double m_seconds;
+};
+
+BatchProjectResult::BatchProjectResult()
+	: m_succeeded(false)
+	, m_numStreams(0)
+	, m_seconds(0.0)
+{
+}
+
+// Unbundles every project in a list file or every .MPL under a directory.  Projects run
+// concurrently on one pool with one worker each, since most of the work per project is in
+// a few large streams that don't benefit from more workers as much as the batch does.
+bool UnbundleBatch(const UnbundleOptions& options, const std::string& inputPath, const std::string& outputRoot)
+{
+	std::vector<std::string> seg1Paths;
+	if (mtdisasm::IsDirectory(inputPath))
 	{
-		printf("Detected as Windows format\n");
-		isBigEndian = false;
-		sp.m_systemType = mtdisasm::SystemType::kWindows;
+		if (!mtdisasm::FindFilesWithExtension(inputPath, ".mpl", seg1Paths))
+		{
+			fprintf(stderr, "Failed to scan directory '%s'\n", inputPath.c_str());
+			return false;
+		}
+
+		std::sort(seg1Paths.begin(), seg1Paths.end());
 	}
 	else
 	{
-		fprintf(stderr, "Unknown system value\n");
-		return -1;
+		if (!ReadProjectList(inputPath, seg1Paths))
+			return false;
 	}
 
-	uint32_t byteOrderCheckInt;
-	uint8_t byteOrderCheckBytes[4] = { 0, 0, 0, 1 };
-
-	memcpy(&byteOrderCheckInt, byteOrderCheckBytes, 4);
-
-	bool isSystemBigEndian = false;
-	if (byteOrderCheckInt == 1)
-		isSystemBigEndian = true;
-	else if (byteOrderCheckInt == 0x01000000)
-		isSystemBigEndian = false;
-	else
+	if (seg1Paths.empty())
 	{
-		fprintf(stderr, "Couldn't detect system endian\n");
-		return -1;
+		fprintf(stderr, "No projects found in '%s'\n", inputPath.c_str());
+		return false;
 	}
 
-	sp.m_isByteSwapped = (isSystemBigEndian != isBigEndian);
-
-	if (!seg1Stream.SeekSet(0))
+	if (!mtdisasm::MakeDirectory(outputRoot))
 	{
-		fprintf(stderr, "Failed to reposition to start\n");
-		return -1;
+		fprintf(stderr, "Failed to create output directory '%s'\n", outputRoot.c_str());
+		return false;
 	}
 
-	mtdisasm::DataReader dataReader(seg1Stream, sp.m_isByteSwapped);
-
-	dataReader.Seek(0);
+	const size_t numProjects = seg1Paths.size();
+	std::vector<BatchProjectResult> results(numProjects);
 
-	mtdisasm::Catalog catalog;
-	if (!catalog.Load(dataReader))
+	std::unordered_set<std::string> usedDirNames;
+	for (size_t i = 0; i < numProjects; i++)
 	{
-		fprintf(stderr, "Failed to load catalog\n");
-		return -1;
+		std::string dirName = ProjectOutputDirName(seg1Paths[i]);
+		std::string uniqueDirName = dirName;
+		for (int suffix = 2; usedDirNames.count(FoldDirNameCase(uniqueDirName)); suffix++)
+			uniqueDirName = dirName + "_" + std::to_string(suffix);
+
+		usedDirNames.insert(FoldDirNameCase(uniqueDirName));
+
+		results[i].m_seg1Path = seg1Paths[i];
+		results[i].m_outputDir = outputRoot + "/" + uniqueDirName;
 	}
 
-	std::vector<FILE*> segments;
-	size_t numSegments = catalog.NumSegments();
+	UnbundleOptions projectOptions = options;
+	projectOptions.m_numJobs = 1;
+	projectOptions.m_printProgress = false;
 
-	segments.resize(numSegments);
-	segments[0] = catFile;
+	printf("Unbundling %i projects...\n", static_cast<int>(numProjects));
 
-	bool isWinConvention = false;
-	if (numSegments > 1)
-	{
-		if (seg1Path[seg1Path.size() - 1] != '1')
-		{
-			isWinConvention = true;
-			if (seg1Path.size() < 5 || seg1Path[seg1Path.size() - 5] != '1' || seg1Path[seg1Path.size() - 4] != '.')
-			{
-				fprintf(stderr, "Couldn't figure out segment naming convention");
-				return -1;
-			}
-		}
-	}
+	std::mutex progressMutex;
+	size_t numFinished = 0;
+
+	std::chrono::steady_clock::time_point batchStartTime = std::chrono::steady_clock::now();
 
-	for (size_t i = 1; i < numSegments; i++)
 	{
-		std::string mpxPath;
-		if (isWinConvention)
-			mpxPath = seg1Path.substr(0, seg1Path.size() - 5) + std::to_string(i + 1) + ".MPX";
-		else
-			mpxPath = seg1Path.substr(0, seg1Path.size() - 1) + std::to_string(i + 1);
+		mtdisasm::ThreadPool pool(std::min(options.m_numJobs, numProjects));
 
-		segments[i] = fopen(mpxPath.c_str(), "rb");
-		if (!segments[i])
+		for (size_t i = 0; i < numProjects; i++)
 		{
-			fprintf(stderr, "Attempted to open %s but couldn't find it\n", mpxPath.c_str());
-			return -1;
-		}
-	}
+			BatchProjectResult* result = &results[i];
 
-	if (mode == "text")
-	{
-		std::string catPath = outputDir + "/catalog.txt";
+			pool.Submit([&projectOptions, &progressMutex, &numFinished, numProjects, result](size_t /*workerIndex*/)
+			{
+				std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
 
-		FILE* dumpF = fopen(catPath.c_str(), "wb");
-		if (!dumpF)
-		{
-			fprintf(stderr, "Failed to open catalog path '%s'", catPath.c_str());
-			return -1;
+				if (!mtdisasm::MakeDirectory(result->m_outputDir))
+					fprintf(stderr, "Failed to create output directory '%s'\n", result->m_outputDir.c_str());
+				else
+					result->m_succeeded = UnbundleProject(projectOptions, result->m_seg1Path, result->m_outputDir, result->m_numStreams);
+
+				result->m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+				std::lock_guard<std::mutex> lock(progressMutex);
+				numFinished++;
+				printf("[%i/%i] %s %s\n", static_cast<int>(numFinished), static_cast<int>(numProjects), result->m_succeeded ? "OK" : "FAILED", result->m_seg1Path.c_str());
+			});
 		}
 
-		PrintCatalogDisassembly(catalog, dumpF);
+		pool.WaitForIdle();
+	}
+
+	double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStartTime).count();
 
-		fclose(dumpF);
+	size_t numSucceeded = 0;
+	size_t totalStreams = 0;
+	for (const BatchProjectResult& result : results)
+	{
+		if (result.m_succeeded)
+			numSucceeded++;
+		totalStreams += result.m_numStreams;
 	}
 
-	const size_t numStreams = catalog.NumStreams();
+	std::string summaryPath = outputRoot + "/summary.txt";
+	FILE* summaryF = fopen(summaryPath.c_str(), "wb");
+	if (!summaryF)
+	{
+		fprintf(stderr, "Failed to open summary path '%s'\n", summaryPath.c_str());
+		return false;
+	}
 
-	printf("Unbundling %i streams...\n", static_cast<int>(numStreams));
+	fprintf(summaryF, "# status\tstreams\tseconds\tproject\toutput\n");
+	for (const BatchProjectResult& result : results)
+		fprintf(summaryF, "%s\t%i\t%.3f\t%s\t%s\n", result.m_succeeded ? "OK" : "FAILED", static_cast<int>(result.m_numStreams), result.m_seconds, result.m_seg1Path.c_str(), result.m_outputDir.c_str());
+	fprintf(summaryF, "# %i of %i projects succeeded, %i streams, %.3f seconds\n", static_cast<int>(numSucceeded), static_cast<int>(numProjects), static_cast<int>(totalStreams), batchSeconds);
 
-	std::unordered_set<uint32_t> extractedAssets;
+	bool summaryWritten = (fclose(summaryF) == 0);
+	if (!summaryWritten)
+		fprintf(stderr, "Failed to write summary '%s'\n", summaryPath.c_str());
 
-	for (size_t i = 0; i < numStreams; i++)
-	{
-		const mtdisasm::StreamDesc& streamDesc = catalog.GetStream(i);
+	printf("%i of %i projects succeeded, %i streams, %.3f seconds\n", static_cast<int>(numSucceeded), static_cast<int>(numProjects), static_cast<int>(totalStreams), batchSeconds);
 
-		std::string streamPath = outputDir + "/stream-" + std::to_string(i) + "-" + std::to_string(streamDesc.m_segmentNumber) + ".";
-		mtdisasm::CFileIOStream stream(segments[streamDesc.m_segmentNumber - 1]);
+	return summaryWritten && numSucceeded == numProjects;
+}
 
-		if (!strcmp(streamDesc.m_streamType, "assetStream"))
-			streamPath += "asset";
-		else if (!strcmp(streamDesc.m_streamType, "bootStream"))
-			streamPath += "boot";
-		else if (!strcmp(streamDesc.m_streamType, "sceneStream"))
-			streamPath += "scene";
-		else
+// The benchmark links this file for its decoders and provides its own main
+#ifndef MTDISASM_NO_MAIN
+int main(int argc, const char** argv)
+{
+	IOBackend ioBackend = kDefaultIOBackend;
+	size_t numJobs = 1;
+	size_t readAheadSize = kDefaultReadAheadSize;
+	bool printStats = false;
+	std::string indexPath;
+	std::unique_ptr<mtdisasm::ObjectTypeFilter> typeFilter;
+	std::vector<uint32_t> assetIDs;
+	bool usePhysicalOrder = true;
+	bool isBatch = false;
+	bool isIncremental = false;
+	MToonFrameMode mtoonFrameMode = MToonFrameMode::kFrames;
+	mtdisasm::ImageEncoderBackend imageEncoderBackend = mtdisasm::ImageEncoderBackend::kSTBPNG;
+	int imageLevel = 1;
+	bool useAsyncReads = true;
+	mtdisasm::AsyncReadEngine asyncReadEngine = mtdisasm::AsyncReadEngine::kAuto;
+
+	std::vector<std::string> positionalArgs;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "-io")
 		{
-			fprintf(stderr, "Unknown stream type '%s'\n", streamDesc.m_streamType);
-			return -1;
+			if (i + 1 == argc)
+			{
+				PrintUsage();
+				return -1;
+			}
+
+			std::string backendName = argv[++i];
+			if (backendName == "stdio")
+				ioBackend = IOBackend::kStdio;
+			else if (backendName == "mmap")
+				ioBackend = IOBackend::kMMap;
+			else if (backendName == "auto")
+				ioBackend = IOBackend::kAuto;
+			else
+			{
+				fprintf(stderr, "Supported I/O backends: stdio, mmap, auto\n");
+				return -1;
+			}
 		}
+		else if (arg == "-aio")
+		{
+			if (i + 1 == argc)
+			{
+				PrintUsage();
+				return -1;
+			}
 
-		if (!stream.SeekSet(streamDesc.m_pos))
+			std::string engineName = argv[++i];
+			useAsyncReads = true;
+			if (engineName == "auto")
+				asyncReadEngine = mtdisasm::AsyncReadEngine::kAuto;
+			else if (engineName == "uring")
+				asyncReadEngine = mtdisasm::AsyncReadEngine::kIOURing;
+			else if (engineName == "threads")
+				asyncReadEngine = mtdisasm::AsyncReadEngine::kThreads;
+			else if (engineName == "off")
+				useAsyncReads = false;
+			else
+			{
+				fprintf(stderr, "Supported asynchronous read engines: auto, uring, threads, off\n");
+				return -1;
+			}
+		}
+		else if (arg == "-asset" || arg == "--asset")
 		{
-			fprintf(stderr, "Failed to load stream\n");
-			return -1;
+			if (i + 1 == argc)
+			{
+				PrintUsage();
+				return -1;
+			}
+
+			if (!ParseAssetIDList(argv[++i], assetIDs))
+				return -1;
 		}
+		else if (arg == "-image")
+		{
+			if (i + 1 == argc)
+			{
+				PrintUsage();
+				return -1;
+			}
 
-		FILE* dumpF = fopen(streamPath.c_str(), "wb");
-		if (!dumpF)
+			std::string encoderName = argv[++i];
+			if (encoderName == "stb")
+				imageEncoderBackend = mtdisasm::ImageEncoderBackend::kSTBPNG;
+			else if (encoderName == "png")
+				imageEncoderBackend = mtdisasm::ImageEncoderBackend::kPNG;
+			else if (encoderName == "pnm")
+				imageEncoderBackend = mtdisasm::ImageEncoderBackend::kPNM;
+			else if (encoderName == "qoi")
+				imageEncoderBackend = mtdisasm::ImageEncoderBackend::kQOI;
+			else
+			{
+				fprintf(stderr, "Supported image encoders: stb, png, pnm, qoi\n");
+				return -1;
+			}
+		}
+		else if (arg == "-imagelevel")
 		{
-			fprintf(stderr, "Failed to open output path '%s'", streamPath.c_str());
-			return -1;
+			if (i + 1 == argc)
+			{
+				PrintUsage();
+				return -1;
+			}
+
+			const char* levelStr = argv[++i];
+			char* levelEnd = nullptr;
+			long level = strtol(levelStr, &levelEnd, 10);
+			if (levelEnd == levelStr || *levelEnd != '\0' || level < 0 || level > mtdisasm::ImageEncoderOptions::kMaxLevel)
+			{
+				fprintf(stderr, "Image level must be from 0 to %i\n", mtdisasm::ImageEncoderOptions::kMaxLevel);
+				return -1;
+			}
+
+			imageLevel = static_cast<int>(level);
 		}
+		else if (arg == "-index")
+		{
+			if (i + 1 == argc)
+			{
+				PrintUsage();
+				return -1;
+			}
 
-		if (mode == "bin")
+			indexPath = argv[++i];
+		}
+		else if (arg == "-j")
 		{
-			mtdisasm::CFileIOStream outStream(dumpF);
+			if (i + 1 == argc)
+			{
+				PrintUsage();
+				return -1;
+			}
 
-			uint8_t copyBuffer[2048];
-			size_t bytesRemaining = streamDesc.m_size;
-			while (bytesRemaining > 0)
+			int jobs = atoi(argv[++i]);
+			if (jobs < 1)
 			{
-				size_t chunkSize = bytesRemaining;
-				if (chunkSize > sizeof(copyBuffer))
-					chunkSize = sizeof(copyBuffer);
+				fprintf(stderr, "Job count must be at least 1\n");
+				return -1;
+			}
 
-				bytesRemaining -= chunkSize;
+			numJobs = static_cast<size_t>(jobs);
+		}
+		else if (arg == "-mtoon")
+		{
+			if (i + 1 == argc)
+			{
+				PrintUsage();
+				return -1;
+			}
 
-				if (!stream.ReadAll(copyBuffer, chunkSize) || !outStream.WriteAll(copyBuffer, chunkSize))
-				{
-					fprintf(stderr, "Failed to dump stream data at position %i\n", static_cast<int>(stream.Tell()));
-					return -1;
-				}
+			std::string frameModeName = argv[++i];
+			if (frameModeName == "frames")
+				mtoonFrameMode = MToonFrameMode::kFrames;
+			else if (frameModeName == "composite")
+				mtoonFrameMode = MToonFrameMode::kComposite;
+			else if (frameModeName == "atlas")
+				mtoonFrameMode = MToonFrameMode::kAtlas;
+			else
+			{
+				fprintf(stderr, "Supported mToon frame modes: frames, composite, atlas\n");
+				return -1;
 			}
 		}
-		else if (mode == "text")
+		else if (arg == "-order")
 		{
-			fprintf(dumpF, "Stream %i   Segment: %i   Position in file: %x\n\n", static_cast<int>(i), static_cast<int>(streamDesc.m_segmentNumber), static_cast<int>(streamDesc.m_pos));
+			if (i + 1 == argc)
+			{
+				PrintUsage();
+				return -1;
+			}
 
-			mtdisasm::SliceIOStream slice(stream, streamDesc.m_pos, streamDesc.m_size);
-			DisassembleStream(slice, streamDesc.m_size, static_cast<int>(i), streamDesc.m_pos, sp, dumpF);
+			std::string orderName = argv[++i];
+			if (orderName == "catalog")
+				usePhysicalOrder = false;
+			else if (orderName == "physical")
+				usePhysicalOrder = true;
+			else
+			{
+				fprintf(stderr, "Supported stream orders: catalog, physical\n");
+				return -1;
+			}
 		}
-		else if (mode == "assets")
+		else if (arg == "-readahead")
 		{
-			fprintf(dumpF, "Stream %i   Segment: %i   Position in file: %x\n\n", static_cast<int>(i), static_cast<int>(streamDesc.m_segmentNumber), static_cast<int>(streamDesc.m_pos));
+			if (i + 1 == argc)
+			{
+				PrintUsage();
+				return -1;
+			}
 
-			mtdisasm::SliceIOStream slice(stream, streamDesc.m_pos, streamDesc.m_size);
-			ExtractAssetsFromStream(extractedAssets, stream, slice, streamDesc.m_size, static_cast<int>(streamDesc.m_segmentNumber), static_cast<int>(i), streamDesc.m_pos, sp, outputDir);
+			int readAheadMiB = atoi(argv[++i]);
+			if (readAheadMiB < 0 || static_cast<size_t>(readAheadMiB) > kMaxReadAheadMiB)
+			{
+				fprintf(stderr, "Read-ahead size must be between 0 and %i MiB\n", static_cast<int>(kMaxReadAheadMiB));
+				return -1;
+			}
+
+			readAheadSize = static_cast<size_t>(readAheadMiB) * 1024 * 1024;
 		}
-		else
+		else if (arg == "-batch")
+			isBatch = true;
+		else if (arg == "-incremental")
+			isIncremental = true;
+		else if (arg == "-stats")
+			printStats = true;
+		else if (arg == "-types")
+		{
+			if (i + 1 == argc)
+			{
+				PrintUsage();
+				return -1;
+			}
+
+			typeFilter.reset(new mtdisasm::ObjectTypeFilter());
+			if (!ParseObjectTypeFilter(argv[++i], *typeFilter))
+				return -1;
+		}
+		else if (arg.size() > 1 && arg[0] == '-')
 		{
-			fprintf(stderr, "Unknown mode %s\n", mode.c_str());
+			fprintf(stderr, "Unknown option '%s'\n", arg.c_str());
+			PrintUsage();
 			return -1;
 		}
+		else
+			positionalArgs.push_back(arg);
+	}
+
+	if (positionalArgs.size() != 3)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	GenerateMacStandardPalette();
+
+	std::string mode = positionalArgs[0];
+	std::string outputDir = positionalArgs[2];
+	bool is112Compat = false;
+
+	if (mode != "bin" && mode != "text" && mode != "text112" && mode != "json" && mode != "json112" && mode != "records" && mode != "records112" && mode != "assets" && mode != "assets112" && mode != "index" && mode != "index112" && mode != "extract" && mode != "extract112")
+	{
+		fprintf(stderr, "Supported disassembly modes: bin, text, text112, json, json112, records, records112, assets, assets112, index, index112, extract, extract112\n");
+		return -1;
+	}
 
-		fclose(dumpF);
+	if (mode == "text112")
+	{
+		mode = "text";
+		is112Compat = true;
 	}
 
-	for (FILE* f : segments)
+	if (mode == "json112")
 	{
-		fclose(f);
+		mode = "json";
+		is112Compat = true;
 	}
 
-	return 0;
+	if (mode == "records112")
+	{
+		mode = "records";
+		is112Compat = true;
+	}
+
+	if (mode == "assets112")
+	{
+		mode = "assets";
+		is112Compat = true;
+	}
+
+	if (mode == "index112")
+	{
+		mode = "index";
+		is112Compat = true;
+	}
+
+	if (mode == "extract112")
+	{
+		mode = "extract";
+		is112Compat = true;
+	}
+
+	if (mode == "extract" && assetIDs.empty())
+	{
+		fprintf(stderr, "Extract mode requires -asset\n");
+		return -1;
+	}
+
+	if (isBatch && (mode == "extract" || !indexPath.empty()))
+	{
+		fprintf(stderr, "Batch mode doesn't support extract mode or -index\n");
+		return -1;
+	}
+
+	if (isIncremental && mode != "bin" && mode != "text" && mode != "assets")
+	{
+		fprintf(stderr, "-incremental only supports bin, text, and assets modes\n");
+		return -1;
+	}
+
+	UnbundleOptions options;
+	options.m_mode = mode;
+	options.m_is112Compatible = is112Compat;
+	options.m_ioBackend = ioBackend;
+	options.m_numJobs = numJobs;
+	options.m_readAheadSize = readAheadSize;
+	options.m_usePhysicalOrder = usePhysicalOrder;
+	options.m_printProgress = !isBatch;
+	options.m_indexPath = indexPath;
+	options.m_typeFilter = typeFilter.get();
+	options.m_assetIDs = assetIDs;
+	options.m_useAsyncReads = useAsyncReads;
+	options.m_asyncReadEngine = asyncReadEngine;
+	options.m_isIncremental = isIncremental;
+	options.m_assetOptions.m_mtoonFrameMode = mtoonFrameMode;
+	options.m_assetOptions.m_imageEncoderOptions.m_backend = imageEncoderBackend;
+	options.m_assetOptions.m_imageEncoderOptions.m_level = imageLevel;
+
+	// Shared by the asset extractions so that encoders only add threads while some of the
+	// -j threads are idle, such as when a large image is the last asset left
+	mtdisasm::ThreadBudget threadBudget(numJobs);
+	options.m_assetOptions.m_imageEncoderOptions.m_numThreads = numJobs;
+	options.m_assetOptions.m_imageEncoderOptions.m_threadBudget = &threadBudget;
+
+	bool succeeded = false;
+	if (isBatch)
+		succeeded = UnbundleBatch(options, positionalArgs[1], outputDir);
+	else
+	{
+		size_t numStreams = 0;
+		succeeded = UnbundleProject(options, positionalArgs[1], outputDir, numStreams);
+	}
+
+	if (printStats)
+		PrintObjectTypeCounts();
+
+	return succeeded ? 0 : -1;
 }
+#endif
@@ -0,0 +1,118 @@
+#include "MToonCompositor.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mtdisasm
+{
+	bool MToonCanvasRect::IsEmpty() const
+	{
+		return m_left >= m_right || m_top >= m_bottom;
+	}
+
+	MToonCompositor::MToonCompositor()
+		: m_width(0)
+		, m_height(0)
+		, m_isFirstFrame(true)
+		, m_frameWidth(0)
+		, m_frameHeight(0)
+	{
+	}
+
+	void MToonCompositor::Reset(size_t width, size_t height)
+	{
+		m_width = width;
+		m_height = height;
+		m_isFirstFrame = true;
+
+		m_canvas.assign(width * height * 4, 0);
+	}
+
+	MToonRLESurface MToonCompositor::BeginFrame(size_t width, size_t height, bool isBottomUp)
+	{
+		m_frameWidth = width;
+		m_frameHeight = height;
+
+		m_frame.assign(width * height * 4, 0);
+
+		return MakeMToonRLESurface(m_frame.data(), width, height, width * 4, MToonRLEPixelFormat::kRGBA32, isBottomUp);
+	}
+
+	MToonCanvasRect MToonCompositor::EndFrame(ptrdiff_t left, ptrdiff_t top, bool isKeyframe)
+	{
+		MToonCanvasRect dirtyRect = { m_width, m_height, 0, 0 };
+
+		if (isKeyframe)
+			std::fill(m_canvas.begin(), m_canvas.end(), 0);
+
+		// Canvas columns and rows covered by the frame
+		const ptrdiff_t canvasWidth = static_cast<ptrdiff_t>(m_width);
+		const ptrdiff_t canvasHeight = static_cast<ptrdiff_t>(m_height);
+		const size_t startX = static_cast<size_t>(std::min(std::max<ptrdiff_t>(left, 0), canvasWidth));
+		const size_t startY = static_cast<size_t>(std::min(std::max<ptrdiff_t>(top, 0), canvasHeight));
+		const size_t endX = static_cast<size_t>(std::max(std::min(left + static_cast<ptrdiff_t>(m_frameWidth), canvasWidth), static_cast<ptrdiff_t>(startX)));
+		size_t endY = static_cast<size_t>(std::max(std::min(top + static_cast<ptrdiff_t>(m_frameHeight), canvasHeight), static_cast<ptrdiff_t>(startY)));
+
+		if (startX == endX)
+			endY = startY;
+
+		for (size_t y = startY; y < endY; y++)
+		{
+			const size_t frameX = static_cast<size_t>(static_cast<ptrdiff_t>(startX) - left);
+			const size_t frameY = static_cast<size_t>(static_cast<ptrdiff_t>(y) - top);
+
+			const uint8_t* src = &m_frame[(frameY * m_frameWidth + frameX) * 4];
+			uint8_t* dest = &m_canvas[(y * m_width + startX) * 4];
+
+			size_t firstChanged = endX;
+			size_t lastChanged = 0;
+			for (size_t x = startX; x < endX; x++, src += 4, dest += 4)
+			{
+				if (src[3] == 0 || !memcmp(src, dest, 4))
+					continue;
+
+				memcpy(dest, src, 4);
+				if (firstChanged == endX)
+					firstChanged = x;
+				lastChanged = x;
+			}
+
+			if (firstChanged != endX)
+			{
+				dirtyRect.m_left = std::min(dirtyRect.m_left, firstChanged);
+				dirtyRect.m_right = std::max(dirtyRect.m_right, lastChanged + 1);
+				dirtyRect.m_top = std::min(dirtyRect.m_top, y);
+				dirtyRect.m_bottom = y + 1;
+			}
+		}
+
+		if (isKeyframe || m_isFirstFrame)
+		{
+			dirtyRect.m_left = 0;
+			dirtyRect.m_top = 0;
+			dirtyRect.m_right = m_width;
+			dirtyRect.m_bottom = m_height;
+		}
+		else if (dirtyRect.IsEmpty())
+			dirtyRect.m_left = dirtyRect.m_top = dirtyRect.m_right = dirtyRect.m_bottom = 0;
+
+		m_isFirstFrame = false;
+
+		return dirtyRect;
+	}
+
+	size_t MToonCompositor::GetWidth() const
+	{
+		return m_width;
+	}
+
+	size_t MToonCompositor::GetHeight() const
+	{
+		return m_height;
+	}
+
+	const uint8_t* MToonCompositor::GetPixels() const
+	{
+		return m_canvas.data();
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MToonRLEDecoder.h"
+
+namespace mtdisasm
+{
+	struct MToonCanvasRect
+	{
+		size_t m_left;
+		size_t m_top;
+		size_t m_right;
+		size_t m_bottom;
+
+		bool IsEmpty() const;
+	};
+
+	// Rebuilds the frames of a temporally compressed mToon on a persistent RGBA canvas the
+	// size of the mToon's rect.  Each frame is decoded into a surface from BeginFrame and
+	// drawn over the canvas by EndFrame.  Keyframes replace the whole canvas, and pixels
+	// that delta frames skip keep the previous frame's colors.
+	//
+	// Decoded pixels are always opaque, so pixels still at alpha 0 in the frame surface are
+	// the ones that the frame skipped.
+	class MToonCompositor
+	{
+	public:
+		MToonCompositor();
+
+		// Clears the canvas to transparent
+		void Reset(size_t width, size_t height);
+
+		// Returns a cleared RGBA surface for decoding a frame of this size
+		MToonRLESurface BeginFrame(size_t width, size_t height, bool isBottomUp);
+
+		// Draws the decoded frame with its top-left corner at (left, top) on the canvas,
+		// clipped to the canvas, and returns the rect of the canvas pixels that changed.
+		// The first frame after a reset and keyframes report the whole canvas.
+		MToonCanvasRect EndFrame(ptrdiff_t left, ptrdiff_t top, bool isKeyframe);
+
+		size_t GetWidth() const;
+		size_t GetHeight() const;
+		const uint8_t* GetPixels() const;	// Top-down, 4 bytes per pixel with no row padding
+
+	private:
+		std::vector<uint8_t> m_canvas;
+		size_t m_width;
+		size_t m_height;
+		bool m_isFirstFrame;
+
+		std::vector<uint8_t> m_frame;
+		size_t m_frameWidth;
+		size_t m_frameHeight;
+	};
+}
@@ -0,0 +1,258 @@
+#include "MToonRLEDecoder.h"
+
+#include "PixelConvert.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mtdisasm
+{
+	namespace
+	{
+		inline uint32_t ReadBE32(const uint8_t* bytes)
+		{
+			return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) | (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
+		}
+
+		template<bool TBigEndian>
+		inline uint16_t ReadWord(const uint8_t* bytes)
+		{
+			if (TBigEndian)
+				return static_cast<uint16_t>((bytes[0] << 8) | bytes[1]);
+			else
+				return static_cast<uint16_t>((bytes[1] << 8) | bytes[0]);
+		}
+
+		inline uint8_t* GetRow(const MToonRLESurface& surface, size_t row)
+		{
+			return surface.m_firstRow + static_cast<ptrdiff_t>(row) * surface.m_pitch;
+		}
+
+		// Fills count pixels with one RGBA value, 4 pixels per store
+		inline void FillRGBA32(uint8_t* dest, const uint8_t* rgba, size_t count)
+		{
+			uint8_t pattern[16];
+			for (size_t i = 0; i < 16; i += 4)
+				memcpy(pattern + i, rgba, 4);
+
+			size_t x = 0;
+			for (; x + 4 <= count; x += 4)
+				memcpy(dest + x * 4, pattern, 16);
+
+			for (; x < count; x++)
+				memcpy(dest + x * 4, rgba, 4);
+		}
+	}
+
+	MToonRLESurface MakeMToonRLESurface(uint8_t* pixels, size_t width, size_t height, size_t bytesPerRow, MToonRLEPixelFormat format, bool isBottomUp)
+	{
+		MToonRLESurface surface;
+		surface.m_firstRow = pixels;
+		surface.m_pitch = static_cast<ptrdiff_t>(bytesPerRow);
+		surface.m_width = width;
+		surface.m_height = height;
+		surface.m_format = format;
+
+		if (isBottomUp && height > 0)
+		{
+			surface.m_firstRow = pixels + (height - 1) * bytesPerRow;
+			surface.m_pitch = -surface.m_pitch;
+		}
+
+		return surface;
+	}
+
+	MToonRLEDecoder::MToonRLEDecoder()
+		: m_converters(GetPixelRowConverters(PixelConvertISA::kAuto))
+		, m_palette(nullptr)
+		, m_keepTransparentPixels(false)
+	{
+	}
+
+	void MToonRLEDecoder::SetPalette(const uint32_t* palette)
+	{
+		m_palette = palette;
+	}
+
+	void MToonRLEDecoder::SetKeepTransparentPixels(bool keepTransparentPixels)
+	{
+		m_keepTransparentPixels = keepTransparentPixels;
+	}
+
+	bool MToonRLEDecoder::ReadFrameHeader(const uint8_t* data, size_t size, MToonRLEFrameHeader& outHeader)
+	{
+		if (size < kFrameHeaderSize)
+			return false;
+
+		outHeader.m_signature = ReadBE32(data + 0);
+		outHeader.m_format = ReadBE32(data + 4);
+		outHeader.m_width = ReadBE32(data + 8);
+		outHeader.m_height = ReadBE32(data + 12);
+		outHeader.m_size = ReadBE32(data + 16);
+		return true;
+	}
+
+	bool MToonRLEDecoder::DecodeFrame8(const uint8_t* data, size_t size, bool isKeyframe, const MToonRLESurface& surface) const
+	{
+		const bool isRGBA = (surface.m_format == MToonRLEPixelFormat::kRGBA32);
+		const size_t bytesPerPixel = isRGBA ? 4 : 1;
+		const size_t width = surface.m_width;
+
+		if (isRGBA && !m_palette)
+			return false;
+
+		size_t pos = 0;
+		for (size_t row = 0; row < surface.m_height; row++)
+		{
+			uint8_t* rowPixels = GetRow(surface, row);
+
+			for (size_t col = 0; col < width; )
+			{
+				if (pos == size)
+					return true;
+
+				const uint8_t rleCode = data[pos++];
+				if (rleCode == 0 && !isKeyframe)
+				{
+					if (pos == size)
+						return false;
+
+					const uint8_t numTransparent = data[pos++];
+					if (numTransparent & 0x80)
+					{
+						// Appears to be vertical displacement...?
+						row += (numTransparent & 0x7f) - 1;
+						break;
+					}
+
+					// Last row transparent run sometimes overruns the end of the buffer...
+					const size_t numPixels = std::min<size_t>(numTransparent, width - col);
+					if (!m_keepTransparentPixels)
+						memset(rowPixels + col * bytesPerPixel, 0, numPixels * bytesPerPixel);
+					col += numPixels;
+				}
+				else if (rleCode & 0x80)
+				{
+					const size_t numLiterals = rleCode & 0x7f;
+					if (numLiterals > size - pos)
+						return false;
+
+					const size_t numPixels = std::min(numLiterals, width - col);
+					if (isRGBA)
+						m_converters->m_convertIndexed8ToRGBA32(data + pos, rowPixels + col * 4, numPixels, m_palette);
+					else
+						memcpy(rowPixels + col, data + pos, numPixels);
+
+					pos += numLiterals;
+					col += numPixels;
+				}
+				else
+				{
+					// Keyframes have no transparent runs, so a 0 code there is an empty repeat
+					if (pos == size)
+						return false;
+
+					const uint8_t repeatedByte = data[pos++];
+					const size_t numPixels = std::min<size_t>(rleCode, width - col);
+					if (isRGBA)
+						FillRGBA32(rowPixels + col * 4, reinterpret_cast<const uint8_t*>(&m_palette[repeatedByte]), numPixels);
+					else
+						memset(rowPixels + col, repeatedByte, numPixels);
+
+					col += numPixels;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool MToonRLEDecoder::DecodeFrame16(const uint8_t* data, size_t size, bool isBigEndian, const MToonRLESurface& surface) const
+	{
+		if (surface.m_format != MToonRLEPixelFormat::kRGBA32)
+			return false;
+
+		if (isBigEndian)
+			return DecodeFrame16Words<true>(data, size / 2, surface);
+		else
+			return DecodeFrame16Words<false>(data, size / 2, surface);
+	}
+
+	template<bool TBigEndian>
+	bool MToonRLEDecoder::DecodeFrame16Words(const uint8_t* data, size_t numWords, const MToonRLESurface& surface) const
+	{
+		static const uint8_t kMissingColor[4] = { 255, 0, 255, 255 };
+
+		void (*convertLiterals)(const uint8_t* src, uint8_t* dest, size_t width) = TBigEndian ? m_converters->m_convertRGB555BEToRGBA32 : m_converters->m_convertRGB555LEToRGBA32;
+
+		const size_t width = surface.m_width;
+
+		size_t pos = 0;
+		for (size_t row = 0; row < surface.m_height; row++)
+		{
+			uint8_t* rowPixels = GetRow(surface, row);
+
+			for (size_t col = 0; col < width; )
+			{
+				if (pos == numWords)
+					return true;
+
+				const uint16_t rleCode = ReadWord<TBigEndian>(data + pos * 2);
+				pos++;
+
+				if (rleCode == 0)
+				{
+					if (pos == numWords)
+						return false;
+
+					const uint16_t numTransparent = ReadWord<TBigEndian>(data + pos * 2);
+					pos++;
+
+					if (numTransparent & 0x8000)
+					{
+						// Appears to be vertical displacement...?
+						row += (numTransparent & 0x7fff) - 1;
+						break;
+					}
+
+					// Last row transparent run sometimes overruns the end of the buffer...
+					const size_t numPixels = std::min<size_t>(numTransparent, width - col);
+					if (!m_keepTransparentPixels)
+						memset(rowPixels + col * 4, 0, numPixels * 4);
+					col += numPixels;
+				}
+				else if (rleCode & 0x8000)
+				{
+					const size_t numLiterals = rleCode & 0x7fff;
+					if (numLiterals > numWords - pos)
+						return false;
+
+					const size_t numPixels = std::min(numLiterals, width - col);
+					convertLiterals(data + pos * 2, rowPixels + col * 4, numPixels);
+
+					pos += numLiterals;
+					col += numPixels;
+				}
+				else
+				{
+					if (pos == numWords)
+					{
+						// Marks the rest of the row so the missing value is visible
+						FillRGBA32(rowPixels + col * 4, kMissingColor, width - col);
+						return false;
+					}
+
+					uint8_t color[4];
+					convertLiterals(data + pos * 2, color, 1);
+					pos++;
+
+					const size_t numPixels = std::min<size_t>(rleCode, width - col);
+					FillRGBA32(rowPixels + col * 4, color, numPixels);
+					col += numPixels;
+				}
+			}
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mtdisasm
+{
+	struct PixelRowConverters;
+
+	enum class MToonRLEPixelFormat
+	{
+		kIndexed8,		// Palette indices, for 8-bit frames only
+		kRGBA32,		// R, G, B, A bytes in memory order
+	};
+
+	// Pixels that a frame is decoded into.  m_pitch is the distance in bytes from the start of
+	// one row to the next and is negative for surfaces stored bottom-up.
+	struct MToonRLESurface
+	{
+		uint8_t* m_firstRow;
+		ptrdiff_t m_pitch;
+		size_t m_width;
+		size_t m_height;
+		MToonRLEPixelFormat m_format;
+	};
+
+	// Describes top-down pixels, flipped if the frame is stored bottom-up
+	MToonRLESurface MakeMToonRLESurface(uint8_t* pixels, size_t width, size_t height, size_t bytesPerRow, MToonRLEPixelFormat format, bool isBottomUp);
+
+	// The big endian header at the start of each RLE frame
+	struct MToonRLEFrameHeader
+	{
+		uint32_t m_signature;	// kKeyframeSignature for keyframes, 1 otherwise
+		uint32_t m_format;		// k8BitFormat or k16BitFormat
+		uint32_t m_width;
+		uint32_t m_height;
+		uint32_t m_size;		// Including the header in 8-bit frames but not always in 16-bit frames
+	};
+
+	// Decodes mToon '.RLE' frames straight from the frame data.  Every run is checked against
+	// the end of the data once, and runs that overrun the end of a row are clipped to it.
+	//
+	// Delta frames skip pixels with transparent runs, which are cleared to 0 unless the
+	// decoder keeps them, so that a delta frame can be drawn over the frame before it.
+	class MToonRLEDecoder
+	{
+	public:
+		MToonRLEDecoder();
+
+		// 256 entries of R, G, B, A bytes in memory order, for 8-bit frames decoded to RGBA
+		void SetPalette(const uint32_t* palette);
+		void SetKeepTransparentPixels(bool keepTransparentPixels);
+
+		static bool ReadFrameHeader(const uint8_t* data, size_t size, MToonRLEFrameHeader& outHeader);
+
+		// Decodes the RLE data after the frame header.  Data that ends before the surface is
+		// filled leaves the rest of it untouched.  Returns false if a run is cut off by the end
+		// of the data, after decoding everything before it, or if the surface format isn't
+		// supported for the frame.
+		bool DecodeFrame8(const uint8_t* data, size_t size, bool isKeyframe, const MToonRLESurface& surface) const;
+		bool DecodeFrame16(const uint8_t* data, size_t size, bool isBigEndian, const MToonRLESurface& surface) const;
+
+		static const uint32_t kKeyframeSignature = 0x524c4520;	// 'RLE '
+		static const uint32_t k8BitFormat = 0x01000001;
+		static const uint32_t k16BitFormat = 0x01000002;
+		static const size_t kFrameHeaderSize = 20;
+
+	private:
+		template<bool TBigEndian>
+		bool DecodeFrame16Words(const uint8_t* data, size_t numWords, const MToonRLESurface& surface) const;
+
+		const PixelRowConverters* m_converters;
+		const uint32_t* m_palette;
+		bool m_keepTransparentPixels;
+	};
+}
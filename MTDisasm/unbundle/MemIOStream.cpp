@@ -28,6 +28,20 @@ namespace mtdisasm
 		return 0;
 	}
 
+	size_t MemIOStream::ReadAtPartial(uint32_t pos, void* dest, size_t sz) const
+	{
+		if (pos >= m_size)
+			return 0;
+
+		size_t available = m_size - pos;
+		if (available < sz)
+			sz = available;
+
+		memcpy(dest, static_cast<const char*>(m_buf) + pos, sz);
+
+		return sz;
+	}
+
 	bool MemIOStream::SeekSet(int32_t pos)
 	{
 		if (pos < 0)
@@ -61,4 +75,12 @@ namespace mtdisasm
 	{
 		return m_pos;
 	}
+
+	bool MemIOStream::GetContiguousSpan(const void*& outData, size_t& outSize, uint32_t& outGlobalBase) const
+	{
+		outData = m_buf;
+		outSize = m_size;
+		outGlobalBase = 0;
+		return true;
+	}
 }
@@ -11,6 +11,7 @@ namespace mtdisasm
 
 		size_t ReadPartial(void* dest, size_t sz) override;
 		size_t WritePartial(const void* src, size_t sz) override;
+		size_t ReadAtPartial(uint32_t pos, void* dest, size_t sz) const override;
 
 		bool SeekSet(int32_t pos) override;
 		bool SeekCur(int32_t pos) override;
@@ -19,6 +20,8 @@ namespace mtdisasm
 		uint32_t Tell() const override;
 		uint32_t TellGlobal() const override;
 
+		bool GetContiguousSpan(const void*& outData, size_t& outSize, uint32_t& outGlobalBase) const override;
+
 	private:
 		const void* m_buf;
 		size_t m_size;
@@ -0,0 +1,125 @@
+#include "ObjectArena.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace mtdisasm
+{
+	namespace
+	{
+		thread_local ObjectArena* t_currentArena = nullptr;
+
+		// ArenaAllocated blocks are prefixed with the arena they came from, or null if they
+		// came from the heap, padded to keep the object maximally aligned.
+		const size_t kAllocationHeaderSize = alignof(std::max_align_t) < sizeof(ObjectArena*) ? sizeof(ObjectArena*) : alignof(std::max_align_t);
+
+		void* AllocateWithHeader(size_t size)
+		{
+			if (size > SIZE_MAX - kAllocationHeaderSize)
+				throw std::bad_alloc();
+
+			ObjectArena* arena = t_currentArena;
+
+			uint8_t* block = nullptr;
+			if (arena)
+				block = static_cast<uint8_t*>(arena->Allocate(size + kAllocationHeaderSize, alignof(std::max_align_t)));
+			else
+				block = static_cast<uint8_t*>(::operator new(size + kAllocationHeaderSize));
+
+			*reinterpret_cast<ObjectArena**>(block) = arena;
+			return block + kAllocationHeaderSize;
+		}
+
+		void FreeWithHeader(void* ptr)
+		{
+			if (!ptr)
+				return;
+
+			uint8_t* block = static_cast<uint8_t*>(ptr) - kAllocationHeaderSize;
+			if (*reinterpret_cast<ObjectArena**>(block) == nullptr)
+				::operator delete(block);
+		}
+	}
+
+	ObjectArena::Scope::Scope(ObjectArena& arena)
+		: m_prevArena(t_currentArena)
+	{
+		t_currentArena = &arena;
+	}
+
+	ObjectArena::Scope::~Scope()
+	{
+		t_currentArena = m_prevArena;
+	}
+
+	ObjectArena::ObjectArena()
+		: m_blockCursor(nullptr)
+		, m_blockEnd(nullptr)
+	{
+	}
+
+	ObjectArena::~ObjectArena()
+	{
+		for (void* block : m_blocks)
+			free(block);
+	}
+
+	void* ObjectArena::Allocate(size_t size, size_t alignment)
+	{
+		if (size == 0)
+			size = 1;
+
+		// Large allocations get their own block so that they don't waste the rest of the current one
+		if (size > kMaxSmallAllocationSize)
+			return AllocateBlock(size);
+
+		uintptr_t cursor = reinterpret_cast<uintptr_t>(m_blockCursor);
+		uintptr_t alignedCursor = (cursor + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+
+		if (m_blockCursor == nullptr || alignedCursor + size > reinterpret_cast<uintptr_t>(m_blockEnd))
+		{
+			m_blockCursor = static_cast<uint8_t*>(AllocateBlock(kBlockSize));
+			m_blockEnd = m_blockCursor + kBlockSize;
+			alignedCursor = reinterpret_cast<uintptr_t>(m_blockCursor);
+		}
+
+		m_blockCursor = reinterpret_cast<uint8_t*>(alignedCursor + size);
+		return reinterpret_cast<void*>(alignedCursor);
+	}
+
+	ObjectArena* ObjectArena::GetCurrent()
+	{
+		return t_currentArena;
+	}
+
+	void* ObjectArena::AllocateBlock(size_t size)
+	{
+		// malloc returns memory aligned for any fundamental type, which covers every alignment requested
+		void* block = malloc(size);
+		if (!block)
+			throw std::bad_alloc();
+
+		m_blocks.push_back(block);
+		return block;
+	}
+
+	void* ArenaAllocated::operator new(size_t size)
+	{
+		return AllocateWithHeader(size);
+	}
+
+	void* ArenaAllocated::operator new[](size_t size)
+	{
+		return AllocateWithHeader(size);
+	}
+
+	void ArenaAllocated::operator delete(void* ptr)
+	{
+		FreeWithHeader(ptr);
+	}
+
+	void ArenaAllocated::operator delete[](void* ptr)
+	{
+		FreeWithHeader(ptr);
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace mtdisasm
+{
+	// Bump allocator for data objects and their variable-length members.  Memory is only
+	// released when the arena is destroyed, so an arena is meant to hold everything loaded
+	// from one stream.  Allocation is not thread-safe, but objects may be destroyed from
+	// any thread while the arena is still alive.
+	//
+	// Allocations are made from the arena that is current on the calling thread, which is
+	// set with ObjectArena::Scope.  Outside of a scope, allocations use the heap.
+	class ObjectArena
+	{
+	public:
+		class Scope
+		{
+		public:
+			explicit Scope(ObjectArena& arena);
+			~Scope();
+
+		private:
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+			ObjectArena* m_prevArena;
+		};
+
+		ObjectArena();
+		~ObjectArena();
+
+		void* Allocate(size_t size, size_t alignment);
+
+		static ObjectArena* GetCurrent();
+
+	private:
+		ObjectArena(const ObjectArena&) = delete;
+		ObjectArena& operator=(const ObjectArena&) = delete;
+
+		static const size_t kBlockSize = 64 * 1024;
+		static const size_t kMaxSmallAllocationSize = kBlockSize / 4;
+
+		void* AllocateBlock(size_t size);
+
+		std::vector<void*> m_blocks;
+		uint8_t* m_blockCursor;
+		uint8_t* m_blockEnd;
+	};
+
+	// Base for types that are allocated from the current arena with new and new[].
+	// delete is a no-op for arena memory and frees heap memory as usual.
+	struct ArenaAllocated
+	{
+		static void* operator new(size_t size);
+		static void* operator new[](size_t size);
+		static void operator delete(void* ptr);
+		static void operator delete[](void* ptr);
+	};
+
+	// Allocator that binds to the arena that is current when it's constructed, so that
+	// containers created while loading an object allocate from the same arena.  Copies of
+	// containers bind to the arena current at the time of the copy.
+	template<class T>
+	class ArenaAllocator
+	{
+	public:
+		typedef T value_type;
+		typedef std::true_type propagate_on_container_move_assignment;
+		typedef std::true_type propagate_on_container_swap;
+
+		ArenaAllocator();
+		template<class TOther>
+		ArenaAllocator(const ArenaAllocator<TOther>& other);
+
+		T* allocate(size_t n);
+		void deallocate(T* ptr, size_t n);
+
+		ArenaAllocator select_on_container_copy_construction() const;
+
+		ObjectArena* GetArena() const;
+
+	private:
+		ObjectArena* m_arena;
+	};
+
+	template<class T>
+	using ArenaVector = std::vector<T, ArenaAllocator<T> >;
+
+	template<class T>
+	inline ArenaAllocator<T>::ArenaAllocator()
+		: m_arena(ObjectArena::GetCurrent())
+	{
+	}
+
+	template<class T>
+	template<class TOther>
+	inline ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<TOther>& other)
+		: m_arena(other.GetArena())
+	{
+	}
+
+	template<class T>
+	inline T* ArenaAllocator<T>::allocate(size_t n)
+	{
+		if (n > SIZE_MAX / sizeof(T))
+			throw std::bad_array_new_length();
+
+		if (m_arena)
+			return static_cast<T*>(m_arena->Allocate(n * sizeof(T), alignof(T)));
+
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	template<class T>
+	inline void ArenaAllocator<T>::deallocate(T* ptr, size_t)
+	{
+		if (!m_arena)
+			::operator delete(ptr);
+	}
+
+	template<class T>
+	inline ArenaAllocator<T> ArenaAllocator<T>::select_on_container_copy_construction() const
+	{
+		return ArenaAllocator<T>();
+	}
+
+	template<class T>
+	inline ObjectArena* ArenaAllocator<T>::GetArena() const
+	{
+		return m_arena;
+	}
+
+	template<class T, class TOther>
+	inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<TOther>& b)
+	{
+		return a.GetArena() == b.GetArena();
+	}
+
+	template<class T, class TOther>
+	inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<TOther>& b)
+	{
+		return a.GetArena() != b.GetArena();
+	}
+}
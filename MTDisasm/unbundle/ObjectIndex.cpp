@@ -0,0 +1,412 @@
+#include "ObjectIndex.h"
+
+#include "Catalog.h"
+#include "DataObject.h"
+#include "DataReader.h"
+#include "MMapIOStream.h"
+#include "ObjectArena.h"
+#include "ObjectStreamCursor.h"
+#include "ReadAheadIOStream.h"
+#include "SliceIOStream.h"
+
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#endif
+
+namespace mtdisasm
+{
+	namespace
+	{
+		const uint32_t kByteOrderMark = 0x01020304;
+
+		const size_t kHashEdgeSampleSize = 64 * 1024;
+		const size_t kHashInteriorSampleSize = 4 * 1024;
+		const size_t kHashNumInteriorSamples = 64;
+
+		static_assert(sizeof(ObjectIndexHeader) == 32, "Index header layout changed");
+		static_assert(sizeof(ObjectIndexSegmentKey) == 24, "Index segment key layout changed");
+		static_assert(sizeof(ObjectIndexStream) == 24, "Index stream layout changed");
+		static_assert(sizeof(ObjectIndexEntry) == 20, "Index entry layout changed");
+
+		uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+		{
+			// FNV-1a
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= 0x100000001b3ull;
+			}
+
+			return hash;
+		}
+
+		bool HashStreamRange(uint64_t& hash, const IOStream& stream, uint64_t pos, size_t size, std::vector<uint8_t>& buffer)
+		{
+			buffer.resize(size);
+			if (size == 0)
+				return true;
+
+			if (!stream.ReadAt(static_cast<uint32_t>(pos), &buffer[0], size))
+				return false;
+
+			hash = HashBytes(hash, &buffer[0], size);
+			return true;
+		}
+
+		template<class TReader>
+		ObjectIndexStreamStatus IndexStreamWithReader(TReader& reader, size_t streamSize, const SerializationProperties& sp, std::vector<ObjectIndexEntry>& entries)
+		{
+			ObjectStreamCursor<TReader> cursor(reader, streamSize, sp);
+
+			while (cursor.Next())
+			{
+				DataObject* dataObject = cursor.Load();
+				if (!dataObject)
+					break;
+
+				ObjectIndexEntry entry;
+				entry.m_position = cursor.GetPosition();
+				entry.m_size = reader.Tell() - cursor.GetPosition();
+				entry.m_typeCode = cursor.GetTypeCode();
+				entry.m_revision = cursor.GetRevision();
+				entry.m_unused13 = 0;
+
+				ObjectIDKind idKind = ObjectIDKind::kNone;
+				cursor.GetTypeInfo().m_getID(*dataObject, idKind, entry.m_id);
+				entry.m_idKind = static_cast<uint8_t>(idKind);
+
+				dataObject->Delete();
+
+				entries.push_back(entry);
+			}
+
+			switch (cursor.GetStatus())
+			{
+			case ObjectStreamStatus::kEndOfStream:
+				return ObjectIndexStreamStatus::kComplete;
+			case ObjectStreamStatus::kTruncatedHeader:
+				return ObjectIndexStreamStatus::kTruncatedHeader;
+			case ObjectStreamStatus::kUnknownType:
+				return ObjectIndexStreamStatus::kUnknownType;
+			default:
+				return ObjectIndexStreamStatus::kLoadFailed;
+			}
+		}
+
+		ObjectIndexStreamStatus IndexStream(IOStream& segmentStream, const StreamDesc& streamDesc, const SerializationProperties& sp, size_t readAheadSize, std::vector<ObjectIndexEntry>& entries)
+		{
+			SliceIOStream slice(segmentStream, streamDesc.m_pos, streamDesc.m_size);
+			ReadAheadIOStream readAheadStream(slice, streamDesc.m_size, readAheadSize);
+
+			ObjectArena arena;
+			ObjectArena::Scope arenaScope(arena);
+
+			if (sp.m_isByteSwapped)
+			{
+				SwappedOrderDataReader reader(readAheadStream);
+				return IndexStreamWithReader(reader, streamDesc.m_size, sp, entries);
+			}
+			else
+			{
+				NativeOrderDataReader reader(readAheadStream);
+				return IndexStreamWithReader(reader, streamDesc.m_size, sp, entries);
+			}
+		}
+	}
+
+	ObjectIndex::ObjectIndex()
+		: m_data(nullptr)
+		, m_dataSize(0)
+		, m_header(nullptr)
+		, m_segmentKeys(nullptr)
+		, m_streams(nullptr)
+		, m_entries(nullptr)
+	{
+	}
+
+	ObjectIndex::~ObjectIndex()
+	{
+	}
+
+	bool ObjectIndex::Build(const Catalog& catalog, const std::vector<IOStream*>& segmentStreams, const std::vector<ObjectIndexSegmentKey>& segmentKeys, const SerializationProperties& sp, size_t readAheadSize)
+	{
+		Reset();
+
+		const size_t numSegments = segmentStreams.size();
+		const size_t numStreams = catalog.NumStreams();
+
+		if (segmentKeys.size() != numSegments)
+			return false;
+
+		std::vector<ObjectIndexStream> streams;
+		std::vector<ObjectIndexEntry> entries;
+
+		streams.resize(numStreams);
+		for (size_t i = 0; i < numStreams; i++)
+		{
+			const StreamDesc& streamDesc = catalog.GetStream(i);
+			if (streamDesc.m_segmentNumber < 1 || streamDesc.m_segmentNumber > numSegments)
+				return false;
+
+			ObjectIndexStream& stream = streams[i];
+			stream.m_segmentNumber = streamDesc.m_segmentNumber;
+			stream.m_pos = streamDesc.m_pos;
+			stream.m_size = streamDesc.m_size;
+			stream.m_firstEntry = static_cast<uint32_t>(entries.size());
+			stream.m_status = IndexStream(*segmentStreams[streamDesc.m_segmentNumber - 1], streamDesc, sp, readAheadSize, entries);
+
+			if (entries.size() > UINT32_MAX)
+				return false;
+
+			stream.m_numEntries = static_cast<uint32_t>(entries.size()) - stream.m_firstEntry;
+		}
+
+		const size_t keysOffset = sizeof(ObjectIndexHeader);
+		const size_t streamsOffset = keysOffset + numSegments * sizeof(ObjectIndexSegmentKey);
+		const size_t entriesOffset = streamsOffset + numStreams * sizeof(ObjectIndexStream);
+		const size_t totalSize = entriesOffset + entries.size() * sizeof(ObjectIndexEntry);
+
+		// Stored as 64-bit words so that the layout is as aligned as a mapping would be
+		m_builtData.resize((totalSize + 7) / 8);
+		uint8_t* data = reinterpret_cast<uint8_t*>(&m_builtData[0]);
+		memset(data, 0, m_builtData.size() * 8);
+
+		ObjectIndexHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.m_magic, "MTIX", 4);
+		header.m_version = kVersion;
+		header.m_byteOrderMark = kByteOrderMark;
+		header.m_systemType = static_cast<uint8_t>(sp.m_systemType);
+		header.m_is112Compatible = sp.m_is112Compatible ? 1 : 0;
+		header.m_isByteSwapped = sp.m_isByteSwapped ? 1 : 0;
+		header.m_numSegments = static_cast<uint32_t>(numSegments);
+		header.m_numStreams = static_cast<uint32_t>(numStreams);
+		header.m_numEntries = static_cast<uint32_t>(entries.size());
+
+		memcpy(data, &header, sizeof(header));
+		if (numSegments > 0)
+			memcpy(data + keysOffset, &segmentKeys[0], numSegments * sizeof(ObjectIndexSegmentKey));
+		if (numStreams > 0)
+			memcpy(data + streamsOffset, &streams[0], numStreams * sizeof(ObjectIndexStream));
+		if (entries.size() > 0)
+			memcpy(data + entriesOffset, &entries[0], entries.size() * sizeof(ObjectIndexEntry));
+
+		return Attach(data, totalSize);
+	}
+
+	bool ObjectIndex::Load(FILE* f)
+	{
+		Reset();
+
+		std::unique_ptr<MMapIOStream> mapping(new MMapIOStream(f));
+		if (!mapping->IsValid())
+			return false;
+
+		const void* data = nullptr;
+		size_t size = 0;
+		uint32_t globalBase = 0;
+		if (!mapping->GetContiguousSpan(data, size, globalBase) || !data)
+			return false;
+
+		if (!Attach(data, size))
+			return false;
+
+		m_mapping = std::move(mapping);
+		return true;
+	}
+
+	bool ObjectIndex::Save(FILE* f) const
+	{
+		if (!m_data)
+			return false;
+
+		return fwrite(m_data, 1, m_dataSize, f) == m_dataSize;
+	}
+
+	bool ObjectIndex::IsCurrent(const Catalog& catalog, const std::vector<ObjectIndexSegmentKey>& segmentKeys, const SerializationProperties& sp) const
+	{
+		if (!m_header)
+			return false;
+
+		if (m_header->m_systemType != static_cast<uint8_t>(sp.m_systemType)
+			|| m_header->m_is112Compatible != (sp.m_is112Compatible ? 1 : 0)
+			|| m_header->m_isByteSwapped != (sp.m_isByteSwapped ? 1 : 0))
+			return false;
+
+		if (m_header->m_numSegments != segmentKeys.size() || m_header->m_numStreams != catalog.NumStreams())
+			return false;
+
+		for (size_t i = 0; i < segmentKeys.size(); i++)
+		{
+			const ObjectIndexSegmentKey& indexedKey = m_segmentKeys[i];
+			const ObjectIndexSegmentKey& key = segmentKeys[i];
+			if (indexedKey.m_size != key.m_size || indexedKey.m_modifiedTime != key.m_modifiedTime || indexedKey.m_contentHash != key.m_contentHash)
+				return false;
+		}
+
+		for (size_t i = 0; i < catalog.NumStreams(); i++)
+		{
+			const StreamDesc& streamDesc = catalog.GetStream(i);
+			const ObjectIndexStream& stream = m_streams[i];
+			if (stream.m_segmentNumber != streamDesc.m_segmentNumber || stream.m_pos != streamDesc.m_pos || stream.m_size != streamDesc.m_size)
+				return false;
+		}
+
+		return true;
+	}
+
+	size_t ObjectIndex::NumSegments() const
+	{
+		return m_header ? m_header->m_numSegments : 0;
+	}
+
+	const ObjectIndexSegmentKey& ObjectIndex::GetSegmentKey(size_t index) const
+	{
+		return m_segmentKeys[index];
+	}
+
+	size_t ObjectIndex::NumStreams() const
+	{
+		return m_header ? m_header->m_numStreams : 0;
+	}
+
+	const ObjectIndexStream& ObjectIndex::GetStream(size_t index) const
+	{
+		return m_streams[index];
+	}
+
+	size_t ObjectIndex::NumEntries() const
+	{
+		return m_header ? m_header->m_numEntries : 0;
+	}
+
+	const ObjectIndexEntry& ObjectIndex::GetEntry(size_t index) const
+	{
+		return m_entries[index];
+	}
+
+	bool ObjectIndex::ComputeSegmentKey(FILE* f, const IOStream& stream, ObjectIndexSegmentKey& outKey)
+	{
+#ifdef _WIN32
+		struct _stat64 st;
+		if (_fstat64(_fileno(f), &st) != 0)
+			return false;
+
+		const int64_t modifiedTime = static_cast<int64_t>(st.st_mtime) * 1000000000;
+#else
+		struct stat st;
+		if (fstat(fileno(f), &st) != 0)
+			return false;
+
+#if defined(__APPLE__)
+		const int64_t modifiedTime = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+		const int64_t modifiedTime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#else
+		const int64_t modifiedTime = static_cast<int64_t>(st.st_mtime) * 1000000000;
+#endif
+#endif
+
+		if (st.st_size < 0 || st.st_size > INT32_MAX)
+			return false;
+
+		const uint64_t size = static_cast<uint64_t>(st.st_size);
+
+		uint64_t hash = 0xcbf29ce484222325ull;
+		hash = HashBytes(hash, &size, sizeof(size));
+
+		// A full hash would cost as much as reading the whole project, so only sample it.
+		// Rebuilds move the catalog and stream boundaries, which the edges and the
+		// interior samples catch along with the size and modification time.
+		std::vector<uint8_t> buffer;
+		if (size <= kHashEdgeSampleSize * 2)
+		{
+			if (!HashStreamRange(hash, stream, 0, static_cast<size_t>(size), buffer))
+				return false;
+		}
+		else
+		{
+			if (!HashStreamRange(hash, stream, 0, kHashEdgeSampleSize, buffer))
+				return false;
+
+			const uint64_t interiorStart = kHashEdgeSampleSize;
+			const uint64_t interiorSize = size - kHashEdgeSampleSize * 2;
+			if (interiorSize >= kHashInteriorSampleSize * kHashNumInteriorSamples)
+			{
+				const uint64_t stride = interiorSize / kHashNumInteriorSamples;
+				for (size_t i = 0; i < kHashNumInteriorSamples; i++)
+				{
+					if (!HashStreamRange(hash, stream, interiorStart + stride * i, kHashInteriorSampleSize, buffer))
+						return false;
+				}
+			}
+			else if (!HashStreamRange(hash, stream, interiorStart, static_cast<size_t>(interiorSize), buffer))
+				return false;
+
+			if (!HashStreamRange(hash, stream, size - kHashEdgeSampleSize, kHashEdgeSampleSize, buffer))
+				return false;
+		}
+
+		outKey.m_size = size;
+		outKey.m_modifiedTime = modifiedTime;
+		outKey.m_contentHash = hash;
+
+		return true;
+	}
+
+	bool ObjectIndex::Attach(const void* data, size_t size)
+	{
+		if (size < sizeof(ObjectIndexHeader))
+			return false;
+
+		const ObjectIndexHeader* header = static_cast<const ObjectIndexHeader*>(data);
+		if (memcmp(header->m_magic, "MTIX", 4) != 0 || header->m_version != kVersion || header->m_byteOrderMark != kByteOrderMark)
+			return false;
+
+		const uint64_t keysOffset = sizeof(ObjectIndexHeader);
+		const uint64_t streamsOffset = keysOffset + static_cast<uint64_t>(header->m_numSegments) * sizeof(ObjectIndexSegmentKey);
+		const uint64_t entriesOffset = streamsOffset + static_cast<uint64_t>(header->m_numStreams) * sizeof(ObjectIndexStream);
+		const uint64_t totalSize = entriesOffset + static_cast<uint64_t>(header->m_numEntries) * sizeof(ObjectIndexEntry);
+
+		if (totalSize != size)
+			return false;
+
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		const ObjectIndexStream* streams = reinterpret_cast<const ObjectIndexStream*>(bytes + streamsOffset);
+
+		for (size_t i = 0; i < header->m_numStreams; i++)
+		{
+			const ObjectIndexStream& stream = streams[i];
+			if (stream.m_firstEntry > header->m_numEntries || stream.m_numEntries > header->m_numEntries - stream.m_firstEntry)
+				return false;
+		}
+
+		m_data = data;
+		m_dataSize = size;
+		m_header = header;
+		m_segmentKeys = reinterpret_cast<const ObjectIndexSegmentKey*>(bytes + keysOffset);
+		m_streams = streams;
+		m_entries = reinterpret_cast<const ObjectIndexEntry*>(bytes + entriesOffset);
+
+		return true;
+	}
+
+	void ObjectIndex::Reset()
+	{
+		m_data = nullptr;
+		m_dataSize = 0;
+		m_header = nullptr;
+		m_segmentKeys = nullptr;
+		m_streams = nullptr;
+		m_entries = nullptr;
+
+		m_mapping.reset();
+		m_builtData.clear();
+	}
+}
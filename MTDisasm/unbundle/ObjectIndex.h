@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace mtdisasm
+{
+	class Catalog;
+	class IOStream;
+	class MMapIOStream;
+	struct SerializationProperties;
+
+	// On-disk index of the objects in every stream of a project.  The file is the header
+	// followed by the segment keys, stream records, and object entries, all in native byte
+	// order so that it can be used directly from a memory mapping.  Every section starts
+	// on an 8-byte boundary.
+	struct ObjectIndexHeader
+	{
+		char m_magic[4];			// "MTIX"
+		uint32_t m_version;
+		uint32_t m_byteOrderMark;	// 0x01020304 in the byte order of the machine that wrote it
+		uint8_t m_systemType;
+		uint8_t m_is112Compatible;
+		uint8_t m_isByteSwapped;
+		uint8_t m_unused0f;
+		uint32_t m_numSegments;
+		uint32_t m_numStreams;
+		uint32_t m_numEntries;
+		uint32_t m_unused1c;
+	};
+
+	// Identifies the contents of a segment file.  The content hash covers the start and
+	// end of the file and evenly spaced samples in between.
+	struct ObjectIndexSegmentKey
+	{
+		uint64_t m_size;
+		int64_t m_modifiedTime;		// Nanoseconds where the platform supports it
+		uint64_t m_contentHash;
+	};
+
+	enum class ObjectIndexStreamStatus : uint32_t
+	{
+		kComplete,
+		kTruncatedHeader,
+		kUnknownType,
+		kLoadFailed,
+	};
+
+	struct ObjectIndexStream
+	{
+		uint32_t m_segmentNumber;
+		uint32_t m_pos;
+		uint32_t m_size;
+		uint32_t m_firstEntry;
+		uint32_t m_numEntries;
+		ObjectIndexStreamStatus m_status;	// If not complete, indexing stopped at the end of the entries
+	};
+
+	struct ObjectIndexEntry
+	{
+		uint32_t m_position;	// Relative to the start of the stream
+		uint32_t m_size;		// Including the type code and revision
+		uint32_t m_typeCode;
+		uint32_t m_id;			// GUID or asset ID, depending on m_idKind
+		uint16_t m_revision;
+		uint8_t m_idKind;		// ObjectIDKind
+		uint8_t m_unused13;
+	};
+
+	class ObjectIndex
+	{
+	public:
+		ObjectIndex();
+		~ObjectIndex();
+
+		// Scans every stream in the catalog.  Streams that can't be fully scanned are still
+		// indexed up to the failed object.  Fails only if a stream is out of range of its
+		// segment or the index would be too large.
+		bool Build(const Catalog& catalog, const std::vector<IOStream*>& segmentStreams, const std::vector<ObjectIndexSegmentKey>& segmentKeys, const SerializationProperties& sp, size_t readAheadSize);
+
+		// Maps an index file.  Fails if the file isn't a well-formed index of this version
+		// written in this machine's byte order.
+		bool Load(FILE* f);
+		bool Save(FILE* f) const;
+
+		// Checks that the index was built from these exact segments with the same
+		// serialization properties and catalog layout
+		bool IsCurrent(const Catalog& catalog, const std::vector<ObjectIndexSegmentKey>& segmentKeys, const SerializationProperties& sp) const;
+
+		size_t NumSegments() const;
+		const ObjectIndexSegmentKey& GetSegmentKey(size_t index) const;
+
+		size_t NumStreams() const;
+		const ObjectIndexStream& GetStream(size_t index) const;
+
+		size_t NumEntries() const;
+		const ObjectIndexEntry& GetEntry(size_t index) const;
+
+		static bool ComputeSegmentKey(FILE* f, const IOStream& stream, ObjectIndexSegmentKey& outKey);
+
+		static const uint32_t kVersion = 1;
+
+	private:
+		ObjectIndex(const ObjectIndex&) = delete;
+		ObjectIndex& operator=(const ObjectIndex&) = delete;
+
+		bool Attach(const void* data, size_t size);
+		void Reset();
+
+		std::unique_ptr<MMapIOStream> m_mapping;
+		std::vector<uint64_t> m_builtData;
+
+		const void* m_data;
+		size_t m_dataSize;
+
+		const ObjectIndexHeader* m_header;
+		const ObjectIndexSegmentKey* m_segmentKeys;
+		const ObjectIndexStream* m_streams;
+		const ObjectIndexEntry* m_entries;
+	};
+}
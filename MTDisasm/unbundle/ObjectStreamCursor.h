@@ -0,0 +1,254 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "DataObject.h"
+#include "ObjectTypeRegistry.h"
+
+namespace mtdisasm
+{
+	enum class ObjectStreamStatus
+	{
+		kOK,
+		kEndOfStream,
+		kTruncatedHeader,	// The type code or revision couldn't be read
+		kUnknownType,
+		kLoadFailed,
+	};
+
+	// Walks the objects of a stream.  Next() reads the type code and revision of the next
+	// object, and the caller then either loads it with Load() or leaves it, in which case
+	// the following Next() skips over it.  Objects are allocated from the current
+	// ObjectArena, if there is one.
+	//
+	// Objects of types registered as skippable by their size tag are skipped without being
+	// parsed.  With a type filter set,
+	// Next() only stops on objects of the filtered types, so a scan for a few types
+	// doesn't parse the rest of the stream.
+	//
+	// Once anything other than kOK is returned, the stream can't be continued because the
+	// end of the failed object isn't known.
+	template<class TReader>
+	class ObjectStreamCursor
+	{
+	public:
+		ObjectStreamCursor(TReader& reader, size_t streamSize, const SerializationProperties& sp);
+
+		bool Next();
+		ObjectStreamStatus GetStatus() const;
+
+		// Restricts Next() to these types.  The filter must outlive the cursor.
+		void SetTypeFilter(const ObjectTypeFilter* typeFilter);
+
+		// Properties of the current object, or of the failed object if Next or Load failed
+		uint32_t GetPosition() const;
+		uint32_t GetTypeCode() const;
+		uint16_t GetRevision() const;
+		size_t GetTypeIndex() const;
+		const ObjectTypeInfo& GetTypeInfo() const;
+
+		// Loads the current object.  The caller takes ownership.  Returns null if the object
+		// couldn't be loaded.
+		DataObject* Load();
+
+		// Skips the current object without returning it
+		bool Skip();
+
+		TReader& GetReader() const;
+
+	private:
+		ObjectStreamCursor(const ObjectStreamCursor&) = delete;
+		ObjectStreamCursor& operator=(const ObjectStreamCursor&) = delete;
+
+		bool NextObject();
+		bool SkipBySizeTag();
+
+		TReader& m_reader;
+		size_t m_streamSize;
+		const SerializationProperties& m_sp;
+		const ObjectTypeFilter* m_typeFilter;
+
+		ObjectStreamStatus m_status;
+		bool m_isObjectPending;
+
+		uint32_t m_position;
+		uint32_t m_typeCode;
+		uint16_t m_revision;
+		size_t m_typeIndex;
+	};
+
+	template<class TReader>
+	ObjectStreamCursor<TReader>::ObjectStreamCursor(TReader& reader, size_t streamSize, const SerializationProperties& sp)
+		: m_reader(reader)
+		, m_streamSize(streamSize)
+		, m_sp(sp)
+		, m_typeFilter(nullptr)
+		, m_status(ObjectStreamStatus::kOK)
+		, m_isObjectPending(false)
+		, m_position(0)
+		, m_typeCode(0)
+		, m_revision(0)
+		, m_typeIndex(0)
+	{
+	}
+
+	template<class TReader>
+	bool ObjectStreamCursor<TReader>::Next()
+	{
+		while (NextObject())
+		{
+			if (!m_typeFilter || m_typeFilter->Contains(m_typeIndex))
+				return true;
+		}
+
+		return false;
+	}
+
+	template<class TReader>
+	bool ObjectStreamCursor<TReader>::NextObject()
+	{
+		if (m_status != ObjectStreamStatus::kOK)
+			return false;
+
+		if (m_isObjectPending && !Skip())
+			return false;
+
+		m_position = m_reader.Tell();
+		if (m_position == m_streamSize)
+		{
+			m_status = ObjectStreamStatus::kEndOfStream;
+			return false;
+		}
+
+		m_typeCode = 0;
+		m_revision = 0;
+		if (!m_reader.ReadU32(m_typeCode) || !m_reader.ReadU16(m_revision))
+		{
+			m_status = ObjectStreamStatus::kTruncatedHeader;
+			return false;
+		}
+
+		if (!FindObjectType(m_typeCode, m_typeIndex))
+		{
+			m_status = ObjectStreamStatus::kUnknownType;
+			return false;
+		}
+
+		m_isObjectPending = true;
+		return true;
+	}
+
+	template<class TReader>
+	ObjectStreamStatus ObjectStreamCursor<TReader>::GetStatus() const
+	{
+		return m_status;
+	}
+
+	template<class TReader>
+	void ObjectStreamCursor<TReader>::SetTypeFilter(const ObjectTypeFilter* typeFilter)
+	{
+		m_typeFilter = typeFilter;
+	}
+
+	template<class TReader>
+	uint32_t ObjectStreamCursor<TReader>::GetPosition() const
+	{
+		return m_position;
+	}
+
+	template<class TReader>
+	uint32_t ObjectStreamCursor<TReader>::GetTypeCode() const
+	{
+		return m_typeCode;
+	}
+
+	template<class TReader>
+	uint16_t ObjectStreamCursor<TReader>::GetRevision() const
+	{
+		return m_revision;
+	}
+
+	template<class TReader>
+	size_t ObjectStreamCursor<TReader>::GetTypeIndex() const
+	{
+		return m_typeIndex;
+	}
+
+	template<class TReader>
+	const ObjectTypeInfo& ObjectStreamCursor<TReader>::GetTypeInfo() const
+	{
+		return GetObjectTypeInfo(m_typeIndex);
+	}
+
+	template<class TReader>
+	DataObject* ObjectStreamCursor<TReader>::Load()
+	{
+		if (!m_isObjectPending)
+			return nullptr;
+
+		m_isObjectPending = false;
+
+		DataObject* dataObject = CreateObjectOfType(m_typeIndex);
+		if (!dataObject->Load(m_reader, m_revision, m_sp))
+		{
+			dataObject->Delete();
+			m_status = ObjectStreamStatus::kLoadFailed;
+			return nullptr;
+		}
+
+		return dataObject;
+	}
+
+	template<class TReader>
+	bool ObjectStreamCursor<TReader>::Skip()
+	{
+		if (!m_isObjectPending)
+			return m_status == ObjectStreamStatus::kOK;
+
+		if (GetTypeInfo().m_hasSizeTag)
+		{
+			if (SkipBySizeTag())
+			{
+				m_isObjectPending = false;
+				return true;
+			}
+
+			// Implausible size, so fall back to loading from just after the revision
+			if (!m_reader.Seek(m_position + 6))
+			{
+				m_isObjectPending = false;
+				m_status = ObjectStreamStatus::kLoadFailed;
+				return false;
+			}
+		}
+
+		DataObject* dataObject = Load();
+		if (!dataObject)
+			return false;
+
+		dataObject->Delete();
+		return true;
+	}
+
+	template<class TReader>
+	bool ObjectStreamCursor<TReader>::SkipBySizeTag()
+	{
+		// The tag follows a 32-bit marker and counts from the start of the type code
+		uint32_t marker = 0;
+		uint32_t sizeIncludingTag = 0;
+		if (!m_reader.ReadU32(marker) || !m_reader.ReadU32(sizeIncludingTag))
+			return false;
+
+		if (sizeIncludingTag < 14 || sizeIncludingTag > m_streamSize - m_position)
+			return false;
+
+		return m_reader.Seek(m_position + sizeIncludingTag);
+	}
+
+	template<class TReader>
+	TReader& ObjectStreamCursor<TReader>::GetReader() const
+	{
+		return m_reader;
+	}
+}
@@ -0,0 +1,213 @@
+#include "ObjectTypeRegistry.h"
+#include "DataObject.h"
+
+#include <atomic>
+
+namespace mtdisasm
+{
+	namespace
+	{
+		// Overloads are ranked so that a GUID is preferred over a modifier header GUID,
+		// which is preferred over an asset ID
+		struct IDRankNone {};
+		struct IDRankAssetID : public IDRankNone {};
+		struct IDRankModifierGUID : public IDRankAssetID {};
+		struct IDRankGUID : public IDRankModifierGUID {};
+
+		template<class T>
+		auto GetObjectIDOfType(const T& obj, ObjectIDKind& outKind, uint32_t& outID, IDRankGUID) -> decltype(obj.m_guid, bool())
+		{
+			outKind = ObjectIDKind::kGUID;
+			outID = obj.m_guid;
+			return true;
+		}
+
+		template<class T>
+		auto GetObjectIDOfType(const T& obj, ObjectIDKind& outKind, uint32_t& outID, IDRankModifierGUID) -> decltype(obj.m_modHeader.m_guid, bool())
+		{
+			outKind = ObjectIDKind::kGUID;
+			outID = obj.m_modHeader.m_guid;
+			return true;
+		}
+
+		template<class T>
+		auto GetObjectIDOfType(const T& obj, ObjectIDKind& outKind, uint32_t& outID, IDRankAssetID) -> decltype(obj.m_assetID, bool())
+		{
+			outKind = ObjectIDKind::kAssetID;
+			outID = obj.m_assetID;
+			return true;
+		}
+
+		template<class T>
+		bool GetObjectIDOfType(const T& obj, ObjectIDKind& outKind, uint32_t& outID, IDRankNone)
+		{
+			outKind = ObjectIDKind::kNone;
+			outID = 0;
+			return false;
+		}
+
+		template<class T>
+		bool GetObjectID(const DataObject& dataObject, ObjectIDKind& outKind, uint32_t& outID)
+		{
+			return GetObjectIDOfType(static_cast<const T&>(dataObject), outKind, outID, IDRankGUID());
+		}
+
+		// Types that are skipped by their size tag.  Only types whose loaders always end at the
+		// tag belong here, because they either accept one size or skip to it.  Other loaders read
+		// their fields whatever the tag says (MacOnlyCursorModifier's ignores it on Mac), so
+		// those objects are skipped by loading them.
+		template<class T>
+		struct SkipsBySizeTag
+		{
+			static const bool kValue = false;
+		};
+
+#define MTDISASM_SKIP_BY_SIZE_TAG(className) \
+		template<> \
+		struct SkipsBySizeTag<className> \
+		{ \
+			static const bool kValue = true; \
+		};
+
+		MTDISASM_SKIP_BY_SIZE_TAG(DOStreamHeader)
+		MTDISASM_SKIP_BY_SIZE_TAG(DOPresentationSettings)
+		MTDISASM_SKIP_BY_SIZE_TAG(DOGlobalObjectInfo)
+		MTDISASM_SKIP_BY_SIZE_TAG(DOUnknown19)
+		MTDISASM_SKIP_BY_SIZE_TAG(DODebris)
+		MTDISASM_SKIP_BY_SIZE_TAG(DOColorTableAsset)
+		MTDISASM_SKIP_BY_SIZE_TAG(DONotYetImplemented)
+		MTDISASM_SKIP_BY_SIZE_TAG(DOAssetDataSection)
+#undef MTDISASM_SKIP_BY_SIZE_TAG
+
+		const ObjectTypeInfo kObjectTypes[] =
+		{
+#define MTDISASM_OBJECT_TYPE_INFO(typeCode, className, constructorArgs, name) \
+			{ typeCode, name, sizeof(className), []() -> DataObject* { return new className constructorArgs; }, GetObjectID<className>, SkipsBySizeTag<className>::kValue },
+			MTDISASM_FOR_EACH_OBJECT_TYPE(MTDISASM_OBJECT_TYPE_INFO)
+#undef MTDISASM_OBJECT_TYPE_INFO
+		};
+
+		static_assert(sizeof(kObjectTypes) / sizeof(kObjectTypes[0]) == kNumObjectTypes, "Object type table size mismatch");
+		static_assert(kNumObjectTypes < 0xff, "Object type indexes must fit in the lookup table");
+
+		std::atomic<uint64_t> g_objectCounts[kNumObjectTypes];
+
+		// Almost every type code is small, so those are looked up directly and the rest
+		// (debris, plug-ins and asset data sections) are searched.
+		class ObjectTypeLookup
+		{
+		public:
+			ObjectTypeLookup();
+
+			bool Find(uint32_t typeCode, size_t& outTypeIndex) const;
+
+		private:
+			static const uint32_t kDirectLookupSize = 0x500;
+			static const uint8_t kNoType = 0xff;
+
+			uint8_t m_directLookup[kDirectLookupSize];
+
+			size_t m_numOtherTypes;
+			uint8_t m_otherTypes[kNumObjectTypes];
+		};
+
+		ObjectTypeLookup::ObjectTypeLookup()
+			: m_numOtherTypes(0)
+		{
+			for (uint32_t i = 0; i < kDirectLookupSize; i++)
+				m_directLookup[i] = kNoType;
+
+			for (size_t i = 0; i < kNumObjectTypes; i++)
+			{
+				uint32_t typeCode = kObjectTypes[i].m_typeCode;
+				if (typeCode < kDirectLookupSize)
+					m_directLookup[typeCode] = static_cast<uint8_t>(i);
+				else
+					m_otherTypes[m_numOtherTypes++] = static_cast<uint8_t>(i);
+			}
+		}
+
+		bool ObjectTypeLookup::Find(uint32_t typeCode, size_t& outTypeIndex) const
+		{
+			if (typeCode < kDirectLookupSize)
+			{
+				uint8_t typeIndex = m_directLookup[typeCode];
+				if (typeIndex == kNoType)
+					return false;
+
+				outTypeIndex = typeIndex;
+				return true;
+			}
+
+			for (size_t i = 0; i < m_numOtherTypes; i++)
+			{
+				if (kObjectTypes[m_otherTypes[i]].m_typeCode == typeCode)
+				{
+					outTypeIndex = m_otherTypes[i];
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		const ObjectTypeLookup g_objectTypeLookup;
+	}
+
+	bool FindObjectType(uint32_t typeCode, size_t& outTypeIndex)
+	{
+		return g_objectTypeLookup.Find(typeCode, outTypeIndex);
+	}
+
+	const ObjectTypeInfo& GetObjectTypeInfo(size_t typeIndex)
+	{
+		return kObjectTypes[typeIndex];
+	}
+
+	DataObject* CreateObjectOfType(size_t typeIndex)
+	{
+		g_objectCounts[typeIndex].fetch_add(1, std::memory_order_relaxed);
+		return kObjectTypes[typeIndex].m_create();
+	}
+
+	DataObject* CreateObjectFromType(uint32_t typeCode)
+	{
+		size_t typeIndex = 0;
+		if (!FindObjectType(typeCode, typeIndex))
+			return nullptr;
+
+		return CreateObjectOfType(typeIndex);
+	}
+
+	uint64_t GetObjectCountOfType(size_t typeIndex)
+	{
+		return g_objectCounts[typeIndex].load(std::memory_order_relaxed);
+	}
+
+	ObjectTypeFilter::ObjectTypeFilter()
+	{
+		for (bool& isIncluded : m_types)
+			isIncluded = false;
+	}
+
+	void ObjectTypeFilter::Add(size_t typeIndex)
+	{
+		m_types[typeIndex] = true;
+	}
+
+	bool ObjectTypeFilter::Contains(size_t typeIndex) const
+	{
+		return m_types[typeIndex];
+	}
+
+	bool ObjectTypeFilter::IsEmpty() const
+	{
+		for (bool isIncluded : m_types)
+		{
+			if (isIncluded)
+				return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mtdisasm
+{
+	class DataObject;
+
+	// Every object type that can appear in a stream, as X(typeCode, className, constructorArgs, name).
+	// Adding a type here registers its factory and name, and the disassembler's per-type
+	// handler table is generated from the same list.
+#define MTDISASM_FOR_EACH_OBJECT_TYPE(X) \
+	X(0x002, DOProjectStructuralDef, (), "ProjectStructuralDef") \
+	X(0x003, DOSectionStructuralDef, (), "SectionStructuralDef") \
+	X(0x005, DOMovieStructuralDef, (), "MovieStructuralDef") \
+	X(0x006, DOMToonStructuralDef, (), "MToonStructuralDef") \
+	X(0x007, DOImageStructuralDef, (), "ImageStructuralDef") \
+	X(0x008, DOGraphicStructuralDef, (), "GraphicStructuralDef") \
+	X(0x0015, DOTextStructuralDef, (), "TextStructuralDef") \
+	X(0xa, DOSoundStructuralDef, (), "SoundStructuralDef") \
+	X(0x001f, DOTextAsset, (), "TextAsset") \
+	X(0x00d, DOAssetCatalog, (), "AssetCatalog") \
+	X(0x017, DOGlobalObjectInfo, (), "GlobalObjectInfo") \
+	X(0x019, DOUnknown19, (), "Unknown19") \
+	X(0xfffffffe, DODebris, (), "Debris") \
+	X(0x00e, DOImageAsset, (), "ImageAsset") \
+	X(0x00f, DOMToonAsset, (), "MToonAsset") \
+	X(0x010, DOMovieAsset, (), "MovieAsset") \
+	X(0x011, DOAudioAsset, (), "AudioAsset") \
+	X(0x01e, DOColorTableAsset, (), "ColorTable") \
+	X(0x021, DOSubsectionStructuralDef, (), "SubsectionStructuralDef") \
+	X(0x022, DOProjectLabelMap, (), "ProjectLabelMap") \
+	X(0x3e9, DOStreamHeader, (), "StreamHeader") \
+	X(0x3ec, DOPresentationSettings, (), "PresentationSettings") \
+	X(0x2c6, DOBehaviorModifier, (), "BehaviorModifier") \
+	X(0x3c0, DOMiniscriptModifier, (), "MiniscriptModifier") \
+	X(0x2da, DOMessengerModifier, (), "MessengerModifier") \
+	X(0x2bc, DOIfMessengerModifier, (), "IfMessengerModifier") \
+	X(0x2e4, DOTimerMessengerModifier, (), "TimerMessengerModifier") \
+	X(0x2f8, DOBoundaryDetectionMessengerModifier, (), "BoundaryDetectionMessengerModifier") \
+	X(0x2ee, DOCollisionDetectionMessengerModifier, (), "CollisionDetectionMessengerModifier") \
+	X(0x302, DOKeyboardMessengerModifier, (), "KeyboardMessengerModifier") \
+	X(0x321, DOBooleanVariableModifier, (), "BooleanVariableModifier") \
+	X(0x2c7, DOCompoundVariableModifier, (), "CompoundVariableModifier") \
+	X(0x322, DOIntegerVariableModifier, (), "IntegerVariableModifier") \
+	X(0x329, DOStringVariableModifier, (), "StringVariableModifier") \
+	X(0x324, DOIntegerRangeVariableModifier, (), "IntegerRangeVariableModifier") \
+	X(0x328, DOFloatVariableModifier, (), "FloatVariableModifier") \
+	X(0x327, DOVectorVariableModifier, (), "VectorVariableModifier") \
+	X(0x326, DOPointVariableModifier, (), "PointVariableModifier") \
+	X(0x136, DOChangeSceneModifier, (), "ChangeSceneModifier") \
+	X(0x140, DONotYetImplemented, (0x140, "Return modifier"), "NotYetImplemented") \
+	X(0x29a, DOSharedSceneModifier, (), "SharedSceneModifier") \
+	X(0x2df, DOSetModifier, (), "SetModifier") \
+	X(0x4d8, DOSaveAndRestoreModifier, (), "SaveAndRestoreModifier") \
+	X(0x26c, DOSceneTransitionModifier, (), "SceneTransitionModifier") \
+	X(0x276, DOElementTransitionModifier, (), "ElementTransitionModifier") \
+	X(0x1fe, DOSimpleMotionModifier, (), "SimpleMotionModifier") \
+	X(0x21b, DOPathMotionModifierV2, (), "PathMotionModifierV2") \
+	X(0x21c, DOPathMotionModifierV1, (), "PathMotionModifierV1") \
+	X(0x208, DODragMotionModifier, (), "DragMotionModifier") \
+	X(0x226, DOVectorMotionModifier, (), "VectorMotionModifier") \
+	X(0x1a4, DOSoundEffectModifier, (), "SoundEffectModifier") \
+	X(0x32a, DOTextStyleModifier, (), "TextStyleModifier") \
+	X(0x334, DOGraphicModifier, (), "GraphicModifier") \
+	X(0x4c4, DONotYetImplemented, (0x4c4, "Color Table modifier"), "NotYetImplemented") \
+	X(0x4b0, DONotYetImplemented, (0x4b0, "Gradient modifier"), "NotYetImplemented") \
+	X(0x384, DOImageEffectModifier, (), "ImageEffectModifier") \
+	X(0x4ce, DOSoundFadeModifier, (), "SoundFadeModifier") \
+	X(0x27, DOAliasModifier, (), "AliasModifier") \
+	X(0xffffffff, DOPlugInModifier, (), "PlugInModifier") \
+	X(0x3ca, DOMacOnlyCursorModifier, (), "MacOnlyCursorModifier") \
+	X(0xffff, DOAssetDataSection, (), "AssetDataSection") \
+	X(0x33e, DONotYetImplemented, (0x33e, "Unknown33e"), "NotYetImplemented") \
+	X(0x24, DOExtVideoAsset, (), "ExtVideoAsset") \
+	X(0x25, DOExternalMovieStructuralDef, (), "ExternalMovieStructuralDef")
+
+	enum class ObjectIDKind : uint8_t
+	{
+		kNone,
+		kGUID,
+		kAssetID,
+	};
+
+	struct ObjectTypeInfo
+	{
+		uint32_t m_typeCode;
+		const char* m_name;
+		size_t m_sizeHint;	// Size of the object, not including variable-length members
+		DataObject* (*m_create)();
+
+		// Gets the object's GUID if it has one, otherwise the ID of the asset it defines or references
+		bool (*m_getID)(const DataObject& dataObject, ObjectIDKind& outKind, uint32_t& outID);
+
+		// If set, the object starts with a marker and its size including the type code and
+		// revision, and its loader always ends there, so it can be skipped without loading it
+		bool m_hasSizeTag;
+	};
+
+	enum
+	{
+#define MTDISASM_COUNT_OBJECT_TYPE(typeCode, className, constructorArgs, name) + 1
+		kNumObjectTypes = 0 MTDISASM_FOR_EACH_OBJECT_TYPE(MTDISASM_COUNT_OBJECT_TYPE),
+#undef MTDISASM_COUNT_OBJECT_TYPE
+	};
+
+	// Type indexes are positions in MTDISASM_FOR_EACH_OBJECT_TYPE
+	bool FindObjectType(uint32_t typeCode, size_t& outTypeIndex);
+	const ObjectTypeInfo& GetObjectTypeInfo(size_t typeIndex);
+
+	// Creates an object and counts it toward the type's total
+	DataObject* CreateObjectOfType(size_t typeIndex);
+	DataObject* CreateObjectFromType(uint32_t typeCode);
+
+	uint64_t GetObjectCountOfType(size_t typeIndex);
+
+	// Set of type indexes, for scans that only need some object types
+	class ObjectTypeFilter
+	{
+	public:
+		ObjectTypeFilter();
+
+		void Add(size_t typeIndex);
+		bool Contains(size_t typeIndex) const;
+		bool IsEmpty() const;
+
+	private:
+		bool m_types[kNumObjectTypes];
+	};
+}
@@ -0,0 +1,78 @@
+#include "PayloadIOStream.h"
+
+#include <cstring>
+
+namespace mtdisasm
+{
+	PayloadIOStream::PayloadIOStream(const void* buf, size_t size, uint32_t basePos)
+		: m_buf(buf)
+		, m_size(size)
+		, m_basePos(basePos)
+		, m_pos(basePos)
+	{
+	}
+
+	size_t PayloadIOStream::ReadPartial(void* dest, size_t sz)
+	{
+		size_t amountRead = ReadAtPartial(m_pos, dest, sz);
+		m_pos += static_cast<uint32_t>(amountRead);
+
+		return amountRead;
+	}
+
+	size_t PayloadIOStream::WritePartial(const void* src, size_t sz)
+	{
+		return 0;
+	}
+
+	size_t PayloadIOStream::ReadAtPartial(uint32_t pos, void* dest, size_t sz) const
+	{
+		if (pos < m_basePos || pos - m_basePos >= m_size)
+			return 0;
+
+		size_t offset = pos - m_basePos;
+		size_t available = m_size - offset;
+		if (available < sz)
+			sz = available;
+
+		memcpy(dest, static_cast<const char*>(m_buf) + offset, sz);
+
+		return sz;
+	}
+
+	bool PayloadIOStream::SeekSet(int32_t pos)
+	{
+		if (pos < 0)
+			return false;
+
+		uint32_t upos = static_cast<uint32_t>(pos);
+		if (upos < m_basePos || upos - m_basePos > m_size)
+			return false;
+
+		m_pos = upos;
+
+		return true;
+	}
+
+	bool PayloadIOStream::SeekCur(int32_t pos)
+	{
+		return SeekSet(static_cast<int32_t>(m_pos) + pos);
+	}
+
+	bool PayloadIOStream::SeekEnd(int32_t pos)
+	{
+		if (pos > 0)
+			return false;
+		return SeekSet(static_cast<int32_t>(m_basePos + m_size) + pos);
+	}
+
+	uint32_t PayloadIOStream::Tell() const
+	{
+		return m_pos;
+	}
+
+	uint32_t PayloadIOStream::TellGlobal() const
+	{
+		return m_pos;
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "IOStream.h"
+
+namespace mtdisasm
+{
+	// Read-only stream over a copy of part of a segment.  Positions are segment positions,
+	// so code that reads a payload from its segment can read it from the copy instead.
+	// Reads outside of the copied range return nothing.
+	class PayloadIOStream final : public IOStream
+	{
+	public:
+		PayloadIOStream(const void* buf, size_t size, uint32_t basePos);
+
+		size_t ReadPartial(void* dest, size_t sz) override;
+		size_t WritePartial(const void* src, size_t sz) override;
+		size_t ReadAtPartial(uint32_t pos, void* dest, size_t sz) const override;
+
+		bool SeekSet(int32_t pos) override;
+		bool SeekCur(int32_t pos) override;
+		bool SeekEnd(int32_t pos) override;
+
+		uint32_t Tell() const override;
+		uint32_t TellGlobal() const override;
+
+	private:
+		const void* m_buf;
+		size_t m_size;
+		uint32_t m_basePos;
+		uint32_t m_pos;
+	};
+}
@@ -0,0 +1,664 @@
+#include "PixelConvert.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MTDISASM_PIXEL_CONVERT_X86
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only allow intrinsics in functions built for their instruction set.  MSVC
+// allows them anywhere.
+#if defined(MTDISASM_PIXEL_CONVERT_X86) && defined(__GNUC__)
+#define MTDISASM_TARGET_SSE2 __attribute__((target("sse2")))
+#define MTDISASM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MTDISASM_TARGET_SSE2
+#define MTDISASM_TARGET_AVX2
+#endif
+
+namespace mtdisasm
+{
+	namespace
+	{
+		// Scalar
+
+		inline uint8_t Expand5(uint32_t c)
+		{
+			return static_cast<uint8_t>((c * 33) >> 2);
+		}
+
+		inline void RGB555ToRGB(uint16_t v, uint8_t* dest)
+		{
+			dest[0] = Expand5((v >> 10) & 0x1f);
+			dest[1] = Expand5((v >> 5) & 0x1f);
+			dest[2] = Expand5(v & 0x1f);
+		}
+
+		void ConvertWin32ToRGB24Scalar(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			for (size_t x = 0; x < width; x++)
+			{
+				dest[x * 3 + 0] = src[x * 4 + 3];
+				dest[x * 3 + 1] = src[x * 4 + 2];
+				dest[x * 3 + 2] = src[x * 4 + 1];
+			}
+		}
+
+		void ConvertMac32ToRGB24Scalar(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			for (size_t x = 0; x < width; x++)
+			{
+				dest[x * 3 + 0] = src[x * 4 + 0];
+				dest[x * 3 + 1] = src[x * 4 + 1];
+				dest[x * 3 + 2] = src[x * 4 + 2];
+			}
+		}
+
+		void ConvertRGB555LEToRGB24Scalar(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			for (size_t x = 0; x < width; x++)
+				RGB555ToRGB(static_cast<uint16_t>(src[x * 2 + 0] + (src[x * 2 + 1] << 8)), dest + x * 3);
+		}
+
+		void ConvertRGB555BEToRGB24Scalar(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			for (size_t x = 0; x < width; x++)
+				RGB555ToRGB(static_cast<uint16_t>(src[x * 2 + 1] + (src[x * 2 + 0] << 8)), dest + x * 3);
+		}
+
+		void ConvertGray8ToRGB24Scalar(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			for (size_t x = 0; x < width; x++)
+			{
+				const uint8_t gray = src[x];
+				dest[x * 3 + 0] = gray;
+				dest[x * 3 + 1] = gray;
+				dest[x * 3 + 2] = gray;
+			}
+		}
+
+		// Gray levels of the pixels in each possible byte, so that unpacking doesn't
+		// shift and scale per pixel
+		struct GrayUnpackTables
+		{
+			GrayUnpackTables();
+
+			uint8_t m_gray4[256][2];
+			uint8_t m_gray2[256][4];
+			uint8_t m_gray1[256][8];
+		};
+
+		GrayUnpackTables::GrayUnpackTables()
+		{
+			for (int b = 0; b < 256; b++)
+			{
+				for (int i = 0; i < 2; i++)
+					m_gray4[b][i] = static_cast<uint8_t>(((b >> (1 - i)) & 15) * 17);
+				for (int i = 0; i < 4; i++)
+					m_gray2[b][i] = static_cast<uint8_t>(((b >> (3 - i)) & 3) * 85);
+				for (int i = 0; i < 8; i++)
+					m_gray1[b][i] = static_cast<uint8_t>(((b >> (7 - i)) & 1) * 255);
+			}
+		}
+
+		const GrayUnpackTables& GetGrayUnpackTables()
+		{
+			static GrayUnpackTables tables;
+			return tables;
+		}
+
+		template<size_t TPixelsPerByte>
+		void ConvertPackedGrayToRGB24(const uint8_t (*table)[TPixelsPerByte], const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			for (size_t x = 0; x < width; x += TPixelsPerByte)
+			{
+				const uint8_t* grays = table[*src++];
+
+				size_t numPixels = width - x;
+				if (numPixels > TPixelsPerByte)
+					numPixels = TPixelsPerByte;
+
+				for (size_t i = 0; i < numPixels; i++)
+				{
+					dest[0] = grays[i];
+					dest[1] = grays[i];
+					dest[2] = grays[i];
+					dest += 3;
+				}
+			}
+		}
+
+		void ConvertGray4ToRGB24Scalar(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			ConvertPackedGrayToRGB24<2>(GetGrayUnpackTables().m_gray4, src, dest, width);
+		}
+
+		void ConvertGray2ToRGB24Scalar(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			ConvertPackedGrayToRGB24<4>(GetGrayUnpackTables().m_gray2, src, dest, width);
+		}
+
+		void ConvertGray1ToRGB24Scalar(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			ConvertPackedGrayToRGB24<8>(GetGrayUnpackTables().m_gray1, src, dest, width);
+		}
+
+		void ConvertIndexed8ToRGBA32Scalar(const uint8_t* src, uint8_t* dest, size_t width, const uint32_t* palette)
+		{
+			for (size_t x = 0; x < width; x++)
+				memcpy(dest + x * 4, &palette[src[x]], 4);
+		}
+
+		void ConvertRGB555LEToRGBA32Scalar(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			for (size_t x = 0; x < width; x++)
+			{
+				RGB555ToRGB(static_cast<uint16_t>(src[x * 2 + 0] + (src[x * 2 + 1] << 8)), dest + x * 4);
+				dest[x * 4 + 3] = 255;
+			}
+		}
+
+		void ConvertRGB555BEToRGBA32Scalar(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			for (size_t x = 0; x < width; x++)
+			{
+				RGB555ToRGB(static_cast<uint16_t>(src[x * 2 + 1] + (src[x * 2 + 0] << 8)), dest + x * 4);
+				dest[x * 4 + 3] = 255;
+			}
+		}
+
+		void ConvertRGBX32ToRGBA32Scalar(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			for (size_t x = 0; x < width; x++)
+			{
+				dest[x * 4 + 0] = src[x * 4 + 0];
+				dest[x * 4 + 1] = src[x * 4 + 1];
+				dest[x * 4 + 2] = src[x * 4 + 2];
+				dest[x * 4 + 3] = 255;
+			}
+		}
+
+		const PixelRowConverters g_scalarConverters =
+		{
+			"scalar",
+			ConvertWin32ToRGB24Scalar,
+			ConvertMac32ToRGB24Scalar,
+			ConvertRGB555LEToRGB24Scalar,
+			ConvertRGB555BEToRGB24Scalar,
+			ConvertGray8ToRGB24Scalar,
+			ConvertGray4ToRGB24Scalar,
+			ConvertGray2ToRGB24Scalar,
+			ConvertGray1ToRGB24Scalar,
+			ConvertIndexed8ToRGBA32Scalar,
+			ConvertRGB555LEToRGBA32Scalar,
+			ConvertRGB555BEToRGBA32Scalar,
+			ConvertRGBX32ToRGBA32Scalar,
+		};
+
+#ifdef MTDISASM_PIXEL_CONVERT_X86
+		// The vector converters build each pixel as an RGBA dword.  For RGB24 output, the
+		// fourth byte of each pixel is squeezed out and a full register is stored, so the
+		// bytes past the last pixel of a store are overwritten by the next one.  Loops stop
+		// while there is still room for those bytes and leave the rest of the row to the
+		// scalar converters.
+
+		// SSE2
+
+		// 4 RGBA pixels to 12 bytes of RGB at the bottom of the register
+		MTDISASM_TARGET_SSE2 inline __m128i CompactRGBASSE2(__m128i rgba)
+		{
+			// Squeeze each pair of pixels into the low 6 bytes of its qword
+			const __m128i lowPixelMask = _mm_set_epi32(0, 0x00ffffff, 0, 0x00ffffff);
+			const __m128i highPixelMask = _mm_set_epi32(0x0000ffff, static_cast<int>(0xff000000), 0x0000ffff, static_cast<int>(0xff000000));
+
+			__m128i pairs = _mm_or_si128(_mm_and_si128(rgba, lowPixelMask), _mm_and_si128(_mm_srli_epi64(rgba, 8), highPixelMask));
+
+			return _mm_or_si128(_mm_move_epi64(pairs), _mm_slli_si128(_mm_srli_si128(pairs, 8), 6));
+		}
+
+		MTDISASM_TARGET_SSE2 inline __m128i Expand5SSE2(__m128i c)
+		{
+			// (c * 33) >> 2 for 5-bit values
+			return _mm_or_si128(_mm_slli_epi16(c, 3), _mm_srli_epi16(c, 2));
+		}
+
+		// 8 RGB555 pixels to two registers of 4 RGBA pixels
+		MTDISASM_TARGET_SSE2 inline void RGB555ToRGBASSE2(__m128i v, __m128i& outLow, __m128i& outHigh)
+		{
+			const __m128i mask5 = _mm_set1_epi16(0x1f);
+
+			__m128i r = Expand5SSE2(_mm_and_si128(_mm_srli_epi16(v, 10), mask5));
+			__m128i g = Expand5SSE2(_mm_and_si128(_mm_srli_epi16(v, 5), mask5));
+			__m128i b = Expand5SSE2(_mm_and_si128(v, mask5));
+
+			__m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+			__m128i ba = _mm_or_si128(b, _mm_set1_epi16(static_cast<short>(0xff00)));
+
+			outLow = _mm_unpacklo_epi16(rg, ba);
+			outHigh = _mm_unpackhi_epi16(rg, ba);
+		}
+
+		MTDISASM_TARGET_SSE2 inline __m128i SwapBytes16SSE2(__m128i v)
+		{
+			return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		}
+
+		MTDISASM_TARGET_SSE2 void ConvertWin32ToRGB24SSE2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			const __m128i byteMask = _mm_set1_epi32(0xff);
+
+			size_t x = 0;
+			for (; x + 6 <= width; x += 4)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+
+				// Bytes 3, 2, 1 to bytes 0, 1, 2
+				__m128i r = _mm_srli_epi32(v, 24);
+				__m128i g = _mm_and_si128(_mm_srli_epi32(v, 8), _mm_slli_epi32(byteMask, 8));
+				__m128i b = _mm_and_si128(_mm_slli_epi32(v, 8), _mm_slli_epi32(byteMask, 16));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x * 3), CompactRGBASSE2(_mm_or_si128(_mm_or_si128(r, g), b)));
+			}
+
+			ConvertWin32ToRGB24Scalar(src + x * 4, dest + x * 3, width - x);
+		}
+
+		MTDISASM_TARGET_SSE2 void ConvertMac32ToRGB24SSE2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			size_t x = 0;
+			for (; x + 6 <= width; x += 4)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x * 3), CompactRGBASSE2(v));
+			}
+
+			ConvertMac32ToRGB24Scalar(src + x * 4, dest + x * 3, width - x);
+		}
+
+		template<bool TBigEndian>
+		MTDISASM_TARGET_SSE2 void ConvertRGB555ToRGB24SSE2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			size_t x = 0;
+			for (; x + 10 <= width; x += 8)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2));
+				if (TBigEndian)
+					v = SwapBytes16SSE2(v);
+
+				__m128i low, high;
+				RGB555ToRGBASSE2(v, low, high);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x * 3), CompactRGBASSE2(low));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x * 3 + 12), CompactRGBASSE2(high));
+			}
+
+			if (TBigEndian)
+				ConvertRGB555BEToRGB24Scalar(src + x * 2, dest + x * 3, width - x);
+			else
+				ConvertRGB555LEToRGB24Scalar(src + x * 2, dest + x * 3, width - x);
+		}
+
+		MTDISASM_TARGET_SSE2 void ConvertRGB555LEToRGB24SSE2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			ConvertRGB555ToRGB24SSE2<false>(src, dest, width);
+		}
+
+		MTDISASM_TARGET_SSE2 void ConvertRGB555BEToRGB24SSE2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			ConvertRGB555ToRGB24SSE2<true>(src, dest, width);
+		}
+
+		MTDISASM_TARGET_SSE2 void ConvertGray8ToRGB24SSE2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			size_t x = 0;
+			for (; x + 18 <= width; x += 16)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+				__m128i low = _mm_unpacklo_epi8(v, v);
+				__m128i high = _mm_unpackhi_epi8(v, v);
+
+				uint8_t* out = dest + x * 3;
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0), CompactRGBASSE2(_mm_unpacklo_epi16(low, low)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), CompactRGBASSE2(_mm_unpackhi_epi16(low, low)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 24), CompactRGBASSE2(_mm_unpacklo_epi16(high, high)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 36), CompactRGBASSE2(_mm_unpackhi_epi16(high, high)));
+			}
+
+			ConvertGray8ToRGB24Scalar(src + x, dest + x * 3, width - x);
+		}
+
+		template<bool TBigEndian>
+		MTDISASM_TARGET_SSE2 void ConvertRGB555ToRGBA32SSE2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			size_t x = 0;
+			for (; x + 8 <= width; x += 8)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2));
+				if (TBigEndian)
+					v = SwapBytes16SSE2(v);
+
+				__m128i low, high;
+				RGB555ToRGBASSE2(v, low, high);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x * 4), low);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x * 4 + 16), high);
+			}
+
+			if (TBigEndian)
+				ConvertRGB555BEToRGBA32Scalar(src + x * 2, dest + x * 4, width - x);
+			else
+				ConvertRGB555LEToRGBA32Scalar(src + x * 2, dest + x * 4, width - x);
+		}
+
+		MTDISASM_TARGET_SSE2 void ConvertRGB555LEToRGBA32SSE2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			ConvertRGB555ToRGBA32SSE2<false>(src, dest, width);
+		}
+
+		MTDISASM_TARGET_SSE2 void ConvertRGB555BEToRGBA32SSE2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			ConvertRGB555ToRGBA32SSE2<true>(src, dest, width);
+		}
+
+		MTDISASM_TARGET_SSE2 void ConvertRGBX32ToRGBA32SSE2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+
+			size_t x = 0;
+			for (; x + 4 <= width; x += 4)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x * 4), _mm_or_si128(v, alpha));
+			}
+
+			ConvertRGBX32ToRGBA32Scalar(src + x * 4, dest + x * 4, width - x);
+		}
+
+		const PixelRowConverters g_sse2Converters =
+		{
+			"sse2",
+			ConvertWin32ToRGB24SSE2,
+			ConvertMac32ToRGB24SSE2,
+			ConvertRGB555LEToRGB24SSE2,
+			ConvertRGB555BEToRGB24SSE2,
+			ConvertGray8ToRGB24SSE2,
+			ConvertGray4ToRGB24Scalar,
+			ConvertGray2ToRGB24Scalar,
+			ConvertGray1ToRGB24Scalar,
+			ConvertIndexed8ToRGBA32Scalar,
+			ConvertRGB555LEToRGBA32SSE2,
+			ConvertRGB555BEToRGBA32SSE2,
+			ConvertRGBX32ToRGBA32SSE2,
+		};
+
+		// AVX2
+
+		// 8 RGBA pixels to 24 bytes of RGB.  Stores 28 bytes.
+		MTDISASM_TARGET_AVX2 inline void StoreRGBAAsRGB24AVX2(uint8_t* dest, __m256i rgba)
+		{
+			const __m256i compact = _mm256_setr_epi8(
+				0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+				0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+			__m256i rgb = _mm256_shuffle_epi8(rgba, compact);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm256_castsi256_si128(rgb));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 12), _mm256_extracti128_si256(rgb, 1));
+		}
+
+		MTDISASM_TARGET_AVX2 inline __m256i Expand5AVX2(__m256i c)
+		{
+			return _mm256_or_si256(_mm256_slli_epi32(c, 3), _mm256_srli_epi32(c, 2));
+		}
+
+		// 8 RGB555 pixels, one per dword, to RGBA
+		MTDISASM_TARGET_AVX2 inline __m256i RGB555ToRGBAAVX2(__m256i v)
+		{
+			const __m256i mask5 = _mm256_set1_epi32(0x1f);
+
+			__m256i r = Expand5AVX2(_mm256_and_si256(_mm256_srli_epi32(v, 10), mask5));
+			__m256i g = Expand5AVX2(_mm256_and_si256(_mm256_srli_epi32(v, 5), mask5));
+			__m256i b = Expand5AVX2(_mm256_and_si256(v, mask5));
+
+			__m256i rgba = _mm256_or_si256(r, _mm256_slli_epi32(g, 8));
+			rgba = _mm256_or_si256(rgba, _mm256_slli_epi32(b, 16));
+			return _mm256_or_si256(rgba, _mm256_set1_epi32(static_cast<int>(0xff000000)));
+		}
+
+		MTDISASM_TARGET_AVX2 void ConvertWin32ToRGB24AVX2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			// Reorders bytes 3, 2, 1 to 0, 1, 2 so that compacting leaves RGB
+			const __m256i swizzle = _mm256_setr_epi8(
+				3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+				3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+			size_t x = 0;
+			for (; x + 10 <= width; x += 8)
+			{
+				__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 4));
+				StoreRGBAAsRGB24AVX2(dest + x * 3, _mm256_shuffle_epi8(v, swizzle));
+			}
+
+			ConvertWin32ToRGB24Scalar(src + x * 4, dest + x * 3, width - x);
+		}
+
+		MTDISASM_TARGET_AVX2 void ConvertMac32ToRGB24AVX2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			size_t x = 0;
+			for (; x + 10 <= width; x += 8)
+			{
+				__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 4));
+				StoreRGBAAsRGB24AVX2(dest + x * 3, v);
+			}
+
+			ConvertMac32ToRGB24Scalar(src + x * 4, dest + x * 3, width - x);
+		}
+
+		template<bool TBigEndian>
+		MTDISASM_TARGET_AVX2 void ConvertRGB555ToRGB24AVX2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			size_t x = 0;
+			for (; x + 10 <= width; x += 8)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2));
+				if (TBigEndian)
+					v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+
+				StoreRGBAAsRGB24AVX2(dest + x * 3, RGB555ToRGBAAVX2(_mm256_cvtepu16_epi32(v)));
+			}
+
+			if (TBigEndian)
+				ConvertRGB555BEToRGB24Scalar(src + x * 2, dest + x * 3, width - x);
+			else
+				ConvertRGB555LEToRGB24Scalar(src + x * 2, dest + x * 3, width - x);
+		}
+
+		MTDISASM_TARGET_AVX2 void ConvertRGB555LEToRGB24AVX2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			ConvertRGB555ToRGB24AVX2<false>(src, dest, width);
+		}
+
+		MTDISASM_TARGET_AVX2 void ConvertRGB555BEToRGB24AVX2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			ConvertRGB555ToRGB24AVX2<true>(src, dest, width);
+		}
+
+		MTDISASM_TARGET_AVX2 void ConvertGray8ToRGB24AVX2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			// Each zero-extended gray byte to 3 copies of itself
+			const __m256i spread = _mm256_setr_epi8(
+				0, 0, 0, 4, 4, 4, 8, 8, 8, 12, 12, 12, -1, -1, -1, -1,
+				0, 0, 0, 4, 4, 4, 8, 8, 8, 12, 12, 12, -1, -1, -1, -1);
+
+			size_t x = 0;
+			for (; x + 10 <= width; x += 8)
+			{
+				__m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + x)));
+				__m256i rgb = _mm256_shuffle_epi8(v, spread);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x * 3), _mm256_castsi256_si128(rgb));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x * 3 + 12), _mm256_extracti128_si256(rgb, 1));
+			}
+
+			ConvertGray8ToRGB24Scalar(src + x, dest + x * 3, width - x);
+		}
+
+		MTDISASM_TARGET_AVX2 void ConvertIndexed8ToRGBA32AVX2(const uint8_t* src, uint8_t* dest, size_t width, const uint32_t* palette)
+		{
+			const int* paletteInts = reinterpret_cast<const int*>(palette);
+
+			size_t x = 0;
+			for (; x + 8 <= width; x += 8)
+			{
+				__m256i indexes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + x)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + x * 4), _mm256_i32gather_epi32(paletteInts, indexes, 4));
+			}
+
+			ConvertIndexed8ToRGBA32Scalar(src + x, dest + x * 4, width - x, palette);
+		}
+
+		template<bool TBigEndian>
+		MTDISASM_TARGET_AVX2 void ConvertRGB555ToRGBA32AVX2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			size_t x = 0;
+			for (; x + 8 <= width; x += 8)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2));
+				if (TBigEndian)
+					v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + x * 4), RGB555ToRGBAAVX2(_mm256_cvtepu16_epi32(v)));
+			}
+
+			if (TBigEndian)
+				ConvertRGB555BEToRGBA32Scalar(src + x * 2, dest + x * 4, width - x);
+			else
+				ConvertRGB555LEToRGBA32Scalar(src + x * 2, dest + x * 4, width - x);
+		}
+
+		MTDISASM_TARGET_AVX2 void ConvertRGB555LEToRGBA32AVX2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			ConvertRGB555ToRGBA32AVX2<false>(src, dest, width);
+		}
+
+		MTDISASM_TARGET_AVX2 void ConvertRGB555BEToRGBA32AVX2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			ConvertRGB555ToRGBA32AVX2<true>(src, dest, width);
+		}
+
+		MTDISASM_TARGET_AVX2 void ConvertRGBX32ToRGBA32AVX2(const uint8_t* src, uint8_t* dest, size_t width)
+		{
+			const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xff000000));
+
+			size_t x = 0;
+			for (; x + 8 <= width; x += 8)
+			{
+				__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 4));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + x * 4), _mm256_or_si256(v, alpha));
+			}
+
+			ConvertRGBX32ToRGBA32Scalar(src + x * 4, dest + x * 4, width - x);
+		}
+
+		const PixelRowConverters g_avx2Converters =
+		{
+			"avx2",
+			ConvertWin32ToRGB24AVX2,
+			ConvertMac32ToRGB24AVX2,
+			ConvertRGB555LEToRGB24AVX2,
+			ConvertRGB555BEToRGB24AVX2,
+			ConvertGray8ToRGB24AVX2,
+			ConvertGray4ToRGB24Scalar,
+			ConvertGray2ToRGB24Scalar,
+			ConvertGray1ToRGB24Scalar,
+			ConvertIndexed8ToRGBA32AVX2,
+			ConvertRGB555LEToRGBA32AVX2,
+			ConvertRGB555BEToRGBA32AVX2,
+			ConvertRGBX32ToRGBA32AVX2,
+		};
+
+		bool CPUHasSSE2()
+		{
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 1);
+			return (info[3] & (1 << 26)) != 0;
+#else
+			return __builtin_cpu_supports("sse2") != 0;
+#endif
+		}
+
+		bool CPUHasAVX2()
+		{
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+				return false;
+
+			// The OS also has to save the YMM registers
+			__cpuid(info, 1);
+			const int osxsaveAndAVX = (1 << 27) | (1 << 28);
+			if ((info[2] & osxsaveAndAVX) != osxsaveAndAVX || (_xgetbv(0) & 6) != 6)
+				return false;
+
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+#else
+			return __builtin_cpu_supports("avx2") != 0;
+#endif
+		}
+#endif
+	}
+
+	bool IsPixelConvertISASupported(PixelConvertISA isa)
+	{
+		switch (isa)
+		{
+		case PixelConvertISA::kAuto:
+		case PixelConvertISA::kScalar:
+			return true;
+#ifdef MTDISASM_PIXEL_CONVERT_X86
+		case PixelConvertISA::kSSE2:
+			return CPUHasSSE2();
+		case PixelConvertISA::kAVX2:
+			return CPUHasAVX2();
+#endif
+		default:
+			return false;
+		}
+	}
+
+	const PixelRowConverters* GetPixelRowConverters(PixelConvertISA isa)
+	{
+		if (isa == PixelConvertISA::kAuto)
+		{
+			static const PixelRowConverters* bestConverters = IsPixelConvertISASupported(PixelConvertISA::kAVX2) ? GetPixelRowConverters(PixelConvertISA::kAVX2)
+				: IsPixelConvertISASupported(PixelConvertISA::kSSE2) ? GetPixelRowConverters(PixelConvertISA::kSSE2)
+				: GetPixelRowConverters(PixelConvertISA::kScalar);
+			return bestConverters;
+		}
+
+		if (!IsPixelConvertISASupported(isa))
+			return nullptr;
+
+		switch (isa)
+		{
+		case PixelConvertISA::kScalar:
+			return &g_scalarConverters;
+#ifdef MTDISASM_PIXEL_CONVERT_X86
+		case PixelConvertISA::kSSE2:
+			return &g_sse2Converters;
+		case PixelConvertISA::kAVX2:
+			return &g_avx2Converters;
+#endif
+		default:
+			return nullptr;
+		}
+	}
+}
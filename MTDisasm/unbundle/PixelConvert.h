@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mtdisasm
+{
+	enum class PixelConvertISA
+	{
+		kAuto,		// The fastest that this CPU supports
+		kScalar,
+		kSSE2,
+		kAVX2,
+	};
+
+	// Converts one row of width pixels from a stored pixel format.  Every instruction set
+	// produces the same bytes as the scalar converters.
+	//
+	// RGB24 output is for image assets:
+	//     Win32:        R, G, B are bytes 3, 2, 1 of each 4-byte pixel
+	//     Mac32:        R, G, B are bytes 0, 1, 2 of each 4-byte pixel
+	//     RGB555LE/BE:  xRRRRRGG GGGBBBBB in little or big endian, 5-bit channels scaled by 33/4
+	//     GrayN:        N-bit gray levels, first pixel in the high bits of each byte.  Gray4
+	//                   and Gray2 shift by one bit per pixel instead of N, as the image
+	//                   extractor always has, so that output doesn't change.
+	//
+	// RGBA32 output is for mToon frames and is always opaque.  Palettes are 256 entries
+	// holding the R, G, B, A bytes in memory order.
+	struct PixelRowConverters
+	{
+		const char* m_name;
+
+		void (*m_convertWin32ToRGB24)(const uint8_t* src, uint8_t* dest, size_t width);
+		void (*m_convertMac32ToRGB24)(const uint8_t* src, uint8_t* dest, size_t width);
+		void (*m_convertRGB555LEToRGB24)(const uint8_t* src, uint8_t* dest, size_t width);
+		void (*m_convertRGB555BEToRGB24)(const uint8_t* src, uint8_t* dest, size_t width);
+		void (*m_convertGray8ToRGB24)(const uint8_t* src, uint8_t* dest, size_t width);
+		void (*m_convertGray4ToRGB24)(const uint8_t* src, uint8_t* dest, size_t width);
+		void (*m_convertGray2ToRGB24)(const uint8_t* src, uint8_t* dest, size_t width);
+		void (*m_convertGray1ToRGB24)(const uint8_t* src, uint8_t* dest, size_t width);
+
+		void (*m_convertIndexed8ToRGBA32)(const uint8_t* src, uint8_t* dest, size_t width, const uint32_t* palette);
+		void (*m_convertRGB555LEToRGBA32)(const uint8_t* src, uint8_t* dest, size_t width);
+		void (*m_convertRGB555BEToRGBA32)(const uint8_t* src, uint8_t* dest, size_t width);
+		void (*m_convertRGBX32ToRGBA32)(const uint8_t* src, uint8_t* dest, size_t width);
+	};
+
+	bool IsPixelConvertISASupported(PixelConvertISA isa);
+
+	// Returns null if the instruction set isn't supported by this build or CPU
+	const PixelRowConverters* GetPixelRowConverters(PixelConvertISA isa);
+}
@@ -0,0 +1,395 @@
+#include "PixelConvert.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Checks that the pixel converters produce the same bytes as the loops that the image and
+// mToon extractors used before them, on every instruction set this CPU supports
+
+namespace
+{
+	// The extractors' original loops, kept as the reference
+
+	void RefWin32ToRGB24(const uint8_t* src, uint8_t* dest, size_t width)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			dest[x * 3 + 0] = src[x * 4 + 3];
+			dest[x * 3 + 1] = src[x * 4 + 2];
+			dest[x * 3 + 2] = src[x * 4 + 1];
+		}
+	}
+
+	void RefMac32ToRGB24(const uint8_t* src, uint8_t* dest, size_t width)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			dest[x * 3 + 0] = src[x * 4 + 0];
+			dest[x * 3 + 1] = src[x * 4 + 1];
+			dest[x * 3 + 2] = src[x * 4 + 2];
+		}
+	}
+
+	void RefRGB555ToRGB24(uint16_t packedPixel, uint8_t* dest)
+	{
+		dest[2] = ((packedPixel & 0x1f) * 33) >> 2;
+		dest[1] = (((packedPixel >> 5) & 0x1f) * 33) >> 2;
+		dest[0] = (((packedPixel >> 10) & 0x1f) * 33) >> 2;
+	}
+
+	void RefRGB555LEToRGB24(const uint8_t* src, uint8_t* dest, size_t width)
+	{
+		for (size_t x = 0; x < width; x++)
+			RefRGB555ToRGB24(static_cast<uint16_t>(src[x * 2 + 0] + (src[x * 2 + 1] << 8)), dest + x * 3);
+	}
+
+	void RefRGB555BEToRGB24(const uint8_t* src, uint8_t* dest, size_t width)
+	{
+		for (size_t x = 0; x < width; x++)
+			RefRGB555ToRGB24(static_cast<uint16_t>(src[x * 2 + 1] + (src[x * 2 + 0] << 8)), dest + x * 3);
+	}
+
+	void RefGray8ToRGB24(const uint8_t* src, uint8_t* dest, size_t width)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			dest[x * 3 + 0] = src[x];
+			dest[x * 3 + 1] = src[x];
+			dest[x * 3 + 2] = src[x];
+		}
+	}
+
+	void RefGray4ToRGB24(const uint8_t* src, uint8_t* dest, size_t width)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			int bit = (src[x / 2] >> (1 - (x % 2))) & 15;
+			uint8_t byte = bit * 17;
+			dest[x * 3 + 0] = byte;
+			dest[x * 3 + 1] = byte;
+			dest[x * 3 + 2] = byte;
+		}
+	}
+
+	void RefGray2ToRGB24(const uint8_t* src, uint8_t* dest, size_t width)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			int bit = (src[x / 4] >> (3 - (x % 4))) & 3;
+			uint8_t byte = bit * 85;
+			dest[x * 3 + 0] = byte;
+			dest[x * 3 + 1] = byte;
+			dest[x * 3 + 2] = byte;
+		}
+	}
+
+	void RefGray1ToRGB24(const uint8_t* src, uint8_t* dest, size_t width)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			int bit = (src[x / 8] >> (7 - (x % 8))) & 1;
+			uint8_t byte = bit * 255;
+			dest[x * 3 + 0] = byte;
+			dest[x * 3 + 1] = byte;
+			dest[x * 3 + 2] = byte;
+		}
+	}
+
+	void RefIndexed8ToRGBA32(const uint8_t* src, uint8_t* dest, size_t width, const uint32_t* palette)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			const uint8_t* color = reinterpret_cast<const uint8_t*>(&palette[src[x]]);
+			dest[x * 4 + 0] = color[0];
+			dest[x * 4 + 1] = color[1];
+			dest[x * 4 + 2] = color[2];
+			dest[x * 4 + 3] = 255;
+		}
+	}
+
+	void RefRGB555LEToRGBA32(const uint8_t* src, uint8_t* dest, size_t width)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			RefRGB555ToRGB24(static_cast<uint16_t>(src[x * 2 + 0] + (src[x * 2 + 1] << 8)), dest + x * 4);
+			dest[x * 4 + 3] = 255;
+		}
+	}
+
+	void RefRGB555BEToRGBA32(const uint8_t* src, uint8_t* dest, size_t width)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			RefRGB555ToRGB24(static_cast<uint16_t>(src[x * 2 + 1] + (src[x * 2 + 0] << 8)), dest + x * 4);
+			dest[x * 4 + 3] = 255;
+		}
+	}
+
+	void RefRGBX32ToRGBA32(const uint8_t* src, uint8_t* dest, size_t width)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			dest[x * 4 + 0] = src[x * 4 + 0];
+			dest[x * 4 + 1] = src[x * 4 + 1];
+			dest[x * 4 + 2] = src[x * 4 + 2];
+			dest[x * 4 + 3] = 255;
+		}
+	}
+
+	typedef void (*ConvertFunc)(const uint8_t* src, uint8_t* dest, size_t width);
+	typedef void (*ConvertPaletteFunc)(const uint8_t* src, uint8_t* dest, size_t width, const uint32_t* palette);
+
+	struct ConverterCase
+	{
+		const char* m_name;
+		ConvertFunc mtdisasm::PixelRowConverters::*m_convert;
+		ConvertPaletteFunc mtdisasm::PixelRowConverters::*m_convertWithPalette;
+		ConvertFunc m_reference;
+		ConvertPaletteFunc m_referenceWithPalette;
+		size_t m_srcBitsPerPixel;
+		size_t m_destBytesPerPixel;
+	};
+
+	const ConverterCase kConverterCases[] =
+	{
+		{ "Win32ToRGB24", &mtdisasm::PixelRowConverters::m_convertWin32ToRGB24, nullptr, RefWin32ToRGB24, nullptr, 32, 3 },
+		{ "Mac32ToRGB24", &mtdisasm::PixelRowConverters::m_convertMac32ToRGB24, nullptr, RefMac32ToRGB24, nullptr, 32, 3 },
+		{ "RGB555LEToRGB24", &mtdisasm::PixelRowConverters::m_convertRGB555LEToRGB24, nullptr, RefRGB555LEToRGB24, nullptr, 16, 3 },
+		{ "RGB555BEToRGB24", &mtdisasm::PixelRowConverters::m_convertRGB555BEToRGB24, nullptr, RefRGB555BEToRGB24, nullptr, 16, 3 },
+		{ "Gray8ToRGB24", &mtdisasm::PixelRowConverters::m_convertGray8ToRGB24, nullptr, RefGray8ToRGB24, nullptr, 8, 3 },
+		{ "Gray4ToRGB24", &mtdisasm::PixelRowConverters::m_convertGray4ToRGB24, nullptr, RefGray4ToRGB24, nullptr, 4, 3 },
+		{ "Gray2ToRGB24", &mtdisasm::PixelRowConverters::m_convertGray2ToRGB24, nullptr, RefGray2ToRGB24, nullptr, 2, 3 },
+		{ "Gray1ToRGB24", &mtdisasm::PixelRowConverters::m_convertGray1ToRGB24, nullptr, RefGray1ToRGB24, nullptr, 1, 3 },
+		{ "Indexed8ToRGBA32", nullptr, &mtdisasm::PixelRowConverters::m_convertIndexed8ToRGBA32, nullptr, RefIndexed8ToRGBA32, 8, 4 },
+		{ "RGB555LEToRGBA32", &mtdisasm::PixelRowConverters::m_convertRGB555LEToRGBA32, nullptr, RefRGB555LEToRGBA32, nullptr, 16, 4 },
+		{ "RGB555BEToRGBA32", &mtdisasm::PixelRowConverters::m_convertRGB555BEToRGBA32, nullptr, RefRGB555BEToRGBA32, nullptr, 16, 4 },
+		{ "RGBX32ToRGBA32", &mtdisasm::PixelRowConverters::m_convertRGBX32ToRGBA32, nullptr, RefRGBX32ToRGBA32, nullptr, 32, 4 },
+	};
+
+	// Widths around each vector step, up to a few AVX2 iterations
+	const size_t kWidths[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 23, 24, 25, 31, 32, 33, 47, 48, 49, 63, 64, 65, 100 };
+
+	// Bytes written past the row show up as changed guard bytes
+	const size_t kGuardSize = 64;
+	const uint8_t kGuardByte = 0xcd;
+
+	uint32_t g_randomState = 12345;
+
+	uint8_t RandomByte()
+	{
+		g_randomState = g_randomState * 1103515245u + 12345u;
+		return static_cast<uint8_t>(g_randomState >> 16);
+	}
+
+	void MakeTestPalette(uint32_t* palette)
+	{
+		// Opaque like the Mac standard palette, which the extractor's loop didn't read alpha from
+		for (size_t i = 0; i < 256; i++)
+		{
+			const uint8_t rgba[4] = { static_cast<uint8_t>(i), static_cast<uint8_t>(255 - i), static_cast<uint8_t>(i * 7), 255 };
+			memcpy(&palette[i], rgba, 4);
+		}
+	}
+
+	bool RunConverter(const mtdisasm::PixelRowConverters& converters, const ConverterCase& converterCase, const uint8_t* src, uint8_t* dest, size_t width, const uint32_t* palette)
+	{
+		if (converterCase.m_convert)
+		{
+			ConvertFunc convert = converters.*converterCase.m_convert;
+			if (!convert)
+				return false;
+			convert(src, dest, width);
+		}
+		else
+		{
+			ConvertPaletteFunc convert = converters.*converterCase.m_convertWithPalette;
+			if (!convert)
+				return false;
+			convert(src, dest, width, palette);
+		}
+
+		return true;
+	}
+
+	void RunReference(const ConverterCase& converterCase, const uint8_t* src, uint8_t* dest, size_t width, const uint32_t* palette)
+	{
+		if (converterCase.m_reference)
+			converterCase.m_reference(src, dest, width);
+		else
+			converterCase.m_referenceWithPalette(src, dest, width, palette);
+	}
+
+	// Compares each converter against the reference loops on random rows
+	bool TestAgainstReference(const mtdisasm::PixelRowConverters& converters)
+	{
+		bool passed = true;
+
+		uint32_t palette[256];
+		MakeTestPalette(palette);
+
+		for (const ConverterCase& converterCase : kConverterCases)
+		{
+			for (size_t width : kWidths)
+			{
+				for (int trial = 0; trial < 4; trial++)
+				{
+					const size_t srcSize = (width * converterCase.m_srcBitsPerPixel + 7) / 8;
+					const size_t destSize = width * converterCase.m_destBytesPerPixel;
+
+					// The source is exactly the row's size so that reads past it are caught by
+					// address sanitizer builds
+					std::vector<uint8_t> src(srcSize);
+					for (uint8_t& b : src)
+						b = RandomByte();
+
+					std::vector<uint8_t> expected(destSize + kGuardSize, kGuardByte);
+					std::vector<uint8_t> actual(destSize + kGuardSize, kGuardByte);
+
+					const uint8_t* srcData = src.empty() ? nullptr : src.data();
+					RunReference(converterCase, srcData, expected.data(), width, palette);
+					if (!RunConverter(converters, converterCase, srcData, actual.data(), width, palette))
+					{
+						fprintf(stderr, "FAIL %s %s: Missing converter\n", converters.m_name, converterCase.m_name);
+						passed = false;
+						break;
+					}
+
+					if (expected != actual)
+					{
+						size_t mismatch = 0;
+						while (expected[mismatch] == actual[mismatch])
+							mismatch++;
+
+						fprintf(stderr, "FAIL %s %s width %u: Byte %u is %02x, expected %02x%s\n", converters.m_name, converterCase.m_name, static_cast<unsigned int>(width), static_cast<unsigned int>(mismatch),
+							static_cast<unsigned int>(actual[mismatch]), static_cast<unsigned int>(expected[mismatch]), (mismatch >= destSize) ? " (past the end of the row)" : "");
+						passed = false;
+						break;
+					}
+				}
+			}
+		}
+
+		return passed;
+	}
+
+	bool CheckBytes(const char* name, const uint8_t* actual, const uint8_t* expected, size_t size)
+	{
+		if (!memcmp(actual, expected, size))
+			return true;
+
+		fprintf(stderr, "FAIL scalar %s:", name);
+		for (size_t i = 0; i < size; i++)
+			fprintf(stderr, " %02x", static_cast<unsigned int>(actual[i]));
+		fprintf(stderr, ", expected");
+		for (size_t i = 0; i < size; i++)
+			fprintf(stderr, " %02x", static_cast<unsigned int>(expected[i]));
+		fprintf(stderr, "\n");
+		return false;
+	}
+
+	// Pins the scalar converters, and with them the reference, to known output
+	bool TestScalarExpectedBytes()
+	{
+		const mtdisasm::PixelRowConverters& converters = *mtdisasm::GetPixelRowConverters(mtdisasm::PixelConvertISA::kScalar);
+		bool passed = true;
+		uint8_t out[32];
+
+		{
+			const uint8_t src[] = { 0x10, 0x20, 0x30, 0x40, 0xa0, 0xb0, 0xc0, 0xd0 };
+
+			const uint8_t expectedWin32[] = { 0x40, 0x30, 0x20, 0xd0, 0xc0, 0xb0 };
+			converters.m_convertWin32ToRGB24(src, out, 2);
+			passed = CheckBytes("Win32ToRGB24", out, expectedWin32, sizeof(expectedWin32)) && passed;
+
+			const uint8_t expectedMac32[] = { 0x10, 0x20, 0x30, 0xa0, 0xb0, 0xc0 };
+			converters.m_convertMac32ToRGB24(src, out, 2);
+			passed = CheckBytes("Mac32ToRGB24", out, expectedMac32, sizeof(expectedMac32)) && passed;
+
+			const uint8_t expectedRGBX32[] = { 0x10, 0x20, 0x30, 0xff, 0xa0, 0xb0, 0xc0, 0xff };
+			converters.m_convertRGBX32ToRGBA32(src, out, 2);
+			passed = CheckBytes("RGBX32ToRGBA32", out, expectedRGBX32, sizeof(expectedRGBX32)) && passed;
+		}
+
+		{
+			// 0x7c1f is red and blue at 31, 0x03e0 is green at 31, and 0x0421 and 0x4210 are every
+			// channel at 1 and 16.  Channels expand as (x * 33) >> 2, so 31 -> 255, 1 -> 8, 16 -> 132.
+			const uint8_t srcLE[] = { 0x1f, 0x7c, 0xe0, 0x03, 0x21, 0x04, 0x10, 0x42 };
+			const uint8_t srcBE[] = { 0x7c, 0x1f, 0x03, 0xe0, 0x04, 0x21, 0x42, 0x10 };
+
+			const uint8_t expectedRGB24[] = { 255, 0, 255, 0, 255, 0, 8, 8, 8, 132, 132, 132 };
+			converters.m_convertRGB555LEToRGB24(srcLE, out, 4);
+			passed = CheckBytes("RGB555LEToRGB24", out, expectedRGB24, sizeof(expectedRGB24)) && passed;
+			converters.m_convertRGB555BEToRGB24(srcBE, out, 4);
+			passed = CheckBytes("RGB555BEToRGB24", out, expectedRGB24, sizeof(expectedRGB24)) && passed;
+
+			const uint8_t expectedRGBA32[] = { 255, 0, 255, 255, 0, 255, 0, 255, 8, 8, 8, 255, 132, 132, 132, 255 };
+			converters.m_convertRGB555LEToRGBA32(srcLE, out, 4);
+			passed = CheckBytes("RGB555LEToRGBA32", out, expectedRGBA32, sizeof(expectedRGBA32)) && passed;
+			converters.m_convertRGB555BEToRGBA32(srcBE, out, 4);
+			passed = CheckBytes("RGB555BEToRGBA32", out, expectedRGBA32, sizeof(expectedRGBA32)) && passed;
+		}
+
+		{
+			const uint8_t src[] = { 0x00, 0x7f, 0xff };
+			const uint8_t expected[] = { 0x00, 0x00, 0x00, 0x7f, 0x7f, 0x7f, 0xff, 0xff, 0xff };
+			converters.m_convertGray8ToRGB24(src, out, 3);
+			passed = CheckBytes("Gray8ToRGB24", out, expected, sizeof(expected)) && passed;
+		}
+
+		{
+			// Pixels are shifted by 1 and 0 bits rather than 4 and 0, so 0xab gives 5 and 11, and
+			// 0xf0 gives 8 and 0
+			const uint8_t src[] = { 0xab, 0xf0 };
+			const uint8_t expected[] = { 85, 85, 85, 187, 187, 187, 136, 136, 136, 0, 0, 0 };
+			converters.m_convertGray4ToRGB24(src, out, 4);
+			passed = CheckBytes("Gray4ToRGB24", out, expected, sizeof(expected)) && passed;
+		}
+
+		{
+			// Pixels are shifted by 3, 2, 1, and 0 bits, so 0xb4 gives 2, 1, 2, and 0
+			const uint8_t src[] = { 0xb4 };
+			const uint8_t expected[] = { 170, 170, 170, 85, 85, 85, 170, 170, 170, 0, 0, 0 };
+			converters.m_convertGray2ToRGB24(src, out, 4);
+			passed = CheckBytes("Gray2ToRGB24", out, expected, sizeof(expected)) && passed;
+		}
+
+		{
+			const uint8_t src[] = { 0xa5 };
+			const uint8_t expected[] = { 255, 255, 255, 0, 0, 0, 255, 255, 255, 0, 0, 0, 0, 0, 0, 255, 255, 255, 0, 0, 0, 255, 255, 255 };
+			converters.m_convertGray1ToRGB24(src, out, 8);
+			passed = CheckBytes("Gray1ToRGB24", out, expected, sizeof(expected)) && passed;
+		}
+
+		{
+			uint32_t palette[256];
+			MakeTestPalette(palette);
+
+			const uint8_t src[] = { 0, 1, 200 };
+			const uint8_t expected[] = { 0, 255, 0, 255, 1, 254, 7, 255, 200, 55, 120, 255 };
+			converters.m_convertIndexed8ToRGBA32(src, out, 3, palette);
+			passed = CheckBytes("Indexed8ToRGBA32", out, expected, sizeof(expected)) && passed;
+		}
+
+		return passed;
+	}
+}
+
+int main()
+{
+	bool passed = TestScalarExpectedBytes();
+
+	const mtdisasm::PixelConvertISA isas[] = { mtdisasm::PixelConvertISA::kScalar, mtdisasm::PixelConvertISA::kSSE2, mtdisasm::PixelConvertISA::kAVX2 };
+	for (mtdisasm::PixelConvertISA isa : isas)
+	{
+		const mtdisasm::PixelRowConverters* converters = mtdisasm::GetPixelRowConverters(isa);
+		if (!converters)
+			continue;
+
+		const bool isaPassed = TestAgainstReference(*converters);
+		printf("%s: %s\n", converters->m_name, isaPassed ? "passed" : "FAILED");
+		passed = isaPassed && passed;
+	}
+
+	return passed ? 0 : 1;
+}
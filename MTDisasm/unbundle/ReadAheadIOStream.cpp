@@ -0,0 +1,127 @@
+#include "ReadAheadIOStream.h"
+
+#include <cstring>
+
+namespace mtdisasm
+{
+	ReadAheadIOStream::ReadAheadIOStream(const IOStream& parent, size_t length, size_t blockSize)
+		: m_parent(parent)
+		, m_length(length)
+		, m_blockSize(blockSize)
+		, m_pos(0)
+		, m_bufferStart(0)
+		, m_bufferFilled(0)
+	{
+	}
+
+	size_t ReadAheadIOStream::ReadPartial(void* dest, size_t sz)
+	{
+		size_t available = m_length - m_pos;
+		if (sz > available)
+			sz = available;
+
+		uint8_t* destBytes = static_cast<uint8_t*>(dest);
+		size_t amountRead = 0;
+		while (amountRead < sz)
+		{
+			if (m_pos >= m_bufferStart && m_pos < m_bufferStart + m_bufferFilled)
+			{
+				size_t bufferOffset = m_pos - m_bufferStart;
+				size_t amountToCopy = m_bufferFilled - bufferOffset;
+				if (amountToCopy > sz - amountRead)
+					amountToCopy = sz - amountRead;
+
+				memcpy(destBytes + amountRead, &m_buffer[bufferOffset], amountToCopy);
+				amountRead += amountToCopy;
+				m_pos += amountToCopy;
+				continue;
+			}
+
+			// Reads that would fill the whole buffer anyway bypass it
+			size_t remaining = sz - amountRead;
+			if (remaining >= m_blockSize)
+			{
+				size_t directRead = m_parent.ReadAtPartial(static_cast<uint32_t>(m_pos), destBytes + amountRead, remaining);
+				amountRead += directRead;
+				m_pos += directRead;
+				break;
+			}
+
+			if (m_buffer.empty())
+			{
+				size_t bufferSize = m_blockSize;
+				if (bufferSize > m_length)
+					bufferSize = m_length;
+				m_buffer.resize(bufferSize);
+			}
+
+			size_t amountToFill = m_buffer.size();
+			if (amountToFill > m_length - m_pos)
+				amountToFill = m_length - m_pos;
+
+			m_bufferStart = m_pos;
+			m_bufferFilled = m_parent.ReadAtPartial(static_cast<uint32_t>(m_pos), &m_buffer[0], amountToFill);
+			if (m_bufferFilled == 0)
+				break;
+		}
+
+		return amountRead;
+	}
+
+	size_t ReadAheadIOStream::WritePartial(const void* src, size_t sz)
+	{
+		return 0;
+	}
+
+	size_t ReadAheadIOStream::ReadAtPartial(uint32_t pos, void* dest, size_t sz) const
+	{
+		if (pos >= m_length)
+			return 0;
+
+		size_t available = m_length - pos;
+		if (sz > available)
+			sz = available;
+
+		return m_parent.ReadAtPartial(pos, dest, sz);
+	}
+
+	bool ReadAheadIOStream::SeekSet(int32_t pos)
+	{
+		if (pos < 0)
+			return false;
+		if (static_cast<size_t>(pos) > m_length)
+			return false;
+
+		m_pos = static_cast<size_t>(pos);
+
+		return true;
+	}
+
+	bool ReadAheadIOStream::SeekCur(int32_t pos)
+	{
+		return SeekSet(static_cast<int32_t>(m_pos) + pos);
+	}
+
+	bool ReadAheadIOStream::SeekEnd(int32_t pos)
+	{
+		if (pos > 0)
+			return false;
+		return SeekSet(static_cast<int32_t>(m_length) + pos);
+	}
+
+	uint32_t ReadAheadIOStream::Tell() const
+	{
+		return static_cast<uint32_t>(m_pos);
+	}
+
+	uint32_t ReadAheadIOStream::TellGlobal() const
+	{
+		// The parent is usually past m_pos after filling the buffer, so only its base is used
+		return m_parent.TellGlobal() - m_parent.Tell() + static_cast<uint32_t>(m_pos);
+	}
+
+	bool ReadAheadIOStream::GetContiguousSpan(const void*& outData, size_t& outSize, uint32_t& outGlobalBase) const
+	{
+		return m_parent.GetContiguousSpan(outData, outSize, outGlobalBase);
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "IOStream.h"
+
+#include <vector>
+
+namespace mtdisasm
+{
+	// Read-only stream that reads its parent in large blocks with ReadAt, for walking
+	// streams that aren't in memory with many small reads.  If the parent is backed by
+	// contiguous memory, its span is exposed directly and no buffer is allocated.
+	class ReadAheadIOStream final : public IOStream
+	{
+	public:
+		ReadAheadIOStream(const IOStream& parent, size_t length, size_t blockSize);
+
+		size_t ReadPartial(void* dest, size_t sz) override;
+		size_t WritePartial(const void* src, size_t sz) override;
+		size_t ReadAtPartial(uint32_t pos, void* dest, size_t sz) const override;
+
+		bool SeekSet(int32_t pos) override;
+		bool SeekCur(int32_t pos) override;
+		bool SeekEnd(int32_t pos) override;
+
+		uint32_t Tell() const override;
+		uint32_t TellGlobal() const override;
+
+		bool GetContiguousSpan(const void*& outData, size_t& outSize, uint32_t& outGlobalBase) const override;
+
+	private:
+		ReadAheadIOStream(const ReadAheadIOStream&) = delete;
+		ReadAheadIOStream& operator=(const ReadAheadIOStream&) = delete;
+
+		const IOStream& m_parent;
+		size_t m_length;
+		size_t m_blockSize;
+		size_t m_pos;
+
+		std::vector<uint8_t> m_buffer;
+		size_t m_bufferStart;
+		size_t m_bufferFilled;
+	};
+}
@@ -6,20 +6,21 @@ namespace mtdisasm
 		: m_parent(parent)
 		, m_offset(offset)
 		, m_length(length)
+		, m_pos(0)
 	{
 	}
 
 	size_t SliceIOStream::ReadPartial(void* dest, size_t sz)
 	{
-		size_t currentPos = m_parent.Tell();
-		if (currentPos < m_offset)
-		{
-			if (!m_parent.SeekSet(static_cast<int32_t>(m_offset)))
-				return 0;
-			currentPos = m_offset;
-		}
+		size_t amountRead = ReadAtPartial(static_cast<uint32_t>(m_pos), dest, sz);
+		m_pos += amountRead;
 
-		size_t available = m_length - (currentPos - m_offset);
+		return amountRead;
+	}
+
+	size_t SliceIOStream::WritePartial(const void* src, size_t sz)
+	{
+		size_t available = m_length - m_pos;
 
 		if (sz > available)
 			sz = available;
@@ -27,20 +28,21 @@ namespace mtdisasm
 		if (sz == 0)
 			return 0;
 
-		return m_parent.ReadPartial(dest, sz);
+		if (!m_parent.SeekSet(static_cast<int32_t>(m_offset + m_pos)))
+			return 0;
+
+		size_t amountWritten = m_parent.WritePartial(src, sz);
+		m_pos += amountWritten;
+
+		return amountWritten;
 	}
 
-	size_t SliceIOStream::WritePartial(const void* src, size_t sz)
+	size_t SliceIOStream::ReadAtPartial(uint32_t pos, void* dest, size_t sz) const
 	{
-		size_t currentPos = m_parent.Tell();
-		if (currentPos < m_offset)
-		{
-			if (!m_parent.SeekSet(static_cast<int32_t>(m_offset)))
-				return 0;
-			currentPos = m_offset;
-		}
+		if (pos >= m_length)
+			return 0;
 
-		size_t available = m_length - (currentPos - m_offset);
+		size_t available = m_length - pos;
 
 		if (sz > available)
 			sz = available;
@@ -48,7 +50,7 @@ namespace mtdisasm
 		if (sz == 0)
 			return 0;
 
-		return m_parent.WritePartial(src, sz);
+		return m_parent.ReadAtPartial(static_cast<uint32_t>(m_offset + pos), dest, sz);
 	}
 
 	bool SliceIOStream::SeekSet(int32_t pos)
@@ -56,19 +58,23 @@ namespace mtdisasm
 		if (pos < 0)
 			pos = 0;
 
-		return m_parent.SeekSet(pos + static_cast<int32_t>(m_offset));
+		if (static_cast<size_t>(pos) > m_length)
+			return false;
+
+		m_pos = static_cast<size_t>(pos);
+		return true;
 	}
 
 	bool SliceIOStream::SeekCur(int32_t pos)
 	{
-		int32_t currentPos = static_cast<int32_t>(Tell());
-		int32_t adjustedPos = currentPos + pos;
+		int32_t adjustedPos = static_cast<int32_t>(m_pos) + pos;
 		if (adjustedPos < 0)
 			return false;
 		if (adjustedPos > static_cast<int32_t>(m_length))
 			return false;
 
-		return m_parent.SeekSet(adjustedPos + static_cast<int32_t>(m_offset));
+		m_pos = static_cast<size_t>(adjustedPos);
+		return true;
 	}
 
 	bool SliceIOStream::SeekEnd(int32_t pos)
@@ -79,22 +85,35 @@ namespace mtdisasm
 		if (adjustedPos > static_cast<int32_t>(m_length))
 			return false;
 
-		return m_parent.SeekSet(adjustedPos + static_cast<int32_t>(m_offset));
+		m_pos = static_cast<size_t>(adjustedPos);
+		return true;
 	}
 
 	uint32_t SliceIOStream::Tell() const
 	{
-		int32_t pos = static_cast<int32_t>(m_parent.Tell()) - static_cast<int32_t>(m_offset);
-		if (pos < 0)
-			return 0;
-		if (static_cast<size_t>(pos) > m_length)
-			return static_cast<uint32_t>(m_length);
-
-		return static_cast<uint32_t>(pos);
+		return static_cast<uint32_t>(m_pos);
 	}
 
 	uint32_t SliceIOStream::TellGlobal() const
 	{
-		return m_parent.TellGlobal();
+		// The parent's global position minus its local position is the parent's global base
+		return m_parent.TellGlobal() - m_parent.Tell() + static_cast<uint32_t>(m_offset + m_pos);
+	}
+
+	bool SliceIOStream::GetContiguousSpan(const void*& outData, size_t& outSize, uint32_t& outGlobalBase) const
+	{
+		const void* parentData = nullptr;
+		size_t parentSize = 0;
+		uint32_t parentGlobalBase = 0;
+		if (!m_parent.GetContiguousSpan(parentData, parentSize, parentGlobalBase))
+			return false;
+
+		if (m_offset > parentSize || parentSize - m_offset < m_length)
+			return false;
+
+		outData = static_cast<const char*>(parentData) + m_offset;
+		outSize = m_length;
+		outGlobalBase = parentGlobalBase + static_cast<uint32_t>(m_offset);
+		return true;
 	}
 }
@@ -4,6 +4,8 @@
 
 namespace mtdisasm
 {
+	// Window into part of another stream.  The slice keeps its own position and reads
+	// with ReadAt, so it doesn't depend on or disturb the parent's position.
 	class SliceIOStream final : public IOStream
 	{
 	public:
@@ -11,6 +13,7 @@ namespace mtdisasm
 
 		size_t ReadPartial(void* dest, size_t sz) override;
 		size_t WritePartial(const void* src, size_t sz) override;
+		size_t ReadAtPartial(uint32_t pos, void* dest, size_t sz) const override;
 
 		bool SeekSet(int32_t pos) override;
 		bool SeekCur(int32_t pos) override;
@@ -19,9 +22,12 @@ namespace mtdisasm
 		uint32_t Tell() const override;
 		uint32_t TellGlobal() const override;
 
+		bool GetContiguousSpan(const void*& outData, size_t& outSize, uint32_t& outGlobalBase) const override;
+
 	private:
 		IOStream& m_parent;
 		size_t m_offset;
 		size_t m_length;
+		size_t m_pos;
 	};
 }
@@ -0,0 +1,311 @@
+#include "StructuredWriter.h"
+#include "TextWriter.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace mtdisasm
+{
+	void StructuredWriter::WriteString(const char* name, const char* str)
+	{
+		WriteString(name, str, strlen(str));
+	}
+
+	JSONLinesWriter::JSONLinesWriter(TextWriter& f)
+		: m_f(f)
+	{
+	}
+
+	void JSONLinesWriter::BeginRecord()
+	{
+		assert(m_levelHasValues.empty());
+
+		m_f.Put('{');
+		m_levelHasValues.push_back(false);
+	}
+
+	void JSONLinesWriter::EndRecord()
+	{
+		assert(m_levelHasValues.size() == 1);
+
+		m_f.Write("}\n", 2);
+		m_levelHasValues.pop_back();
+	}
+
+	void JSONLinesWriter::BeginObject(const char* name)
+	{
+		BeginValue(name);
+		m_f.Put('{');
+		m_levelHasValues.push_back(false);
+	}
+
+	void JSONLinesWriter::EndObject()
+	{
+		m_f.Put('}');
+		m_levelHasValues.pop_back();
+	}
+
+	void JSONLinesWriter::BeginArray(const char* name)
+	{
+		BeginValue(name);
+		m_f.Put('[');
+		m_levelHasValues.push_back(false);
+	}
+
+	void JSONLinesWriter::EndArray()
+	{
+		m_f.Put(']');
+		m_levelHasValues.pop_back();
+	}
+
+	void JSONLinesWriter::WriteUInt(const char* name, uint64_t value)
+	{
+		BeginValue(name);
+
+		if (value <= 0xffffffffu)
+			m_f.WriteDec(static_cast<uint32_t>(value));
+		else
+			m_f.Printf("%llu", static_cast<unsigned long long>(value));
+	}
+
+	void JSONLinesWriter::WriteInt(const char* name, int64_t value)
+	{
+		BeginValue(name);
+
+		if (value >= INT32_MIN && value <= INT32_MAX)
+			m_f.WriteDec(static_cast<int32_t>(value));
+		else
+			m_f.Printf("%lld", static_cast<long long>(value));
+	}
+
+	void JSONLinesWriter::WriteDouble(const char* name, double value)
+	{
+		BeginValue(name);
+
+		if (std::isfinite(value))
+			m_f.Printf("%.17g", value);
+		else
+			m_f.Write("null", 4);
+	}
+
+	void JSONLinesWriter::WriteBool(const char* name, bool value)
+	{
+		BeginValue(name);
+
+		if (value)
+			m_f.Write("true", 4);
+		else
+			m_f.Write("false", 5);
+	}
+
+	void JSONLinesWriter::WriteNull(const char* name)
+	{
+		BeginValue(name);
+		m_f.Write("null", 4);
+	}
+
+	void JSONLinesWriter::WriteString(const char* name, const char* chars, size_t length)
+	{
+		BeginValue(name);
+		WriteQuoted(chars, length);
+	}
+
+	void JSONLinesWriter::WriteBytes(const char* name, const uint8_t* bytes, size_t size)
+	{
+		BeginValue(name);
+
+		m_f.Put('\"');
+		for (size_t i = 0; i < size; i++)
+			m_f.WriteHex(bytes[i], 2);
+		m_f.Put('\"');
+	}
+
+	void JSONLinesWriter::BeginValue(const char* name)
+	{
+		assert(!m_levelHasValues.empty());
+
+		if (m_levelHasValues.back())
+			m_f.Put(',');
+		else
+			m_levelHasValues.back() = true;
+
+		if (name)
+		{
+			WriteQuoted(name, strlen(name));
+			m_f.Put(':');
+		}
+	}
+
+	void JSONLinesWriter::WriteQuoted(const char* chars, size_t length)
+	{
+		m_f.Put('\"');
+
+		size_t runStart = 0;
+		for (size_t i = 0; i < length; i++)
+		{
+			uint8_t c = static_cast<uint8_t>(chars[i]);
+			if (c >= 0x20 && c < 0x80 && c != '\"' && c != '\\')
+				continue;
+
+			m_f.Write(chars + runStart, i - runStart);
+			runStart = i + 1;
+
+			switch (c)
+			{
+			case '\"':
+				m_f.Write("\\\"", 2);
+				break;
+			case '\\':
+				m_f.Write("\\\\", 2);
+				break;
+			case '\n':
+				m_f.Write("\\n", 2);
+				break;
+			case '\r':
+				m_f.Write("\\r", 2);
+				break;
+			case '\t':
+				m_f.Write("\\t", 2);
+				break;
+			default:
+				m_f.Write("\\u00", 4);
+				m_f.WriteHex(c, 2);
+				break;
+			}
+		}
+
+		m_f.Write(chars + runStart, length - runStart);
+		m_f.Put('\"');
+	}
+
+	BinaryRecordWriter::BinaryRecordWriter(TextWriter& f)
+		: m_f(f)
+	{
+		m_f.Write("MTSR", 4);
+		m_f.Put(static_cast<char>(kVersion));
+	}
+
+	void BinaryRecordWriter::BeginRecord()
+	{
+		m_record.clear();
+	}
+
+	void BinaryRecordWriter::EndRecord()
+	{
+		m_record.push_back(kTagEnd);
+
+		uint8_t lengthBytes[10];
+		size_t numLengthBytes = 0;
+		uint64_t length = m_record.size();
+		while (length >= 0x80)
+		{
+			lengthBytes[numLengthBytes++] = static_cast<uint8_t>(length | 0x80);
+			length >>= 7;
+		}
+		lengthBytes[numLengthBytes++] = static_cast<uint8_t>(length);
+
+		m_f.Write(reinterpret_cast<const char*>(lengthBytes), numLengthBytes);
+		m_f.Write(reinterpret_cast<const char*>(&m_record[0]), m_record.size());
+	}
+
+	void BinaryRecordWriter::BeginObject(const char* name)
+	{
+		BeginValue(kTagObject, name);
+	}
+
+	void BinaryRecordWriter::EndObject()
+	{
+		m_record.push_back(kTagEnd);
+	}
+
+	void BinaryRecordWriter::BeginArray(const char* name)
+	{
+		BeginValue(kTagArray, name);
+	}
+
+	void BinaryRecordWriter::EndArray()
+	{
+		m_record.push_back(kTagEnd);
+	}
+
+	void BinaryRecordWriter::WriteUInt(const char* name, uint64_t value)
+	{
+		BeginValue(kTagUInt, name);
+		PutVarInt(value);
+	}
+
+	void BinaryRecordWriter::WriteInt(const char* name, int64_t value)
+	{
+		BeginValue(kTagInt, name);
+
+		uint64_t bits = static_cast<uint64_t>(value);
+		PutVarInt((bits << 1) ^ (value < 0 ? ~static_cast<uint64_t>(0) : 0));
+	}
+
+	void BinaryRecordWriter::WriteDouble(const char* name, double value)
+	{
+		BeginValue(kTagDouble, name);
+
+		uint64_t bits = 0;
+		memcpy(&bits, &value, 8);
+
+		uint8_t bytes[8];
+		for (int i = 0; i < 8; i++)
+			bytes[i] = static_cast<uint8_t>(bits >> (i * 8));
+
+		PutData(bytes, 8);
+	}
+
+	void BinaryRecordWriter::WriteBool(const char* name, bool value)
+	{
+		BeginValue(value ? kTagTrue : kTagFalse, name);
+	}
+
+	void BinaryRecordWriter::WriteNull(const char* name)
+	{
+		BeginValue(kTagNull, name);
+	}
+
+	void BinaryRecordWriter::WriteString(const char* name, const char* chars, size_t length)
+	{
+		BeginValue(kTagString, name);
+		PutVarInt(length);
+		PutData(chars, length);
+	}
+
+	void BinaryRecordWriter::WriteBytes(const char* name, const uint8_t* bytes, size_t size)
+	{
+		BeginValue(kTagBytes, name);
+		PutVarInt(size);
+		PutData(bytes, size);
+	}
+
+	void BinaryRecordWriter::BeginValue(Tag tag, const char* name)
+	{
+		m_record.push_back(static_cast<uint8_t>(tag));
+
+		if (name)
+		{
+			size_t length = strlen(name);
+			PutVarInt(length);
+			PutData(name, length);
+		}
+	}
+
+	void BinaryRecordWriter::PutVarInt(uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			m_record.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		m_record.push_back(static_cast<uint8_t>(value));
+	}
+
+	void BinaryRecordWriter::PutData(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		m_record.insert(m_record.end(), bytes, bytes + size);
+	}
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mtdisasm
+{
+	class TextWriter;
+
+	// Streams records made of named, nested fields.  Each record is written out as soon as
+	// it's ended, so memory use only depends on the size of the largest record.  Names
+	// are null for the elements of arrays and must be set for the fields of objects.
+	class StructuredWriter
+	{
+	public:
+		virtual ~StructuredWriter() {}
+
+		virtual void BeginRecord() = 0;
+		virtual void EndRecord() = 0;
+
+		virtual void BeginObject(const char* name) = 0;
+		virtual void EndObject() = 0;
+		virtual void BeginArray(const char* name) = 0;
+		virtual void EndArray() = 0;
+
+		virtual void WriteUInt(const char* name, uint64_t value) = 0;
+		virtual void WriteInt(const char* name, int64_t value) = 0;
+		virtual void WriteDouble(const char* name, double value) = 0;
+		virtual void WriteBool(const char* name, bool value) = 0;
+		virtual void WriteNull(const char* name) = 0;
+		virtual void WriteString(const char* name, const char* chars, size_t length) = 0;
+		virtual void WriteBytes(const char* name, const uint8_t* bytes, size_t size) = 0;
+
+		void WriteString(const char* name, const char* str);
+	};
+
+	// One JSON object per line.  Strings are Latin-1 so that every byte of a name survives,
+	// byte strings are written as hex, and non-finite numbers as null.
+	class JSONLinesWriter final : public StructuredWriter
+	{
+	public:
+		explicit JSONLinesWriter(TextWriter& f);
+
+		void BeginRecord() override;
+		void EndRecord() override;
+
+		void BeginObject(const char* name) override;
+		void EndObject() override;
+		void BeginArray(const char* name) override;
+		void EndArray() override;
+
+		void WriteUInt(const char* name, uint64_t value) override;
+		void WriteInt(const char* name, int64_t value) override;
+		void WriteDouble(const char* name, double value) override;
+		void WriteBool(const char* name, bool value) override;
+		void WriteNull(const char* name) override;
+		void WriteString(const char* name, const char* chars, size_t length) override;
+		void WriteBytes(const char* name, const uint8_t* bytes, size_t size) override;
+
+	private:
+		void BeginValue(const char* name);
+		void WriteQuoted(const char* chars, size_t length);
+
+		TextWriter& m_f;
+		std::vector<bool> m_levelHasValues;
+	};
+
+	// Compact binary records.  The file starts with "MTSR" and a version byte, then each
+	// record is a varint byte count followed by the fields of its top-level object and kTagEnd.
+	//
+	// A field is a tag byte, then its name as a varint length and characters if it's in an
+	// object, then its value:
+	//     kTagObject, kTagArray:  fields until kTagEnd
+	//     kTagUInt:               varint
+	//     kTagInt:                zigzag varint
+	//     kTagDouble:             8 bytes, little endian IEEE 754
+	//     kTagFalse, kTagTrue, kTagNull: nothing
+	//     kTagString, kTagBytes:  varint length and data
+	class BinaryRecordWriter final : public StructuredWriter
+	{
+	public:
+		enum Tag
+		{
+			kTagEnd = 0,
+			kTagObject = 1,
+			kTagArray = 2,
+			kTagUInt = 3,
+			kTagInt = 4,
+			kTagDouble = 5,
+			kTagFalse = 6,
+			kTagTrue = 7,
+			kTagNull = 8,
+			kTagString = 9,
+			kTagBytes = 10,
+		};
+
+		static const uint8_t kVersion = 1;
+
+		explicit BinaryRecordWriter(TextWriter& f);
+
+		void BeginRecord() override;
+		void EndRecord() override;
+
+		void BeginObject(const char* name) override;
+		void EndObject() override;
+		void BeginArray(const char* name) override;
+		void EndArray() override;
+
+		void WriteUInt(const char* name, uint64_t value) override;
+		void WriteInt(const char* name, int64_t value) override;
+		void WriteDouble(const char* name, double value) override;
+		void WriteBool(const char* name, bool value) override;
+		void WriteNull(const char* name) override;
+		void WriteString(const char* name, const char* chars, size_t length) override;
+		void WriteBytes(const char* name, const uint8_t* bytes, size_t size) override;
+
+	private:
+		void BeginValue(Tag tag, const char* name);
+		void PutVarInt(uint64_t value);
+		void PutData(const void* data, size_t size);
+
+		TextWriter& m_f;
+		std::vector<uint8_t> m_record;
+	};
+}
@@ -0,0 +1,181 @@
+#include "TextWriter.h"
+
+#include <cstdarg>
+
+namespace mtdisasm
+{
+	namespace
+	{
+		const char kDigitPairs[] =
+			"00010203040506070809"
+			"10111213141516171819"
+			"20212223242526272829"
+			"30313233343536373839"
+			"40414243444546474849"
+			"50515253545556575859"
+			"60616263646566676869"
+			"70717273747576777879"
+			"80818283848586878889"
+			"90919293949596979899";
+
+		// Formats into the end of a buffer of at least 10 characters and returns the first digit
+		char* FormatDec(uint32_t value, char* end)
+		{
+			char* digits = end;
+			while (value >= 100)
+			{
+				uint32_t pair = (value % 100) * 2;
+				value /= 100;
+				digits -= 2;
+				digits[0] = kDigitPairs[pair];
+				digits[1] = kDigitPairs[pair + 1];
+			}
+
+			if (value >= 10)
+			{
+				uint32_t pair = value * 2;
+				digits -= 2;
+				digits[0] = kDigitPairs[pair];
+				digits[1] = kDigitPairs[pair + 1];
+			}
+			else
+				*--digits = static_cast<char>('0' + value);
+
+			return digits;
+		}
+	}
+
+	TextWriter::TextWriter(FILE* f)
+		: m_f(f)
+		, m_string(nullptr)
+		, m_used(0)
+		, m_failed(false)
+	{
+		m_buffer.resize(kBufferSize);
+	}
+
+	TextWriter::TextWriter(std::string& outString)
+		: m_f(nullptr)
+		, m_string(&outString)
+		, m_used(0)
+		, m_failed(false)
+	{
+		m_buffer.resize(kBufferSize);
+	}
+
+	TextWriter::~TextWriter()
+	{
+		Flush();
+	}
+
+	void TextWriter::WriteDec(uint32_t value)
+	{
+		char chars[10];
+		char* end = chars + sizeof(chars);
+		char* digits = FormatDec(value, end);
+
+		Write(digits, static_cast<size_t>(end - digits));
+	}
+
+	void TextWriter::WriteDec(int32_t value)
+	{
+		char chars[11];
+		char* end = chars + sizeof(chars);
+
+		char* digits = nullptr;
+		if (value < 0)
+		{
+			digits = FormatDec(0u - static_cast<uint32_t>(value), end);
+			*--digits = '-';
+		}
+		else
+			digits = FormatDec(static_cast<uint32_t>(value), end);
+
+		Write(digits, static_cast<size_t>(end - digits));
+	}
+
+	void TextWriter::WriteHex(uint32_t value, size_t minDigits)
+	{
+		char chars[8];
+		char* end = chars + sizeof(chars);
+		char* digits = end;
+
+		if (minDigits > sizeof(chars))
+			minDigits = sizeof(chars);
+
+		do
+		{
+			*--digits = ("0123456789abcdef")[value & 0xf];
+			value >>= 4;
+		} while (value != 0);
+
+		while (static_cast<size_t>(end - digits) < minDigits)
+			*--digits = '0';
+
+		Write(digits, static_cast<size_t>(end - digits));
+	}
+
+	void TextWriter::Printf(const char* format, ...)
+	{
+		// Most formatted text is short, so make sure it usually fits in what's left
+		if (kBufferSize - m_used < 256)
+			Flush();
+
+		va_list args;
+		va_start(args, format);
+
+		va_list retryArgs;
+		va_copy(retryArgs, args);
+
+		size_t available = kBufferSize - m_used;
+		int length = vsnprintf(&m_buffer[m_used], available, format, args);
+		va_end(args);
+
+		if (length >= 0)
+		{
+			if (static_cast<size_t>(length) < available)
+				m_used += static_cast<size_t>(length);
+			else
+			{
+				std::vector<char> chars;
+				chars.resize(static_cast<size_t>(length) + 1);
+				vsnprintf(&chars[0], chars.size(), format, retryArgs);
+				Write(&chars[0], static_cast<size_t>(length));
+			}
+		}
+
+		va_end(retryArgs);
+	}
+
+	bool TextWriter::Flush()
+	{
+		if (m_used > 0)
+		{
+			WriteOut(&m_buffer[0], m_used);
+			m_used = 0;
+		}
+
+		return !m_failed;
+	}
+
+	void TextWriter::WriteSlow(const char* chars, size_t length)
+	{
+		Flush();
+
+		if (length > kBufferSize)
+			WriteOut(chars, length);
+		else
+		{
+			memcpy(&m_buffer[0], chars, length);
+			m_used = length;
+		}
+	}
+
+	void TextWriter::WriteOut(const char* chars, size_t length)
+	{
+		if (m_string)
+			m_string->append(chars, length);
+		else if (fwrite(chars, 1, length, m_f) != length)
+			m_failed = true;
+	}
+}
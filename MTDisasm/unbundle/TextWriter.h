@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace mtdisasm
+{
+	// Collects text in a large buffer and writes it to a file in blocks.  Strings and
+	// integers are copied and formatted straight into the buffer, so the file's lock is
+	// only taken once per block and only Printf parses a format string.
+	class TextWriter
+	{
+	public:
+		explicit TextWriter(FILE* f);
+
+		// Appends to a string instead of a file, for capturing text that's embedded in
+		// other output
+		explicit TextWriter(std::string& outString);
+		~TextWriter();
+
+		void Write(const char* str);
+		void Write(const char* chars, size_t length);
+		void Put(char c);
+
+		void WriteDec(uint32_t value);
+		void WriteDec(int32_t value);
+
+		// Lowercase, padded with zeroes to at least minDigits digits
+		void WriteHex(uint32_t value, size_t minDigits);
+
+		void Printf(const char* format, ...);
+
+		// Writes out the buffered text.  Returns false if any write to the file has failed.
+		bool Flush();
+
+	private:
+		TextWriter(const TextWriter&) = delete;
+		TextWriter& operator=(const TextWriter&) = delete;
+
+		void WriteSlow(const char* chars, size_t length);
+
+		static const size_t kBufferSize = 64 * 1024;
+
+		void WriteOut(const char* chars, size_t length);
+
+		FILE* m_f;
+		std::string* m_string;
+		std::vector<char> m_buffer;
+		size_t m_used;
+		bool m_failed;
+	};
+
+	inline void TextWriter::Write(const char* str)
+	{
+		Write(str, strlen(str));
+	}
+
+	inline void TextWriter::Write(const char* chars, size_t length)
+	{
+		if (length <= kBufferSize - m_used)
+		{
+			memcpy(&m_buffer[m_used], chars, length);
+			m_used += length;
+		}
+		else
+			WriteSlow(chars, length);
+	}
+
+	inline void TextWriter::Put(char c)
+	{
+		if (m_used == kBufferSize)
+			Flush();
+
+		m_buffer[m_used++] = c;
+	}
+}
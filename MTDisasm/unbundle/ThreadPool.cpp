@@ -0,0 +1,116 @@
+#include "ThreadPool.h"
+
+namespace mtdisasm
+{
+	ThreadPool::ThreadPool(size_t numWorkers)
+		: m_numRunningJobs(0)
+		, m_isShuttingDown(false)
+	{
+		if (numWorkers == 0)
+			numWorkers = 1;
+
+		m_threads.reserve(numWorkers);
+		for (size_t i = 0; i < numWorkers; i++)
+			m_threads.push_back(std::thread(&ThreadPool::WorkerThreadFunc, this, i));
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_isShuttingDown = true;
+		}
+
+		m_jobAvailableCondition.notify_all();
+
+		for (std::thread& thread : m_threads)
+			thread.join();
+	}
+
+	size_t ThreadPool::NumWorkers() const
+	{
+		return m_threads.size();
+	}
+
+	void ThreadPool::Submit(const JobFunc& job)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_jobs.push_back(job);
+		}
+
+		m_jobAvailableCondition.notify_one();
+	}
+
+	void ThreadPool::WaitForIdle()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (!m_jobs.empty() || m_numRunningJobs > 0)
+			m_idleCondition.wait(lock);
+	}
+
+	size_t ThreadPool::DefaultNumWorkers()
+	{
+		unsigned int numThreads = std::thread::hardware_concurrency();
+		if (numThreads == 0)
+			return 1;
+
+		return numThreads;
+	}
+
+	void ThreadPool::WorkerThreadFunc(size_t workerIndex)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		for (;;)
+		{
+			while (m_jobs.empty() && !m_isShuttingDown)
+				m_jobAvailableCondition.wait(lock);
+
+			// Remaining jobs are still drained during shutdown
+			if (m_jobs.empty())
+				return;
+
+			JobFunc job = m_jobs.front();
+			m_jobs.pop_front();
+			m_numRunningJobs++;
+
+			lock.unlock();
+			job(workerIndex);
+			lock.lock();
+
+			m_numRunningJobs--;
+			if (m_jobs.empty() && m_numRunningJobs == 0)
+				m_idleCondition.notify_all();
+		}
+	}
+
+	ThreadBudget::ThreadBudget(size_t numThreads)
+		: m_numAvailable(static_cast<ptrdiff_t>(numThreads))
+	{
+	}
+
+	void ThreadBudget::Claim()
+	{
+		m_numAvailable.fetch_sub(1);
+	}
+
+	size_t ThreadBudget::TryAcquire(size_t maxThreads)
+	{
+		ptrdiff_t numAvailable = m_numAvailable.load();
+		for (;;)
+		{
+			if (numAvailable <= 0 || maxThreads == 0)
+				return 0;
+
+			const ptrdiff_t numTaken = (static_cast<size_t>(numAvailable) < maxThreads) ? numAvailable : static_cast<ptrdiff_t>(maxThreads);
+			if (m_numAvailable.compare_exchange_weak(numAvailable, numAvailable - numTaken))
+				return static_cast<size_t>(numTaken);
+		}
+	}
+
+	void ThreadBudget::Release(size_t numThreads)
+	{
+		m_numAvailable.fetch_add(static_cast<ptrdiff_t>(numThreads));
+	}
+}
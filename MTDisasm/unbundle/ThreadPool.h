@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mtdisasm
+{
+	// Fixed-size pool of worker threads.  Jobs receive the index of the worker running
+	// them so that callers can keep per-worker state (e.g. stream views) without locking.
+	class ThreadPool
+	{
+	public:
+		typedef std::function<void(size_t workerIndex)> JobFunc;
+
+		explicit ThreadPool(size_t numWorkers);
+		~ThreadPool();
+
+		size_t NumWorkers() const;
+
+		void Submit(const JobFunc& job);
+		void WaitForIdle();
+
+		static size_t DefaultNumWorkers();
+
+	private:
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		void WorkerThreadFunc(size_t workerIndex);
+
+		std::vector<std::thread> m_threads;
+		std::deque<JobFunc> m_jobs;
+
+		std::mutex m_mutex;
+		std::condition_variable m_jobAvailableCondition;
+		std::condition_variable m_idleCondition;
+
+		size_t m_numRunningJobs;
+		bool m_isShuttingDown;
+	};
+
+	// Limits the threads busy at once across jobs that can split their work further.  Busy
+	// threads are counted with Claim, and jobs take extra helper threads from what's left.
+	class ThreadBudget
+	{
+	public:
+		explicit ThreadBudget(size_t numThreads);
+
+		// Counts the calling thread until it's released.  Never waits, so the budget can be
+		// overdrawn while helpers that were already taken finish.
+		void Claim();
+
+		// Takes up to maxThreads of the threads that are left, and returns how many were taken
+		size_t TryAcquire(size_t maxThreads);
+
+		void Release(size_t numThreads);
+
+	private:
+		ThreadBudget(const ThreadBudget&) = delete;
+		ThreadBudget& operator=(const ThreadBudget&) = delete;
+
+		std::atomic<ptrdiff_t> m_numAvailable;
+	};
+}